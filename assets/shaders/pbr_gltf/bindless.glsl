@@ -0,0 +1,27 @@
+// Bindless materials, see BindlessMaterialTable
+
+struct MaterialData {
+    vec4 baseColorFactor;
+    vec3 emissiveFactor;
+    float metallicFactor;
+    float roughnessFactor;
+    float occlusionStrength;
+    uint texCoordSets;          // 4 bits per texture, in the order of the texture indices below
+    uint pad0;
+    int baseColorTexture;       // index into textures, -1 if none
+    int metallicRoughnessTexture;
+    int normalTexture;
+    int occlusionTexture;
+    int emissiveTexture;
+    uint pad1;
+    uint pad2;
+    uint pad3;
+};
+
+layout(std430, set = 2, binding = 0)
+readonly buffer MaterialDataBuffer {
+    MaterialData materials[];
+};
+
+layout(set = 2, binding = 1)
+uniform sampler2D textures[];
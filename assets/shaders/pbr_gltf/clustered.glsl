@@ -0,0 +1,42 @@
+// Clustered forward lighting, see ClusteredLighting
+
+struct ClusterParams {
+    vec2 tileScale;             // framebuffer coordinates -> tile
+    float sliceScale;           // log(view depth) -> slice
+    float sliceBias;
+    uint tileCountX;
+    uint tileCountY;
+    uint sliceCount;
+    uint directionalLightCount; // the first lights, they affect every cluster
+};
+
+layout(std430, set = 0, binding = 1)
+readonly buffer LightBuffer {
+    ClusterParams clusterParams;
+    Light lights[];
+};
+
+// offset and count of the cluster's light list
+layout(std430, set = 0, binding = 2)
+readonly buffer ClusterBuffer {
+    uvec2 clusters[];
+};
+
+layout(std430, set = 0, binding = 3)
+readonly buffer LightIndexBuffer {
+    uint lightIndices[];
+};
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+uvec2 getCluster(vec2 fragCoord, float viewDepth)
+{
+    uvec2 tile = min(
+        uvec2(fragCoord * clusterParams.tileScale),
+        uvec2(clusterParams.tileCountX, clusterParams.tileCountY) - 1u);
+
+    float slice = log(viewDepth) * clusterParams.sliceScale + clusterParams.sliceBias;
+    uint sliceIndex = uint(clamp(slice, 0.0, float(clusterParams.sliceCount - 1u)));
+
+    return clusters[(sliceIndex * clusterParams.tileCountY + tile.y) * clusterParams.tileCountX + tile.x];
+}
@@ -0,0 +1,65 @@
+//
+// Image based lighting with the maps baked by IblBaker
+//
+// https://github.com/KhronosGroup/glTF-Sample-Viewer/blob/master/source/Renderer/shaders/ibl.glsl
+// https://bruop.github.io/ibl/#single_scattering_results
+//
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+// mip level i of the specular map holds roughness i / (specularMipCount - 1)
+vec3 getIBLRadianceGGX(
+    samplerCube specularMap,
+    uint specularMipCount,
+    sampler2D brdfLut,
+    vec3 n,
+    vec3 v,
+    float roughness,
+    vec3 F0,
+    float specularWeight)
+{
+    float NdotV = clamp(dot(n, v), 0.0, 1.0);
+    float lod = roughness * float(specularMipCount - 1u);
+    vec3 reflection = normalize(reflect(-v, n));
+
+    vec2 f_ab = texture(brdfLut, clamp(vec2(NdotV, roughness), vec2(0.0), vec2(1.0))).rg;
+    vec3 specularLight = textureLod(specularMap, reflection, lod).rgb;
+
+    // roughness dependent fresnel, from Fdez-Aguera
+    vec3 Fr = max(vec3(1.0 - roughness), F0) - F0;
+    vec3 k_S = F0 + Fr * pow(1.0 - NdotV, 5.0);
+    vec3 FssEss = k_S * f_ab.x + f_ab.y;
+
+    return specularWeight * specularLight * FssEss;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+vec3 getIBLRadianceLambertian(
+    samplerCube irradianceMap,
+    sampler2D brdfLut,
+    vec3 n,
+    vec3 v,
+    float roughness,
+    vec3 diffuseColor,
+    vec3 F0,
+    float specularWeight)
+{
+    float NdotV = clamp(dot(n, v), 0.0, 1.0);
+    vec2 f_ab = texture(brdfLut, clamp(vec2(NdotV, roughness), vec2(0.0), vec2(1.0))).rg;
+    vec3 irradiance = texture(irradianceMap, n).rgb;
+
+    // multiple scattering, from Fdez-Aguera
+    vec3 Fr = max(vec3(1.0 - roughness), F0) - F0;
+    vec3 k_S = F0 + Fr * pow(1.0 - NdotV, 5.0);
+    vec3 FssEss = specularWeight * k_S * f_ab.x + f_ab.y;
+
+    float Ems = 1.0 - (f_ab.x + f_ab.y);
+    vec3 F_avg = specularWeight * (F0 + (1.0 - F0) / 21.0);
+    vec3 FmsEms = Ems * FssEss * F_avg / (1.0 - F_avg * Ems);
+    vec3 k_D = diffuseColor * (1.0 - FssEss + FmsEms);
+
+    return (FmsEms + k_D) * irradiance;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
@@ -16,6 +16,10 @@ vec4 getBaseColor()
     baseColor *= texture(u_DiffuseSampler, getDiffuseUV());
 #elif defined(MATERIAL_METALLICROUGHNESS) && defined(HAS_BASE_COLOR_MAP)
     baseColor *= texture(baseColorSampler, getBaseColorUV());
+#elif defined(MATERIAL_METALLICROUGHNESS) && defined(BINDLESS) && defined(HAS_TEXCOORD_VEC2)
+    if (material.baseColorTexture >= 0) {
+        baseColor *= texture(textures[nonuniformEXT(material.baseColorTexture)], getBaseColorUV());
+    }
 #endif
 
     return baseColor * getVertexColor();
@@ -0,0 +1,31 @@
+// decoding of the packed vertex attributes, see VertexFormat::packNormal() and VertexFormat::packTangent()
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+vec3 decodeOctahedral(vec2 e)
+{
+    vec3 n = vec3(e.xy, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+
+    return normalize(n);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+vec3 unpackNormal(uint packedNormal)
+{
+    return decodeOctahedral(unpackSnorm2x16(packedNormal));
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+vec4 unpackTangent(uint packedTangent)
+{
+    float bitangentSign = (packedTangent & 0x10000u) != 0u ? -1.0 : 1.0;
+
+    return vec4(decodeOctahedral(unpackSnorm2x16(packedTangent)), bitangentSign);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
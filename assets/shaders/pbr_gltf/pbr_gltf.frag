@@ -15,6 +15,7 @@
 //     https://github.com/KhronosGroup/glTF/tree/master/extensions/2.0/Khronos/KHR_materials_clearcoat
 
 #version 450
+#extension GL_EXT_nonuniform_qualifier : enable
 #rfx
 
 precision highp float;
@@ -35,6 +36,14 @@ uniform ShaderData {
     Light lights[MAX_LIGHTS];
 } shader;
 
+#ifdef CLUSTERED_LIGHTING
+#include <clustered.glsl>
+#endif
+
+#ifdef BINDLESS
+#include <bindless.glsl>
+#define material materials[inMaterialIndex]
+#else
 layout(set = 2, binding = 0)
 uniform MaterialData {
     vec4 baseColorFactor;
@@ -43,11 +52,21 @@ uniform MaterialData {
     float pad0;
     float pad1;
 } material;
+#endif
 
-layout(set = 3, binding = 0)
-uniform MeshData {
+struct DrawData {
     mat4 modelMatrix;
-} mesh;
+    uint materialIndex;
+    uint pad0;
+    uint pad1;
+    uint pad2;
+};
+
+// indexed with gl_InstanceIndex, i.e. the firstInstance of the indirect draw command plus the instance
+layout(std430, set = 3, binding = 0)
+readonly buffer DrawDataBuffer {
+    DrawData draws[];
+};
 
 
 layout(location = 0) in vec3 inPosition;
@@ -258,6 +277,38 @@ MaterialInfo getMetallicRoughnessInfo(MaterialInfo info)
 
 // ---------------------------------------------------------------------------------------------------------------------
 
+#ifdef USE_PUNCTUAL
+void addLightContribution(Light light, vec3 n, vec3 v, MaterialInfo materialInfo, inout vec3 f_diffuse, inout vec3 f_specular)
+{
+    vec3 pointToLight;
+    if (light.type != DIRECTIONAL_LIGHT) {
+        pointToLight = light.position - inPosition;
+    }
+    else  {
+        pointToLight = -light.direction;
+    }
+
+    // BSTF
+    vec3 l = normalize(pointToLight);   // Direction from surface point to light
+    vec3 h = normalize(l + v);          // Direction of the vector between l and v, called halfway vector
+    float NdotL = clampedDot(n, l);
+    float NdotV = clampedDot(n, v);
+    float NdotH = clampedDot(n, h);
+    float LdotH = clampedDot(l, h);
+    float VdotH = clampedDot(v, h);
+    if (NdotL > 0.0 || NdotV > 0.0)
+    {
+        // Calculation of analytical light
+        // https://github.com/KhronosGroup/glTF/tree/master/specification/2.0#acknowledgments AppendixB
+        vec3 intensity = getLightIntensity(light, pointToLight);
+        f_diffuse += intensity * NdotL *  BRDF_lambertian(materialInfo.f0, materialInfo.f90, materialInfo.c_diff, materialInfo.specularWeight, VdotH);
+        f_specular += intensity * NdotL * BRDF_specularGGX(materialInfo.f0, materialInfo.f90, materialInfo.alphaRoughness, materialInfo.specularWeight, VdotH, NdotL, NdotV, NdotH);
+    }
+}
+#endif
+
+// ---------------------------------------------------------------------------------------------------------------------
+
 void main() {
     vec4 baseColor = getBaseColor();
 
@@ -311,38 +362,26 @@ void main() {
 
 #ifdef USE_PUNCTUAL
 
+#ifdef CLUSTERED_LIGHTING
+    for (uint i = 0; i < clusterParams.directionalLightCount; ++i) {
+        addLightContribution(lights[i], n, v, materialInfo, f_diffuse, f_specular);
+    }
+
+    // only the point and spot lights whose range overlaps the cluster of this fragment
+    float viewDepth = -(scene.viewMatrix * vec4(inPosition, 1.0)).z;
+    uvec2 cluster = getCluster(gl_FragCoord.xy, viewDepth);
+    for (uint i = 0; i < cluster.y; ++i) {
+        addLightContribution(lights[lightIndices[cluster.x + i]], n, v, materialInfo, f_diffuse, f_specular);
+    }
+#else
     for (int i = 0; i < MAX_LIGHTS; ++i)
     {
         Light light = shader.lights[i];
-        if (!light.enabled) {
-            continue;
-        }
-
-        vec3 pointToLight;
-        if (light.type != DIRECTIONAL_LIGHT) {
-            pointToLight = light.position - inPosition;
-        }
-        else  {
-            pointToLight = -light.direction;
-        }
-
-        // BSTF
-        vec3 l = normalize(pointToLight);   // Direction from surface point to light
-        vec3 h = normalize(l + v);          // Direction of the vector between l and v, called halfway vector
-        float NdotL = clampedDot(n, l);
-        float NdotV = clampedDot(n, v);
-        float NdotH = clampedDot(n, h);
-        float LdotH = clampedDot(l, h);
-        float VdotH = clampedDot(v, h);
-        if (NdotL > 0.0 || NdotV > 0.0)
-        {
-            // Calculation of analytical light
-            // https://github.com/KhronosGroup/glTF/tree/master/specification/2.0#acknowledgments AppendixB
-            vec3 intensity = getLightIntensity(light, pointToLight);
-            f_diffuse += intensity * NdotL *  BRDF_lambertian(materialInfo.f0, materialInfo.f90, materialInfo.c_diff, materialInfo.specularWeight, VdotH);
-            f_specular += intensity * NdotL * BRDF_specularGGX(materialInfo.f0, materialInfo.f90, materialInfo.alphaRoughness, materialInfo.specularWeight, VdotH, NdotL, NdotV, NdotH);
+        if (light.enabled) {
+            addLightContribution(light, n, v, materialInfo, f_diffuse, f_specular);
         }
     }
+#endif
 
 #endif
 
@@ -17,6 +17,7 @@ uniform ShaderData {
     Light lights[MAX_LIGHTS];
 } shader;
 
+#ifndef BINDLESS
 layout(set = 2, binding = 0)
 uniform MaterialData {
     vec4 baseColor;
@@ -25,15 +26,30 @@ uniform MaterialData {
     float pad0;
     float pad1;
 } material;
+#endif
 
-layout(set = 3, binding = 0)
-uniform MeshData {
+struct DrawData {
     mat4 modelMatrix;
-} mesh;
+    uint materialIndex;
+    uint pad0;
+    uint pad1;
+    uint pad2;
+};
+
+// indexed with gl_InstanceIndex, i.e. the firstInstance of the indirect draw command plus the instance
+layout(std430, set = 3, binding = 0)
+readonly buffer DrawDataBuffer {
+    DrawData draws[];
+};
 
 
 layout(location = 0) in vec3 inPosition;
 
+#ifdef HAS_PACKED_NORMALS
+#include <packing.glsl>
+#define inNormal unpackNormal(inPackedNormal)
+#endif
+
 layout(location = 0) out vec3 outPosition;
 
 // ---------------------------------------------------------------------------------------------------------------------
@@ -76,7 +92,13 @@ vec3 getNormal()
 
 void main()
 {
-    vec4 pos = mesh.modelMatrix * getPosition();
+    mat4 modelMatrix = draws[gl_InstanceIndex].modelMatrix;
+
+#ifdef BINDLESS
+    outMaterialIndex = draws[gl_InstanceIndex].materialIndex;
+#endif
+
+    vec4 pos = modelMatrix * getPosition();
     outPosition = vec3(pos.xyz) / pos.w;
 
 #ifdef HAS_NORMAL_VEC3
@@ -87,7 +109,7 @@ void main()
     vec3 bitangentW = cross(normalW, tangentW) * a_tangent.w;
     v_TBN = mat3(tangentW, bitangentW, normalW);
 #else
-    mat3 normalMatrix = mat3(mesh.modelMatrix);
+    mat3 normalMatrix = mat3(modelMatrix);
     outNormal = normalize(normalMatrix * inNormal);
 #endif
 #endif
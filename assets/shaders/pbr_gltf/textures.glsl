@@ -3,8 +3,10 @@
 
 #ifdef MATERIAL_METALLICROUGHNESS
 
+#ifndef BINDLESS
 layout(set = 2, binding = 1)
 uniform sampler2D baseColorSampler;
+#endif
 
 #ifdef HAS_TEXCOORD_VEC2
 
@@ -10,10 +10,6 @@ using namespace filesystem;
 
 // ---------------------------------------------------------------------------------------------------------------------
 
-static const int MAX_FRAMES_IN_FLIGHT = 2;
-
-// ---------------------------------------------------------------------------------------------------------------------
-
 static void onGlfwError(int, const char* description) {
     RFX_LOG_ERROR << description;
 }
@@ -88,6 +84,7 @@ void Application::initGraphics()
     createMultiSamplingBuffer();
     createDepthBuffer();
     createSyncObjects();
+    createFrameCommandPools();
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
@@ -111,7 +108,12 @@ void Application::createGraphicsDevice()
     graphicsDevice = graphicsContext->createGraphicsDevice(
         features,
         { VK_KHR_SWAPCHAIN_EXTENSION_NAME, VK_KHR_MAINTENANCE1_EXTENSION_NAME},
-        { VK_QUEUE_GRAPHICS_BIT, VK_QUEUE_COMPUTE_BIT });
+        { VK_QUEUE_GRAPHICS_BIT, VK_QUEUE_COMPUTE_BIT },
+        { VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME });
+
+    graphicsDevice->setShaderCache(make_shared<ShaderCache>(getCacheDirectory() / "shaders"));
+    graphicsDevice->getPipelineCache()->load(getPipelineCachePath());
+    graphicsDevice->setMipmapGenerator(make_shared<MipmapGenerator>(graphicsDevice, getShadersDirectory()));
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
@@ -189,6 +191,20 @@ path Application::getShadersDirectory()
 
 // ---------------------------------------------------------------------------------------------------------------------
 
+path Application::getCacheDirectory()
+{
+    return filesystem::current_path() / "cache";
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+path Application::getPipelineCachePath()
+{
+    return getCacheDirectory() / "pipelines.bin";
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
 void Application::createFrameBuffers()
 {
     graphicsDevice->getSwapChain()->createFrameBuffers(
@@ -257,6 +273,9 @@ void Application::runMainLoop()
         if (acquireNextImage()) {
             updateFrameDeltaTime();
             update(deltaTime);
+            if (perFrameRecording) {
+                recordCurrentFrame();
+            }
             drawDevTools();
             submitAndPresent();
         }
@@ -343,7 +362,9 @@ void Application::submitAndPresent()
     VkPipelineStageFlags waitStages[] = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
 
     vector<VkCommandBuffer> submitCommandBuffers {
-        commandBuffers[currentImageIndex]->getHandle()
+        perFrameRecording
+            ? frameCommandBuffers[currentFrame]->getHandle()
+            : commandBuffers[currentImageIndex]->getHandle()
     };
     if (devToolsEnabled) {
         submitCommandBuffers.push_back(devTools->getCommandBuffer(currentImageIndex));
@@ -392,12 +413,14 @@ void Application::cleanup()
 
     cleanupSwapChain();
     destroySyncObjects();
+    destroyFrameCommandPools();
 
     if (descriptorPool != VK_NULL_HANDLE) {
         vkDestroyDescriptorPool(graphicsDevice->getLogicalDevice(), descriptorPool, nullptr);
         descriptorPool = VK_NULL_HANDLE;
     }
 
+    graphicsDevice->getPipelineCache()->save(getPipelineCachePath());
     graphicsDevice.reset();
     graphicsContext.reset();
 
@@ -425,6 +448,62 @@ void Application::destroySyncObjects()
 
 // ---------------------------------------------------------------------------------------------------------------------
 
+void Application::createFrameCommandPools()
+{
+    const VkCommandPoolCreateInfo poolInfo = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+        .flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
+        .queueFamilyIndex = graphicsDevice->getGraphicsQueue()->getFamilyIndex()
+    };
+
+    frameCommandPools.resize(MAX_FRAMES_IN_FLIGHT);
+    frameCommandBuffers.resize(MAX_FRAMES_IN_FLIGHT);
+
+    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+        ThrowIfFailed(vkCreateCommandPool(
+            graphicsDevice->getLogicalDevice(),
+            &poolInfo,
+            nullptr,
+            &frameCommandPools[i]));
+
+        frameCommandBuffers[i] = graphicsDevice->createCommandBuffer(frameCommandPools[i]);
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void Application::destroyFrameCommandPools()
+{
+    for (VkCommandPool commandPool : frameCommandPools) {
+        vkDestroyCommandPool(graphicsDevice->getLogicalDevice(), commandPool, nullptr);
+    }
+
+    frameCommandPools.clear();
+    frameCommandBuffers.clear();
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void Application::recordCurrentFrame()
+{
+    // acquireNextImage() has waited for this frame's fence, so nothing allocated from the pool is in flight anymore
+    ThrowIfFailed(vkResetCommandPool(
+        graphicsDevice->getLogicalDevice(),
+        frameCommandPools[currentFrame],
+        0));
+
+    recordFrame(frameCommandBuffers[currentFrame]);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+uint32_t Application::getCurrentFrame() const
+{
+    return static_cast<uint32_t>(currentFrame);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
 void Application::cleanupSwapChain()
 {
 //    const VkDevice vkDevice = graphicsDevice->getLogicalDevice();
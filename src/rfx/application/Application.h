@@ -14,6 +14,8 @@ class Application : public std::enable_shared_from_this<Application>,
                     public WindowListener
 {
 public:
+    static constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 2;
+
     Application();
     virtual ~Application() = default;
 
@@ -22,6 +24,8 @@ public:
 protected:
     [[nodiscard]] static std::filesystem::path getAssetsDirectory();    // TODO: this should be defined by concrete application - make pure virtual
     [[nodiscard]] static std::filesystem::path getShadersDirectory();   // TODO: this should be defined by concrete application - make pure virtual
+    [[nodiscard]] static std::filesystem::path getCacheDirectory();
+    [[nodiscard]] static std::filesystem::path getPipelineCachePath();
 
     void onResized(const Window& window, int width, int height) override;
 
@@ -33,6 +37,11 @@ protected:
     virtual void recreateSwapChain();
     void freeCommandBuffers();
 
+    // with perFrameRecording, called every frame once the frame's previous submission has completed;
+    // the command buffer comes from a per-frame command pool that was just reset
+    virtual void recordFrame(const CommandBufferPtr& commandBuffer) {}
+    [[nodiscard]] uint32_t getCurrentFrame() const;
+
     void createFrameBuffers();
     void createSyncObjects();
     void destroyRenderPass();
@@ -45,6 +54,7 @@ protected:
     VkRenderPass renderPass = VK_NULL_HANDLE;
     VkDescriptorPool descriptorPool = VK_NULL_HANDLE;
     uint32_t currentImageIndex = 0;
+    bool perFrameRecording = false;
 
     bool devToolsEnabled = true;
     std::unique_ptr<DevTools> devTools;
@@ -74,6 +84,9 @@ private:
     void endMainLoop() const;
 
     void destroySyncObjects();
+    void createFrameCommandPools();
+    void destroyFrameCommandPools();
+    void recordCurrentFrame();
 
     std::vector<VkSemaphore> imageAvailableSemaphores;
     std::vector<VkSemaphore> renderFinishedSemaphores;
@@ -81,6 +94,8 @@ private:
     size_t currentFrame = 0;
     std::vector<VkFence> fencesInFlight;
     std::vector<VkFence> imagesInFlight;
+    std::vector<VkCommandPool> frameCommandPools;
+    std::vector<CommandBufferPtr> frameCommandBuffers;
     bool windowResized = false;
     bool paused = false;
 
@@ -60,7 +60,7 @@ DevTools::DevTools(
         .Device = graphicsDevice_->getLogicalDevice(),
         .QueueFamily = graphicsDevice_->getGraphicsQueue()->getFamilyIndex(),
         .Queue = graphicsDevice_->getGraphicsQueue()->getHandle(),
-        .PipelineCache = VK_NULL_HANDLE,
+        .PipelineCache = graphicsDevice_->getPipelineCache()->getHandle(),
         .DescriptorPool = descriptorPool,
         .MinImageCount = swapChainDesc.bufferCount,
         .ImageCount = swapChainDesc.bufferCount,
@@ -212,6 +212,9 @@ void DevTools::beginDraw(uint32_t frameIndex, uint32_t lastFPS)
     ImGui::Begin("DevTools", nullptr, ImGuiWindowFlags_AlwaysAutoResize);
     ImGui::Text("%s", graphicsDevice_->getDesc().properties.deviceName);
     ImGui::Text("%.2f ms/frame (%.1d fps)", (1000.0f / lastFPS), lastFPS);
+    const DeviceMemoryStats memoryStats = graphicsDevice_->getMemoryStats();
+    ImGui::Text("%u device memory allocations (%u sub-allocated resources)",
+        memoryStats.deviceMemoryCount, memoryStats.subAllocationCount);
     ImGui::NewLine();
 }
 
@@ -325,3 +328,10 @@ bool DevTools::collapsingHeader(const char* label, bool expanded)
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
+
+void DevTools::text(const string& text)
+{
+    ImGui::TextUnformatted(text.c_str());
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
@@ -26,6 +26,7 @@ public:
     bool colorEdit3(const char* label, float* color);
     bool combo(const char* label, int itemCount, const char** items, int* selectedIndex);
     bool collapsingHeader(const char* label, bool expanded);
+    void text(const std::string& text);
 
     [[nodiscard]] VkCommandBuffer getCommandBuffer(uint32_t frameIndex) const;
 
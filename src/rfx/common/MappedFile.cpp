@@ -0,0 +1,102 @@
+#include "rfx/pch.h"
+#include "rfx/common/MappedFile.h"
+
+#ifndef _WINDOWS
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif // _WINDOWS
+
+using namespace rfx;
+using namespace std;
+using namespace std::filesystem;
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+#ifdef _WINDOWS
+MappedFile::MappedFile(const path& filePath)
+{
+    RFX_CHECK_STATE(exists(filePath), "File not found: " + filePath.string());
+
+    size = file_size(filePath);
+    if (size == 0) {
+        return;
+    }
+
+    fileHandle = CreateFileW(
+        filePath.wstring().c_str(),
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+        nullptr);
+    RFX_CHECK_STATE(fileHandle != INVALID_HANDLE_VALUE, "Failed to open file: " + filePath.string());
+
+    mappingHandle = CreateFileMappingW(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    RFX_CHECK_STATE(mappingHandle != nullptr, "Failed to map file: " + filePath.string());
+
+    data = static_cast<const std::byte*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+    RFX_CHECK_STATE(data != nullptr, "Failed to map file: " + filePath.string());
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+MappedFile::~MappedFile()
+{
+    if (data != nullptr) {
+        UnmapViewOfFile(data);
+    }
+    if (mappingHandle != nullptr) {
+        CloseHandle(mappingHandle);
+    }
+    if (fileHandle != INVALID_HANDLE_VALUE) {
+        CloseHandle(fileHandle);
+    }
+}
+#else
+MappedFile::MappedFile(const path& filePath)
+{
+    RFX_CHECK_STATE(exists(filePath), "File not found: " + filePath.string());
+
+    size = file_size(filePath);
+    if (size == 0) {
+        return;
+    }
+
+    const int fileDescriptor = open(filePath.c_str(), O_RDONLY);
+    RFX_CHECK_STATE(fileDescriptor != -1, "Failed to open file: " + filePath.string());
+
+    void* mappedData = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+    close(fileDescriptor);
+    RFX_CHECK_STATE(mappedData != MAP_FAILED, "Failed to map file: " + filePath.string());
+
+    madvise(mappedData, size, MADV_SEQUENTIAL);
+    data = static_cast<const std::byte*>(mappedData);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+MappedFile::~MappedFile()
+{
+    if (data != nullptr) {
+        munmap(const_cast<std::byte*>(data), size);
+    }
+}
+#endif // _WINDOWS
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+const std::byte* MappedFile::getData() const
+{
+    return data;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+size_t MappedFile::getSize() const
+{
+    return size;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
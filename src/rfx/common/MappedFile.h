@@ -0,0 +1,28 @@
+#pragma once
+
+
+namespace rfx {
+
+// Read-only memory mapping of a whole file
+class MappedFile
+{
+public:
+    explicit MappedFile(const std::filesystem::path& filePath);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    [[nodiscard]] const std::byte* getData() const;
+    [[nodiscard]] size_t getSize() const;
+
+private:
+    const std::byte* data = nullptr;
+    size_t size = 0;
+#ifdef _WINDOWS
+    HANDLE fileHandle = INVALID_HANDLE_VALUE;
+    HANDLE mappingHandle = nullptr;
+#endif // _WINDOWS
+};
+
+} // namespace rfx
@@ -10,6 +10,12 @@ public:
 
     Math() = delete;
 
+    // rounds value up to the next multiple of alignment, which doesn't need to be a power of two
+    static constexpr uint64_t alignUp(uint64_t value, uint64_t alignment)
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
 };
 
 
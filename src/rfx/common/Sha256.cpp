@@ -0,0 +1,163 @@
+#include "rfx/pch.h"
+#include "rfx/common/Sha256.h"
+
+using namespace rfx;
+using namespace std;
+
+static constexpr array<uint32_t, 64> ROUND_CONSTANTS = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+static constexpr uint32_t rotateRight(uint32_t value, int count)
+{
+    return (value >> count) | (value << (32 - count));
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+Sha256::Sha256()
+    : state { 0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19 } {}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void Sha256::update(const void* data, size_t size)
+{
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    messageSize += size;
+
+    while (size > 0)
+    {
+        const size_t count = min(size, buffer.size() - bufferSize);
+        memcpy(buffer.data() + bufferSize, bytes, count);
+        bufferSize += count;
+        bytes += count;
+        size -= count;
+
+        if (bufferSize == buffer.size()) {
+            processBlock(buffer.data());
+            bufferSize = 0;
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void Sha256::update(string_view data)
+{
+    update(data.data(), data.size());
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+Sha256::Digest Sha256::finish()
+{
+    const uint64_t messageBits = messageSize * 8;
+
+    // padding: a single 1 bit, zeros up to 56 mod 64 bytes, then the message length as big endian 64 bit value
+    const uint8_t padStart = 0x80;
+    update(&padStart, 1);
+
+    const uint8_t zero = 0;
+    while (bufferSize != 56) {
+        update(&zero, 1);
+    }
+
+    array<uint8_t, 8> length {};
+    for (size_t i = 0; i < length.size(); ++i) {
+        length[i] = static_cast<uint8_t>(messageBits >> (56 - 8 * i));
+    }
+    update(length.data(), length.size());
+
+    Digest digest {};
+    for (size_t i = 0; i < state.size(); ++i) {
+        digest[4 * i + 0] = static_cast<uint8_t>(state[i] >> 24);
+        digest[4 * i + 1] = static_cast<uint8_t>(state[i] >> 16);
+        digest[4 * i + 2] = static_cast<uint8_t>(state[i] >> 8);
+        digest[4 * i + 3] = static_cast<uint8_t>(state[i]);
+    }
+
+    return digest;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void Sha256::processBlock(const uint8_t* block)
+{
+    array<uint32_t, 64> w {};
+    for (size_t i = 0; i < 16; ++i) {
+        w[i] = static_cast<uint32_t>(block[4 * i]) << 24
+            | static_cast<uint32_t>(block[4 * i + 1]) << 16
+            | static_cast<uint32_t>(block[4 * i + 2]) << 8
+            | static_cast<uint32_t>(block[4 * i + 3]);
+    }
+    for (size_t i = 16; i < 64; ++i) {
+        const uint32_t s0 = rotateRight(w[i - 15], 7) ^ rotateRight(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        const uint32_t s1 = rotateRight(w[i - 2], 17) ^ rotateRight(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    uint32_t a = state[0];
+    uint32_t b = state[1];
+    uint32_t c = state[2];
+    uint32_t d = state[3];
+    uint32_t e = state[4];
+    uint32_t f = state[5];
+    uint32_t g = state[6];
+    uint32_t h = state[7];
+
+    for (size_t i = 0; i < 64; ++i)
+    {
+        const uint32_t s1 = rotateRight(e, 6) ^ rotateRight(e, 11) ^ rotateRight(e, 25);
+        const uint32_t choice = (e & f) ^ (~e & g);
+        const uint32_t temp1 = h + s1 + choice + ROUND_CONSTANTS[i] + w[i];
+        const uint32_t s0 = rotateRight(a, 2) ^ rotateRight(a, 13) ^ rotateRight(a, 22);
+        const uint32_t majority = (a & b) ^ (a & c) ^ (b & c);
+        const uint32_t temp2 = s0 + majority;
+
+        h = g;
+        g = f;
+        f = e;
+        e = d + temp1;
+        d = c;
+        c = b;
+        b = a;
+        a = temp1 + temp2;
+    }
+
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+string Sha256::toHexString(const Digest& digest)
+{
+    static constexpr char HEX_DIGITS[] = "0123456789abcdef";
+
+    string hexString;
+    hexString.reserve(digest.size() * 2);
+
+    for (uint8_t byte : digest) {
+        hexString.push_back(HEX_DIGITS[byte >> 4]);
+        hexString.push_back(HEX_DIGITS[byte & 0x0f]);
+    }
+
+    return hexString;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
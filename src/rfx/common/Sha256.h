@@ -0,0 +1,32 @@
+#pragma once
+
+#include <array>
+
+
+namespace rfx {
+
+// Incremental SHA-256 (FIPS 180-4)
+class Sha256
+{
+public:
+    using Digest = std::array<uint8_t, 32>;
+
+    Sha256();
+
+    void update(const void* data, size_t size);
+    void update(std::string_view data);
+
+    [[nodiscard]] Digest finish();
+
+    [[nodiscard]] static std::string toHexString(const Digest& digest);
+
+private:
+    void processBlock(const uint8_t* block);
+
+    std::array<uint32_t, 8> state {};
+    std::array<uint8_t, 64> buffer {};
+    size_t bufferSize = 0;
+    uint64_t messageSize = 0;
+};
+
+} // namespace rfx
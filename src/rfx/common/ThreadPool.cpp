@@ -0,0 +1,69 @@
+#include "rfx/pch.h"
+#include "rfx/common/ThreadPool.h"
+
+using namespace rfx;
+using namespace std;
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+ThreadPool::ThreadPool(uint32_t threadCount)
+{
+    RFX_CHECK_ARGUMENT(threadCount > 0);
+
+    threads.reserve(threadCount);
+    for (uint32_t i = 0; i < threadCount; ++i) {
+        threads.emplace_back(&ThreadPool::run, this);
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+ThreadPool::~ThreadPool()
+{
+    {
+        lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    condition.notify_all();
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void ThreadPool::run()
+{
+    for (;;) {
+        function<void()> task;
+        {
+            unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [this] { return stopping || !tasks.empty(); });
+            if (tasks.empty()) {
+                return;
+            }
+            task = move(tasks.front());
+            tasks.pop_front();
+        }
+
+        // exceptions are delivered through the task's future
+        task();
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+uint32_t ThreadPool::getThreadCount() const
+{
+    return static_cast<uint32_t>(threads.size());
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+uint32_t ThreadPool::getDefaultThreadCount()
+{
+    return max(thread::hardware_concurrency(), 1U);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
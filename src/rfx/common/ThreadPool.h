@@ -0,0 +1,49 @@
+#pragma once
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <deque>
+
+namespace rfx {
+
+class ThreadPool
+{
+public:
+    explicit ThreadPool(uint32_t threadCount = getDefaultThreadCount());
+    ~ThreadPool();
+
+    template<typename Task>
+    auto submit(Task&& task) -> std::future<std::invoke_result_t<Task>>
+    {
+        using Result = std::invoke_result_t<Task>;
+
+        auto packagedTask = std::make_shared<std::packaged_task<Result()>>(std::forward<Task>(task));
+        std::future<Result> future = packagedTask->get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            tasks.emplace_back([packagedTask] { (*packagedTask)(); });
+        }
+        condition.notify_one();
+
+        return future;
+    }
+
+    [[nodiscard]] uint32_t getThreadCount() const;
+
+    [[nodiscard]] static uint32_t getDefaultThreadCount();
+
+private:
+    void run();
+
+    std::vector<std::thread> threads;
+    std::deque<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool stopping = false;
+};
+
+using ThreadPoolPtr = std::shared_ptr<ThreadPool>;
+
+} // namespace rfx
@@ -11,13 +11,14 @@ Buffer::Buffer(
     VkDeviceSize size,
     VkDevice device,
     VkBuffer buffer,
-    VkDeviceMemory deviceMemory)
+    const DeviceMemoryAllocation& allocation,
+    DeviceMemoryAllocatorPtr allocator)
         : size_(size),
           device_(device),
           buffer_(buffer),
-          deviceMemory_(deviceMemory)
+          allocation_(allocation),
+          allocator_(move(allocator))
 {
-    // TODO: support for sub-buffer allocation
     descriptorBufferInfo_ = {
         .buffer = buffer,
         .offset = 0,
@@ -29,8 +30,8 @@ Buffer::Buffer(
 
 Buffer::~Buffer()
 {
-    vkFreeMemory(device_, deviceMemory_, nullptr);
     vkDestroyBuffer(device_, buffer_, nullptr);
+    allocator_->free(allocation_);
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
@@ -38,19 +39,9 @@ Buffer::~Buffer()
 void Buffer::load(size_t size, const void* inData) const
 {
     RFX_CHECK_ARGUMENT(size <= size_);
+    RFX_CHECK_STATE(allocation_.mappedData != nullptr, "Buffer memory is not host visible");
 
-    uint8_t* mappedMemory = nullptr;
-    ThrowIfFailed(vkMapMemory(
-        device_,
-        deviceMemory_,
-        0,
-        size,
-        0,
-        reinterpret_cast<void**>(&mappedMemory)));
-
-    memcpy(mappedMemory, inData, size);
-
-    vkUnmapMemory(device_, deviceMemory_);
+    memcpy(allocation_.mappedData, inData, size);
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
@@ -64,7 +55,21 @@ VkBuffer Buffer::getHandle() const
 
 VkDeviceMemory Buffer::getDeviceMemory() const
 {
-    return deviceMemory_;
+    return allocation_.deviceMemory;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+VkDeviceSize Buffer::getDeviceMemoryOffset() const
+{
+    return allocation_.offset;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void* Buffer::getMappedData() const
+{
+    return allocation_.mappedData;
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
@@ -86,19 +91,9 @@ const VkDescriptorBufferInfo& Buffer::getDescriptorBufferInfo() const
 void Buffer::save(size_t size, void* outData) const
 {
     RFX_CHECK_ARGUMENT(size <= size_);
+    RFX_CHECK_STATE(allocation_.mappedData != nullptr, "Buffer memory is not host visible");
 
-    void* mappedMemory = nullptr;
-    ThrowIfFailed(vkMapMemory(
-        device_,
-        deviceMemory_,
-        0,
-        size,
-        0,
-        &mappedMemory));
-
-    memcpy(outData, mappedMemory, size);
-
-    vkUnmapMemory(device_, deviceMemory_);
+    memcpy(outData, allocation_.mappedData, size);
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
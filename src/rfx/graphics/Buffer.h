@@ -1,5 +1,7 @@
 #pragma once
 
+#include "rfx/graphics/DeviceMemoryAllocator.h"
+
 namespace rfx {
 
 class Buffer
@@ -9,7 +11,8 @@ public:
         VkDeviceSize size,
         VkDevice device,
         VkBuffer buffer,
-        VkDeviceMemory deviceMemory);
+        const DeviceMemoryAllocation& allocation,
+        DeviceMemoryAllocatorPtr allocator);
 
     virtual ~Buffer();
 
@@ -18,6 +21,8 @@ public:
 
     [[nodiscard]] VkBuffer getHandle() const;
     [[nodiscard]] VkDeviceMemory getDeviceMemory() const;
+    [[nodiscard]] VkDeviceSize getDeviceMemoryOffset() const;
+    [[nodiscard]] void* getMappedData() const;
     [[nodiscard]] VkDeviceSize getSize() const;
 
     const VkDescriptorBufferInfo& getDescriptorBufferInfo() const;
@@ -26,7 +31,8 @@ private:
     VkDeviceSize size_ = 0;
     VkDevice device_ = VK_NULL_HANDLE;
     VkBuffer buffer_ = VK_NULL_HANDLE;
-    VkDeviceMemory deviceMemory_ = VK_NULL_HANDLE;
+    DeviceMemoryAllocation allocation_;
+    DeviceMemoryAllocatorPtr allocator_;
     VkDescriptorBufferInfo descriptorBufferInfo_{};
 };
 
@@ -34,9 +34,50 @@ void CommandBuffer::begin(VkCommandBufferUsageFlags usage) const
 
 // ---------------------------------------------------------------------------------------------------------------------
 
+void CommandBuffer::begin(
+    VkCommandBufferUsageFlags usage,
+    const VkCommandBufferInheritanceInfo& inheritanceInfo) const
+{
+    const VkCommandBufferBeginInfo beginInfo = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+        .flags = usage,
+        .pInheritanceInfo = &inheritanceInfo
+    };
+
+    ThrowIfFailed(vkBeginCommandBuffer(
+        commandBuffer,
+        &beginInfo));
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
 void CommandBuffer::beginRenderPass(const VkRenderPassBeginInfo& beginInfo) const
 {
-    vkCmdBeginRenderPass(commandBuffer, &beginInfo, VK_SUBPASS_CONTENTS_INLINE);
+    beginRenderPass(beginInfo, VK_SUBPASS_CONTENTS_INLINE);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void CommandBuffer::beginRenderPass(
+    const VkRenderPassBeginInfo& beginInfo,
+    VkSubpassContents contents) const
+{
+    vkCmdBeginRenderPass(commandBuffer, &beginInfo, contents);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void CommandBuffer::executeCommands(const vector<shared_ptr<CommandBuffer>>& commandBuffers) const
+{
+    const vector<VkCommandBuffer> commandBufferHandles = commandBuffers
+        | views::transform([](const shared_ptr<CommandBuffer>& commandBuffer)
+            { return commandBuffer->getHandle(); })
+        | to<vector>();
+
+    vkCmdExecuteCommands(
+        commandBuffer,
+        static_cast<uint32_t>(commandBufferHandles.size()),
+        commandBufferHandles.data());
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
@@ -67,6 +108,26 @@ void CommandBuffer::bindDescriptorSet(
 
 // ---------------------------------------------------------------------------------------------------------------------
 
+void CommandBuffer::bindDescriptorSet(
+    VkPipelineBindPoint bindPoint,
+    VkPipelineLayout layout,
+    uint32_t firstSet,
+    VkDescriptorSet descriptorSet,
+    uint32_t dynamicOffset) const
+{
+    vkCmdBindDescriptorSets(
+        commandBuffer,
+        bindPoint,
+        layout,
+        firstSet,
+        1,
+        &descriptorSet,
+        1,
+        &dynamicOffset);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
 void CommandBuffer::bindDescriptorSets(
     VkPipelineBindPoint bindPoint,
     VkPipelineLayout layout,
@@ -142,6 +203,21 @@ void CommandBuffer::drawIndexed(uint32_t indexCount, uint32_t firstIndex) const
 
 // ---------------------------------------------------------------------------------------------------------------------
 
+void CommandBuffer::drawIndexedIndirect(
+    const shared_ptr<Buffer>& buffer,
+    VkDeviceSize offset,
+    uint32_t drawCount) const
+{
+    vkCmdDrawIndexedIndirect(
+        commandBuffer,
+        buffer->getHandle(),
+        offset,
+        drawCount,
+        sizeof(VkDrawIndexedIndirectCommand));
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
 void CommandBuffer::endRenderPass() const
 {
     vkCmdEndRenderPass(commandBuffer);
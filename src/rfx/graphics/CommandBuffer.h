@@ -13,13 +13,26 @@ public:
 
     void begin() const;
     void begin(VkCommandBufferUsageFlags usage) const;
+    void begin(
+        VkCommandBufferUsageFlags usage,
+        const VkCommandBufferInheritanceInfo& inheritanceInfo) const;
     void beginRenderPass(const VkRenderPassBeginInfo& beginInfo) const;
+    void beginRenderPass(
+        const VkRenderPassBeginInfo& beginInfo,
+        VkSubpassContents contents) const;
+    void executeCommands(const std::vector<std::shared_ptr<CommandBuffer>>& commandBuffers) const;
     void bindPipeline(const VkPipelineBindPoint& bindPoint, VkPipeline pipeline) const;
     void bindDescriptorSet(
         VkPipelineBindPoint bindPoint,
         VkPipelineLayout layout,
         uint32_t firstSet,
         VkDescriptorSet descriptorSet) const;
+    void bindDescriptorSet(
+        VkPipelineBindPoint bindPoint,
+        VkPipelineLayout layout,
+        uint32_t firstSet,
+        VkDescriptorSet descriptorSet,
+        uint32_t dynamicOffset) const;
     void bindDescriptorSets(
         VkPipelineBindPoint bindPoint,
         VkPipelineLayout layout,
@@ -32,6 +45,10 @@ public:
     void draw(uint32_t vertexCount) const;
     void drawIndexed(uint32_t indexCount) const;
     void drawIndexed(uint32_t indexCount, uint32_t firstIndex) const;
+    void drawIndexedIndirect(
+        const std::shared_ptr<Buffer>& buffer,
+        VkDeviceSize offset,
+        uint32_t drawCount) const;
     void endRenderPass() const;
     void end() const;
 
@@ -0,0 +1,418 @@
+#include "rfx/pch.h"
+#include "rfx/graphics/DeviceMemoryAllocator.h"
+#include "rfx/common/Logger.h"
+
+#include <bit>
+
+
+using namespace rfx;
+using namespace std;
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+float DeviceMemoryStats::getInternalFragmentation() const
+{
+    return usedSlotBytes > 0
+        ? 1.0f - static_cast<float>(requestedBytes) / static_cast<float>(usedSlotBytes)
+        : 0.0f;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+float DeviceMemoryStats::getExternalFragmentation() const
+{
+    return blockBytes > 0
+        ? 1.0f - static_cast<float>(usedSlotBytes) / static_cast<float>(blockBytes)
+        : 0.0f;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+DeviceMemoryAllocator::DeviceMemoryAllocator(
+    VkDevice device,
+    const VkPhysicalDeviceMemoryProperties& memoryProperties)
+        : device(device),
+          memoryProperties(memoryProperties) {}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+DeviceMemoryAllocator::~DeviceMemoryAllocator()
+{
+    if (stats.subAllocationCount > 0 || stats.dedicatedAllocationCount > 0) {
+        RFX_LOG_WARNING << "Destroying device memory allocator with "
+                        << stats.subAllocationCount << " sub-allocation(s) and "
+                        << stats.dedicatedAllocationCount << " dedicated allocation(s) still alive";
+    }
+
+    for (const auto& pool : pools) {
+        for (const auto& block : pool.blocks) {
+            if (block.deviceMemory != VK_NULL_HANDLE) {
+                vkFreeMemory(device, block.deviceMemory, nullptr);
+            }
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+DeviceMemoryAllocation DeviceMemoryAllocator::allocate(
+    VkBuffer buffer,
+    VkMemoryPropertyFlags memoryProperties)
+{
+    const VkBufferMemoryRequirementsInfo2 requirementsInfo {
+        .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_REQUIREMENTS_INFO_2,
+        .buffer = buffer
+    };
+
+    VkMemoryDedicatedRequirements dedicatedRequirements {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_REQUIREMENTS
+    };
+
+    VkMemoryRequirements2 memoryRequirements {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2,
+        .pNext = &dedicatedRequirements
+    };
+
+    vkGetBufferMemoryRequirements2(device, &requirementsInfo, &memoryRequirements);
+
+    const VkMemoryDedicatedAllocateInfo dedicatedAllocateInfo {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_ALLOCATE_INFO,
+        .buffer = buffer
+    };
+
+    return allocate(
+        memoryRequirements.memoryRequirements,
+        memoryProperties,
+        true,
+        dedicatedRequirements.requiresDedicatedAllocation || dedicatedRequirements.prefersDedicatedAllocation,
+        dedicatedAllocateInfo);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+DeviceMemoryAllocation DeviceMemoryAllocator::allocate(
+    VkImage image,
+    VkImageTiling tiling,
+    VkMemoryPropertyFlags memoryProperties)
+{
+    const VkImageMemoryRequirementsInfo2 requirementsInfo {
+        .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_REQUIREMENTS_INFO_2,
+        .image = image
+    };
+
+    VkMemoryDedicatedRequirements dedicatedRequirements {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_REQUIREMENTS
+    };
+
+    VkMemoryRequirements2 memoryRequirements {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2,
+        .pNext = &dedicatedRequirements
+    };
+
+    vkGetImageMemoryRequirements2(device, &requirementsInfo, &memoryRequirements);
+
+    const VkMemoryDedicatedAllocateInfo dedicatedAllocateInfo {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_ALLOCATE_INFO,
+        .image = image
+    };
+
+    return allocate(
+        memoryRequirements.memoryRequirements,
+        memoryProperties,
+        tiling == VK_IMAGE_TILING_LINEAR,
+        dedicatedRequirements.requiresDedicatedAllocation || dedicatedRequirements.prefersDedicatedAllocation,
+        dedicatedAllocateInfo);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+DeviceMemoryAllocation DeviceMemoryAllocator::allocate(
+    const VkMemoryRequirements& memoryRequirements,
+    VkMemoryPropertyFlags memoryProperties,
+    bool linear,
+    bool dedicated,
+    const VkMemoryDedicatedAllocateInfo& dedicatedAllocateInfo)
+{
+    const uint32_t memoryTypeIndex = getMemoryType(memoryRequirements.memoryTypeBits, memoryProperties);
+    const VkDeviceSize slotSize = getSlotSize(memoryRequirements);
+
+    lock_guard<mutex> lock(allocationMutex);
+
+    if (dedicated || slotSize > MAX_SLOT_SIZE || !subAllocationEnabled) {
+        return allocateDedicated(memoryRequirements.size, memoryTypeIndex, dedicatedAllocateInfo);
+    }
+
+    return allocateFromPool(getPoolIndex(memoryTypeIndex, linear, slotSize), memoryRequirements.size);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+uint32_t DeviceMemoryAllocator::getMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) const
+{
+    for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; ++i) {
+        if ((typeFilter & (1 << i))
+                && (memoryProperties.memoryTypes[i].propertyFlags & properties) == properties) {
+            return i;
+        }
+    }
+
+    RFX_THROW("Failed to find suitable memory type");
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+VkDeviceSize DeviceMemoryAllocator::getSlotSize(const VkMemoryRequirements& memoryRequirements)
+{
+    return max({
+        bit_ceil(memoryRequirements.size),
+        bit_ceil(memoryRequirements.alignment),
+        MIN_SLOT_SIZE
+    });
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+uint32_t DeviceMemoryAllocator::getPoolIndex(uint32_t memoryTypeIndex, bool linear, VkDeviceSize slotSize)
+{
+    for (uint32_t i = 0; i < pools.size(); ++i) {
+        const Pool& pool = pools[i];
+        if (pool.memoryTypeIndex == memoryTypeIndex && pool.linear == linear && pool.slotSize == slotSize) {
+            return i;
+        }
+    }
+
+    pools.push_back({
+        .memoryTypeIndex = memoryTypeIndex,
+        .linear = linear,
+        .slotSize = slotSize,
+        .slotsPerBlock = static_cast<uint32_t>(min<VkDeviceSize>(MAX_SLOTS_PER_BLOCK, MAX_BLOCK_SIZE / slotSize))
+    });
+
+    return static_cast<uint32_t>(pools.size() - 1);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+DeviceMemoryAllocation DeviceMemoryAllocator::allocateDedicated(
+    VkDeviceSize size,
+    uint32_t memoryTypeIndex,
+    const VkMemoryDedicatedAllocateInfo& dedicatedAllocateInfo)
+{
+    DeviceMemoryAllocation allocation {
+        .size = size,
+        .memoryTypeIndex = memoryTypeIndex
+    };
+
+    allocation.deviceMemory = allocateDeviceMemory(
+        size,
+        memoryTypeIndex,
+        &dedicatedAllocateInfo,
+        &allocation.mappedData);
+
+    stats.dedicatedAllocationCount++;
+    stats.dedicatedBytes += size;
+
+    return allocation;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+DeviceMemoryAllocation DeviceMemoryAllocator::allocateFromPool(uint32_t poolIndex, VkDeviceSize requestedSize)
+{
+    Pool& pool = pools[poolIndex];
+
+    auto it = ranges::find_if(pool.blocks, [](const Block& block) {
+        return block.deviceMemory != VK_NULL_HANDLE && !block.freeSlots.empty();
+    });
+    if (it == pool.blocks.end()) {
+        createBlock(pool);
+        it = ranges::find_if(pool.blocks, [](const Block& block) {
+            return block.deviceMemory != VK_NULL_HANDLE && !block.freeSlots.empty();
+        });
+    }
+
+    Block& block = *it;
+    const uint32_t slotIndex = block.freeSlots.back();
+    block.freeSlots.pop_back();
+    block.requestedSizes[slotIndex] = requestedSize;
+
+    const VkDeviceSize offset = slotIndex * pool.slotSize;
+
+    stats.subAllocationCount++;
+    stats.totalSubAllocations++;
+    stats.usedSlotBytes += pool.slotSize;
+    stats.requestedBytes += requestedSize;
+
+    return {
+        .deviceMemory = block.deviceMemory,
+        .offset = offset,
+        .size = requestedSize,
+        .mappedData = block.mappedData != nullptr ? static_cast<uint8_t*>(block.mappedData) + offset : nullptr,
+        .memoryTypeIndex = pool.memoryTypeIndex,
+        .poolIndex = poolIndex,
+        .blockIndex = static_cast<uint32_t>(distance(pool.blocks.begin(), it)),
+        .slotIndex = slotIndex
+    };
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void DeviceMemoryAllocator::createBlock(Pool& pool)
+{
+    Block block;
+    block.deviceMemory = allocateDeviceMemory(
+        pool.slotSize * pool.slotsPerBlock,
+        pool.memoryTypeIndex,
+        nullptr,
+        &block.mappedData);
+    block.requestedSizes.resize(pool.slotsPerBlock, 0);
+    block.freeSlots.resize(pool.slotsPerBlock);
+    // hand out low offsets first
+    for (uint32_t i = 0; i < pool.slotsPerBlock; ++i) {
+        block.freeSlots[i] = pool.slotsPerBlock - 1 - i;
+    }
+
+    stats.blockCount++;
+    stats.blockBytes += pool.slotSize * pool.slotsPerBlock;
+
+    // reuse the index of a previously released block, so indices of live allocations stay valid
+    auto it = ranges::find(pool.blocks, VK_NULL_HANDLE, &Block::deviceMemory);
+    if (it != pool.blocks.end()) {
+        *it = move(block);
+    }
+    else {
+        pool.blocks.push_back(move(block));
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+VkDeviceMemory DeviceMemoryAllocator::allocateDeviceMemory(
+    VkDeviceSize size,
+    uint32_t memoryTypeIndex,
+    const void* next,
+    void** outMappedData)
+{
+    const VkMemoryAllocateInfo allocInfo {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+        .pNext = next,
+        .allocationSize = size,
+        .memoryTypeIndex = memoryTypeIndex
+    };
+
+    VkDeviceMemory deviceMemory = VK_NULL_HANDLE;
+    ThrowIfFailed(vkAllocateMemory(
+        device,
+        &allocInfo,
+        nullptr,
+        &deviceMemory));
+
+    *outMappedData = nullptr;
+    if (memoryProperties.memoryTypes[memoryTypeIndex].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
+        ThrowIfFailed(vkMapMemory(
+            device,
+            deviceMemory,
+            0,
+            VK_WHOLE_SIZE,
+            0,
+            outMappedData));
+    }
+
+    stats.deviceMemoryCount++;
+    stats.totalDeviceMemoryAllocations++;
+
+    return deviceMemory;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void DeviceMemoryAllocator::free(const DeviceMemoryAllocation& allocation)
+{
+    if (allocation.deviceMemory == VK_NULL_HANDLE) {
+        return;
+    }
+
+    lock_guard<mutex> lock(allocationMutex);
+
+    if (allocation.isDedicated()) {
+        freeDeviceMemory(allocation.deviceMemory);
+        stats.dedicatedAllocationCount--;
+        stats.dedicatedBytes -= allocation.size;
+        return;
+    }
+
+    RFX_CHECK_ARGUMENT(allocation.poolIndex < pools.size());
+    Pool& pool = pools[allocation.poolIndex];
+    RFX_CHECK_ARGUMENT(allocation.blockIndex < pool.blocks.size());
+    Block& block = pool.blocks[allocation.blockIndex];
+    RFX_CHECK_ARGUMENT(block.deviceMemory == allocation.deviceMemory);
+
+    block.freeSlots.push_back(allocation.slotIndex);
+    stats.subAllocationCount--;
+    stats.usedSlotBytes -= pool.slotSize;
+    stats.requestedBytes -= block.requestedSizes[allocation.slotIndex];
+    block.requestedSizes[allocation.slotIndex] = 0;
+
+    // keep one empty block per pool around to avoid thrashing on alloc/free sequences
+    if (block.freeSlots.size() == pool.slotsPerBlock) {
+        const bool hasOtherFreeBlock = ranges::any_of(pool.blocks, [&](const Block& other) {
+            return &other != &block
+                && other.deviceMemory != VK_NULL_HANDLE
+                && other.freeSlots.size() == pool.slotsPerBlock;
+        });
+        if (hasOtherFreeBlock) {
+            freeDeviceMemory(block.deviceMemory);
+            block = {};
+            stats.blockCount--;
+            stats.blockBytes -= pool.slotSize * pool.slotsPerBlock;
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void DeviceMemoryAllocator::freeDeviceMemory(VkDeviceMemory deviceMemory)
+{
+    vkFreeMemory(device, deviceMemory, nullptr);
+    stats.deviceMemoryCount--;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void DeviceMemoryAllocator::setSubAllocationEnabled(bool enabled)
+{
+    lock_guard<mutex> lock(allocationMutex);
+
+    subAllocationEnabled = enabled;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+DeviceMemoryStats DeviceMemoryAllocator::getStats() const
+{
+    lock_guard<mutex> lock(allocationMutex);
+
+    return stats;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void DeviceMemoryAllocator::logStats() const
+{
+    const DeviceMemoryStats currentStats = getStats();
+
+    RFX_LOG_INFO << "Device memory: "
+                 << currentStats.deviceMemoryCount << " allocation(s) ("
+                 << currentStats.blockCount << " block(s), "
+                 << currentStats.dedicatedAllocationCount << " dedicated) serving "
+                 << currentStats.subAllocationCount << " sub-allocation(s)";
+    RFX_LOG_INFO << "Device memory: "
+                 << currentStats.blockBytes / 1024 << " KiB in blocks, "
+                 << currentStats.usedSlotBytes / 1024 << " KiB used, "
+                 << currentStats.dedicatedBytes / 1024 << " KiB dedicated, "
+                 << fmt::format("internal fragmentation: {:.1f}%, external fragmentation: {:.1f}%",
+                        currentStats.getInternalFragmentation() * 100.0f,
+                        currentStats.getExternalFragmentation() * 100.0f);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
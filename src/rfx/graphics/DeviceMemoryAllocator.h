@@ -0,0 +1,146 @@
+#pragma once
+
+#include <mutex>
+
+namespace rfx {
+
+struct DeviceMemoryAllocation
+{
+    VkDeviceMemory deviceMemory = VK_NULL_HANDLE;
+    VkDeviceSize offset = 0;
+    VkDeviceSize size = 0;
+    void* mappedData = nullptr;
+    uint32_t memoryTypeIndex = UINT32_MAX;
+    uint32_t poolIndex = UINT32_MAX;    // UINT32_MAX for dedicated allocations
+    uint32_t blockIndex = UINT32_MAX;
+    uint32_t slotIndex = UINT32_MAX;
+
+    [[nodiscard]] bool isDedicated() const { return poolIndex == UINT32_MAX; }
+};
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+struct DeviceMemoryStats
+{
+    uint32_t deviceMemoryCount = 0;         // live vkAllocateMemory() allocations (blocks + dedicated)
+    uint32_t blockCount = 0;
+    uint32_t dedicatedAllocationCount = 0;
+    uint32_t subAllocationCount = 0;
+    uint64_t totalDeviceMemoryAllocations = 0;  // vkAllocateMemory() calls since creation
+    uint64_t totalSubAllocations = 0;
+    VkDeviceSize blockBytes = 0;            // bytes reserved by pool blocks
+    VkDeviceSize usedSlotBytes = 0;         // bytes of handed out slots
+    VkDeviceSize requestedBytes = 0;        // bytes requested by sub-allocated resources
+    VkDeviceSize dedicatedBytes = 0;
+
+    // share of handed out slot bytes not covered by resource requirements (size class rounding)
+    [[nodiscard]] float getInternalFragmentation() const;
+
+    // share of block bytes that are currently free
+    [[nodiscard]] float getExternalFragmentation() const;
+};
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  Sub-allocates resources from large VkDeviceMemory blocks instead of calling vkAllocateMemory() per resource.
+ *
+ *  Each pool serves a single (memory type, resource tiling, size class) combination. Size classes are powers of two,
+ *  so slot offsets automatically satisfy the alignment requirements of the resources placed into them. Linear and
+ *  optimal tiled resources never share a block, which keeps bufferImageGranularity out of the picture.
+ *  Requests above MAX_SLOT_SIZE and resources that prefer/require a dedicated allocation get their own memory.
+ *
+ *  Host visible blocks are persistently mapped.
+ */
+class DeviceMemoryAllocator
+{
+public:
+    static constexpr VkDeviceSize MIN_SLOT_SIZE = 256;
+    static constexpr VkDeviceSize MAX_SLOT_SIZE = 4 * 1024 * 1024;
+    static constexpr VkDeviceSize MAX_BLOCK_SIZE = 16 * 1024 * 1024;
+    static constexpr uint32_t MAX_SLOTS_PER_BLOCK = 4096;
+
+    DeviceMemoryAllocator(
+        VkDevice device,
+        const VkPhysicalDeviceMemoryProperties& memoryProperties);
+
+    ~DeviceMemoryAllocator();
+
+    [[nodiscard]]
+    DeviceMemoryAllocation allocate(
+        VkBuffer buffer,
+        VkMemoryPropertyFlags memoryProperties);
+
+    [[nodiscard]]
+    DeviceMemoryAllocation allocate(
+        VkImage image,
+        VkImageTiling tiling,
+        VkMemoryPropertyFlags memoryProperties);
+
+    void free(const DeviceMemoryAllocation& allocation);
+
+    // disabled, every allocation gets its own memory like a dedicated allocation; to measure the gain of pooling
+    void setSubAllocationEnabled(bool enabled);
+
+    [[nodiscard]] DeviceMemoryStats getStats() const;
+    void logStats() const;
+
+private:
+    struct Block
+    {
+        VkDeviceMemory deviceMemory = VK_NULL_HANDLE;
+        void* mappedData = nullptr;
+        std::vector<uint32_t> freeSlots;
+        std::vector<VkDeviceSize> requestedSizes;
+    };
+
+    struct Pool
+    {
+        uint32_t memoryTypeIndex = 0;
+        bool linear = true;
+        VkDeviceSize slotSize = 0;
+        uint32_t slotsPerBlock = 0;
+        std::vector<Block> blocks;
+    };
+
+    [[nodiscard]] uint32_t getMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) const;
+    [[nodiscard]] static VkDeviceSize getSlotSize(const VkMemoryRequirements& memoryRequirements);
+    [[nodiscard]] uint32_t getPoolIndex(uint32_t memoryTypeIndex, bool linear, VkDeviceSize slotSize);
+
+    [[nodiscard]]
+    DeviceMemoryAllocation allocate(
+        const VkMemoryRequirements& memoryRequirements,
+        VkMemoryPropertyFlags memoryProperties,
+        bool linear,
+        bool dedicated,
+        const VkMemoryDedicatedAllocateInfo& dedicatedAllocateInfo);
+
+    [[nodiscard]]
+    DeviceMemoryAllocation allocateDedicated(
+        VkDeviceSize size,
+        uint32_t memoryTypeIndex,
+        const VkMemoryDedicatedAllocateInfo& dedicatedAllocateInfo);
+
+    [[nodiscard]] DeviceMemoryAllocation allocateFromPool(uint32_t poolIndex, VkDeviceSize requestedSize);
+    void createBlock(Pool& pool);
+
+    [[nodiscard]]
+    VkDeviceMemory allocateDeviceMemory(
+        VkDeviceSize size,
+        uint32_t memoryTypeIndex,
+        const void* next,
+        void** outMappedData);
+
+    void freeDeviceMemory(VkDeviceMemory deviceMemory);
+
+    VkDevice device = VK_NULL_HANDLE;
+    VkPhysicalDeviceMemoryProperties memoryProperties {};
+    std::vector<Pool> pools;
+    DeviceMemoryStats stats;
+    bool subAllocationEnabled = true;
+    mutable std::mutex allocationMutex;
+};
+
+using DeviceMemoryAllocatorPtr = std::shared_ptr<DeviceMemoryAllocator>;
+
+} // namespace rfx
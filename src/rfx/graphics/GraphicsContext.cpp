@@ -299,6 +299,23 @@ void GraphicsContext::queryProperties(VkPhysicalDevice physicalDevice, GraphicsD
     else if (counts & VK_SAMPLE_COUNT_8_BIT)  { deviceDesc->maxSampleCount = VK_SAMPLE_COUNT_8_BIT; }
     else if (counts & VK_SAMPLE_COUNT_4_BIT)  { deviceDesc->maxSampleCount = VK_SAMPLE_COUNT_4_BIT; }
     else if (counts & VK_SAMPLE_COUNT_2_BIT)  { deviceDesc->maxSampleCount = VK_SAMPLE_COUNT_2_BIT; }
+
+    deviceDesc->subgroupProperties = {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SUBGROUP_PROPERTIES
+    };
+
+    // devices below 1.2 are rejected anyway, see isMatching()
+    if (deviceDesc->properties.apiVersion < VK_API_VERSION_1_2) {
+        return;
+    }
+
+    VkPhysicalDeviceProperties2 properties {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
+        .pNext = &deviceDesc->subgroupProperties
+    };
+    vkGetPhysicalDeviceProperties2(physicalDevice, &properties);
+
+    deviceDesc->subgroupProperties.pNext = nullptr;
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
@@ -306,6 +323,23 @@ void GraphicsContext::queryProperties(VkPhysicalDevice physicalDevice, GraphicsD
 void GraphicsContext::queryFeatures(VkPhysicalDevice physicalDevice, GraphicsDeviceDesc* deviceDesc)
 {
     vkGetPhysicalDeviceFeatures(physicalDevice, &deviceDesc->features);
+
+    deviceDesc->descriptorIndexingFeatures = {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES
+    };
+
+    // devices below 1.2 are rejected anyway, see isMatching()
+    if (deviceDesc->properties.apiVersion < VK_API_VERSION_1_2) {
+        return;
+    }
+
+    VkPhysicalDeviceFeatures2 features {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+        .pNext = &deviceDesc->descriptorIndexingFeatures
+    };
+    vkGetPhysicalDeviceFeatures2(physicalDevice, &features);
+
+    deviceDesc->descriptorIndexingFeatures.pNext = nullptr;
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
@@ -416,14 +450,22 @@ bool GraphicsContext::isPresentationSupported(VkPhysicalDevice physicalDevice, u
 shared_ptr<GraphicsDevice> GraphicsContext::createGraphicsDevice(
     const VkPhysicalDeviceFeatures& features,
     const vector<string>& extensions,
-    const vector<VkQueueFlagBits>& queueCapabilities)
+    const vector<VkQueueFlagBits>& queueCapabilities,
+    const vector<string>& optionalExtensions)
 {
     VkPhysicalDevice physicalDevice =
         findFirstMatchingPhysicalDevice(features, extensions, queueCapabilities);
 
     RFX_CHECK_STATE(physicalDevice != nullptr, "No suitable device available");
 
-    return createLogicalDevice(physicalDevice, features, extensions, queueCapabilities);
+    vector<string> enabledExtensions = extensions;
+    for (const auto& optionalExtension : optionalExtensions) {
+        if (hasRequiredExtensions(deviceDescs.at(physicalDevice), { optionalExtension })) {
+            enabledExtensions.push_back(optionalExtension);
+        }
+    }
+
+    return createLogicalDevice(physicalDevice, features, enabledExtensions, queueCapabilities);
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
@@ -676,13 +718,23 @@ shared_ptr<GraphicsDevice> GraphicsContext::createLogicalDevice(
     ranges::transform(extensions, back_inserter(extensionsAsChars),
         [](const string& name) -> const char* { return name.c_str(); });
 
+    // the features needed for indirect drawing are enabled whenever both of them are supported
+    const VkPhysicalDeviceFeatures& supportedFeatures = deviceDescs.at(physicalDevice).features;
+    const VkBool32 indirectDrawingSupported =
+        supportedFeatures.multiDrawIndirect
+        && supportedFeatures.drawIndirectFirstInstance;
+
+    VkPhysicalDeviceFeatures enabledFeatures = features;
+    enabledFeatures.multiDrawIndirect |= indirectDrawingSupported;
+    enabledFeatures.drawIndirectFirstInstance |= indirectDrawingSupported;
+
     VkDeviceCreateInfo deviceCreateInfo {
         .sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
         .queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size()),
         .pQueueCreateInfos = queueCreateInfos.data(),
         .enabledExtensionCount = static_cast<uint32_t>(extensionsAsChars.size()),
         .ppEnabledExtensionNames = extensionsAsChars.data(),
-        .pEnabledFeatures = &features
+        .pEnabledFeatures = &enabledFeatures
     };
 
     VkDeviceGroupDeviceCreateInfoKHR deviceGroupInfo = {
@@ -699,6 +751,33 @@ shared_ptr<GraphicsDevice> GraphicsContext::createLogicalDevice(
         }
     }
 
+    const auto& it = deviceDescs.find(physicalDevice);
+    RFX_CHECK_STATE(it != deviceDescs.end(), "Internal error");
+    GraphicsDeviceDesc deviceDesc = it->second;
+    deviceDesc.features = enabledFeatures;
+    deviceDesc.enabledExtensions = extensions;
+
+    // the descriptor indexing features needed for bindless textures are enabled whenever all of them are supported
+    const VkPhysicalDeviceDescriptorIndexingFeatures& supportedIndexingFeatures = deviceDesc.descriptorIndexingFeatures;
+    const VkBool32 bindlessSupported =
+        supportedIndexingFeatures.runtimeDescriptorArray
+        && supportedIndexingFeatures.shaderSampledImageArrayNonUniformIndexing
+        && supportedIndexingFeatures.descriptorBindingPartiallyBound
+        && supportedIndexingFeatures.descriptorBindingVariableDescriptorCount;
+
+    VkPhysicalDeviceDescriptorIndexingFeatures descriptorIndexingFeatures {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES,
+        .pNext = const_cast<void*>(deviceCreateInfo.pNext),
+        .shaderSampledImageArrayNonUniformIndexing = bindlessSupported,
+        .descriptorBindingPartiallyBound = bindlessSupported,
+        .descriptorBindingVariableDescriptorCount = bindlessSupported,
+        .runtimeDescriptorArray = bindlessSupported
+    };
+    deviceCreateInfo.pNext = &descriptorIndexingFeatures;
+
+    deviceDesc.descriptorIndexingFeatures = descriptorIndexingFeatures;
+    deviceDesc.descriptorIndexingFeatures.pNext = nullptr;
+
     VkDevice logicalDevice = VK_NULL_HANDLE;
     ThrowIfFailed(vkCreateDevice(
         physicalDevice,
@@ -721,11 +800,8 @@ shared_ptr<GraphicsDevice> GraphicsContext::createLogicalDevice(
     RFX_CHECK_STATE(vkQueue != VK_NULL_HANDLE, "Failed to get compute queue");
     const auto computeQueue = make_shared<Queue>(vkQueue, computeQueueFamilyIndex, logicalDevice);
 
-    const auto& it = deviceDescs.find(physicalDevice);
-    RFX_CHECK_STATE(it != deviceDescs.end(), "Internal error");
-    const GraphicsDeviceDesc& deviceDesc = it->second;
     GraphicsDevicePtr graphicsDevice = make_shared<GraphicsDevice>(
-        deviceDesc,
+        move(deviceDesc),
         physicalDevice,
         logicalDevice,
         selectedQueueFamilyIndices,
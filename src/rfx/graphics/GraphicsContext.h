@@ -21,7 +21,8 @@ public:
     std::shared_ptr<GraphicsDevice> createGraphicsDevice(
         const VkPhysicalDeviceFeatures& features,
         const std::vector<std::string>& extensions,
-        const std::vector<VkQueueFlagBits>& queueCapabilities);
+        const std::vector<VkQueueFlagBits>& queueCapabilities,
+        const std::vector<std::string>& optionalExtensions = {});
 
 private:
     static void dumpExtensions();
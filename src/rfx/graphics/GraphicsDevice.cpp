@@ -1,5 +1,6 @@
 #include "rfx/pch.h"
 #include "rfx/graphics/GraphicsDevice.h"
+#include "rfx/graphics/IndexUtil.h"
 #include "rfx/common/to.h"
 #include "rfx/common/Logger.h"
 
@@ -21,6 +22,7 @@ GraphicsDevice::GraphicsDevice(
         : desc_(move(desc)),
           physicalDevice(physicalDevice),
           device(logicalDevice),
+          memoryAllocator(make_shared<DeviceMemoryAllocator>(logicalDevice, desc_.memoryProperties)),
           usedQueueFamilyIndices(move(usedQueueFamilyIndices)),
           graphicsQueue(move(graphicsQueue)),
           presentationQueue(move(presentQueue)),
@@ -29,6 +31,33 @@ GraphicsDevice::GraphicsDevice(
 {
     createGraphicsCommandPool();
     createComputeCommandPool();
+    createUploadQueue();
+
+    pipelineCache = make_shared<PipelineCache>(device, desc_.properties);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void GraphicsDevice::createUploadQueue()
+{
+    uploadQueue = make_shared<UploadQueue>(
+        device,
+        graphicsQueue,
+        createStagingBuffer(UploadQueue::DEFAULT_STAGING_BUFFER_SIZE),
+        [this](VkDeviceSize size) { return createStagingBuffer(size); });
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BufferPtr GraphicsDevice::createStagingBuffer(VkDeviceSize size) const
+{
+    BufferPtr stagingBuffer = createBuffer(
+        size,
+        VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    bind(stagingBuffer);
+
+    return stagingBuffer;
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
@@ -73,8 +102,17 @@ GraphicsDevice::~GraphicsDevice()
     destroyDepthBuffer();
     destroySwapChain();
 
+    uploadQueue.reset();
+
+    pipelineCache->logStats();
+    pipelineCache.reset();
+
     vkDestroyCommandPool(device, graphicsCommandPool, nullptr);
     vkDestroyCommandPool(device, computeCommandPool, nullptr);
+
+    logMemoryStats();
+    memoryAllocator.reset();
+
     vkDestroyDevice(device, nullptr);
 }
 
@@ -508,13 +546,34 @@ void GraphicsDevice::waitIdle() const
 
 // ---------------------------------------------------------------------------------------------------------------------
 
+DeviceMemoryStats GraphicsDevice::getMemoryStats() const
+{
+    return memoryAllocator->getStats();
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void GraphicsDevice::logMemoryStats() const
+{
+    memoryAllocator->logStats();
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void GraphicsDevice::setMemorySubAllocationEnabled(bool enabled)
+{
+    memoryAllocator->setSubAllocationEnabled(enabled);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
 shared_ptr<Buffer> GraphicsDevice::createBuffer(
     VkDeviceSize size,
     VkBufferUsageFlags usage,
     VkMemoryPropertyFlags memoryProperties) const
 {
     VkBuffer vkBuffer = VK_NULL_HANDLE;
-    VkDeviceMemory vkDeviceMemory = VK_NULL_HANDLE;
+    DeviceMemoryAllocation allocation;
 
     createBufferInternal(
         size,
@@ -522,13 +581,14 @@ shared_ptr<Buffer> GraphicsDevice::createBuffer(
         memoryProperties,
         false,
         vkBuffer,
-        vkDeviceMemory);
+        allocation);
 
     return make_shared<Buffer>(
         size,
         device,
         vkBuffer,
-        vkDeviceMemory);
+        allocation,
+        memoryAllocator);
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
@@ -539,7 +599,7 @@ void GraphicsDevice::createBufferInternal(
     VkMemoryPropertyFlags memoryProperties,
     bool shared,
     VkBuffer& outBuffer,
-    VkDeviceMemory& outDeviceMemory) const
+    DeviceMemoryAllocation& outAllocation) const
 {
     VkSharingMode sharingMode = VK_SHARING_MODE_EXCLUSIVE;
     uint32_t queueFamilyIndexCount = 0;
@@ -570,20 +630,7 @@ void GraphicsDevice::createBufferInternal(
         nullptr,
         &outBuffer));
 
-    VkMemoryRequirements memoryRequirements {};
-    vkGetBufferMemoryRequirements(device, outBuffer, &memoryRequirements);
-
-    VkMemoryAllocateInfo allocInfo = {
-        .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-        .allocationSize = memoryRequirements.size,
-        .memoryTypeIndex = getMemoryType(memoryRequirements.memoryTypeBits, memoryProperties)
-    };
-
-    ThrowIfFailed(vkAllocateMemory(
-        device,
-        &allocInfo,
-        nullptr,
-        &outDeviceMemory));
+    outAllocation = memoryAllocator->allocate(outBuffer, memoryProperties);
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
@@ -594,7 +641,7 @@ BufferPtr GraphicsDevice::createSharedBuffer(
     VkMemoryPropertyFlags memoryProperties) const
 {
     VkBuffer vkBuffer = VK_NULL_HANDLE;
-    VkDeviceMemory vkDeviceMemory = VK_NULL_HANDLE;
+    DeviceMemoryAllocation allocation;
 
     createBufferInternal(
         size,
@@ -602,29 +649,14 @@ BufferPtr GraphicsDevice::createSharedBuffer(
         memoryProperties,
         true,
         vkBuffer,
-        vkDeviceMemory);
+        allocation);
 
     return make_shared<Buffer>(
         size,
         device,
         vkBuffer,
-        vkDeviceMemory);
-}
-
-// ---------------------------------------------------------------------------------------------------------------------
-
-uint32_t GraphicsDevice::getMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) const
-{
-    VkPhysicalDeviceMemoryProperties memoryProperties;
-    vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memoryProperties);
-
-    for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; i++) {
-        if ((typeFilter & (1 << i)) && (memoryProperties.memoryTypes[i].propertyFlags & properties) == properties) {
-            return i;
-        }
-    }
-
-    RFX_THROW("Failed to find suitable memory type");
+        allocation,
+        memoryAllocator);
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
@@ -632,7 +664,7 @@ uint32_t GraphicsDevice::getMemoryType(uint32_t typeFilter, VkMemoryPropertyFlag
 shared_ptr<VertexBuffer> GraphicsDevice::createVertexBuffer(uint32_t vertexCount, const VertexFormat& vertexFormat) const
 {
     VkBuffer vkBuffer = VK_NULL_HANDLE;
-    VkDeviceMemory vkDeviceMemory = VK_NULL_HANDLE;
+    DeviceMemoryAllocation allocation;
     const VkDeviceSize bufferSize = vertexCount * vertexFormat.getVertexSize();
 
     createBufferInternal(
@@ -641,38 +673,25 @@ shared_ptr<VertexBuffer> GraphicsDevice::createVertexBuffer(uint32_t vertexCount
         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
         false,
         vkBuffer,
-        vkDeviceMemory);
+        allocation);
 
     return make_shared<VertexBuffer>(
         vertexCount,
         vertexFormat,
         device,
         vkBuffer,
-        vkDeviceMemory);
+        allocation,
+        memoryAllocator);
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
 
 shared_ptr<IndexBuffer> GraphicsDevice::createIndexBuffer(uint32_t indexCount, VkIndexType indexType)
 {
-    VkDeviceSize bufferSize = 0;
-
-    switch (indexType) {
-        case VK_INDEX_TYPE_UINT16:
-            bufferSize = indexCount * sizeof(uint16_t);
-            break;
-        case VK_INDEX_TYPE_UINT32:
-            bufferSize = indexCount * sizeof(uint32_t);
-            break;
-        case VK_INDEX_TYPE_UINT8_EXT:
-            bufferSize = indexCount;
-            break;
-        default:
-            RFX_CHECK_ARGUMENT(false);
-    }
+    const VkDeviceSize bufferSize = VkDeviceSize { indexCount } * IndexUtil::getIndexSize(indexType);
 
     VkBuffer vkBuffer = VK_NULL_HANDLE;
-    VkDeviceMemory vkDeviceMemory = VK_NULL_HANDLE;
+    DeviceMemoryAllocation allocation;
 
     createBufferInternal(
         bufferSize,
@@ -680,7 +699,7 @@ shared_ptr<IndexBuffer> GraphicsDevice::createIndexBuffer(uint32_t indexCount, V
         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
         false,
         vkBuffer,
-        vkDeviceMemory);
+        allocation);
 
     return make_shared<IndexBuffer>(
         indexCount,
@@ -688,7 +707,8 @@ shared_ptr<IndexBuffer> GraphicsDevice::createIndexBuffer(uint32_t indexCount, V
         bufferSize,
         device,
         vkBuffer,
-        vkDeviceMemory);
+        allocation,
+        memoryAllocator);
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
@@ -699,26 +719,24 @@ void GraphicsDevice::bind(const shared_ptr<Buffer>& buffer) const
         device,
         buffer->getHandle(),
         buffer->getDeviceMemory(),
-        0));
+        buffer->getDeviceMemoryOffset()));
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
 
 void GraphicsDevice::map(const shared_ptr<Buffer>& buffer, void** data) const
 {
-    ThrowIfFailed(vkMapMemory(device,
-        buffer->getDeviceMemory(),
-        0,
-        buffer->getSize(),
-        0,
-        data));
+    // host visible memory is persistently mapped by the allocator
+    RFX_CHECK_STATE(buffer->getMappedData() != nullptr, "Buffer memory is not host visible");
+
+    *data = buffer->getMappedData();
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
 
 void GraphicsDevice::unmap(const shared_ptr<Buffer>& buffer) const
 {
-    vkUnmapMemory(device, buffer->getDeviceMemory());
+    RFX_CHECK_STATE(buffer->getMappedData() != nullptr, "Buffer memory is not host visible");
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
@@ -730,12 +748,15 @@ shared_ptr<CommandBuffer> GraphicsDevice::createCommandBuffer(VkCommandPool comm
 
 // ---------------------------------------------------------------------------------------------------------------------
 
-vector<shared_ptr<CommandBuffer>> GraphicsDevice::createCommandBuffers(VkCommandPool commandPool, uint32_t count) const
+vector<shared_ptr<CommandBuffer>> GraphicsDevice::createCommandBuffers(
+    VkCommandPool commandPool,
+    uint32_t count,
+    VkCommandBufferLevel level) const
 {
     VkCommandBufferAllocateInfo allocInfo = {
         .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
         .commandPool = commandPool,
-        .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+        .level = level,
         .commandBufferCount = count
     };
 
@@ -830,32 +851,32 @@ shared_ptr<Image> GraphicsDevice::createImage(
             static_cast<uint32_t>(floor(log2(max(imageDesc.width, imageDesc.height)))) + 1;
     }
 
+    const MipmapGeneratorPtr& mipmapGenerator = uploadQueue->getMipmapGenerator();
+    const bool isComputeMipmaps =
+        isGenerateMipmaps && mipmapGenerator && mipmapGenerator->isSupported(targetImageDesc.format);
+
     ImagePtr image = createImage(
         id,
         targetImageDesc,
-        VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+        VK_IMAGE_USAGE_SAMPLED_BIT
+            | VK_IMAGE_USAGE_TRANSFER_SRC_BIT
+            | (isComputeMipmaps ? MipmapGenerator::getImageUsage() : 0),
         VK_IMAGE_TILING_OPTIMAL,
-        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+        isComputeMipmaps ? MipmapGenerator::getImageCreateFlags(targetImageDesc.format) : 0);
 
-    if (isGenerateMipmaps) {
-        transitionImageLayout(
-            image,
-            targetImageDesc,
-            VK_IMAGE_LAYOUT_UNDEFINED,
-            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+    if (isGenerateMipmaps && !isComputeMipmaps) {
+        VkFormatProperties formatProperties;
+        vkGetPhysicalDeviceFormatProperties(physicalDevice, targetImageDesc.format, &formatProperties);
+        RFX_CHECK_STATE(formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT,
+            "Texture image format does not support linear blitting");
     }
 
-    updateImage(image, imageData, isGenerateMipmaps);
-
-    if (isGenerateMipmaps) {
-        generateMipmaps(
-            image,
-            targetImageDesc,
-            VK_FORMAT_R8G8B8A8_SRGB);
+    uploadQueue->uploadImage(image, imageData.data(), imageData.size(), isGenerateMipmaps);
+    if (!uploadQueue->isBatching()) {
+        uploadQueue->flush();
     }
 
-    image->setDesc(targetImageDesc);
-
     return image;
 }
 
@@ -866,12 +887,13 @@ shared_ptr<Image> GraphicsDevice::createImage(
     const ImageDesc& imageDesc,
     VkImageUsageFlags usage,
     VkImageTiling tiling,
-    VkMemoryPropertyFlags properties) const
+    VkMemoryPropertyFlags properties,
+    VkImageCreateFlags flags) const
 {
     VkImageCreateInfo imageCreateInfo = {
         .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
         .pNext = nullptr,
-        .flags = static_cast<VkImageCreateFlags>(imageDesc.isCubemap ? VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT : 0),
+        .flags = flags | (imageDesc.isCubemap ? VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT : 0),
         .imageType = VK_IMAGE_TYPE_2D,
         .format = imageDesc.format,
         .extent = { imageDesc.width, imageDesc.height, 1 },
@@ -893,253 +915,21 @@ shared_ptr<Image> GraphicsDevice::createImage(
         nullptr,
         &image));
 
-    VkMemoryRequirements memoryRequirements = {};
-    vkGetImageMemoryRequirements(device, image, &memoryRequirements);
-
-    VkMemoryAllocateInfo memoryAllocInfo {
-        .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-        .pNext = nullptr,
-        .allocationSize = memoryRequirements.size,
-        .memoryTypeIndex = getMemoryType(memoryRequirements.memoryTypeBits, properties)
-    };
-
-    VkDeviceMemory imageMemory = VK_NULL_HANDLE;
-    ThrowIfFailed(vkAllocateMemory(
-        device,
-        &memoryAllocInfo,
-        nullptr,
-        &imageMemory));
+    const DeviceMemoryAllocation allocation = memoryAllocator->allocate(image, tiling, properties);
 
     ThrowIfFailed(vkBindImageMemory(
         device,
         image,
-        imageMemory,
-        0));
+        allocation.deviceMemory,
+        allocation.offset));
 
     return make_shared<Image>(
         id,
         imageDesc,
         device,
         image,
-        imageMemory);
-}
-
-// ---------------------------------------------------------------------------------------------------------------------
-
-void GraphicsDevice::updateImage(
-    const ImagePtr& image,
-    const vector<std::byte>& imageData,
-    bool isGenerateMipmaps) const
-{
-    const size_t bufferSize = imageData.size() * sizeof(std::byte);
-    const shared_ptr<Buffer> stagingBuffer =
-        createBuffer(
-            bufferSize,
-            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-
-    void* data = nullptr;
-    bind(stagingBuffer);
-    map(stagingBuffer, &data);
-    memcpy(data, imageData.data(), bufferSize);
-    unmap(stagingBuffer);
-
-    const ImageDesc& imageDesc = image->getDesc();
-
-    vector<VkBufferImageCopy> imageCopies;
-    uint32_t offsetIndex = 0;
-
-    // TODO: fix ambiguity between miplevels vs. mipOffsets
-    const uint32_t mipLevelCount = min(static_cast<size_t>(imageDesc.mipLevels), imageDesc.mipOffsets.size());
-
-    for (uint32_t mipLevel = 0; mipLevel < mipLevelCount; ++mipLevel)
-    {
-        VkBufferImageCopy imageCopy {
-            .bufferOffset = imageDesc.mipOffsets[offsetIndex],
-            .imageSubresource {
-                .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
-                .mipLevel = mipLevel,
-                .baseArrayLayer = 0,
-                .layerCount = imageDesc.layers
-            },
-            .imageExtent {
-                .width = imageDesc.width >> mipLevel,
-                .height = imageDesc.height >> mipLevel,
-                .depth = 1
-            },
-        };
-        imageCopies.push_back(imageCopy);
-        ++offsetIndex;
-    }
-
-    const CommandBufferPtr commandBuffer = createCommandBuffer(graphicsCommandPool);
-    commandBuffer->begin();
-
-    if (!isGenerateMipmaps) {
-        commandBuffer->setImageMemoryBarrier(
-            image,
-            0,
-            VK_ACCESS_TRANSFER_WRITE_BIT,
-            VK_IMAGE_LAYOUT_UNDEFINED,
-            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-            VK_PIPELINE_STAGE_HOST_BIT,
-            VK_PIPELINE_STAGE_TRANSFER_BIT);
-//        commandBuffer->setImageMemoryBarrier(
-//            image,
-//            VK_IMAGE_LAYOUT_UNDEFINED,
-//            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-    }
-
-    commandBuffer->copyBufferToImage(stagingBuffer, image, imageCopies);
-
-    if (!isGenerateMipmaps) {
-        commandBuffer->setImageMemoryBarrier(
-            image,
-            VK_ACCESS_TRANSFER_WRITE_BIT,
-            VK_ACCESS_SHADER_READ_BIT,
-            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-            VK_PIPELINE_STAGE_TRANSFER_BIT,
-            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
-//        commandBuffer->setImageMemoryBarrier(
-//            image,
-//            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-//            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-    }
-
-    commandBuffer->end();
-
-    VkFence fence = createFence();
-    graphicsQueue->submit(commandBuffer, fence);
-    ThrowIfFailed(waitForFence(fence, DEFAULT_FENCE_TIMEOUT));
-    destroyFence(fence);
-    destroyCommandBuffer(commandBuffer, graphicsCommandPool);
-}
-
-// ---------------------------------------------------------------------------------------------------------------------
-
-void GraphicsDevice::generateMipmaps(
-    const ImagePtr& image,
-    const ImageDesc& targetImageDesc,
-    VkFormat imageFormat) const
-{
-    // Check if image format supports linear blitting
-    VkFormatProperties formatProperties;
-    vkGetPhysicalDeviceFormatProperties(physicalDevice, imageFormat, &formatProperties);
-    RFX_CHECK_STATE(formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT,
-        "Texture image format does not support linear blitting");
-
-    const shared_ptr<CommandBuffer>& commandBuffer = createCommandBuffer(graphicsCommandPool);
-    commandBuffer->begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
-
-    VkImageMemoryBarrier barrier {
-        .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
-        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-        .image = image->getHandle(),
-        .subresourceRange = {
-            .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
-            .levelCount = 1,
-            .baseArrayLayer = 0,
-            .layerCount = targetImageDesc.layers
-        }
-    };
-
-    auto mipWidth = static_cast<int32_t>(targetImageDesc.width);
-    auto mipHeight = static_cast<int32_t>(targetImageDesc.height);
-
-    for (uint32_t i = 1; i < targetImageDesc.mipLevels; i++) {
-        barrier.subresourceRange.baseMipLevel = i - 1;
-        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-        barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-
-        vkCmdPipelineBarrier(commandBuffer->getHandle(),
-            VK_PIPELINE_STAGE_TRANSFER_BIT,
-            VK_PIPELINE_STAGE_TRANSFER_BIT,
-            0,
-            0,
-            nullptr,
-            0,
-            nullptr,
-            1,
-            &barrier);
-
-        VkImageBlit blit {
-            .srcSubresource = {
-                .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
-                .mipLevel = i - 1,
-                .baseArrayLayer = 0,
-                .layerCount = targetImageDesc.layers,
-            },
-            .srcOffsets = {
-                { 0, 0, 0 },
-                { mipWidth, mipHeight, 1 }
-            },
-            .dstSubresource = {
-                .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
-                .mipLevel = i,
-                .baseArrayLayer = 0,
-                .layerCount = targetImageDesc.layers
-            },
-            .dstOffsets = {
-                { 0, 0, 0 },
-                { mipWidth > 1 ? mipWidth / 2 : 1, mipHeight > 1 ? mipHeight / 2 : 1, 1 }
-            }
-        };
-
-        vkCmdBlitImage(commandBuffer->getHandle(),
-            image->getHandle(),
-            VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-            image->getHandle(),
-            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-            1,
-            &blit,
-            VK_FILTER_LINEAR);
-
-        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-        barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-        barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-
-        vkCmdPipelineBarrier(
-            commandBuffer->getHandle(),
-            VK_PIPELINE_STAGE_TRANSFER_BIT,
-            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-            0,
-            0,
-            nullptr,
-            0,
-            nullptr,
-            1,
-            &barrier);
-
-        if (mipWidth > 1) mipWidth /= 2;
-        if (mipHeight > 1) mipHeight /= 2;
-    }
-
-    barrier.subresourceRange.baseMipLevel = targetImageDesc.mipLevels - 1;
-    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-    barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-
-    vkCmdPipelineBarrier(
-        commandBuffer->getHandle(),
-        VK_PIPELINE_STAGE_TRANSFER_BIT,
-        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-        0,
-        0,
-        nullptr,
-        0,
-        nullptr,
-        1,
-        &barrier);
-
-    commandBuffer->end();
-    graphicsQueue->submit(commandBuffer);
-    graphicsQueue->waitIdle();
+        allocation,
+        memoryAllocator);
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
@@ -1269,77 +1059,31 @@ VkResult GraphicsDevice::waitForFences(uint32_t count, const VkFence* fences, bo
 
 // ---------------------------------------------------------------------------------------------------------------------
 
-void GraphicsDevice::transitionImageLayout(
-    const ImagePtr& image,
-    const ImageDesc& targetImageDesc,
-    VkImageLayout oldLayout,
-    VkImageLayout newLayout) const
-{
-    const shared_ptr<CommandBuffer>& commandBuffer = createCommandBuffer(graphicsCommandPool);
-    commandBuffer->begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
-
-    VkImageMemoryBarrier barrier {
-        .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
-        .oldLayout = oldLayout,
-        .newLayout = newLayout,
-        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-        .image = image->getHandle(),
-        .subresourceRange = {
-            .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
-            .baseMipLevel = 0,
-            .levelCount = targetImageDesc.mipLevels,
-            .baseArrayLayer = 0,
-            .layerCount = targetImageDesc.layers
-        }
-    };
-
-    VkPipelineStageFlags sourceStage;
-    VkPipelineStageFlags destinationStage;
-
-    if (oldLayout == VK_IMAGE_LAYOUT_UNDEFINED
-            && newLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL) {
-        barrier.srcAccessMask = 0;
-        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+const GraphicsDeviceDesc& GraphicsDevice::getDesc() const
+{
+    return desc_;
+}
 
-        sourceStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-        destinationStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-    }
-    else if (oldLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL
-            && newLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL) {
-        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+// ---------------------------------------------------------------------------------------------------------------------
 
-        sourceStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-        destinationStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-    }
-    else {
-        throw invalid_argument("unsupported layout transition");
-    }
+bool GraphicsDevice::isExtensionEnabled(const string& extensionName) const
+{
+    return ranges::find(desc_.enabledExtensions, extensionName) != desc_.enabledExtensions.end();
+}
 
-    vkCmdPipelineBarrier(
-        commandBuffer->getHandle(),
-        sourceStage,
-        destinationStage,
-        0,
-        0,
-        nullptr,
-        0,
-        nullptr,
-        1,
-        &barrier
-    );
+// ---------------------------------------------------------------------------------------------------------------------
 
-    commandBuffer->end();
-    graphicsQueue->submit(commandBuffer);
-    graphicsQueue->waitIdle();
+bool GraphicsDevice::isBindlessSupported() const
+{
+    // the features are enabled all or nothing, see GraphicsContext::createLogicalDevice()
+    return desc_.descriptorIndexingFeatures.runtimeDescriptorArray == VK_TRUE;
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
 
-const GraphicsDeviceDesc& GraphicsDevice::getDesc() const
+bool GraphicsDevice::isIndirectDrawingSupported() const
 {
-    return desc_;
+    return desc_.features.multiDrawIndirect == VK_TRUE && desc_.features.drawIndirectFirstInstance == VK_TRUE;
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
@@ -1391,3 +1135,45 @@ const QueuePtr& GraphicsDevice::getComputeQueue() const
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
+
+const UploadQueuePtr& GraphicsDevice::getUploadQueue() const
+{
+    return uploadQueue;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void GraphicsDevice::setShaderCache(ShaderCachePtr shaderCache)
+{
+    this->shaderCache = move(shaderCache);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+const ShaderCachePtr& GraphicsDevice::getShaderCache() const
+{
+    return shaderCache;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void GraphicsDevice::setMipmapGenerator(MipmapGeneratorPtr mipmapGenerator)
+{
+    uploadQueue->setMipmapGenerator(move(mipmapGenerator));
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+const MipmapGeneratorPtr& GraphicsDevice::getMipmapGenerator() const
+{
+    return uploadQueue->getMipmapGenerator();
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+const PipelineCachePtr& GraphicsDevice::getPipelineCache() const
+{
+    return pipelineCache;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
@@ -13,6 +13,10 @@
 #include "rfx/graphics/SamplerDesc.h"
 #include "rfx/graphics/Image.h"
 #include "rfx/graphics/ImageDesc.h"
+#include "rfx/graphics/DeviceMemoryAllocator.h"
+#include "rfx/graphics/UploadQueue.h"
+#include "rfx/graphics/ShaderCache.h"
+#include "rfx/graphics/PipelineCache.h"
 
 
 namespace rfx {
@@ -39,6 +43,17 @@ public:
     [[nodiscard]]
     const GraphicsDeviceDesc& getDesc() const;
 
+    [[nodiscard]]
+    bool isExtensionEnabled(const std::string& extensionName) const;
+
+    // runtime sized, partially bound, non-uniformly indexed sampled image arrays
+    [[nodiscard]]
+    bool isBindlessSupported() const;
+
+    // multi draw indirect with a first instance, see RenderGraph::enableIndirectDrawing()
+    [[nodiscard]]
+    bool isIndirectDrawingSupported() const;
+
     void createSwapChain(
         uint32_t width,
         uint32_t height);
@@ -89,7 +104,10 @@ public:
     void destroyCommandBuffer(const CommandBufferPtr& commandBuffer, VkCommandPool commandPool) const;
 
     [[nodiscard]]
-    std::vector<CommandBufferPtr> createCommandBuffers(VkCommandPool commandPool, uint32_t count) const;
+    std::vector<CommandBufferPtr> createCommandBuffers(
+        VkCommandPool commandPool,
+        uint32_t count,
+        VkCommandBufferLevel level = VK_COMMAND_BUFFER_LEVEL_PRIMARY) const;
 
     [[nodiscard]]
     Texture2DPtr createTexture2D(
@@ -137,6 +155,10 @@ public:
 
     void waitIdle() const;
 
+    [[nodiscard]] DeviceMemoryStats getMemoryStats() const;
+    void logMemoryStats() const;
+    void setMemorySubAllocationEnabled(bool enabled);   // for benchmarks, see DeviceMemoryAllocator
+
     [[nodiscard]] VkPhysicalDevice getPhysicalDevice() const;
     [[nodiscard]] VkDevice getLogicalDevice() const;
     [[nodiscard]] const QueuePtr& getGraphicsQueue() const;
@@ -144,11 +166,19 @@ public:
     [[nodiscard]] const QueuePtr& getPresentationQueue() const;
     [[nodiscard]] VkCommandPool getComputeCommandPool() const;
     [[nodiscard]] const QueuePtr& getComputeQueue() const;
+    [[nodiscard]] const UploadQueuePtr& getUploadQueue() const;
 
-private:
-    [[nodiscard]]
-    uint32_t getMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) const;
+    // optional, used by ShaderLoader to skip compiling unchanged GLSL sources
+    void setShaderCache(ShaderCachePtr shaderCache);
+    [[nodiscard]] const ShaderCachePtr& getShaderCache() const;
+
+    // optional, generates the mip levels of created images with supported formats instead of blitting them
+    void setMipmapGenerator(MipmapGeneratorPtr mipmapGenerator);
+    [[nodiscard]] const MipmapGeneratorPtr& getMipmapGenerator() const;
 
+    [[nodiscard]] const PipelineCachePtr& getPipelineCache() const;
+
+private:
     SwapChainDesc buildSwapChainDesc(
         uint32_t width,
         uint32_t height,
@@ -180,7 +210,7 @@ private:
         VkMemoryPropertyFlags memoryProperties,
         bool shared,
         VkBuffer& outBuffer,
-        VkDeviceMemory& outDeviceMemory) const;
+        DeviceMemoryAllocation& outAllocation) const;
 
     [[nodiscard]]
     std::shared_ptr<Image> createImage(
@@ -188,23 +218,12 @@ private:
         const ImageDesc& imageDesc,
         VkImageUsageFlags usage,
         VkImageTiling tiling,
-        VkMemoryPropertyFlags properties) const;
-
-    void transitionImageLayout(
-        const ImagePtr& image,
-        const ImageDesc& targetImageDesc,
-        VkImageLayout oldLayout,
-        VkImageLayout newLayout) const;
-
-    void updateImage(
-        const ImagePtr& image,
-        const std::vector<std::byte>& imageData,
-        bool isGenerateMipmaps) const;
+        VkMemoryPropertyFlags properties,
+        VkImageCreateFlags flags = 0) const;
 
-    void generateMipmaps(
-        const ImagePtr& image,
-        const ImageDesc& targetImageDesc,
-        VkFormat imageFormat) const;
+    [[nodiscard]]
+    BufferPtr createStagingBuffer(VkDeviceSize size) const;
+    void createUploadQueue();
 
     [[nodiscard]]
     VkSampler createSampler(const SamplerDesc& desc) const;
@@ -217,6 +236,7 @@ private:
     GraphicsDeviceDesc desc_ {};
     VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;
     VkDevice device = VK_NULL_HANDLE;
+    DeviceMemoryAllocatorPtr memoryAllocator;
     std::vector<uint32_t> usedQueueFamilyIndices;
     std::shared_ptr<Queue> graphicsQueue;
     VkCommandPool graphicsCommandPool = VK_NULL_HANDLE;
@@ -227,6 +247,9 @@ private:
 
     std::shared_ptr<Queue> computeQueue;
     VkCommandPool computeCommandPool = VK_NULL_HANDLE;
+    UploadQueuePtr uploadQueue;
+    ShaderCachePtr shaderCache;
+    PipelineCachePtr pipelineCache;
 
     VkSampleCountFlagBits multiSampleCount = VK_SAMPLE_COUNT_1_BIT;
     std::shared_ptr<Image> multiSampleImage;
@@ -8,9 +8,12 @@ struct GraphicsDeviceDesc
 {
     VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;
     VkPhysicalDeviceProperties properties {};
+    VkPhysicalDeviceSubgroupProperties subgroupProperties {};
     VkPhysicalDeviceMemoryProperties memoryProperties {};
-    VkPhysicalDeviceFeatures features {};
+    VkPhysicalDeviceFeatures features {};                                        // supported or, for a device, enabled
+    VkPhysicalDeviceDescriptorIndexingFeatures descriptorIndexingFeatures {};    // supported or, for a device, enabled
     std::vector<VkExtensionProperties> extensions;
+    std::vector<std::string> enabledExtensions;
     std::vector<QueueFamilyDesc> queueFamilies;
     VkSampleCountFlagBits maxSampleCount = VK_SAMPLE_COUNT_1_BIT;
 };
@@ -0,0 +1,752 @@
+#include "rfx/pch.h"
+#include "rfx/graphics/IblBaker.h"
+#include "rfx/graphics/IrradianceBaker.h"
+#include "rfx/graphics/TextureLoader.h"
+#include "rfx/common/ThreadPool.h"
+#include "rfx/common/Sha256.h"
+#include "rfx/common/Logger.h"
+#include "rfx/common/Math.h"
+
+#include <glm/gtc/packing.hpp>
+#include <thread>
+
+using namespace rfx;
+using namespace glm;
+using namespace std;
+using namespace filesystem;
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+namespace {
+
+// bump when the baked results change
+constexpr uint32_t CACHE_VERSION = 1;
+constexpr uint32_t ROWS_PER_TASK = 4;
+
+const string CACHE_FILE_EXTENSION = ".ktx";
+const path TEMPORARY_FILE_EXTENSION = ".tmp";
+
+// younger temporary files may belong to a baker of another process that is still writing them
+constexpr chrono::hours STALE_TEMPORARY_FILE_AGE { 1 };
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+ImageDesc createImageDesc(
+    VkFormat format,
+    uint32_t channels,
+    uint32_t size,
+    uint32_t mipLevels,
+    bool isCubemap)
+{
+    ImageDesc imageDesc {
+        .format = format,
+        .width = size,
+        .height = size,
+        .bytesPerPixel = channels * static_cast<uint32_t>(sizeof(uint16_t)),
+        .channels = channels,
+        .layers = isCubemap ? 6u : 1u,
+        .mipLevels = mipLevels,
+        .mipOffsets = {},
+        .isCubemap = isCubemap
+    };
+
+    VkDeviceSize offset = 0;
+    for (uint32_t level = 0; level < mipLevels; ++level) {
+        const VkDeviceSize levelSize = std::max(size >> level, 1u);
+        imageDesc.mipOffsets.push_back(offset);
+        offset += levelSize * levelSize * imageDesc.layers * imageDesc.bytesPerPixel;
+    }
+
+    return imageDesc;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+ImageDesc createBrdfLutDesc()
+{
+    return createImageDesc(VK_FORMAT_R16G16_SFLOAT, 2, IblBaker::BRDF_LUT_SIZE, 1, false);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+ImageDesc createCubeMapDesc(uint32_t size, uint32_t mipLevels)
+{
+    return createImageDesc(VK_FORMAT_R16G16B16A16_SFLOAT, 4, size, mipLevels, true);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+size_t getImageDataSize(const ImageDesc& imageDesc)
+{
+    const uint32_t lastLevelSize = std::max(imageDesc.width >> (imageDesc.mipLevels - 1), 1u);
+
+    return imageDesc.mipOffsets.back()
+        + static_cast<size_t>(lastLevelSize) * lastLevelSize * imageDesc.layers * imageDesc.bytesPerPixel;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+// direction through the center of a cube map texel, faces in Vulkan layer order
+vec3 getTexelDirection(uint32_t face, uint32_t x, uint32_t y, uint32_t size)
+{
+    const float s = 2.0f * (static_cast<float>(x) + 0.5f) / static_cast<float>(size) - 1.0f;
+    const float t = 2.0f * (static_cast<float>(y) + 0.5f) / static_cast<float>(size) - 1.0f;
+
+    vec3 direction;
+    switch (face) {
+        case 0: direction = vec3(1.0f, -t, -s); break;
+        case 1: direction = vec3(-1.0f, -t, s); break;
+        case 2: direction = vec3(s, 1.0f, t); break;
+        case 3: direction = vec3(s, -1.0f, -t); break;
+        case 4: direction = vec3(s, -t, 1.0f); break;
+        default: direction = vec3(-s, -t, -1.0f); break;
+    }
+
+    return normalize(direction);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+// face and face coordinates in [0, 1] of a direction, like the cube map lookup of the GPU
+uint32_t getFaceCoords(const vec3& direction, vec2& outCoords)
+{
+    const vec3 absDirection = abs(direction);
+
+    uint32_t face = 0;
+    float majorAxis = 0.0f;
+    vec2 coords;
+
+    if (absDirection.x >= absDirection.y && absDirection.x >= absDirection.z) {
+        face = direction.x > 0.0f ? 0 : 1;
+        majorAxis = absDirection.x;
+        coords = vec2(direction.x > 0.0f ? -direction.z : direction.z, -direction.y);
+    }
+    else if (absDirection.y >= absDirection.z) {
+        face = direction.y > 0.0f ? 2 : 3;
+        majorAxis = absDirection.y;
+        coords = vec2(direction.x, direction.y > 0.0f ? direction.z : -direction.z);
+    }
+    else {
+        face = direction.z > 0.0f ? 4 : 5;
+        majorAxis = absDirection.z;
+        coords = vec2(direction.z > 0.0f ? direction.x : -direction.x, -direction.y);
+    }
+
+    outCoords = (coords / majorAxis + 1.0f) * 0.5f;
+
+    return face;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+// the RGB radiance of an environment with a box filtered mip chain, sampled trilinearly
+class EnvironmentMipChain
+{
+public:
+    EnvironmentMipChain(const ImageDesc& imageDesc, const vector<std::byte>& imageData)
+    {
+        RFX_CHECK_ARGUMENT(imageDesc.isCubemap && imageDesc.layers == 6);
+        RFX_CHECK_ARGUMENT(imageDesc.format == VK_FORMAT_R32G32B32A32_SFLOAT);
+        RFX_CHECK_ARGUMENT(imageDesc.width == imageDesc.height && imageDesc.width > 0);
+
+        uint32_t size = imageDesc.width;
+        const size_t texelCount = static_cast<size_t>(size) * size * 6;
+        RFX_CHECK_ARGUMENT(imageData.size() >= texelCount * 4 * sizeof(float));
+
+        const auto texels = reinterpret_cast<const float*>(imageData.data());
+        vector<vec3>& firstLevel = levels.emplace_back(texelCount);
+        for (size_t i = 0; i < texelCount; ++i) {
+            firstLevel[i] = vec3(texels[i * 4], texels[i * 4 + 1], texels[i * 4 + 2]);
+        }
+        sizes.push_back(size);
+
+        while (size > 1) {
+            levels.push_back(downsample(levels.back(), size));
+            size = std::max(size / 2, 1u);
+            sizes.push_back(size);
+        }
+    }
+
+    [[nodiscard]] uint32_t getSize() const
+    {
+        return sizes[0];
+    }
+
+    [[nodiscard]] vec3 sample(const vec3& direction, float lod) const
+    {
+        vec2 coords;
+        const uint32_t face = getFaceCoords(direction, coords);
+
+        lod = glm::clamp(lod, 0.0f, static_cast<float>(levels.size() - 1));
+        const auto level = static_cast<uint32_t>(lod);
+        const float weight = lod - static_cast<float>(level);
+
+        const vec3 color = sampleLevel(level, face, coords);
+        if (weight <= 0.0f) {
+            return color;
+        }
+
+        return mix(color, sampleLevel(level + 1, face, coords), weight);
+    }
+
+private:
+    [[nodiscard]] static vector<vec3> downsample(const vector<vec3>& level, uint32_t size)
+    {
+        const uint32_t targetSize = std::max(size / 2, 1u);
+        vector<vec3> targetLevel(static_cast<size_t>(targetSize) * targetSize * 6);
+
+        for (uint32_t face = 0; face < 6; ++face) {
+            const vec3* texels = &level[static_cast<size_t>(face) * size * size];
+            vec3* targetTexels = &targetLevel[static_cast<size_t>(face) * targetSize * targetSize];
+
+            for (uint32_t y = 0; y < targetSize; ++y) {
+                const uint32_t y0 = std::min(y * 2, size - 1) * size;
+                const uint32_t y1 = std::min(y * 2 + 1, size - 1) * size;
+
+                for (uint32_t x = 0; x < targetSize; ++x)
+                {
+                    const uint32_t x0 = std::min(x * 2, size - 1);
+                    const uint32_t x1 = std::min(x * 2 + 1, size - 1);
+
+                    targetTexels[y * targetSize + x] =
+                        (texels[y0 + x0] + texels[y0 + x1] + texels[y1 + x0] + texels[y1 + x1]) * 0.25f;
+                }
+            }
+        }
+
+        return targetLevel;
+    }
+
+    // bilinear, clamped to the face
+    [[nodiscard]] vec3 sampleLevel(uint32_t level, uint32_t face, const vec2& coords) const
+    {
+        const uint32_t size = sizes[level];
+        const vec3* texels = &levels[level][static_cast<size_t>(face) * size * size];
+        const float maxCoord = static_cast<float>(size - 1);
+
+        const float u = glm::clamp(coords.x * static_cast<float>(size) - 0.5f, 0.0f, maxCoord);
+        const float v = glm::clamp(coords.y * static_cast<float>(size) - 0.5f, 0.0f, maxCoord);
+        const auto x0 = static_cast<uint32_t>(u);
+        const auto y0 = static_cast<uint32_t>(v);
+        const uint32_t x1 = std::min(x0 + 1, size - 1);
+        const uint32_t y1 = std::min(y0 + 1, size - 1);
+        const float s = u - static_cast<float>(x0);
+        const float t = v - static_cast<float>(y0);
+
+        return mix(
+            mix(texels[y0 * size + x0], texels[y0 * size + x1], s),
+            mix(texels[y1 * size + x0], texels[y1 * size + x1], s),
+            t);
+    }
+
+    vector<uint32_t> sizes;
+    vector<vector<vec3>> levels;
+};
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+// importance sample of a lobe around +z, with the source mip level matching its solid angle
+struct LobeSample
+{
+    vec3 direction { 0.0f };
+    float weight = 0.0f;
+    float lod = 0.0f;
+};
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+// "GPU-Based Importance Sampling", GPU Gems 3, chapter 20.4 - the +1 biases towards smoother results
+float getSourceLod(float pdf, uint32_t sampleCount, uint32_t sourceSize)
+{
+    const float sampleSolidAngle = 1.0f / (static_cast<float>(sampleCount) * pdf);
+    const float texelSolidAngle = 4.0f * Math::PI / (6.0f * static_cast<float>(sourceSize * sourceSize));
+
+    return std::max(0.5f * log2(sampleSolidAngle / texelSolidAngle) + 1.0f, 0.0f);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+vec3 importanceSampleGgx(const vec2& xi, float alphaRoughness)
+{
+    const float alphaSquared = alphaRoughness * alphaRoughness;
+    const float phi = Math::TWO_PI * xi.x;
+    const float cosTheta = sqrt((1.0f - xi.y) / (1.0f + (alphaSquared - 1.0f) * xi.y));
+    const float sinTheta = sqrt(1.0f - cosTheta * cosTheta);
+
+    return { sinTheta * cos(phi), sinTheta * sin(phi), cosTheta };
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+// reflections of GGX distributed half vectors with N = V = R, weighted by NdotL
+vector<LobeSample> createGgxSamples(float roughness, uint32_t sampleCount, uint32_t sourceSize)
+{
+    const float alphaRoughness = roughness * roughness;
+    const float alphaSquared = alphaRoughness * alphaRoughness;
+
+    vector<LobeSample> samples;
+    for (uint32_t i = 0; i < sampleCount; ++i)
+    {
+        const vec3 h = importanceSampleGgx(IrradianceBaker::hammersley2d(i, sampleCount), alphaRoughness);
+        const vec3 l = 2.0f * h.z * h - vec3(0.0f, 0.0f, 1.0f);
+        if (l.z <= 0.0f) {
+            continue;
+        }
+
+        // pdf = D * NdotH / (4 * VdotH), and NdotH = VdotH
+        const float d = (alphaSquared - 1.0f) * h.z * h.z + 1.0f;
+        const float pdf = alphaSquared / (Math::PI * d * d) / 4.0f;
+
+        samples.push_back({
+            .direction = l,
+            .weight = l.z,
+            .lod = getSourceLod(pdf, sampleCount, sourceSize)
+        });
+    }
+
+    return samples;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+// cosine distributed directions, the cosine cancels out with the PDF
+vector<LobeSample> createCosineSamples(uint32_t sampleCount, uint32_t sourceSize)
+{
+    vector<LobeSample> samples;
+    for (uint32_t i = 0; i < sampleCount; ++i)
+    {
+        const vec2 xi = IrradianceBaker::hammersley2d(i, sampleCount);
+        const float phi = Math::TWO_PI * xi.x;
+        const float cosTheta = sqrt(1.0f - xi.y);
+        const float sinTheta = sqrt(xi.y);
+
+        samples.push_back({
+            .direction = vec3(sinTheta * cos(phi), sinTheta * sin(phi), cosTheta),
+            .weight = 1.0f,
+            .lod = getSourceLod(cosTheta / Math::PI, sampleCount, sourceSize)
+        });
+    }
+
+    return samples;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+vec3 integrate(
+    const EnvironmentMipChain& environment,
+    const vector<LobeSample>& samples,
+    const vec3& normal)
+{
+    const vec3 up = abs(normal.z) < 0.999f ? vec3(0.0f, 0.0f, 1.0f) : vec3(1.0f, 0.0f, 0.0f);
+    const vec3 tangent = normalize(cross(up, normal));
+    const vec3 bitangent = cross(normal, tangent);
+
+    vec3 color(0.0f);
+    float weight = 0.0f;
+    for (const LobeSample& sample : samples)
+    {
+        const vec3 direction =
+            tangent * sample.direction.x + bitangent * sample.direction.y + normal * sample.direction.z;
+        color += environment.sample(direction, sample.lod) * sample.weight;
+        weight += sample.weight;
+    }
+
+    return weight > 0.0f ? color / weight : color;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+// calls bakeRows(firstRow, rowCount) for blocks of rows in parallel
+void bakeInParallel(uint32_t rowCount, const function<void(uint32_t, uint32_t)>& bakeRows)
+{
+    const uint32_t taskCount = (rowCount + ROWS_PER_TASK - 1) / ROWS_PER_TASK;
+    ThreadPool threadPool(std::min(ThreadPool::getDefaultThreadCount(), taskCount));
+
+    vector<future<void>> tasks;
+    tasks.reserve(taskCount);
+
+    for (uint32_t firstRow = 0; firstRow < rowCount; firstRow += ROWS_PER_TASK) {
+        tasks.push_back(threadPool.submit([&bakeRows, firstRow, rowCount] {
+            bakeRows(firstRow, std::min(ROWS_PER_TASK, rowCount - firstRow));
+        }));
+    }
+
+    // wait for all tasks before rethrowing, they reference bakeRows
+    for (auto& task : tasks) {
+        task.wait();
+    }
+    for (auto& task : tasks) {
+        task.get();
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+// bakes a mip level of a cube map, the rows of all faces in parallel
+void bakeCubeMapLevel(
+    const ImageDesc& imageDesc,
+    uint32_t level,
+    const function<vec3(const vec3&)>& bakeTexel,
+    vector<std::byte>* outImageData)
+{
+    const uint32_t size = std::max(imageDesc.width >> level, 1u);
+    const auto texels = reinterpret_cast<uint16_t*>(outImageData->data() + imageDesc.mipOffsets[level]);
+
+    bakeInParallel(6 * size, [&bakeTexel, size, texels](uint32_t firstRow, uint32_t rowCount) {
+        for (uint32_t row = firstRow; row < firstRow + rowCount; ++row) {
+            const uint32_t face = row / size;
+            const uint32_t y = row % size;
+
+            for (uint32_t x = 0; x < size; ++x)
+            {
+                const vec3 color = bakeTexel(getTexelDirection(face, x, y, size));
+                uint16_t* texel = texels + (static_cast<size_t>(row) * size + x) * 4;
+                texel[0] = packHalf1x16(color.r);
+                texel[1] = packHalf1x16(color.g);
+                texel[2] = packHalf1x16(color.b);
+                texel[3] = packHalf1x16(1.0f);
+            }
+        }
+    });
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+gli::format toGliFormat(VkFormat format)
+{
+    switch (format) {
+        case VK_FORMAT_R16G16_SFLOAT: return gli::FORMAT_RG16_SFLOAT_PACK16;
+        case VK_FORMAT_R16G16B16A16_SFLOAT: return gli::FORMAT_RGBA16_SFLOAT_PACK16;
+        default: RFX_THROW("Unsupported image format");
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+// left behind by processes that crashed between writing and renaming a cache entry
+void removeStaleTemporaryFiles(const path& directory)
+{
+    error_code error;
+    for (const auto& directoryEntry : directory_iterator(directory, error))
+    {
+        if (directoryEntry.path().extension() != TEMPORARY_FILE_EXTENSION) {
+            continue;
+        }
+
+        error_code fileError;
+        const file_time_type lastWrite = directoryEntry.last_write_time(fileError);
+        if (!fileError && file_time_type::clock::now() - lastWrite > STALE_TEMPORARY_FILE_AGE) {
+            remove(directoryEntry.path(), fileError);
+        }
+    }
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+IblBaker::IblBaker(
+    GraphicsDevicePtr graphicsDevice,
+    path cacheDirectory)
+        : graphicsDevice(move(graphicsDevice)),
+          cacheDirectory(move(cacheDirectory))
+{
+    create_directories(this->cacheDirectory);
+    removeStaleTemporaryFiles(this->cacheDirectory);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+IblBaker::Maps IblBaker::bake(const path& environmentPath) const
+{
+    const Images images = bakeImages(environmentPath);
+    const string environmentName = environmentPath.filename().string();
+
+    return {
+        .brdfLut = graphicsDevice->createTexture2D(
+            "brdf_lut",
+            images.brdfLutDesc,
+            images.brdfLutData,
+            false),
+        .irradianceMap = graphicsDevice->createCubeMap(
+            environmentName + " irradiance",
+            images.irradianceMapDesc,
+            images.irradianceMapData,
+            false),
+        .specularMap = graphicsDevice->createCubeMap(
+            environmentName + " specular",
+            images.specularMapDesc,
+            images.specularMapData,
+            false)
+    };
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+IblBaker::Images IblBaker::bakeImages(const path& environmentPath) const
+{
+    Images images {
+        .brdfLutDesc = createBrdfLutDesc(),
+        .irradianceMapDesc = createCubeMapDesc(IRRADIANCE_MAP_SIZE, 1),
+        .specularMapDesc = createCubeMapDesc(SPECULAR_MAP_SIZE, SPECULAR_MIP_COUNT)
+    };
+
+    const path brdfLutPath = getCachePath(createCacheKey({}), "brdf_lut");
+    if (!loadCachedImage(brdfLutPath, images.brdfLutDesc, &images.brdfLutData)) {
+        bakeBrdfLut(&images.brdfLutDesc, &images.brdfLutData);
+        storeCachedImage(brdfLutPath, images.brdfLutDesc, images.brdfLutData);
+    }
+
+    const string key = createCacheKey(environmentPath);
+    const path irradianceMapPath = getCachePath(key, "irradiance");
+    const path specularMapPath = getCachePath(key, "specular");
+    const bool isIrradianceMapCached =
+        loadCachedImage(irradianceMapPath, images.irradianceMapDesc, &images.irradianceMapData);
+    const bool isSpecularMapCached =
+        loadCachedImage(specularMapPath, images.specularMapDesc, &images.specularMapData);
+
+    if (isIrradianceMapCached && isSpecularMapCached) {
+        return images;
+    }
+
+    RFX_LOG_INFO << "Baking IBL maps of " << environmentPath.filename().string() << " ...";
+
+    ImageDesc environmentDesc {};
+    vector<std::byte> environmentData;
+    TextureLoader(graphicsDevice).loadCubeMapImage(environmentPath, environmentDesc, environmentData);
+
+    if (!isIrradianceMapCached) {
+        bakeIrradianceMap(environmentDesc, environmentData, &images.irradianceMapDesc, &images.irradianceMapData);
+        storeCachedImage(irradianceMapPath, images.irradianceMapDesc, images.irradianceMapData);
+    }
+    if (!isSpecularMapCached) {
+        bakeSpecularMap(environmentDesc, environmentData, &images.specularMapDesc, &images.specularMapData);
+        storeCachedImage(specularMapPath, images.specularMapDesc, images.specularMapData);
+    }
+
+    return images;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void IblBaker::bakeBrdfLut(
+    ImageDesc* outImageDesc,
+    vector<std::byte>* outImageData)
+{
+    *outImageDesc = createBrdfLutDesc();
+    outImageData->resize(getImageDataSize(*outImageDesc));
+
+    const auto texels = reinterpret_cast<uint16_t*>(outImageData->data());
+
+    // based on https://github.com/SaschaWillems/Vulkan-glTF-PBR/blob/master/data/shaders/genbrdflut.frag,
+    // like brdf_lut.comp
+    bakeInParallel(BRDF_LUT_SIZE, [texels](uint32_t firstRow, uint32_t rowCount) {
+        vector<vec3> halfVectors(BRDF_LUT_SAMPLE_COUNT);
+
+        for (uint32_t y = firstRow; y < firstRow + rowCount; ++y)
+        {
+            const float roughness = (static_cast<float>(y) + 0.5f) / static_cast<float>(BRDF_LUT_SIZE);
+            const float k = roughness * roughness / 2.0f;
+            for (uint32_t i = 0; i < BRDF_LUT_SAMPLE_COUNT; ++i) {
+                halfVectors[i] = importanceSampleGgx(
+                    IrradianceBaker::hammersley2d(i, BRDF_LUT_SAMPLE_COUNT), roughness * roughness);
+            }
+
+            for (uint32_t x = 0; x < BRDF_LUT_SIZE; ++x)
+            {
+                const float NdotV = (static_cast<float>(x) + 0.5f) / static_cast<float>(BRDF_LUT_SIZE);
+                const vec3 v(sqrt(1.0f - NdotV * NdotV), 0.0f, NdotV);
+
+                vec2 scaleBias(0.0f);
+                for (const vec3& h : halfVectors)
+                {
+                    const float VdotH = std::max(dot(v, h), 0.0f);
+                    const float NdotL = 2.0f * VdotH * h.z - v.z;
+                    if (NdotL <= 0.0f) {
+                        continue;
+                    }
+
+                    const float G = NdotL / (NdotL * (1.0f - k) + k) * NdotV / (NdotV * (1.0f - k) + k);
+                    const float G_Vis = G * VdotH / (h.z * NdotV);
+                    const float Fc = pow(1.0f - VdotH, 5.0f);
+                    scaleBias += vec2((1.0f - Fc) * G_Vis, Fc * G_Vis);
+                }
+                scaleBias /= static_cast<float>(BRDF_LUT_SAMPLE_COUNT);
+
+                texels[(y * BRDF_LUT_SIZE + x) * 2] = packHalf1x16(scaleBias.x);
+                texels[(y * BRDF_LUT_SIZE + x) * 2 + 1] = packHalf1x16(scaleBias.y);
+            }
+        }
+    });
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void IblBaker::bakeIrradianceMap(
+    const ImageDesc& environmentDesc,
+    const vector<std::byte>& environmentData,
+    ImageDesc* outImageDesc,
+    vector<std::byte>* outImageData)
+{
+    const EnvironmentMipChain environment(environmentDesc, environmentData);
+    const vector<LobeSample> samples = createCosineSamples(IRRADIANCE_SAMPLE_COUNT, environment.getSize());
+
+    *outImageDesc = createCubeMapDesc(IRRADIANCE_MAP_SIZE, 1);
+    outImageData->resize(getImageDataSize(*outImageDesc));
+
+    bakeCubeMapLevel(*outImageDesc, 0, [&environment, &samples](const vec3& normal) {
+        return integrate(environment, samples, normal);
+    }, outImageData);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void IblBaker::bakeSpecularMap(
+    const ImageDesc& environmentDesc,
+    const vector<std::byte>& environmentData,
+    ImageDesc* outImageDesc,
+    vector<std::byte>* outImageData)
+{
+    const EnvironmentMipChain environment(environmentDesc, environmentData);
+
+    *outImageDesc = createCubeMapDesc(SPECULAR_MAP_SIZE, SPECULAR_MIP_COUNT);
+    outImageData->resize(getImageDataSize(*outImageDesc));
+
+    // roughness 0 is a mirror, only the resolution needs to be reduced
+    const float mirrorLod = log2(static_cast<float>(environment.getSize()) / static_cast<float>(SPECULAR_MAP_SIZE));
+    bakeCubeMapLevel(*outImageDesc, 0, [&environment, mirrorLod](const vec3& direction) {
+        return environment.sample(direction, mirrorLod);
+    }, outImageData);
+
+    for (uint32_t level = 1; level < SPECULAR_MIP_COUNT; ++level)
+    {
+        const float roughness = static_cast<float>(level) / static_cast<float>(SPECULAR_MIP_COUNT - 1);
+        const vector<LobeSample> samples = createGgxSamples(roughness, SPECULAR_SAMPLE_COUNT, environment.getSize());
+
+        bakeCubeMapLevel(*outImageDesc, level, [&environment, &samples](const vec3& normal) {
+            return integrate(environment, samples, normal);
+        }, outImageData);
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+string IblBaker::createCacheKey(const path& environmentPath)
+{
+    const string parameters = fmt::format("IblBaker {} {} {} {} {} {} {} {}",
+        CACHE_VERSION,
+        BRDF_LUT_SIZE,
+        BRDF_LUT_SAMPLE_COUNT,
+        IRRADIANCE_MAP_SIZE,
+        IRRADIANCE_SAMPLE_COUNT,
+        SPECULAR_MAP_SIZE,
+        SPECULAR_MIP_COUNT,
+        SPECULAR_SAMPLE_COUNT);
+
+    // the terminating null character separates the parameters from the file contents
+    Sha256 sha256;
+    sha256.update(parameters.c_str(), parameters.size() + 1);
+
+    if (!environmentPath.empty()) {
+        ifstream file(environmentPath, ios::binary);
+        RFX_CHECK_STATE(file.is_open(), "Failed to open environment: " + environmentPath.string());
+
+        vector<char> buffer(1024 * 1024);
+        while (file.read(buffer.data(), static_cast<streamsize>(buffer.size())) || file.gcount() > 0) {
+            sha256.update(buffer.data(), static_cast<size_t>(file.gcount()));
+        }
+    }
+
+    return Sha256::toHexString(sha256.finish());
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+path IblBaker::getCachePath(const string& key, const string& name) const
+{
+    return cacheDirectory / (key + "_" + name + CACHE_FILE_EXTENSION);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+bool IblBaker::loadCachedImage(
+    const path& cachePath,
+    const ImageDesc& expectedImageDesc,
+    vector<std::byte>* outImageData)
+{
+    error_code error;
+    if (!exists(cachePath, error)) {
+        return false;
+    }
+
+    const gli::texture texture = gli::load_ktx(cachePath.string());
+    if (texture.empty()
+            || texture.format() != toGliFormat(expectedImageDesc.format)
+            || texture.extent() != gli::extent3d(expectedImageDesc.width, expectedImageDesc.height, 1)
+            || texture.faces() != expectedImageDesc.layers
+            || texture.levels() != expectedImageDesc.mipLevels) {
+        RFX_LOG_WARNING << "Ignoring unusable IBL cache entry " << cachePath;
+        return false;
+    }
+
+    outImageData->resize(getImageDataSize(expectedImageDesc));
+
+    for (uint32_t level = 0; level < expectedImageDesc.mipLevels; ++level) {
+        const size_t faceSize = texture.size(level);
+        for (uint32_t face = 0; face < expectedImageDesc.layers; ++face) {
+            memcpy(
+                outImageData->data() + expectedImageDesc.mipOffsets[level] + face * faceSize,
+                texture.data(0, face, level),
+                faceSize);
+        }
+    }
+
+    return true;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void IblBaker::storeCachedImage(
+    const path& cachePath,
+    const ImageDesc& imageDesc,
+    const vector<std::byte>& imageData)
+{
+    gli::texture texture(
+        imageDesc.isCubemap ? gli::TARGET_CUBE : gli::TARGET_2D,
+        toGliFormat(imageDesc.format),
+        gli::extent3d(imageDesc.width, imageDesc.height, 1),
+        1,
+        imageDesc.layers,
+        imageDesc.mipLevels);
+
+    for (uint32_t level = 0; level < imageDesc.mipLevels; ++level) {
+        const size_t faceSize = texture.size(level);
+        for (uint32_t face = 0; face < imageDesc.layers; ++face) {
+            memcpy(
+                texture.data(0, face, level),
+                imageData.data() + imageDesc.mipOffsets[level] + face * faceSize,
+                faceSize);
+        }
+    }
+
+    // written to a temporary file and renamed, so other processes never load a partial entry
+    ostringstream temporaryFileName;
+    temporaryFileName << cachePath.filename().string() << "." << this_thread::get_id()
+        << "." << chrono::steady_clock::now().time_since_epoch().count() << TEMPORARY_FILE_EXTENSION.string();
+    const path temporaryPath = cachePath.parent_path() / temporaryFileName.str();
+
+    error_code error;
+    if (!gli::save_ktx(texture, temporaryPath.string())) {
+        RFX_LOG_WARNING << "Failed to write IBL cache entry " << temporaryPath;
+        remove(temporaryPath, error);
+        return;
+    }
+
+    rename(temporaryPath, cachePath, error);
+    if (error) {
+        RFX_LOG_WARNING << "Failed to store IBL cache entry " << cachePath << ": " << error.message();
+        remove(temporaryPath, error);
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
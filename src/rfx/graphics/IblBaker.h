@@ -0,0 +1,102 @@
+#pragma once
+
+#include "rfx/graphics/GraphicsDevice.h"
+#include "rfx/graphics/Texture2D.h"
+#include "rfx/graphics/CubeMap.h"
+#include "rfx/graphics/ImageDesc.h"
+
+
+namespace rfx {
+
+/**
+ *  Image based lighting maps for the split sum approximation, baked on the CPU from an HDR environment:
+ *
+ *  1. the BRDF LUT - scale and bias to F0 (RG16F) indexed by (NdotV, roughness), environment independent
+ *  2. the irradiance cube map - the cosine weighted average radiance around each normal (RGBA16F)
+ *  3. the specular cube map - GGX prefiltered radiance (RGBA16F), mip level i holds roughness
+ *     i / (SPECULAR_MIP_COUNT - 1)
+ *
+ *  Both convolutions importance sample their lobe and read each sample from the source mip level whose texel solid
+ *  angle matches the solid angle the sample covers according to its PDF, which keeps the sample counts low without
+ *  aliasing. Texels are baked in parallel rows.
+ *
+ *  The baked maps are cached as KTX files named after the SHA-256 of the environment file and the bake parameters,
+ *  so switching to an environment that was baked before only loads the cached files. Temporary files older than an
+ *  hour, left behind by crashed writers, are removed when the cache directory is opened.
+ */
+class IblBaker
+{
+public:
+    static constexpr uint32_t BRDF_LUT_SIZE = 256;
+    static constexpr uint32_t BRDF_LUT_SAMPLE_COUNT = 1024;
+    static constexpr uint32_t IRRADIANCE_MAP_SIZE = 32;
+    static constexpr uint32_t IRRADIANCE_SAMPLE_COUNT = 512;
+    static constexpr uint32_t SPECULAR_MAP_SIZE = 256;
+    static constexpr uint32_t SPECULAR_MIP_COUNT = 6;
+    static constexpr uint32_t SPECULAR_SAMPLE_COUNT = 128;
+
+    struct Images
+    {
+        ImageDesc brdfLutDesc;
+        std::vector<std::byte> brdfLutData;
+        ImageDesc irradianceMapDesc;
+        std::vector<std::byte> irradianceMapData;
+        ImageDesc specularMapDesc;
+        std::vector<std::byte> specularMapData;
+    };
+
+    struct Maps
+    {
+        Texture2DPtr brdfLut;
+        CubeMapPtr irradianceMap;
+        CubeMapPtr specularMap;
+    };
+
+    IblBaker(
+        GraphicsDevicePtr graphicsDevice,
+        std::filesystem::path cacheDirectory);
+
+    // environments are loaded with TextureLoader::loadCubeMapImage() and must have RGBA32F faces, i.e. be HDR files
+    [[nodiscard]] Maps bake(const std::filesystem::path& environmentPath) const;
+    [[nodiscard]] Images bakeImages(const std::filesystem::path& environmentPath) const;
+
+    // the stages, without caching - mip levels of the baked images are stored level by level, all faces each
+    static void bakeBrdfLut(
+        ImageDesc* outImageDesc,
+        std::vector<std::byte>* outImageData);
+
+    static void bakeIrradianceMap(
+        const ImageDesc& environmentDesc,
+        const std::vector<std::byte>& environmentData,
+        ImageDesc* outImageDesc,
+        std::vector<std::byte>* outImageData);
+
+    static void bakeSpecularMap(
+        const ImageDesc& environmentDesc,
+        const std::vector<std::byte>& environmentData,
+        ImageDesc* outImageDesc,
+        std::vector<std::byte>* outImageData);
+
+private:
+    // an empty path gives the key of the BRDF LUT
+    [[nodiscard]] static std::string createCacheKey(const std::filesystem::path& environmentPath);
+    [[nodiscard]] std::filesystem::path getCachePath(const std::string& key, const std::string& name) const;
+
+    [[nodiscard]] static bool loadCachedImage(
+        const std::filesystem::path& cachePath,
+        const ImageDesc& expectedImageDesc,
+        std::vector<std::byte>* outImageData);
+
+    static void storeCachedImage(
+        const std::filesystem::path& cachePath,
+        const ImageDesc& imageDesc,
+        const std::vector<std::byte>& imageData);
+
+
+    GraphicsDevicePtr graphicsDevice;
+    std::filesystem::path cacheDirectory;
+};
+
+using IblBakerPtr = std::shared_ptr<IblBaker>;
+
+} // namespace rfx
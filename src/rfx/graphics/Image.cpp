@@ -12,19 +12,21 @@ Image::Image(
     ImageDesc desc,
     VkDevice device,
     VkImage image,
-    VkDeviceMemory deviceMemory)
+    const DeviceMemoryAllocation& allocation,
+    DeviceMemoryAllocatorPtr allocator)
         : id(move(id)),
           desc(move(desc)),
-          device(device),
           image(image),
-          deviceMemory(deviceMemory) {}
+          device(device),
+          allocation(allocation),
+          allocator(move(allocator)) {}
 
 // ---------------------------------------------------------------------------------------------------------------------
 
 Image::~Image()
 {
-    vkFreeMemory(device, deviceMemory, nullptr);
     vkDestroyImage(device, image, nullptr);
+    allocator->free(allocation);
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "rfx/graphics/ImageDesc.h"
+#include "rfx/graphics/DeviceMemoryAllocator.h"
 
 namespace rfx {
 
@@ -12,7 +13,8 @@ public:
         ImageDesc desc,
         VkDevice device,
         VkImage image,
-        VkDeviceMemory deviceMemory);
+        const DeviceMemoryAllocation& allocation,
+        DeviceMemoryAllocatorPtr allocator);
 
     ~Image();
 
@@ -27,7 +29,8 @@ private:
     ImageDesc desc;
     VkImage image;
     VkDevice device;
-    VkDeviceMemory deviceMemory;
+    DeviceMemoryAllocation allocation;
+    DeviceMemoryAllocatorPtr allocator;
 };
 
 using ImagePtr = std::shared_ptr<Image>;
@@ -12,8 +12,9 @@ IndexBuffer::IndexBuffer(
     VkDeviceSize size,
     VkDevice device,
     VkBuffer buffer,
-    VkDeviceMemory deviceMemory)
-        : Buffer(size, device, buffer, deviceMemory),
+    const DeviceMemoryAllocation& allocation,
+    DeviceMemoryAllocatorPtr allocator)
+        : Buffer(size, device, buffer, allocation, move(allocator)),
           indexCount(indexCount),
           indexType(indexType) {}
 
@@ -13,7 +13,8 @@ public:
         VkDeviceSize size,
         VkDevice device,
         VkBuffer buffer,
-        VkDeviceMemory deviceMemory);
+        const DeviceMemoryAllocation& allocation,
+        DeviceMemoryAllocatorPtr allocator);
 
     [[nodiscard]] uint32_t getIndexCount() const;
     [[nodiscard]] VkIndexType getIndexType() const;
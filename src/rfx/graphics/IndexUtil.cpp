@@ -0,0 +1,140 @@
+#include "rfx/pch.h"
+#include "rfx/graphics/IndexUtil.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#define RFX_INDEX_UTIL_SSE
+#include <emmintrin.h>
+#endif
+
+using namespace rfx;
+using namespace std;
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+VkIndexType IndexUtil::getIndexType(uint32_t vertexCount)
+{
+    return vertexCount <= MAX_UINT16_VERTEX_COUNT
+        ? VK_INDEX_TYPE_UINT16
+        : VK_INDEX_TYPE_UINT32;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+uint32_t IndexUtil::getIndexSize(VkIndexType indexType)
+{
+    switch (indexType) {
+        case VK_INDEX_TYPE_UINT16:
+            return sizeof(uint16_t);
+        case VK_INDEX_TYPE_UINT32:
+            return sizeof(uint32_t);
+        case VK_INDEX_TYPE_UINT8_EXT:
+            return sizeof(uint8_t);
+        default:
+            RFX_CHECK_ARGUMENT(false);
+    }
+
+    return 0;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void IndexUtil::convert(const uint8_t* source, size_t count, uint32_t baseVertex, uint32_t* dest)
+{
+    size_t i = 0;
+
+#ifdef RFX_INDEX_UTIL_SSE
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i offset = _mm_set1_epi32(static_cast<int>(baseVertex));
+
+    for (; i + 16 <= count; i += 16)
+    {
+        const __m128i indices = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+        const __m128i low = _mm_unpacklo_epi8(indices, zero);
+        const __m128i high = _mm_unpackhi_epi8(indices, zero);
+
+        auto* destVector = reinterpret_cast<__m128i*>(dest + i);
+        _mm_storeu_si128(destVector + 0, _mm_add_epi32(_mm_unpacklo_epi16(low, zero), offset));
+        _mm_storeu_si128(destVector + 1, _mm_add_epi32(_mm_unpackhi_epi16(low, zero), offset));
+        _mm_storeu_si128(destVector + 2, _mm_add_epi32(_mm_unpacklo_epi16(high, zero), offset));
+        _mm_storeu_si128(destVector + 3, _mm_add_epi32(_mm_unpackhi_epi16(high, zero), offset));
+    }
+#endif // RFX_INDEX_UTIL_SSE
+
+    for (; i < count; ++i) {
+        dest[i] = source[i] + baseVertex;
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void IndexUtil::convert(const uint16_t* source, size_t count, uint32_t baseVertex, uint32_t* dest)
+{
+    size_t i = 0;
+
+#ifdef RFX_INDEX_UTIL_SSE
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i offset = _mm_set1_epi32(static_cast<int>(baseVertex));
+
+    for (; i + 8 <= count; i += 8)
+    {
+        const __m128i indices = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+
+        auto* destVector = reinterpret_cast<__m128i*>(dest + i);
+        _mm_storeu_si128(destVector + 0, _mm_add_epi32(_mm_unpacklo_epi16(indices, zero), offset));
+        _mm_storeu_si128(destVector + 1, _mm_add_epi32(_mm_unpackhi_epi16(indices, zero), offset));
+    }
+#endif // RFX_INDEX_UTIL_SSE
+
+    for (; i < count; ++i) {
+        dest[i] = source[i] + baseVertex;
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void IndexUtil::convert(const uint32_t* source, size_t count, uint32_t baseVertex, uint32_t* dest)
+{
+    size_t i = 0;
+
+#ifdef RFX_INDEX_UTIL_SSE
+    const __m128i offset = _mm_set1_epi32(static_cast<int>(baseVertex));
+
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m128i indices = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), _mm_add_epi32(indices, offset));
+    }
+#endif // RFX_INDEX_UTIL_SSE
+
+    for (; i < count; ++i) {
+        dest[i] = source[i] + baseVertex;
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void IndexUtil::convert(const uint32_t* source, size_t count, uint16_t* dest)
+{
+    size_t i = 0;
+
+#ifdef RFX_INDEX_UTIL_SSE
+    // SSE2 only packs with signed saturation, so the indices are biased into the signed range and back
+    const __m128i bias32 = _mm_set1_epi32(0x8000);
+    const __m128i bias16 = _mm_set1_epi16(static_cast<short>(0x8000));
+
+    for (; i + 8 <= count; i += 8)
+    {
+        const __m128i low = _mm_sub_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i)), bias32);
+        const __m128i high = _mm_sub_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i + 4)), bias32);
+        const __m128i indices = _mm_xor_si128(_mm_packs_epi32(low, high), bias16);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), indices);
+    }
+#endif // RFX_INDEX_UTIL_SSE
+
+    for (; i < count; ++i) {
+        dest[i] = static_cast<uint16_t>(source[i]);
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
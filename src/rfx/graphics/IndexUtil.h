@@ -0,0 +1,26 @@
+#pragma once
+
+
+namespace rfx {
+
+class IndexUtil
+{
+public:
+    IndexUtil() = delete;
+
+    // 16 bit indices address up to 65536 vertices
+    static constexpr uint32_t MAX_UINT16_VERTEX_COUNT = 65536;
+
+    static VkIndexType getIndexType(uint32_t vertexCount);
+    static uint32_t getIndexSize(VkIndexType indexType);
+
+    // widen to 32 bit and add baseVertex
+    static void convert(const uint8_t* source, size_t count, uint32_t baseVertex, uint32_t* dest);
+    static void convert(const uint16_t* source, size_t count, uint32_t baseVertex, uint32_t* dest);
+    static void convert(const uint32_t* source, size_t count, uint32_t baseVertex, uint32_t* dest);
+
+    // narrow to 16 bit, all indices must be below MAX_UINT16_VERTEX_COUNT
+    static void convert(const uint32_t* source, size_t count, uint16_t* dest);
+};
+
+} // namespace rfx
@@ -0,0 +1,216 @@
+#include "rfx/pch.h"
+#include "rfx/graphics/IrradianceBaker.h"
+#include "rfx/common/Math.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#define RFX_IRRADIANCE_BAKER_SSE
+#include <emmintrin.h>
+#endif
+
+using namespace rfx;
+using namespace glm;
+using namespace std;
+
+static constexpr uint32_t SIMD_WIDTH = 4;
+static constexpr uint32_t ROWS_PER_TASK = 4;
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+IrradianceBaker::IrradianceBaker(
+    uint32_t width,
+    uint32_t height,
+    uint32_t sampleCount)
+        : width(width),
+          height(height)
+{
+    RFX_CHECK_ARGUMENT(width > 0 && height > 0);
+    RFX_CHECK_ARGUMENT(sampleCount > 0);
+
+    for (uint32_t y = 0; y < height; ++y) {
+        const float theta = float(y) / float(height) * Math::PI;
+        sinTheta.push_back(sin(theta));
+        cosTheta.push_back(cos(theta));
+    }
+
+    for (uint32_t x = 0; x < width; ++x) {
+        const float phi = float(x) / float(width) * Math::TWO_PI;
+        sinPhi.push_back(sin(phi));
+        cosPhi.push_back(cos(phi));
+    }
+
+    const uint32_t paddedSampleCount = (sampleCount + SIMD_WIDTH - 1) / SIMD_WIDTH * SIMD_WIDTH;
+    sampleTexels.resize(sampleCount);
+    sampleX.resize(paddedSampleCount, 0.0f);
+    sampleY.resize(paddedSampleCount, 0.0f);
+    sampleZ.resize(paddedSampleCount, 0.0f);
+
+    // the samples are snapped to the texel grid, so their directions are those of the texels
+    for (uint32_t i = 0; i < sampleCount; ++i)
+    {
+        const vec2 h = hammersley2d(i, sampleCount);
+        const auto x = static_cast<uint32_t>(floor(h.x * float(width)));
+        const auto y = static_cast<uint32_t>(floor(h.y * float(height)));
+
+        sampleTexels[i] = y * width + x;
+        sampleX[i] = sinTheta[y] * cosPhi[x];
+        sampleY[i] = sinTheta[y] * sinPhi[x];
+        sampleZ[i] = cosTheta[y];
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void IrradianceBaker::bake(
+    const vec3* radiance,
+    vec3* outIrradiance,
+    uint32_t threadCount) const
+{
+    RFX_CHECK_ARGUMENT(radiance != nullptr && outIrradiance != nullptr);
+
+    const SampleColors sampleColors = gatherSampleColors(radiance);
+    const uint32_t taskCount = (height + ROWS_PER_TASK - 1) / ROWS_PER_TASK;
+
+    if (threadCount <= 1 || taskCount <= 1) {
+        bakeRows(sampleColors, 0, height, outIrradiance);
+        return;
+    }
+
+    ThreadPool threadPool(min(threadCount, taskCount));
+
+    vector<future<void>> tasks;
+    tasks.reserve(taskCount);
+
+    for (uint32_t firstRow = 0; firstRow < height; firstRow += ROWS_PER_TASK) {
+        tasks.push_back(threadPool.submit([this, &sampleColors, firstRow, outIrradiance] {
+            bakeRows(sampleColors, firstRow, std::min(ROWS_PER_TASK, height - firstRow), outIrradiance);
+        }));
+    }
+
+    // wait for all tasks before rethrowing, they reference sampleColors
+    for (auto& task : tasks) {
+        task.wait();
+    }
+    for (auto& task : tasks) {
+        task.get();
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+IrradianceBaker::SampleColors IrradianceBaker::gatherSampleColors(const vec3* radiance) const
+{
+    SampleColors sampleColors {
+        .r = vector<float>(sampleX.size(), 0.0f),
+        .g = vector<float>(sampleX.size(), 0.0f),
+        .b = vector<float>(sampleX.size(), 0.0f)
+    };
+
+    for (size_t i = 0; i < sampleTexels.size(); ++i)
+    {
+        const vec3& color = radiance[sampleTexels[i]];
+        sampleColors.r[i] = color.r;
+        sampleColors.g[i] = color.g;
+        sampleColors.b[i] = color.b;
+    }
+
+    return sampleColors;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void IrradianceBaker::bakeRows(
+    const SampleColors& sampleColors,
+    uint32_t firstRow,
+    uint32_t rowCount,
+    vec3* outIrradiance) const
+{
+    for (uint32_t y = firstRow; y < firstRow + rowCount; ++y) {
+        for (uint32_t x = 0; x < width; ++x)
+        {
+            const vec3 normal(sinTheta[y] * cosPhi[x], sinTheta[y] * sinPhi[x], cosTheta[y]);
+            outIrradiance[y * width + x] = integrate(sampleColors, normal);
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+vec3 IrradianceBaker::integrate(const SampleColors& sampleColors, const vec3& normal) const
+{
+    const size_t count = sampleX.size();
+    vec3 color(0.0f);
+    float weight = 0.0f;
+
+#ifdef RFX_IRRADIANCE_BAKER_SSE
+    const __m128 normalX = _mm_set1_ps(normal.x);
+    const __m128 normalY = _mm_set1_ps(normal.y);
+    const __m128 normalZ = _mm_set1_ps(normal.z);
+    const __m128 minCosine = _mm_set1_ps(MIN_COSINE);
+
+    __m128 sumR = _mm_setzero_ps();
+    __m128 sumG = _mm_setzero_ps();
+    __m128 sumB = _mm_setzero_ps();
+    __m128 sumWeight = _mm_setzero_ps();
+
+    for (size_t i = 0; i < count; i += SIMD_WIDTH)
+    {
+        const __m128 cosine = _mm_add_ps(
+            _mm_add_ps(
+                _mm_mul_ps(normalX, _mm_loadu_ps(&sampleX[i])),
+                _mm_mul_ps(normalY, _mm_loadu_ps(&sampleY[i]))),
+            _mm_mul_ps(normalZ, _mm_loadu_ps(&sampleZ[i])));
+        const __m128 sampleWeight = _mm_and_ps(_mm_cmpgt_ps(cosine, minCosine), cosine);
+
+        sumR = _mm_add_ps(sumR, _mm_mul_ps(_mm_loadu_ps(&sampleColors.r[i]), sampleWeight));
+        sumG = _mm_add_ps(sumG, _mm_mul_ps(_mm_loadu_ps(&sampleColors.g[i]), sampleWeight));
+        sumB = _mm_add_ps(sumB, _mm_mul_ps(_mm_loadu_ps(&sampleColors.b[i]), sampleWeight));
+        sumWeight = _mm_add_ps(sumWeight, sampleWeight);
+    }
+
+    alignas(16) float sums[4][SIMD_WIDTH];
+    _mm_store_ps(sums[0], sumR);
+    _mm_store_ps(sums[1], sumG);
+    _mm_store_ps(sums[2], sumB);
+    _mm_store_ps(sums[3], sumWeight);
+
+    for (uint32_t lane = 0; lane < SIMD_WIDTH; ++lane) {
+        color += vec3(sums[0][lane], sums[1][lane], sums[2][lane]);
+        weight += sums[3][lane];
+    }
+#else
+    for (size_t i = 0; i < count; ++i)
+    {
+        const float cosine = normal.x * sampleX[i] + normal.y * sampleY[i] + normal.z * sampleZ[i];
+        if (cosine > MIN_COSINE) {
+            color += vec3(sampleColors.r[i], sampleColors.g[i], sampleColors.b[i]) * cosine;
+            weight += cosine;
+        }
+    }
+#endif // RFX_IRRADIANCE_BAKER_SSE
+
+    return color / weight;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+/// From http://holger.dammertz.org/stuff/notes_HammersleyOnHemisphere.html
+vec2 IrradianceBaker::hammersley2d(uint32_t i, uint32_t N)
+{
+    return vec2(float(i) / float(N), radicalInverse_VdC(i));
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+/// From Henry J. Warren's "Hacker's Delight"
+float IrradianceBaker::radicalInverse_VdC(uint32_t bits)
+{
+    bits = (bits << 16u) | (bits >> 16u);
+    bits = ((bits & 0x55555555u) << 1u) | ((bits & 0xAAAAAAAAu) >> 1u);
+    bits = ((bits & 0x33333333u) << 2u) | ((bits & 0xCCCCCCCCu) >> 2u);
+    bits = ((bits & 0x0F0F0F0Fu) << 4u) | ((bits & 0xF0F0F0F0u) >> 4u);
+    bits = ((bits & 0x00FF00FFu) << 8u) | ((bits & 0xFF00FF00u) >> 8u);
+
+    return float(bits) * 2.3283064365386963e-10f; // / 0x100000000
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "rfx/common/ThreadPool.h"
+
+
+namespace rfx {
+
+/**
+ *  Diffuse irradiance of an equirectangular RGB radiance map by Monte-Carlo integration: each texel of the
+ *  irradiance map is the cosine weighted average of a fixed Hammersley set of radiance texels in its hemisphere.
+ *  Samples with a cosine <= MIN_COSINE are skipped.
+ *
+ *  The sample directions don't depend on the irradiance texel, so they are computed once by the constructor and
+ *  kept in SoA tables together with the sample colors gathered by bake(). The per-texel loop then is a dot product
+ *  and four multiply-adds per sample, vectorized with SSE2 where available. Rows are baked in parallel.
+ */
+class IrradianceBaker
+{
+public:
+    static constexpr float MIN_COSINE = 0.01f;
+
+    // both maps have width x height texels
+    IrradianceBaker(
+        uint32_t width,
+        uint32_t height,
+        uint32_t sampleCount);
+
+    void bake(
+        const glm::vec3* radiance,
+        glm::vec3* outIrradiance,
+        uint32_t threadCount = ThreadPool::getDefaultThreadCount()) const;
+
+    [[nodiscard]] static glm::vec2 hammersley2d(uint32_t i, uint32_t N);
+
+private:
+    // SoA, padded like the sample directions
+    struct SampleColors
+    {
+        std::vector<float> r;
+        std::vector<float> g;
+        std::vector<float> b;
+    };
+
+    static float radicalInverse_VdC(uint32_t bits);
+
+    [[nodiscard]] SampleColors gatherSampleColors(const glm::vec3* radiance) const;
+
+    void bakeRows(
+        const SampleColors& sampleColors,
+        uint32_t firstRow,
+        uint32_t rowCount,
+        glm::vec3* outIrradiance) const;
+
+    [[nodiscard]] glm::vec3 integrate(const SampleColors& sampleColors, const glm::vec3& normal) const;
+
+
+    uint32_t width = 0;
+    uint32_t height = 0;
+
+    std::vector<float> sinTheta;                // per row
+    std::vector<float> cosTheta;
+    std::vector<float> sinPhi;                  // per column
+    std::vector<float> cosPhi;
+
+    // SoA, padded to a multiple of the SIMD width with zero directions, which are skipped like back facing ones
+    std::vector<uint32_t> sampleTexels;         // radiance texel index of each sample
+    std::vector<float> sampleX;
+    std::vector<float> sampleY;
+    std::vector<float> sampleZ;
+};
+
+} // namespace rfx
@@ -0,0 +1,862 @@
+#include "rfx/pch.h"
+#include "rfx/graphics/MipmapGenerator.h"
+#include "rfx/graphics/GraphicsDevice.h"
+#include "rfx/graphics/PipelineUtil.h"
+#include "rfx/graphics/ShaderLoader.h"
+#include "rfx/common/Math.h"
+
+using namespace rfx;
+using namespace glm;
+using namespace std;
+using namespace filesystem;
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+namespace {
+
+constexpr uint32_t TILE_SIZE = 64;                  // see downsample.comp
+constexpr uint32_t MAX_MID_LEVEL_SIZE = 64;         // level 6 of a pass must fit into the tile of the last work group
+constexpr uint32_t KAISER_GROUP_SIZE = 8;           // see downsample_kaiser.comp
+constexpr float KAISER_ALPHA = 4.0f;
+constexpr float KAISER_RADIUS = 3.0f;               // in source texels
+
+constexpr uint32_t SRC_IMAGE_BINDING = 0;
+constexpr uint32_t DST_IMAGES_BINDING = 1;
+constexpr uint32_t MID_IMAGE_BINDING = 2;
+constexpr uint32_t COUNTERS_BINDING = 3;
+
+// layouts of the push constants in downsample.comp and downsample_kaiser.comp
+struct SinglePassConstants
+{
+    ivec2 srcSize { 0 };
+    uint32_t levelCount = 0;
+    uint32_t workGroupCount = 0;
+    uint32_t isSrgb = 0;
+};
+
+struct KaiserConstants
+{
+    ivec2 srcSize { 0 };
+    ivec2 dstSize { 0 };
+    vec4 weights { 0.0f };
+    uint32_t isSrgb = 0;
+};
+
+struct StorageFormat
+{
+    VkFormat viewFormat = VK_FORMAT_UNDEFINED;
+    const char* qualifier = nullptr;
+    bool isSrgb = false;
+};
+
+// formats that can be stored without shaderStorageImageExtendedFormats
+const unordered_map<VkFormat, StorageFormat> STORAGE_FORMATS {
+    { VK_FORMAT_R8G8B8A8_UNORM, { VK_FORMAT_R8G8B8A8_UNORM, "rgba8", false } },
+    { VK_FORMAT_R8G8B8A8_SRGB, { VK_FORMAT_R8G8B8A8_UNORM, "rgba8", true } },
+    { VK_FORMAT_R16G16B16A16_SFLOAT, { VK_FORMAT_R16G16B16A16_SFLOAT, "rgba16f", false } },
+    { VK_FORMAT_R32G32B32A32_SFLOAT, { VK_FORMAT_R32G32B32A32_SFLOAT, "rgba32f", false } }
+};
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+uvec2 getLevelSize(const ImageDesc& imageDesc, uint32_t level)
+{
+    return {
+        max(imageDesc.width >> level, 1u),
+        max(imageDesc.height >> level, 1u)
+    };
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+uint32_t getPassLevelCount(
+    const ImageDesc& imageDesc,
+    uint32_t baseLevel,
+    MipmapGenerator::Filter filter)
+{
+    if (filter == MipmapGenerator::Filter::KAISER) {
+        return 1;
+    }
+
+    const uvec2 baseSize = getLevelSize(imageDesc, baseLevel);
+    const uint32_t levelCount = min(imageDesc.mipLevels - 1 - baseLevel, MipmapGenerator::MAX_PASS_LEVEL_COUNT);
+
+    return (max(baseSize.x, baseSize.y) >> 6) > MAX_MID_LEVEL_SIZE
+        ? min(levelCount, 6u)
+        : levelCount;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+float bessel0(float x)
+{
+    float sum = 1.0f;
+    float term = 1.0f;
+
+    for (int k = 1; k < 32; ++k) {
+        const float halfXOverK = x / (2.0f * float(k));
+        term *= halfXOverK * halfXOverK;
+        sum += term;
+    }
+
+    return sum;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+// sinc for the halved sampling rate, windowed and normalized over the three taps on either side
+vec4 createKaiserWeights()
+{
+    vec4 weights(0.0f);
+    float sum = 0.0f;
+
+    for (int i = 0; i < 3; ++i) {
+        const float distance = float(i) + 0.5f;
+        const float x = Math::PI * distance / 2.0f;
+        const float sinc = sin(x) / x;
+        const float t = distance / KAISER_RADIUS;
+        const float window = bessel0(KAISER_ALPHA * sqrt(1.0f - t * t)) / bessel0(KAISER_ALPHA);
+
+        weights[i] = sinc * window;
+        sum += 2.0f * weights[i];
+    }
+
+    return weights / sum;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+VkImageMemoryBarrier createLevelBarrier(
+    const ImagePtr& image,
+    uint32_t baseLevel,
+    uint32_t levelCount,
+    VkAccessFlags srcAccess,
+    VkAccessFlags dstAccess,
+    VkImageLayout oldLayout,
+    VkImageLayout newLayout)
+{
+    return {
+        .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+        .srcAccessMask = srcAccess,
+        .dstAccessMask = dstAccess,
+        .oldLayout = oldLayout,
+        .newLayout = newLayout,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .image = image->getHandle(),
+        .subresourceRange = {
+            .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+            .baseMipLevel = baseLevel,
+            .levelCount = levelCount,
+            .baseArrayLayer = 0,
+            .layerCount = image->getDesc().layers
+        }
+    };
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+MipmapGenerator::Target::~Target()
+{
+    vkDestroyDescriptorPool(device, descriptorPool, nullptr);
+
+    for (VkImageView levelView : levelViews) {
+        vkDestroyImageView(device, levelView, nullptr);
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+const ImagePtr& MipmapGenerator::Target::getImage() const
+{
+    return image;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+MipmapGenerator::MipmapGenerator(
+    const GraphicsDevicePtr& graphicsDevice,
+    path shadersDirectory)
+        : graphicsDevice(graphicsDevice),
+          device(graphicsDevice->getLogicalDevice()),
+          shadersDirectory(move(shadersDirectory))
+{
+    const VkPhysicalDeviceSubgroupProperties& subgroupProperties = graphicsDevice->getDesc().subgroupProperties;
+    isSubgroupQuadSupported = (subgroupProperties.supportedStages & VK_SHADER_STAGE_COMPUTE_BIT)
+        && (subgroupProperties.supportedOperations & VK_SUBGROUP_FEATURE_QUAD_BIT);
+
+    for (const auto& [format, storageFormat] : STORAGE_FORMATS) {
+        VkFormatProperties formatProperties;
+        vkGetPhysicalDeviceFormatProperties(
+            graphicsDevice->getPhysicalDevice(),
+            storageFormat.viewFormat,
+            &formatProperties);
+
+        formatSupport[format] = (formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT) != 0;
+    }
+
+    createSinglePassLayouts();
+    createKaiserLayouts();
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void MipmapGenerator::createSinglePassLayouts()
+{
+    const array<VkDescriptorSetLayoutBinding, 4> bindings {{
+        {
+            .binding = SRC_IMAGE_BINDING,
+            .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+            .descriptorCount = 1,
+            .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT
+        },
+        {
+            .binding = DST_IMAGES_BINDING,
+            .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+            .descriptorCount = MAX_PASS_LEVEL_COUNT,
+            .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT
+        },
+        {
+            .binding = MID_IMAGE_BINDING,
+            .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+            .descriptorCount = 1,
+            .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT
+        },
+        {
+            .binding = COUNTERS_BINDING,
+            .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            .descriptorCount = 1,
+            .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT
+        }
+    }};
+
+    const VkDescriptorSetLayoutCreateInfo createInfo {
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+        .bindingCount = static_cast<uint32_t>(bindings.size()),
+        .pBindings = bindings.data()
+    };
+
+    ThrowIfFailed(vkCreateDescriptorSetLayout(
+        device,
+        &createInfo,
+        nullptr,
+        &singlePassDescriptorSetLayout));
+
+    const VkPushConstantRange pushConstantRange {
+        .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+        .offset = 0,
+        .size = sizeof(SinglePassConstants)
+    };
+
+    singlePassPipelineLayout = PipelineUtil::createPipelineLayout(
+        graphicsDevice.lock(),
+        { singlePassDescriptorSetLayout },
+        { pushConstantRange });
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void MipmapGenerator::createKaiserLayouts()
+{
+    const array<VkDescriptorSetLayoutBinding, 2> bindings {{
+        {
+            .binding = SRC_IMAGE_BINDING,
+            .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+            .descriptorCount = 1,
+            .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT
+        },
+        {
+            .binding = DST_IMAGES_BINDING,
+            .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+            .descriptorCount = 1,
+            .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT
+        }
+    }};
+
+    const VkDescriptorSetLayoutCreateInfo createInfo {
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+        .bindingCount = static_cast<uint32_t>(bindings.size()),
+        .pBindings = bindings.data()
+    };
+
+    ThrowIfFailed(vkCreateDescriptorSetLayout(
+        device,
+        &createInfo,
+        nullptr,
+        &kaiserDescriptorSetLayout));
+
+    const VkPushConstantRange pushConstantRange {
+        .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+        .offset = 0,
+        .size = sizeof(KaiserConstants)
+    };
+
+    kaiserPipelineLayout = PipelineUtil::createPipelineLayout(
+        graphicsDevice.lock(),
+        { kaiserDescriptorSetLayout },
+        { pushConstantRange });
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+MipmapGenerator::~MipmapGenerator()
+{
+    for (const auto& [viewFormat, formatPipelines] : pipelines) {
+        vkDestroyPipeline(device, formatPipelines.singlePass, nullptr);
+        vkDestroyPipeline(device, formatPipelines.kaiser, nullptr);
+    }
+
+    vkDestroyPipelineLayout(device, singlePassPipelineLayout, nullptr);
+    vkDestroyDescriptorSetLayout(device, singlePassDescriptorSetLayout, nullptr);
+    vkDestroyPipelineLayout(device, kaiserPipelineLayout, nullptr);
+    vkDestroyDescriptorSetLayout(device, kaiserDescriptorSetLayout, nullptr);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+bool MipmapGenerator::isSupported(VkFormat format) const
+{
+    const auto it = formatSupport.find(format);
+
+    return it != formatSupport.end() && it->second;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+VkImageUsageFlags MipmapGenerator::getImageUsage()
+{
+    return VK_IMAGE_USAGE_STORAGE_BIT;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+VkImageCreateFlags MipmapGenerator::getImageCreateFlags(VkFormat format)
+{
+    const auto it = STORAGE_FORMATS.find(format);
+
+    // sRGB formats don't support storage usage, only their UNORM views
+    return it != STORAGE_FORMATS.end() && it->second.viewFormat != format
+        ? VK_IMAGE_CREATE_MUTABLE_FORMAT_BIT | VK_IMAGE_CREATE_EXTENDED_USAGE_BIT
+        : 0;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+MipmapGenerator::TargetPtr MipmapGenerator::createTarget(
+    const ImagePtr& image,
+    const Options& options)
+{
+    const ImageDesc& imageDesc = image->getDesc();
+    RFX_CHECK_ARGUMENT(isSupported(imageDesc.format));
+    RFX_CHECK_ARGUMENT(imageDesc.mipLevels > 0);
+
+    const StorageFormat& storageFormat = STORAGE_FORMATS.at(imageDesc.format);
+    const Pipelines& formatPipelines = getPipelines(storageFormat.viewFormat);
+
+    auto target = make_shared<Target>();
+    target->device = device;
+    target->image = image;
+    target->options = options;
+    target->options.isSrgb = options.isSrgb || storageFormat.isSrgb;
+
+    if (options.filter == Filter::KAISER) {
+        target->pipeline = formatPipelines.kaiser;
+        target->pipelineLayout = kaiserPipelineLayout;
+    }
+    else {
+        target->pipeline = formatPipelines.singlePass;
+        target->pipelineLayout = singlePassPipelineLayout;
+
+        // one counter per layer, reset by record()
+        const GraphicsDevicePtr lockedGraphicsDevice = graphicsDevice.lock();
+        RFX_CHECK_STATE(lockedGraphicsDevice != nullptr, "Graphics device already destroyed");
+        target->counterBuffer = lockedGraphicsDevice->createBuffer(
+            imageDesc.layers * sizeof(uint32_t),
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        lockedGraphicsDevice->bind(target->counterBuffer);
+    }
+
+    createLevelViews(*target, storageFormat.viewFormat);
+    createPasses(*target);
+
+    return target;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+const MipmapGenerator::Pipelines& MipmapGenerator::getPipelines(VkFormat viewFormat)
+{
+    const auto it = pipelines.find(viewFormat);
+    if (it != pipelines.end()) {
+        return it->second;
+    }
+
+    const GraphicsDevicePtr lockedGraphicsDevice = graphicsDevice.lock();
+    RFX_CHECK_STATE(lockedGraphicsDevice != nullptr, "Graphics device already destroyed");
+
+    const auto formatIt = ranges::find_if(STORAGE_FORMATS,
+        [viewFormat](const auto& entry) { return entry.second.viewFormat == viewFormat; });
+    const string formatDefine = string("IMAGE_FORMAT ") + formatIt->second.qualifier;
+
+    vector<string> singlePassDefines { formatDefine };
+    if (isSubgroupQuadSupported) {
+        singlePassDefines.emplace_back("USE_SUBGROUP_QUADS");
+    }
+
+    Pipelines formatPipelines;
+    formatPipelines.singlePass = createPipeline(
+        lockedGraphicsDevice,
+        shadersDirectory / "downsample.comp",
+        singlePassDefines,
+        singlePassPipelineLayout);
+    formatPipelines.kaiser = createPipeline(
+        lockedGraphicsDevice,
+        shadersDirectory / "downsample_kaiser.comp",
+        { formatDefine },
+        kaiserPipelineLayout);
+
+    return pipelines.emplace(viewFormat, formatPipelines).first->second;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+VkPipeline MipmapGenerator::createPipeline(
+    const GraphicsDevicePtr& graphicsDevice,
+    const path& shaderPath,
+    const vector<string>& defines,
+    VkPipelineLayout pipelineLayout)
+{
+    const ShaderLoader shaderLoader(graphicsDevice);
+    const ComputeShaderPtr computeShader = shaderLoader.loadComputeShader(shaderPath, "main", defines);
+
+    return PipelineUtil::createComputePipeline(
+        graphicsDevice,
+        pipelineLayout,
+        computeShader);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void MipmapGenerator::createLevelViews(Target& target, VkFormat viewFormat) const
+{
+    const ImageDesc& imageDesc = target.image->getDesc();
+
+    // the view of an sRGB image in UNORM format must not inherit the sampled usage of the image
+    const VkImageViewUsageCreateInfo usageCreateInfo {
+        .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_USAGE_CREATE_INFO,
+        .usage = VK_IMAGE_USAGE_STORAGE_BIT
+    };
+
+    for (uint32_t level = 0; level < imageDesc.mipLevels; ++level)
+    {
+        const VkImageViewCreateInfo createInfo {
+            .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+            .pNext = &usageCreateInfo,
+            .image = target.image->getHandle(),
+            .viewType = VK_IMAGE_VIEW_TYPE_2D_ARRAY,
+            .format = viewFormat,
+            .components = {
+                VK_COMPONENT_SWIZZLE_IDENTITY,
+                VK_COMPONENT_SWIZZLE_IDENTITY,
+                VK_COMPONENT_SWIZZLE_IDENTITY,
+                VK_COMPONENT_SWIZZLE_IDENTITY
+            },
+            .subresourceRange = {
+                .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                .baseMipLevel = level,
+                .levelCount = 1,
+                .baseArrayLayer = 0,
+                .layerCount = imageDesc.layers
+            }
+        };
+
+        VkImageView levelView = VK_NULL_HANDLE;
+        ThrowIfFailed(vkCreateImageView(
+            device,
+            &createInfo,
+            nullptr,
+            &levelView));
+
+        target.levelViews.push_back(levelView);
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void MipmapGenerator::createPasses(Target& target) const
+{
+    const ImageDesc& imageDesc = target.image->getDesc();
+
+    for (uint32_t baseLevel = 0; baseLevel + 1 < imageDesc.mipLevels;)
+    {
+        const uint32_t levelCount = getPassLevelCount(imageDesc, baseLevel, target.options.filter);
+        target.passes.push_back({
+            .baseLevel = baseLevel,
+            .levelCount = levelCount
+        });
+        baseLevel += levelCount;
+    }
+
+    if (target.passes.empty()) {
+        return;
+    }
+
+    createDescriptorPool(target);
+
+    const VkDescriptorSetLayout descriptorSetLayout = target.options.filter == Filter::KAISER
+        ? kaiserDescriptorSetLayout
+        : singlePassDescriptorSetLayout;
+    const vector<VkDescriptorSetLayout> descriptorSetLayouts(target.passes.size(), descriptorSetLayout);
+
+    const VkDescriptorSetAllocateInfo allocateInfo {
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+        .descriptorPool = target.descriptorPool,
+        .descriptorSetCount = static_cast<uint32_t>(descriptorSetLayouts.size()),
+        .pSetLayouts = descriptorSetLayouts.data()
+    };
+
+    vector<VkDescriptorSet> descriptorSets(target.passes.size());
+    ThrowIfFailed(vkAllocateDescriptorSets(
+        device,
+        &allocateInfo,
+        descriptorSets.data()));
+
+    for (size_t i = 0; i < target.passes.size(); ++i)
+    {
+        Target::Pass& pass = target.passes[i];
+        pass.descriptorSet = descriptorSets[i];
+
+        if (target.options.filter == Filter::KAISER) {
+            writeKaiserDescriptorSet(target, pass);
+        }
+        else {
+            writeSinglePassDescriptorSet(target, pass);
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void MipmapGenerator::createDescriptorPool(Target& target) const
+{
+    const auto passCount = static_cast<uint32_t>(target.passes.size());
+
+    vector<VkDescriptorPoolSize> poolSizes;
+    if (target.options.filter == Filter::KAISER) {
+        poolSizes.push_back({ VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 2 * passCount });
+    }
+    else {
+        poolSizes.push_back({ VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, (MAX_PASS_LEVEL_COUNT + 2) * passCount });
+        poolSizes.push_back({ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, passCount });
+    }
+
+    const VkDescriptorPoolCreateInfo createInfo {
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+        .maxSets = passCount,
+        .poolSizeCount = static_cast<uint32_t>(poolSizes.size()),
+        .pPoolSizes = poolSizes.data()
+    };
+
+    ThrowIfFailed(vkCreateDescriptorPool(
+        device,
+        &createInfo,
+        nullptr,
+        &target.descriptorPool));
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void MipmapGenerator::writeSinglePassDescriptorSet(const Target& target, const Target::Pass& pass) const
+{
+    const uint32_t lastLevel = pass.baseLevel + pass.levelCount;
+
+    // the shader doesn't write levels beyond the pass, their bindings just need a valid view
+    const auto getImageInfo = [&target, lastLevel](uint32_t level) {
+        return VkDescriptorImageInfo {
+            .imageView = target.levelViews[min(level, lastLevel)],
+            .imageLayout = VK_IMAGE_LAYOUT_GENERAL
+        };
+    };
+
+    const VkDescriptorImageInfo srcImageInfo = getImageInfo(pass.baseLevel);
+    const VkDescriptorImageInfo midImageInfo = getImageInfo(pass.baseLevel + 6);
+
+    array<VkDescriptorImageInfo, MAX_PASS_LEVEL_COUNT> dstImageInfos {};
+    for (uint32_t i = 0; i < MAX_PASS_LEVEL_COUNT; ++i) {
+        dstImageInfos[i] = getImageInfo(pass.baseLevel + 1 + i);
+    }
+
+    const VkDescriptorBufferInfo counterBufferInfo {
+        .buffer = target.counterBuffer->getHandle(),
+        .offset = 0,
+        .range = VK_WHOLE_SIZE
+    };
+
+    const array<VkWriteDescriptorSet, 4> writes {{
+        {
+            .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            .dstSet = pass.descriptorSet,
+            .dstBinding = SRC_IMAGE_BINDING,
+            .descriptorCount = 1,
+            .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+            .pImageInfo = &srcImageInfo
+        },
+        {
+            .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            .dstSet = pass.descriptorSet,
+            .dstBinding = DST_IMAGES_BINDING,
+            .descriptorCount = MAX_PASS_LEVEL_COUNT,
+            .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+            .pImageInfo = dstImageInfos.data()
+        },
+        {
+            .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            .dstSet = pass.descriptorSet,
+            .dstBinding = MID_IMAGE_BINDING,
+            .descriptorCount = 1,
+            .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+            .pImageInfo = &midImageInfo
+        },
+        {
+            .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            .dstSet = pass.descriptorSet,
+            .dstBinding = COUNTERS_BINDING,
+            .descriptorCount = 1,
+            .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            .pBufferInfo = &counterBufferInfo
+        }
+    }};
+
+    vkUpdateDescriptorSets(
+        device,
+        static_cast<uint32_t>(writes.size()),
+        writes.data(),
+        0,
+        nullptr);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void MipmapGenerator::writeKaiserDescriptorSet(const Target& target, const Target::Pass& pass) const
+{
+    const VkDescriptorImageInfo srcImageInfo {
+        .imageView = target.levelViews[pass.baseLevel],
+        .imageLayout = VK_IMAGE_LAYOUT_GENERAL
+    };
+
+    const VkDescriptorImageInfo dstImageInfo {
+        .imageView = target.levelViews[pass.baseLevel + 1],
+        .imageLayout = VK_IMAGE_LAYOUT_GENERAL
+    };
+
+    const array<VkWriteDescriptorSet, 2> writes {{
+        {
+            .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            .dstSet = pass.descriptorSet,
+            .dstBinding = SRC_IMAGE_BINDING,
+            .descriptorCount = 1,
+            .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+            .pImageInfo = &srcImageInfo
+        },
+        {
+            .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            .dstSet = pass.descriptorSet,
+            .dstBinding = DST_IMAGES_BINDING,
+            .descriptorCount = 1,
+            .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+            .pImageInfo = &dstImageInfo
+        }
+    }};
+
+    vkUpdateDescriptorSets(
+        device,
+        static_cast<uint32_t>(writes.size()),
+        writes.data(),
+        0,
+        nullptr);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void MipmapGenerator::record(
+    const CommandBufferPtr& commandBuffer,
+    const TargetPtr& target,
+    VkImageLayout level0Layout,
+    VkAccessFlags level0Access,
+    VkPipelineStageFlags level0Stage) const
+{
+    RFX_CHECK_ARGUMENT(commandBuffer != nullptr && target != nullptr);
+
+    const ImagePtr& image = target->image;
+    const uint32_t mipLevels = image->getDesc().mipLevels;
+    const VkCommandBuffer vkCommandBuffer = commandBuffer->getHandle();
+
+    vector<VkImageMemoryBarrier> imageBarriers {
+        createLevelBarrier(
+            image,
+            0,
+            1,
+            level0Access,
+            VK_ACCESS_SHADER_READ_BIT,
+            level0Layout,
+            VK_IMAGE_LAYOUT_GENERAL)
+    };
+    if (mipLevels > 1) {
+        // the single pass reads level 6 back, the Kaiser passes the level of the previous pass
+        imageBarriers.push_back(createLevelBarrier(
+            image,
+            1,
+            mipLevels - 1,
+            0,
+            VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+            VK_IMAGE_LAYOUT_UNDEFINED,
+            VK_IMAGE_LAYOUT_GENERAL));
+    }
+
+    vector<VkBufferMemoryBarrier> bufferBarriers;
+    if (target->counterBuffer) {
+        vkCmdFillBuffer(vkCommandBuffer, target->counterBuffer->getHandle(), 0, VK_WHOLE_SIZE, 0);
+
+        bufferBarriers.push_back({
+            .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+            .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+            .dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .buffer = target->counterBuffer->getHandle(),
+            .offset = 0,
+            .size = VK_WHOLE_SIZE
+        });
+    }
+
+    vkCmdPipelineBarrier(
+        vkCommandBuffer,
+        level0Stage | VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        0,
+        0,
+        nullptr,
+        static_cast<uint32_t>(bufferBarriers.size()),
+        bufferBarriers.data(),
+        static_cast<uint32_t>(imageBarriers.size()),
+        imageBarriers.data());
+
+    commandBuffer->bindPipeline(VK_PIPELINE_BIND_POINT_COMPUTE, target->pipeline);
+
+    for (size_t i = 0; i < target->passes.size(); ++i)
+    {
+        if (i > 0) {
+            VkMemoryBarrier memoryBarrier {
+                .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+                .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+                .dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT
+            };
+            commandBuffer->pipelineBarrier(
+                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                memoryBarrier);
+        }
+
+        if (target->options.filter == Filter::KAISER) {
+            recordKaiserPass(commandBuffer, *target, target->passes[i]);
+        }
+        else {
+            recordSinglePass(commandBuffer, *target, target->passes[i]);
+        }
+    }
+
+    const VkImageMemoryBarrier readBarrier = createLevelBarrier(
+        image,
+        0,
+        mipLevels,
+        VK_ACCESS_SHADER_WRITE_BIT,
+        VK_ACCESS_SHADER_READ_BIT,
+        VK_IMAGE_LAYOUT_GENERAL,
+        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+    vkCmdPipelineBarrier(
+        vkCommandBuffer,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        0,
+        0,
+        nullptr,
+        0,
+        nullptr,
+        1,
+        &readBarrier);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void MipmapGenerator::recordSinglePass(
+    const CommandBufferPtr& commandBuffer,
+    const Target& target,
+    const Target::Pass& pass) const
+{
+    const ImageDesc& imageDesc = target.image->getDesc();
+    const uvec2 srcSize = getLevelSize(imageDesc, pass.baseLevel);
+    const uint32_t groupCountX = (srcSize.x + TILE_SIZE - 1) / TILE_SIZE;
+    const uint32_t groupCountY = (srcSize.y + TILE_SIZE - 1) / TILE_SIZE;
+
+    const SinglePassConstants constants {
+        .srcSize = ivec2(srcSize),
+        .levelCount = pass.levelCount,
+        .workGroupCount = groupCountX * groupCountY,
+        .isSrgb = target.options.isSrgb ? 1u : 0u
+    };
+
+    commandBuffer->bindDescriptorSet(
+        VK_PIPELINE_BIND_POINT_COMPUTE,
+        target.pipelineLayout,
+        0,
+        pass.descriptorSet);
+    commandBuffer->pushConstants(
+        target.pipelineLayout,
+        VK_SHADER_STAGE_COMPUTE_BIT,
+        0,
+        sizeof(constants),
+        &constants);
+    commandBuffer->dispatch(groupCountX, groupCountY, imageDesc.layers);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void MipmapGenerator::recordKaiserPass(
+    const CommandBufferPtr& commandBuffer,
+    const Target& target,
+    const Target::Pass& pass) const
+{
+    static const vec4 weights = createKaiserWeights();
+
+    const ImageDesc& imageDesc = target.image->getDesc();
+    const uvec2 dstSize = getLevelSize(imageDesc, pass.baseLevel + 1);
+
+    const KaiserConstants constants {
+        .srcSize = ivec2(getLevelSize(imageDesc, pass.baseLevel)),
+        .dstSize = ivec2(dstSize),
+        .weights = weights,
+        .isSrgb = target.options.isSrgb ? 1u : 0u
+    };
+
+    commandBuffer->bindDescriptorSet(
+        VK_PIPELINE_BIND_POINT_COMPUTE,
+        target.pipelineLayout,
+        0,
+        pass.descriptorSet);
+    commandBuffer->pushConstants(
+        target.pipelineLayout,
+        VK_SHADER_STAGE_COMPUTE_BIT,
+        0,
+        sizeof(constants),
+        &constants);
+    commandBuffer->dispatch(
+        (dstSize.x + KAISER_GROUP_SIZE - 1) / KAISER_GROUP_SIZE,
+        (dstSize.y + KAISER_GROUP_SIZE - 1) / KAISER_GROUP_SIZE,
+        imageDesc.layers);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,149 @@
+#pragma once
+
+#include "rfx/graphics/Buffer.h"
+#include "rfx/graphics/Image.h"
+#include "rfx/graphics/CommandBuffer.h"
+
+
+namespace rfx {
+
+class GraphicsDevice;
+
+/**
+ *  Generates mip chains with compute shaders, recorded into a caller supplied command buffer:
+ *
+ *  - BOX: 2x2 box filter, single pass in the spirit of AMD FidelityFX SPD. One dispatch reduces 64x64 texel tiles
+ *    to up to six levels with subgroup quad operations (shared memory if not supported) and the work group that
+ *    finishes last continues to up to twelve levels. Images larger than 4096 texels take two or three passes.
+ *  - KAISER: 6x6 tap Kaiser windowed sinc, sharper, one dispatch per level.
+ *
+ *  Filtering of sRGB images is done in linear space. The levels are written through storage image views of the
+ *  UNORM alias, so sRGB images need the create flags from getImageCreateFlags().
+ *
+ *  Supported are RGBA8 (UNORM and SRGB), RGBA16F and RGBA32F images with the storage image format feature. Not
+ *  thread-safe.
+ */
+class MipmapGenerator
+{
+public:
+    static constexpr uint32_t MAX_PASS_LEVEL_COUNT = 12;
+
+    enum class Filter
+    {
+        BOX,
+        KAISER
+    };
+
+    struct Options
+    {
+        Filter filter = Filter::BOX;
+        bool isSrgb = false;        // filter UNORM data as sRGB, implied by sRGB formats
+    };
+
+    // image views, descriptor sets and counters of one image, must outlive the command buffers it was recorded into
+    class Target
+    {
+    public:
+        ~Target();
+
+        [[nodiscard]] const ImagePtr& getImage() const;
+
+    private:
+        friend class MipmapGenerator;
+
+        struct Pass
+        {
+            uint32_t baseLevel = 0;
+            uint32_t levelCount = 0;
+            VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+        };
+
+        VkDevice device = VK_NULL_HANDLE;
+        ImagePtr image;
+        Options options;
+        VkPipeline pipeline = VK_NULL_HANDLE;
+        VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+        VkDescriptorPool descriptorPool = VK_NULL_HANDLE;
+        std::vector<VkImageView> levelViews;
+        std::vector<Pass> passes;
+        BufferPtr counterBuffer;                        // single pass only
+    };
+
+    using TargetPtr = std::shared_ptr<Target>;
+
+    // doesn't keep the device alive, GraphicsDevice owns the generator installed with setMipmapGenerator()
+    MipmapGenerator(
+        const std::shared_ptr<GraphicsDevice>& graphicsDevice,
+        std::filesystem::path shadersDirectory);
+
+    ~MipmapGenerator();
+
+    [[nodiscard]] bool isSupported(VkFormat format) const;
+    [[nodiscard]] static VkImageUsageFlags getImageUsage();
+    [[nodiscard]] static VkImageCreateFlags getImageCreateFlags(VkFormat format);
+
+    // the image must have been created with getImageUsage() and getImageCreateFlags()
+    [[nodiscard]] TargetPtr createTarget(
+        const ImagePtr& image,
+        const Options& options);
+
+    // level 0 must be in the given layout and is read after the given access, all levels end up in
+    // VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+    void record(
+        const CommandBufferPtr& commandBuffer,
+        const TargetPtr& target,
+        VkImageLayout level0Layout,
+        VkAccessFlags level0Access,
+        VkPipelineStageFlags level0Stage) const;
+
+private:
+    struct Pipelines
+    {
+        VkPipeline singlePass = VK_NULL_HANDLE;
+        VkPipeline kaiser = VK_NULL_HANDLE;
+    };
+
+    void createSinglePassLayouts();
+    void createKaiserLayouts();
+    const Pipelines& getPipelines(VkFormat viewFormat);
+    [[nodiscard]] static VkPipeline createPipeline(
+        const std::shared_ptr<GraphicsDevice>& graphicsDevice,
+        const std::filesystem::path& shaderPath,
+        const std::vector<std::string>& defines,
+        VkPipelineLayout pipelineLayout);
+
+    void createLevelViews(Target& target, VkFormat viewFormat) const;
+    void createPasses(Target& target) const;
+    void createDescriptorPool(Target& target) const;
+    void writeSinglePassDescriptorSet(const Target& target, const Target::Pass& pass) const;
+    void writeKaiserDescriptorSet(const Target& target, const Target::Pass& pass) const;
+
+    void recordSinglePass(
+        const CommandBufferPtr& commandBuffer,
+        const Target& target,
+        const Target::Pass& pass) const;
+
+    void recordKaiserPass(
+        const CommandBufferPtr& commandBuffer,
+        const Target& target,
+        const Target::Pass& pass) const;
+
+
+    std::weak_ptr<GraphicsDevice> graphicsDevice;
+    VkDevice device = VK_NULL_HANDLE;
+    std::filesystem::path shadersDirectory;
+    bool isSubgroupQuadSupported = false;
+    std::unordered_map<VkFormat, bool> formatSupport;
+
+    VkDescriptorSetLayout singlePassDescriptorSetLayout = VK_NULL_HANDLE;
+    VkPipelineLayout singlePassPipelineLayout = VK_NULL_HANDLE;
+    VkDescriptorSetLayout kaiserDescriptorSetLayout = VK_NULL_HANDLE;
+    VkPipelineLayout kaiserPipelineLayout = VK_NULL_HANDLE;
+
+    // by storage view format, created on first use
+    std::unordered_map<VkFormat, Pipelines> pipelines;
+};
+
+using MipmapGeneratorPtr = std::shared_ptr<MipmapGenerator>;
+
+} // namespace rfx
@@ -0,0 +1,183 @@
+#include "rfx/pch.h"
+#include "rfx/graphics/PipelineCache.h"
+#include "rfx/common/Logger.h"
+
+using namespace rfx;
+using namespace std;
+using namespace filesystem;
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+PipelineCache::PipelineCache(
+    VkDevice device,
+    const VkPhysicalDeviceProperties& deviceProperties)
+        : device(device),
+          deviceProperties(deviceProperties)
+{
+    const VkPipelineCacheCreateInfo createInfo {
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO
+    };
+
+    ThrowIfFailed(vkCreatePipelineCache(
+        device,
+        &createInfo,
+        nullptr,
+        &pipelineCache));
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+PipelineCache::~PipelineCache()
+{
+    vkDestroyPipelineCache(device, pipelineCache, nullptr);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void PipelineCache::load(const path& filePath)
+{
+    error_code error;
+    const uintmax_t fileSize = file_size(filePath, error);
+    if (error) {
+        return;
+    }
+
+    vector<byte> cacheData(fileSize);
+
+    ifstream file(filePath, ios::binary);
+    if (!file.read(reinterpret_cast<char*>(cacheData.data()), static_cast<streamsize>(fileSize))
+        || !isCompatible(cacheData)) {
+        RFX_LOG_WARNING << "Ignoring pipeline cache " << filePath << ", it was created by another device or driver";
+        return;
+    }
+
+    const VkPipelineCacheCreateInfo createInfo {
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+        .initialDataSize = cacheData.size(),
+        .pInitialData = cacheData.data()
+    };
+
+    VkPipelineCache loadedPipelineCache = VK_NULL_HANDLE;
+    ThrowIfFailed(vkCreatePipelineCache(
+        device,
+        &createInfo,
+        nullptr,
+        &loadedPipelineCache));
+
+    const VkResult result = vkMergePipelineCaches(device, pipelineCache, 1, &loadedPipelineCache);
+    vkDestroyPipelineCache(device, loadedPipelineCache, nullptr);
+    ThrowIfFailed(result);
+
+    RFX_LOG_INFO << "Loaded pipeline cache " << filePath << " (" << cacheData.size() / 1024 << " KiB)";
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+bool PipelineCache::isCompatible(const vector<byte>& cacheData) const
+{
+    VkPipelineCacheHeaderVersionOne header {};
+    if (cacheData.size() < sizeof(header)) {
+        return false;
+    }
+
+    memcpy(&header, cacheData.data(), sizeof(header));
+
+    return header.headerSize >= sizeof(header)
+        && header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE
+        && header.vendorID == deviceProperties.vendorID
+        && header.deviceID == deviceProperties.deviceID
+        && memcmp(header.pipelineCacheUUID, deviceProperties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void PipelineCache::save(const path& filePath) const
+{
+    size_t dataSize = 0;
+    ThrowIfFailed(vkGetPipelineCacheData(device, pipelineCache, &dataSize, nullptr));
+
+    vector<byte> cacheData(dataSize);
+    ThrowIfFailed(vkGetPipelineCacheData(device, pipelineCache, &dataSize, cacheData.data()));
+
+    error_code error;
+    create_directories(filePath.parent_path(), error);
+
+    path temporaryPath = filePath;
+    temporaryPath += ".tmp";
+    {
+        ofstream file(temporaryPath, ios::binary | ios::trunc);
+        if (!file.write(reinterpret_cast<const char*>(cacheData.data()), static_cast<streamsize>(dataSize))) {
+            RFX_LOG_WARNING << "Failed to write pipeline cache " << temporaryPath;
+            file.close();
+            remove(temporaryPath, error);
+            return;
+        }
+    }
+
+    rename(temporaryPath, filePath, error);
+    if (error) {
+        RFX_LOG_WARNING << "Failed to save pipeline cache " << filePath << ": " << error.message();
+        remove(temporaryPath, error);
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+VkPipelineCache PipelineCache::getHandle() const
+{
+    return pipelineCache;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void PipelineCache::addCreation(
+    chrono::nanoseconds creationTime,
+    const VkPipelineCreationFeedbackEXT* feedback)
+{
+    lock_guard lock(statsMutex);
+
+    if (feedback != nullptr && (feedback->flags & VK_PIPELINE_CREATION_FEEDBACK_VALID_BIT_EXT)) {
+        creationTime = chrono::nanoseconds(feedback->duration);
+        stats.feedbackCount++;
+        if (feedback->flags & VK_PIPELINE_CREATION_FEEDBACK_APPLICATION_PIPELINE_CACHE_HIT_BIT_EXT) {
+            stats.cacheHitCount++;
+        }
+    }
+
+    stats.pipelineCount++;
+    stats.totalCreationTime += creationTime;
+    stats.maxCreationTime = max(stats.maxCreationTime, creationTime);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+PipelineCreationStats PipelineCache::getStats() const
+{
+    lock_guard lock(statsMutex);
+
+    return stats;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void PipelineCache::logStats() const
+{
+    const PipelineCreationStats currentStats = getStats();
+    if (currentStats.pipelineCount == 0) {
+        return;
+    }
+
+    RFX_LOG_INFO << "Pipelines: "
+                 << currentStats.pipelineCount << " created in "
+                 << fmt::format("{:.2f} ms (max {:.2f} ms)",
+                        chrono::duration<double, milli>(currentStats.totalCreationTime).count(),
+                        chrono::duration<double, milli>(currentStats.maxCreationTime).count());
+
+    if (currentStats.feedbackCount > 0) {
+        RFX_LOG_INFO << "Pipelines: "
+                     << currentStats.cacheHitCount << " of " << currentStats.feedbackCount
+                     << " hit the pipeline cache";
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
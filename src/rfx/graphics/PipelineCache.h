@@ -0,0 +1,65 @@
+#pragma once
+
+#include <mutex>
+
+
+namespace rfx {
+
+struct PipelineCreationStats
+{
+    uint32_t pipelineCount = 0;
+    uint32_t feedbackCount = 0;             // pipelines created with VK_EXT_pipeline_creation_feedback
+    uint32_t cacheHitCount = 0;             // reported by the driver, only known for pipelines with feedback
+    std::chrono::nanoseconds totalCreationTime {};
+    std::chrono::nanoseconds maxCreationTime {};
+};
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  Device owned VkPipelineCache that can be persisted between runs.
+ *
+ *  load() merges a previously saved cache - the data is only used if its header matches vendor, device and pipeline
+ *  cache UUID of the current device, otherwise the driver would just reject it or, worse, misinterpret it.
+ *  save() writes to a temporary file first and renames it, so an interrupted save never leaves a truncated cache.
+ */
+class PipelineCache
+{
+public:
+    PipelineCache(
+        VkDevice device,
+        const VkPhysicalDeviceProperties& deviceProperties);
+
+    ~PipelineCache();
+
+    PipelineCache(const PipelineCache&) = delete;
+    PipelineCache& operator=(const PipelineCache&) = delete;
+
+    void load(const std::filesystem::path& filePath);
+    void save(const std::filesystem::path& filePath) const;
+
+    [[nodiscard]] VkPipelineCache getHandle() const;
+
+    // creationTime is measured by the caller and replaced by the driver reported duration if feedback is valid;
+    // feedback is null if the device doesn't support VK_EXT_pipeline_creation_feedback
+    void addCreation(
+        std::chrono::nanoseconds creationTime,
+        const VkPipelineCreationFeedbackEXT* feedback);
+
+    [[nodiscard]] PipelineCreationStats getStats() const;
+    void logStats() const;
+
+private:
+    [[nodiscard]] bool isCompatible(const std::vector<std::byte>& cacheData) const;
+
+    VkDevice device = VK_NULL_HANDLE;
+    VkPhysicalDeviceProperties deviceProperties {};
+    VkPipelineCache pipelineCache = VK_NULL_HANDLE;
+
+    PipelineCreationStats stats;
+    mutable std::mutex statsMutex;
+};
+
+using PipelineCachePtr = std::shared_ptr<PipelineCache>;
+
+} // namespace rfx
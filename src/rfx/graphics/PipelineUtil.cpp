@@ -8,14 +8,15 @@ using namespace std;
 
 VkPipelineLayout PipelineUtil::createPipelineLayout(
     const GraphicsDevicePtr& graphicsDevice,
-    const vector<VkDescriptorSetLayout>& descriptorSetLayouts)
+    const vector<VkDescriptorSetLayout>& descriptorSetLayouts,
+    const vector<VkPushConstantRange>& pushConstantRanges)
 {
     VkPipelineLayoutCreateInfo pipelineLayoutInfo = {
         .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
         .setLayoutCount = static_cast<uint32_t>(descriptorSetLayouts.size()),
         .pSetLayouts = descriptorSetLayouts.data(),
-        .pushConstantRangeCount = 0,
-        .pPushConstantRanges = nullptr
+        .pushConstantRangeCount = static_cast<uint32_t>(pushConstantRanges.size()),
+        .pPushConstantRanges = pushConstantRanges.data()
     };
 
     VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
@@ -137,6 +138,28 @@ VkPipelineDynamicStateCreateInfo PipelineUtil::getDynamicState(const vector<VkDy
 
 // ---------------------------------------------------------------------------------------------------------------------
 
+bool PipelineUtil::isCreationFeedbackEnabled(const GraphicsDevicePtr& graphicsDevice)
+{
+    return graphicsDevice->isExtensionEnabled(VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+VkPipelineCreationFeedbackCreateInfoEXT PipelineUtil::getCreationFeedbackCreateInfo(
+    VkPipelineCreationFeedbackEXT* pipelineFeedback,
+    VkPipelineCreationFeedbackEXT* stageFeedbacks,
+    uint32_t stageCount)
+{
+    return {
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_CREATION_FEEDBACK_CREATE_INFO_EXT,
+        .pPipelineCreationFeedback = pipelineFeedback,
+        .pipelineStageCreationFeedbackCount = stageCount,
+        .pPipelineStageCreationFeedbacks = stageFeedbacks
+    };
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
 VkPipeline PipelineUtil::createGraphicsPipeline(
     const GraphicsDevicePtr& graphicsDevice,
     VkPipelineLayout pipelineLayout,
@@ -174,15 +197,31 @@ VkPipeline PipelineUtil::createGraphicsPipeline(
         .basePipelineIndex = -1 // Optional
     };
 
+    VkPipelineCreationFeedbackEXT pipelineFeedback {};
+    array<VkPipelineCreationFeedbackEXT, 2> stageFeedbacks {};
+    const VkPipelineCreationFeedbackCreateInfoEXT feedbackCreateInfo =
+        getCreationFeedbackCreateInfo(&pipelineFeedback, stageFeedbacks.data(), static_cast<uint32_t>(stageFeedbacks.size()));
+    const bool isFeedbackEnabled = isCreationFeedbackEnabled(graphicsDevice);
+    if (isFeedbackEnabled) {
+        pipelineCreateInfo.pNext = &feedbackCreateInfo;
+    }
+
+    const PipelineCachePtr& pipelineCache = graphicsDevice->getPipelineCache();
+    const auto startTime = chrono::steady_clock::now();
+
     VkPipeline pipeline = VK_NULL_HANDLE;
     ThrowIfFailed(vkCreateGraphicsPipelines(
         graphicsDevice->getLogicalDevice(),
-        VK_NULL_HANDLE, // TODO: pipeline cache
+        pipelineCache->getHandle(),
         1,
         &pipelineCreateInfo,
         nullptr,
         &pipeline));
 
+    pipelineCache->addCreation(
+        chrono::steady_clock::now() - startTime,
+        isFeedbackEnabled ? &pipelineFeedback : nullptr);
+
 
     // TODO: move wireframe pipeline creation to somewhere else
 //    rasterizationState.polygonMode = VK_POLYGON_MODE_LINE;
@@ -215,15 +254,31 @@ VkPipeline PipelineUtil::createComputePipeline(
         .layout = pipelineLayout
     };
 
+    VkPipelineCreationFeedbackEXT pipelineFeedback {};
+    VkPipelineCreationFeedbackEXT stageFeedback {};
+    const VkPipelineCreationFeedbackCreateInfoEXT feedbackCreateInfo =
+        getCreationFeedbackCreateInfo(&pipelineFeedback, &stageFeedback, 1);
+    const bool isFeedbackEnabled = isCreationFeedbackEnabled(graphicsDevice);
+    if (isFeedbackEnabled) {
+        pipelineCreateInfo.pNext = &feedbackCreateInfo;
+    }
+
+    const PipelineCachePtr& pipelineCache = graphicsDevice->getPipelineCache();
+    const auto startTime = chrono::steady_clock::now();
+
     VkPipeline pipeline = VK_NULL_HANDLE;
     ThrowIfFailed(vkCreateComputePipelines(
         graphicsDevice->getLogicalDevice(),
-        nullptr,
+        pipelineCache->getHandle(),
         1,
         &pipelineCreateInfo,
         nullptr,
         &pipeline));
 
+    pipelineCache->addCreation(
+        chrono::steady_clock::now() - startTime,
+        isFeedbackEnabled ? &pipelineFeedback : nullptr);
+
     return pipeline;
 }
 
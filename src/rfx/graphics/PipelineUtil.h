@@ -14,7 +14,8 @@ public:
 
     static VkPipelineLayout createPipelineLayout(
         const GraphicsDevicePtr& graphicsDevice,
-        const std::vector<VkDescriptorSetLayout>& descriptorSetLayouts);
+        const std::vector<VkDescriptorSetLayout>& descriptorSetLayouts,
+        const std::vector<VkPushConstantRange>& pushConstantRanges = {});
 
     static VkPipelineInputAssemblyStateCreateInfo getDefaultInputAssemblyState();
     static VkPipelineRasterizationStateCreateInfo getDefaultRasterizationState();
@@ -44,6 +45,13 @@ public:
         const GraphicsDevicePtr& graphicsDevice,
         VkPipelineLayout pipelineLayout,
         const ComputeShaderPtr& computeShader);
+
+private:
+    static bool isCreationFeedbackEnabled(const GraphicsDevicePtr& graphicsDevice);
+    static VkPipelineCreationFeedbackCreateInfoEXT getCreationFeedbackCreateInfo(
+        VkPipelineCreationFeedbackEXT* pipelineFeedback,
+        VkPipelineCreationFeedbackEXT* stageFeedbacks,
+        uint32_t stageCount);
 };
 
 } // namespace rfx
@@ -0,0 +1,216 @@
+#include "rfx/pch.h"
+#include "rfx/graphics/ShaderCache.h"
+#include "rfx/graphics/ShaderCompiler.h"
+#include "rfx/common/Sha256.h"
+#include "rfx/common/Logger.h"
+
+#include <thread>
+
+using namespace rfx;
+using namespace std;
+using namespace filesystem;
+
+static constexpr uint32_t SPIRV_MAGIC_NUMBER = 0x07230203;
+static const path ENTRY_EXTENSION = ".spv";
+static const path TEMPORARY_EXTENSION = ".tmp";
+
+// younger temporary files may belong to a writer of another process that is still at work
+static constexpr chrono::hours STALE_TEMPORARY_FILE_AGE { 1 };
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+ShaderCache::ShaderCache(
+    path directory,
+    uintmax_t maxSize)
+        : directory(move(directory)),
+          maxSize(maxSize)
+{
+    create_directories(this->directory);
+
+    lock_guard lock(mutex);
+    evict();
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+string ShaderCache::createKey(
+    VkShaderStageFlagBits stage,
+    const char* entryPoint,
+    const string& preprocessedSource)
+{
+    const string compilerOptions = getCompilerOptionsKey();
+
+    // the terminating null characters separate the variable length fields
+    Sha256 sha256;
+    sha256.update(compilerOptions.c_str(), compilerOptions.size() + 1);
+    sha256.update(&stage, sizeof(stage));
+    sha256.update(entryPoint, strlen(entryPoint) + 1);
+    sha256.update(preprocessedSource);
+
+    return Sha256::toHexString(sha256.finish());
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+bool ShaderCache::load(const string& key, vector<uint32_t>& outSpirv) const
+{
+    const path entryPath = getEntryPath(key);
+
+    error_code error;
+    const uintmax_t entrySize = file_size(entryPath, error);
+    if (error || entrySize == 0 || entrySize % sizeof(uint32_t) != 0) {
+        return false;
+    }
+
+    outSpirv.resize(entrySize / sizeof(uint32_t));
+
+    ifstream file(entryPath, ios::binary);
+    if (!file.read(reinterpret_cast<char*>(outSpirv.data()), static_cast<streamsize>(entrySize))
+        || outSpirv[0] != SPIRV_MAGIC_NUMBER) {
+        outSpirv.clear();
+        return false;
+    }
+
+    // the modification time serves as last use time for the eviction
+    last_write_time(entryPath, file_time_type::clock::now(), error);
+
+    return true;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void ShaderCache::store(const string& key, const vector<uint32_t>& spirv)
+{
+    RFX_CHECK_ARGUMENT(!spirv.empty());
+
+    const path entryPath = getEntryPath(key);
+    const uintmax_t entrySize = spirv.size() * sizeof(uint32_t);
+
+    // unique per writer - the rename below publishes the complete entry at once
+    ostringstream temporaryFileName;
+    temporaryFileName << key << "." << this_thread::get_id()
+        << "." << chrono::steady_clock::now().time_since_epoch().count() << TEMPORARY_EXTENSION.string();
+    const path temporaryPath = directory / temporaryFileName.str();
+
+    error_code error;
+    {
+        ofstream file(temporaryPath, ios::binary | ios::trunc);
+        if (!file.write(reinterpret_cast<const char*>(spirv.data()), static_cast<streamsize>(entrySize))) {
+            RFX_LOG_WARNING << "Failed to write shader cache entry " << temporaryPath;
+            file.close();
+            remove(temporaryPath, error);
+            return;
+        }
+    }
+
+    const bool isReplacing = exists(entryPath, error);
+
+    rename(temporaryPath, entryPath, error);
+    if (error) {
+        RFX_LOG_WARNING << "Failed to store shader cache entry " << entryPath << ": " << error.message();
+        remove(temporaryPath, error);
+        return;
+    }
+
+    lock_guard lock(mutex);
+
+    if (!isReplacing) {
+        size += entrySize;
+    }
+    if (size > maxSize) {
+        evict();
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void ShaderCache::clear()
+{
+    lock_guard lock(mutex);
+
+    error_code error;
+    for (const auto& entry : directory_iterator(directory, error)) {
+        if (entry.path().extension() == ENTRY_EXTENSION) {
+            remove(entry.path(), error);
+        }
+    }
+
+    size = 0;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+path ShaderCache::getEntryPath(const string& key) const
+{
+    return directory / (key + ENTRY_EXTENSION.string());
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void ShaderCache::evict()
+{
+    struct Entry
+    {
+        path filePath;
+        uintmax_t size = 0;
+        file_time_type lastUsed;
+    };
+
+    vector<Entry> entries;
+    error_code error;
+
+    // rescan, other processes may share the directory
+    size = 0;
+    for (const auto& directoryEntry : directory_iterator(directory, error))
+    {
+        // left behind by writers that crashed between writing and renaming
+        if (directoryEntry.path().extension() == TEMPORARY_EXTENSION) {
+            error_code timeError;
+            const file_time_type lastWrite = directoryEntry.last_write_time(timeError);
+            if (!timeError && file_time_type::clock::now() - lastWrite > STALE_TEMPORARY_FILE_AGE) {
+                remove(directoryEntry.path(), timeError);
+            }
+            continue;
+        }
+
+        if (directoryEntry.path().extension() != ENTRY_EXTENSION) {
+            continue;
+        }
+
+        error_code sizeError;
+        error_code timeError;
+        Entry entry {
+            .filePath = directoryEntry.path(),
+            .size = directoryEntry.file_size(sizeError),
+            .lastUsed = directoryEntry.last_write_time(timeError)
+        };
+        if (!sizeError && !timeError) {
+            size += entry.size;
+            entries.push_back(move(entry));
+        }
+    }
+
+    if (size <= maxSize) {
+        return;
+    }
+
+    // trim below the limit, so that a full cache isn't rescanned on every store
+    const uintmax_t targetSize = maxSize / 4 * 3;
+
+    ranges::sort(entries, {}, &Entry::lastUsed);
+
+    for (const Entry& entry : entries)
+    {
+        if (size <= targetSize) {
+            break;
+        }
+
+        if (remove(entry.filePath, error)) {
+            size -= entry.size;
+        }
+    }
+
+    RFX_LOG_INFO << "Shader cache trimmed to " << size << " bytes";
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
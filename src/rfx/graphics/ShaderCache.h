@@ -0,0 +1,49 @@
+#pragma once
+
+#include <mutex>
+
+
+namespace rfx {
+
+/**
+ *  Content addressed on-disk cache of compiled SPIR-V.
+ *
+ *  Entries are keyed by the SHA-256 of the fully preprocessed source, stage, entry point and compiler options, so
+ *  a changed include or define simply produces a new key. Entries are written to a temporary file and renamed, which
+ *  keeps concurrent readers (and other processes) from seeing partial files. When the cache grows beyond its size
+ *  limit, the least recently used entries are evicted - hits refresh the modification time. Temporary files older
+ *  than an hour, left behind by crashed writers, are removed when the cache is opened or trimmed.
+ */
+class ShaderCache
+{
+public:
+    static constexpr uintmax_t DEFAULT_MAX_SIZE = 64 * 1024 * 1024;
+
+    explicit ShaderCache(
+        std::filesystem::path directory,
+        uintmax_t maxSize = DEFAULT_MAX_SIZE);
+
+    [[nodiscard]] static std::string createKey(
+        VkShaderStageFlagBits stage,
+        const char* entryPoint,
+        const std::string& preprocessedSource);
+
+    // returns false on a miss or an unusable entry
+    [[nodiscard]] bool load(const std::string& key, std::vector<uint32_t>& outSpirv) const;
+    void store(const std::string& key, const std::vector<uint32_t>& spirv);
+
+    void clear();
+
+private:
+    [[nodiscard]] std::filesystem::path getEntryPath(const std::string& key) const;
+    void evict();
+
+    std::filesystem::path directory;
+    uintmax_t maxSize = 0;
+    uintmax_t size = 0;
+    mutable std::mutex mutex;
+};
+
+using ShaderCachePtr = std::shared_ptr<ShaderCache>;
+
+} // namespace rfx
@@ -19,6 +19,46 @@ string addLineNumbersTo(const string& shaderString);
 
 // ---------------------------------------------------------------------------------------------------------------------
 
+static constexpr int GLSL_DEFAULT_VERSION = 450;
+static constexpr EShClient CLIENT = EShClientVulkan;
+static constexpr EShTargetClientVersion CLIENT_VERSION = EShTargetVulkan_1_2;
+static constexpr EShTargetLanguage TARGET_LANGUAGE = EShTargetSpv;
+// SPIR-V 1.3 or later is required by the subgroup operations
+static constexpr EShTargetLanguageVersion TARGET_LANGUAGE_VERSION = EShTargetSpv_1_5;
+
+#ifdef _DEBUG
+static constexpr auto MESSAGES = static_cast<EShMessages>(
+    EShMsgDefault | EShMsgDebugInfo | EShMsgSpvRules | EShMsgVulkanRules);
+#else
+static constexpr auto MESSAGES = static_cast<EShMessages>(EShMsgSpvRules | EShMsgVulkanRules);
+#endif
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+static SpvOptions createSpvOptions()
+{
+    SpvOptions options;
+#ifdef _DEBUG
+    options.generateDebugInfo = true;
+    options.stripDebugInfo = false;
+    options.disableOptimizer = true;
+    options.optimizeSize = false;
+    options.disassemble = true;
+    options.validate = true;
+#else
+    options.generateDebugInfo = false;
+    options.stripDebugInfo = true;
+    options.disableOptimizer = false;
+    options.optimizeSize = true;
+    options.disassemble = false;
+    options.validate = false;
+#endif
+
+    return options;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
 void GLSLtoSPV(
     const VkShaderStageFlagBits shaderType,
     const char* shaderString,
@@ -34,12 +74,11 @@ void GLSLtoSPV(
     shaderStrings[0] = shaderString;
     shader.setStrings(shaderStrings, 1);
 
-#ifdef _DEBUG
-    auto messages = static_cast<EShMessages>(EShMsgDefault | EShMsgDebugInfo | EShMsgSpvRules | EShMsgVulkanRules);
-#else
-    auto messages = static_cast<EShMessages>(EShMsgSpvRules | EShMsgVulkanRules);
-#endif
-    if (!shader.parse(&resources, 450, false, messages)) {
+    shader.setEnvInput(EShSourceGlsl, language, CLIENT, 100);
+    shader.setEnvClient(CLIENT, CLIENT_VERSION);
+    shader.setEnvTarget(TARGET_LANGUAGE, TARGET_LANGUAGE_VERSION);
+
+    if (!shader.parse(&resources, GLSL_DEFAULT_VERSION, false, MESSAGES)) {
         RFX_THROW("\nShader: \n\n" + addLineNumbersTo(string(shaderString))
             + StringUtil::trimRight(string(shader.getInfoLog()))
             + "\nInfo Log: " + string(shader.getInfoDebugLog()));
@@ -48,27 +87,12 @@ void GLSLtoSPV(
     TProgram program;
     program.addShader(&shader);
 
-    if (!program.link(messages)) {
+    if (!program.link(MESSAGES)) {
         RFX_THROW(StringUtil::trimRight(string(shader.getInfoLog())) 
             + "\nInfo Log: " + string(shader.getInfoDebugLog()));
     }
 
-    SpvOptions options;
-#ifdef _DEBUG
-    options.generateDebugInfo = true;
-    options.stripDebugInfo = false;
-    options.disableOptimizer = true;
-    options.optimizeSize = false;
-    options.disassemble = true;
-    options.validate = true;
-#else
-    options.generateDebugInfo = false;
-    options.stripDebugInfo = true;
-    options.disableOptimizer = false;
-    options.optimizeSize = true;
-    options.disassemble = false;
-    options.validate = false;
-#endif
+    SpvOptions options = createSpvOptions();
 
     TIntermediate* pIntermediate = program.getIntermediate(language);
     GlslangToSpv(*pIntermediate, spirv, &options);
@@ -76,6 +100,32 @@ void GLSLtoSPV(
 
 // ---------------------------------------------------------------------------------------------------------------------
 
+string getCompilerOptionsKey()
+{
+    // built from the values GLSLtoSPV() passes to glslang, so that changing any of them or updating glslang
+    // invalidates cached SPIR-V
+    const Version version = GetVersion();
+    const SpvOptions options = createSpvOptions();
+
+    return fmt::format("glslang-{}.{}.{}{}/glsl{}/client{}-{:#x}/target{}-{:#x}/messages{:#x}/spv{}{}{}{}",
+        version.major,
+        version.minor,
+        version.patch,
+        version.flavor,
+        GLSL_DEFAULT_VERSION,
+        static_cast<int>(CLIENT),
+        static_cast<uint32_t>(CLIENT_VERSION),
+        static_cast<int>(TARGET_LANGUAGE),
+        static_cast<uint32_t>(TARGET_LANGUAGE_VERSION),
+        static_cast<uint32_t>(MESSAGES),
+        options.generateDebugInfo ? 1 : 0,
+        options.stripDebugInfo ? 1 : 0,
+        options.disableOptimizer ? 1 : 0,
+        options.optimizeSize ? 1 : 0);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
 string addLineNumbersTo(const string& shaderString)
 {
     istringstream iss;
@@ -5,6 +5,9 @@
 namespace rfx
 {
     void GLSLtoSPV(VkShaderStageFlagBits shaderType, const char* shaderString, std::vector<uint32_t>& spirv);
+
+    // identifies the glslang version and the options used by GLSLtoSPV()
+    std::string getCompilerOptionsKey();
 } // namespace rfx
 
 // ---------------------------------------------------------------------------------------------------------------------
\ No newline at end of file
@@ -95,7 +95,7 @@ VkPipelineShaderStageCreateInfo ShaderLoader::loadInternal(
     if (extension != ".spv") {
         insertIncludedFiles(path.parent_path(), shaderString);
         configure(defines, inputs, outputs, shaderString);
-        GLSLtoSPV(stage, shaderString.c_str(), shaderSPV);
+        compile(stage, entryPoint, shaderString, shaderSPV);
     }
     else {
         shaderSPV.resize(shaderString.size() / 4);
@@ -130,6 +130,29 @@ VkPipelineShaderStageCreateInfo ShaderLoader::loadInternal(
 
 // ---------------------------------------------------------------------------------------------------------------------
 
+void ShaderLoader::compile(
+    VkShaderStageFlagBits stage,
+    const char* entryPoint,
+    const string& preprocessedShaderString,
+    vector<uint32_t>& outShaderSPV) const
+{
+    const ShaderCachePtr& shaderCache = graphicsDevice->getShaderCache();
+    if (!shaderCache) {
+        GLSLtoSPV(stage, preprocessedShaderString.c_str(), outShaderSPV);
+        return;
+    }
+
+    const string cacheKey = ShaderCache::createKey(stage, entryPoint, preprocessedShaderString);
+    if (shaderCache->load(cacheKey, outShaderSPV)) {
+        return;
+    }
+
+    GLSLtoSPV(stage, preprocessedShaderString.c_str(), outShaderSPV);
+    shaderCache->store(cacheKey, outShaderSPV);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
 void ShaderLoader::configure(
     const vector<string>& defines,
     const vector<string>& inputs,
@@ -218,11 +241,21 @@ shared_ptr<FragmentShader> ShaderLoader::loadFragmentShader(
 ComputeShaderPtr ShaderLoader::loadComputeShader(
     const path& path,
     const char* entryPoint) const
+{
+    return loadComputeShader(path, entryPoint, {});
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+ComputeShaderPtr ShaderLoader::loadComputeShader(
+    const path& path,
+    const char* entryPoint,
+    const vector<string>& defines) const
 {
     RFX_LOG_INFO << "Loading compute shader " << path.filename() << " ...";
 
     const VkPipelineShaderStageCreateInfo shaderStageCreateInfo =
-        loadInternal(path, VK_SHADER_STAGE_COMPUTE_BIT, entryPoint, {}, {}, {});
+        loadInternal(path, VK_SHADER_STAGE_COMPUTE_BIT, entryPoint, defines, {}, {});
 
     return make_shared<ComputeShader>(
         graphicsDevice->getLogicalDevice(),
@@ -49,6 +49,12 @@ public:
         const std::filesystem::path& path,
         const char* entryPoint) const;
 
+    [[nodiscard]]
+    ComputeShaderPtr loadComputeShader(
+        const std::filesystem::path& path,
+        const char* entryPoint,
+        const std::vector<std::string>& defines) const;
+
 private:
     VkPipelineShaderStageCreateInfo loadInternal(
         const std::filesystem::path& path,
@@ -58,6 +64,12 @@ private:
         const std::vector<std::string>& inputs,
         const std::vector<std::string>& outputs) const;
 
+    void compile(
+        VkShaderStageFlagBits stage,
+        const char* entryPoint,
+        const std::string& preprocessedShaderString,
+        std::vector<uint32_t>& outShaderSPV) const;
+
     static void configure(
         const std::vector<std::string>& defines,
         const std::vector<std::string>& inputs,
@@ -2,7 +2,12 @@
 #include "rfx/graphics/TextureLoader.h"
 #include "rfx/graphics/ImageLoader.h"
 #include "rfx/common/Math.h"
+#include "rfx/common/ThreadPool.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#define RFX_TEXTURE_LOADER_SSE
+#include <emmintrin.h>
+#endif
 
 using namespace rfx;
 using namespace glm;
@@ -16,58 +21,193 @@ static const string HDR_FILE_EXTENSION = ".hdr";
 
 // ---------------------------------------------------------------------------------------------------------------------
 
-vec3 faceCoordsToXYZ(int i, int j, int faceID, int faceSize)
+namespace {
+
+struct CubeMapFace
 {
-    const float A = 2.0f * static_cast<float>(i) / static_cast<float>(faceSize);
-    const float B = 2.0f * static_cast<float>(j) / static_cast<float>(faceSize);
+    vec3 normal;
+    vec3 columnAxis;
+    vec3 rowAxis;
+};
+
+// panorama directions (z up) of the cube map faces, in layer order
+const CubeMapFace CUBE_MAP_FACES[] = {
+    { {  0.0f, -1.0f,  0.0f }, {  1.0f,  0.0f,  0.0f }, {  0.0f,  0.0f, -1.0f } },
+    { {  0.0f,  1.0f,  0.0f }, { -1.0f,  0.0f,  0.0f }, {  0.0f,  0.0f, -1.0f } },
+    { {  0.0f,  0.0f,  1.0f }, {  0.0f, -1.0f,  0.0f }, { -1.0f,  0.0f,  0.0f } },
+    { {  0.0f,  0.0f, -1.0f }, {  0.0f, -1.0f,  0.0f }, {  1.0f,  0.0f,  0.0f } },
+    { { -1.0f,  0.0f,  0.0f }, {  0.0f, -1.0f,  0.0f }, {  0.0f,  0.0f, -1.0f } },
+    { {  1.0f,  0.0f,  0.0f }, {  0.0f,  1.0f,  0.0f }, {  0.0f,  0.0f, -1.0f } }
+};
+
+constexpr uint32_t SIMD_WIDTH = 4;
+constexpr uint32_t ROWS_PER_TASK = 16;
 
-    if (faceID == 0) return { -1.0f, A - 1.0f, B - 1.0f };
-    if (faceID == 1) return { A - 1.0f, -1.0f, 1.0f - B };
-    if (faceID == 2) return { 1.0f, A - 1.0f, 1.0f - B };
-    if (faceID == 3) return { 1.0f - A, 1.0f, 1.0f - B };
-    if (faceID == 4) return { B - 1.0f, A - 1.0f, 1.0f };
-    if (faceID == 5) return { 1.0f - B, A - 1.0f, -1.0f };
+// ---------------------------------------------------------------------------------------------------------------------
 
-    return {};
+#ifdef RFX_TEXTURE_LOADER_SSE
+__m128 blend(__m128 mask, __m128 a, __m128 b)
+{
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
 
-vec4 getPixelFloat(
-    int x,
-    int y,
-    const ImageDesc& imageDesc,
-    const vector<std::byte>& imageData)
+// polynomial from the Cephes atanf, after reducing the argument to [-tan(pi/8), tan(pi/8)]
+__m128 packedAtan2(__m128 y, __m128 x)
 {
-    const uint32_t offset = imageDesc.channels * (y * imageDesc.width + x);
-    const auto data = reinterpret_cast<const float*>(imageData.data());
-
-    return {
-        imageDesc.channels > 0 ? data[offset + 0] : 0.0f,
-        imageDesc.channels > 1 ? data[offset + 1] : 0.0f,
-        imageDesc.channels > 2 ? data[offset + 2] : 0.0f,
-        imageDesc.channels > 3 ? data[offset + 3] : 0.0f
-    };
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 absX = _mm_andnot_ps(signMask, x);
+    const __m128 absY = _mm_andnot_ps(signMask, y);
+
+    __m128 r = _mm_div_ps(
+        _mm_min_ps(absX, absY),
+        _mm_max_ps(_mm_max_ps(absX, absY), _mm_set1_ps(numeric_limits<float>::min())));
+
+    const __m128 reduce = _mm_cmpgt_ps(r, _mm_set1_ps(0.41421356f));
+    r = blend(reduce, _mm_div_ps(_mm_sub_ps(r, one), _mm_add_ps(r, one)), r);
+
+    const __m128 z = _mm_mul_ps(r, r);
+    __m128 p = _mm_set1_ps(8.05374449538e-2f);
+    p = _mm_sub_ps(_mm_mul_ps(p, z), _mm_set1_ps(1.38776856032e-1f));
+    p = _mm_add_ps(_mm_mul_ps(p, z), _mm_set1_ps(1.99777106478e-1f));
+    p = _mm_sub_ps(_mm_mul_ps(p, z), _mm_set1_ps(3.33329491539e-1f));
+
+    __m128 angle = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_mul_ps(p, z), r), r),
+        _mm_and_ps(reduce, _mm_set1_ps(Math::PI / 4.0f)));
+    angle = blend(_mm_cmpgt_ps(absY, absX), _mm_sub_ps(_mm_set1_ps(Math::PI / 2.0f), angle), angle);
+    angle = blend(_mm_cmplt_ps(x, _mm_setzero_ps()), _mm_sub_ps(_mm_set1_ps(Math::PI), angle), angle);
+
+    return _mm_or_ps(angle, _mm_and_ps(y, signMask));
 }
+#endif // RFX_TEXTURE_LOADER_SSE
 
 // ---------------------------------------------------------------------------------------------------------------------
 
-void setPixelFloat(
-    int x,
-    int y,
-    const vec4& c,
-    const ImageDesc& imageDesc,
-    vector<std::byte>* outImageData)
+// panorama coordinates of SIMD_WIDTH consecutive texels of a face row, relative to the panorama texel centers
+void getPanoramaCoords(
+    const CubeMapFace& face,
+    uint32_t faceSize,
+    uint32_t row,
+    uint32_t firstColumn,
+    const ImageDesc& panoramaDesc,
+    float* outU,
+    float* outV)
 {
-    const uint32_t offset = imageDesc.channels * (y * imageDesc.width + x);
-    const auto data = reinterpret_cast<float*>(outImageData->data());
+    const float texelSize = 2.0f / static_cast<float>(faceSize);
+    const float v = (static_cast<float>(row) + 0.5f) * texelSize - 1.0f;
+    const vec3 rowOrigin = face.normal + face.rowAxis * v;
+    const float uScale = static_cast<float>(panoramaDesc.width) / Math::TWO_PI;
+    const float vScale = static_cast<float>(panoramaDesc.height) / Math::PI;
+
+#ifdef RFX_TEXTURE_LOADER_SSE
+    const __m128 u = _mm_sub_ps(
+        _mm_mul_ps(
+            _mm_add_ps(_mm_set1_ps(static_cast<float>(firstColumn) + 0.5f), _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f)),
+            _mm_set1_ps(texelSize)),
+        _mm_set1_ps(1.0f));
+    const __m128 x = _mm_add_ps(_mm_set1_ps(rowOrigin.x), _mm_mul_ps(u, _mm_set1_ps(face.columnAxis.x)));
+    const __m128 y = _mm_add_ps(_mm_set1_ps(rowOrigin.y), _mm_mul_ps(u, _mm_set1_ps(face.columnAxis.y)));
+    const __m128 z = _mm_add_ps(_mm_set1_ps(rowOrigin.z), _mm_mul_ps(u, _mm_set1_ps(face.columnAxis.z)));
+
+    const __m128 theta = packedAtan2(y, x);
+    const __m128 phi = packedAtan2(z, _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y))));
+    const __m128 half = _mm_set1_ps(0.5f);
+
+    _mm_storeu_ps(outU, _mm_sub_ps(
+        _mm_mul_ps(_mm_add_ps(theta, _mm_set1_ps(Math::PI)), _mm_set1_ps(uScale)), half));
+    _mm_storeu_ps(outV, _mm_sub_ps(
+        _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(Math::PI / 2.0f), phi), _mm_set1_ps(vScale)), half));
+#else
+    for (uint32_t i = 0; i < SIMD_WIDTH; ++i)
+    {
+        const float u = (static_cast<float>(firstColumn + i) + 0.5f) * texelSize - 1.0f;
+        const vec3 direction = rowOrigin + face.columnAxis * u;
+        const float theta = std::atan2(direction.y, direction.x);
+        const float phi = std::atan2(direction.z, hypot(direction.x, direction.y));
+
+        outU[i] = (theta + Math::PI) * uScale - 0.5f;
+        outV[i] = (Math::PI / 2.0f - phi) * vScale - 0.5f;
+    }
+#endif // RFX_TEXTURE_LOADER_SSE
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+// bilinear RGBA sample, wrapping around horizontally
+void samplePanorama(
+    const float* panorama,
+    const ImageDesc& panoramaDesc,
+    float u,
+    float v,
+    float* outTexel)
+{
+    const auto width = static_cast<int>(panoramaDesc.width);
+    const auto height = static_cast<int>(panoramaDesc.height);
+
+    // u and v are >= -0.5, so truncation after adding one floors them
+    const int u0 = static_cast<int>(u + 1.0f) - 1;
+    const int v0 = static_cast<int>(v + 1.0f) - 1;
+    const float s = u - static_cast<float>(u0);
+    const float t = v - static_cast<float>(v0);
+
+    const int x0 = u0 < 0 ? u0 + width : (u0 >= width ? u0 - width : u0);
+    const int x1 = x0 + 1 < width ? x0 + 1 : 0;
+    const int y0 = glm::clamp(v0, 0, height - 1);
+    const int y1 = glm::clamp(v0 + 1, 0, height - 1);
+
+    const float* a = panorama + (static_cast<size_t>(y0) * width + x0) * 4;
+    const float* b = panorama + (static_cast<size_t>(y0) * width + x1) * 4;
+    const float* c = panorama + (static_cast<size_t>(y1) * width + x0) * 4;
+    const float* d = panorama + (static_cast<size_t>(y1) * width + x1) * 4;
+
+#ifdef RFX_TEXTURE_LOADER_SSE
+    const __m128 weightS = _mm_set1_ps(s);
+    const __m128 top = _mm_add_ps(_mm_loadu_ps(a), _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(b), _mm_loadu_ps(a)), weightS));
+    const __m128 bottom = _mm_add_ps(_mm_loadu_ps(c), _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(d), _mm_loadu_ps(c)), weightS));
+    _mm_storeu_ps(outTexel, _mm_add_ps(top, _mm_mul_ps(_mm_sub_ps(bottom, top), _mm_set1_ps(t))));
+#else
+    for (uint32_t i = 0; i < 4; ++i) {
+        const float top = a[i] + (b[i] - a[i]) * s;
+        const float bottom = c[i] + (d[i] - c[i]) * s;
+        outTexel[i] = top + (bottom - top) * t;
+    }
+#endif // RFX_TEXTURE_LOADER_SSE
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void convertFaceRows(
+    const float* panorama,
+    const ImageDesc& panoramaDesc,
+    uint32_t faceSize,
+    uint32_t face,
+    uint32_t firstRow,
+    uint32_t rowCount,
+    float* outFaces)
+{
+    // padded to a multiple of the SIMD width
+    const uint32_t paddedFaceSize = (faceSize + SIMD_WIDTH - 1) / SIMD_WIDTH * SIMD_WIDTH;
+    vector<float> u(paddedFaceSize);
+    vector<float> v(paddedFaceSize);
+
+    for (uint32_t row = firstRow; row < firstRow + rowCount; ++row)
+    {
+        for (uint32_t column = 0; column < faceSize; column += SIMD_WIDTH) {
+            getPanoramaCoords(CUBE_MAP_FACES[face], faceSize, row, column, panoramaDesc, &u[column], &v[column]);
+        }
 
-    if (imageDesc.channels > 0) data[offset + 0] = c.x;
-    if (imageDesc.channels > 1) data[offset + 1] = c.y;
-    if (imageDesc.channels > 2) data[offset + 2] = c.z;
-    if (imageDesc.channels > 3) data[offset + 3] = c.w;
+        float* texel = outFaces + ((static_cast<size_t>(face) * faceSize + row) * faceSize) * 4;
+        for (uint32_t column = 0; column < faceSize; ++column) {
+            samplePanorama(panorama, panoramaDesc, u[column], v[column], texel);
+            texel += 4;
+        }
+    }
 }
 
+} // namespace
+
 // ---------------------------------------------------------------------------------------------------------------------
 
 TextureLoader::TextureLoader(GraphicsDevicePtr graphicsDevice)
@@ -236,210 +376,107 @@ CubeMapPtr TextureLoader::loadCubeMap(const path& filePath) const
 {
     ImageDesc imageDesc {};
     vector<std::byte> imageData;
-    bool createMipmaps = false;
 
-    const string extension = filePath.extension().string();
-    const ImageChannelType imageChannelType =
-        extension == HDR_FILE_EXTENSION
-            ? ImageChannelType::FLOAT
-            : ImageChannelType::UNSIGNED_BYTE;
-
-    loadImage(
+    loadCubeMapImage(
         filePath,
-        imageChannelType,
         imageDesc,
-        imageData,
-        createMipmaps);
-
-    if (extension == HDR_FILE_EXTENSION) {
-        ImageDesc verticalCrossImageDesc {};
-        vector<std::byte> verticalCrossImageData;
-        convertEquiRectangularMapToVerticalCross(
-            imageDesc,
-            imageData,
-            &verticalCrossImageDesc,
-            &verticalCrossImageData);
-
-        convertVerticalCrossToCubeMapFaces(
-            verticalCrossImageDesc,
-            verticalCrossImageData,
-            &imageDesc,
-            &imageData);
-
-        createMipmaps = true;
-    }
-
+        imageData);
 
     return graphicsDevice->createCubeMap(
         filePath.filename().string(),
         imageDesc,
         imageData,
-        createMipmaps);
+        filePath.extension().string() != KTX_FILE_EXTENSION);
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
 
-void TextureLoader::convertEquiRectangularMapToVerticalCross(
-    const ImageDesc& inImageDesc,
-    const vector<std::byte>& inImageData,
-    ImageDesc* outImageDesc,
-    vector<std::byte>* outImageData) const
+void TextureLoader::loadCubeMapImage(
+    const path& filePath,
+    ImageDesc& outImageDesc,
+    vector<std::byte>& outImageData) const
 {
-    const int faceSize = inImageDesc.width / 4;
+    bool createMipmaps = false;
 
-    const int width = faceSize * 3;
-    const int height = faceSize * 4;
+    const string extension = filePath.extension().string();
+    const ImageChannelType imageChannelType =
+        extension == HDR_FILE_EXTENSION
+            ? ImageChannelType::FLOAT
+            : ImageChannelType::UNSIGNED_BYTE;
 
-    *outImageDesc = inImageDesc;
-    outImageDesc->width = width;
-    outImageDesc->height = height;
+    loadImage(
+        filePath,
+        imageChannelType,
+        outImageDesc,
+        outImageData,
+        createMipmaps);
 
-    const size_t outImageDataSize = width * height * 4 * sizeof(float);
-    outImageData->resize(outImageDataSize);
+    if (extension == HDR_FILE_EXTENSION) {
+        ImageDesc cubeMapImageDesc {};
+        vector<std::byte> cubeMapImageData;
+        convertEquiRectangularMapToCubeMapFaces(
+            outImageDesc,
+            outImageData,
+            &cubeMapImageDesc,
+            &cubeMapImageData);
 
-    const ivec2 kFaceOffsets[] =
-        {
-            ivec2(faceSize, faceSize * 3),
-            ivec2(0, faceSize),
-            ivec2(faceSize, faceSize),
-            ivec2(faceSize * 2, faceSize),
-            ivec2(faceSize, 0),
-            ivec2(faceSize, faceSize * 2)
-        };
-
-    const int clampW = static_cast<int>(inImageDesc.width - 1);
-    const int clampH = static_cast<int>(inImageDesc.height - 1);
-
-    for (int face = 0; face < 6; ++face)
-    {
-        for (int i = 0; i < faceSize; ++i)
-        {
-            for (int j = 0; j < faceSize; ++j)
-            {
-                const vec3 P = faceCoordsToXYZ(i, j, face, faceSize);
-                const float R = hypot(P.x, P.y);
-                const float theta = atan2(P.y, P.x);
-                const float phi = atan2(P.z, R);
-                //	float point source coordinates
-                const float Uf = 2.0f * static_cast<float>(faceSize) * (theta + Math::PI) / Math::PI;
-                const float Vf = 2.0f * static_cast<float>(faceSize) * (Math::PI / 2.0f - phi) / Math::PI;
-                // 4-samples for bilinear interpolation
-                const int U1 = glm::clamp(int(floor(Uf)), 0, clampW);
-                const int V1 = glm::clamp(int(floor(Vf)), 0, clampH);
-                const int U2 = glm::clamp(U1 + 1, 0, clampW);
-                const int V2 = glm::clamp(V1 + 1, 0, clampH);
-                // fractional part
-                const float s = Uf - static_cast<float>(U1);
-                const float t = Vf - static_cast<float>(V1);
-                // fetch 4-samples
-                const vec4 A = getPixelFloat(U1, V1, inImageDesc, inImageData);
-                const vec4 B = getPixelFloat(U2, V1, inImageDesc, inImageData);
-                const vec4 C = getPixelFloat(U1, V2, inImageDesc, inImageData);
-                const vec4 D = getPixelFloat(U2, V2, inImageDesc, inImageData);
-                // bilinear interpolation
-                const vec4 color = A * (1 - s) * (1 - t) + B * (s) * (1 - t) + C * (1 - s) * t + D * (s) * (t);
-                setPixelFloat(
-                    i + kFaceOffsets[face].x,
-                    j + kFaceOffsets[face].y,
-                    color,
-                    *outImageDesc,
-                    outImageData);
-            }
-        }
+        outImageDesc = move(cubeMapImageDesc);
+        outImageData = move(cubeMapImageData);
     }
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
 
-void TextureLoader::convertVerticalCrossToCubeMapFaces(
+void TextureLoader::convertEquiRectangularMapToCubeMapFaces(
     const ImageDesc& inImageDesc,
-    const std::vector<std::byte>& inImageData,
+    const vector<std::byte>& inImageData,
     ImageDesc* outImageDesc,
     vector<std::byte>* outImageData) const
 {
-    const int faceWidth = inImageDesc.width / 3;
-    const int faceHeight = inImageDesc.height / 4;
+    RFX_CHECK_ARGUMENT(inImageDesc.channels == 4 && inImageDesc.bytesPerPixel == 4 * sizeof(float));
+    RFX_CHECK_ARGUMENT(inImageDesc.width >= 4 && inImageDesc.height > 0);
+
+    const uint32_t faceSize = inImageDesc.width / 4;
 
     *outImageDesc = inImageDesc;
-    outImageDesc->width = faceWidth;
-    outImageDesc->height = faceHeight;
+    outImageDesc->width = faceSize;
+    outImageDesc->height = faceSize;
     outImageDesc->layers = 6;
     outImageDesc->isCubemap = true;
 
-    outImageData->resize(faceWidth * faceHeight * 6 * inImageDesc.bytesPerPixel);
-
-
-    auto src = reinterpret_cast<const uint8_t*>(inImageData.data());
-    auto dst = reinterpret_cast<uint8_t*>(outImageData->data());
-
-    /*
-            ------
-            | +Y |
-       ----------------
-       | -X | -Z | +X |
-       ----------------
-            | -Y |
-            ------
-            | +Z |
-            ------
-    */
-
-    const uint32_t pixelSize = inImageDesc.bytesPerPixel;
-
-    for (int face = 0; face < 6; ++face)
-    {
-        for (int j = 0; j < faceHeight; ++j)
-        {
-            for (int i = 0; i < faceWidth; ++i)
-            {
-                int x = 0;
-                int y = 0;
-
-                switch (face)
-                {
-                    // GL_TEXTURE_CUBE_MAP_POSITIVE_X
-                    case 0:
-                        x = i;
-                        y = faceHeight + j;
-                        break;
-
-                        // GL_TEXTURE_CUBE_MAP_NEGATIVE_X
-                    case 1:
-                        x = 2 * faceWidth + i;
-                        y = 1 * faceHeight + j;
-                        break;
-
-                        // GL_TEXTURE_CUBE_MAP_POSITIVE_Y
-                    case 2:
-                        x = 2 * faceWidth - (i + 1);
-                        y = 1 * faceHeight - (j + 1);
-                        break;
-
-                        // GL_TEXTURE_CUBE_MAP_NEGATIVE_Y
-                    case 3:
-                        x = 2 * faceWidth - (i + 1);
-                        y = 3 * faceHeight - (j + 1);
-                        break;
-
-                        // GL_TEXTURE_CUBE_MAP_POSITIVE_Z
-                    case 4:
-                        x = 2 * faceWidth - (i + 1);
-                        y = inImageDesc.height - (j + 1);
-                        break;
-
-                        // GL_TEXTURE_CUBE_MAP_NEGATIVE_Z
-                    case 5:
-                        x = faceWidth + i;
-                        y = faceHeight + j;
-                        break;
-                }
-
-                memcpy(dst, src + (y * inImageDesc.width + x) * pixelSize, pixelSize);
-
-                dst += pixelSize;
-            }
+    outImageData->resize(static_cast<size_t>(faceSize) * faceSize * 6 * inImageDesc.bytesPerPixel);
+
+    const auto panorama = reinterpret_cast<const float*>(inImageData.data());
+    const auto faces = reinterpret_cast<float*>(outImageData->data());
+    const uint32_t tasksPerFace = (faceSize + ROWS_PER_TASK - 1) / ROWS_PER_TASK;
+
+    ThreadPool threadPool(std::min(ThreadPool::getDefaultThreadCount(), 6 * tasksPerFace));
+
+    vector<future<void>> tasks;
+    tasks.reserve(6 * tasksPerFace);
+
+    for (uint32_t face = 0; face < 6; ++face) {
+        for (uint32_t firstRow = 0; firstRow < faceSize; firstRow += ROWS_PER_TASK) {
+            tasks.push_back(threadPool.submit([&inImageDesc, panorama, faceSize, face, firstRow, faces] {
+                convertFaceRows(
+                    panorama,
+                    inImageDesc,
+                    faceSize,
+                    face,
+                    firstRow,
+                    std::min(ROWS_PER_TASK, faceSize - firstRow),
+                    faces);
+            }));
         }
     }
+
+    // wait for all tasks before rethrowing, they reference the image data
+    for (auto& task : tasks) {
+        task.wait();
+    }
+    for (auto& task : tasks) {
+        task.get();
+    }
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
@@ -20,6 +20,12 @@ public:
     [[nodiscard]]
     CubeMapPtr loadCubeMap(const std::filesystem::path& filePath) const;
 
+    // the faces in layer order - HDR panoramas are converted to RGBA32F faces without mip levels
+    void loadCubeMapImage(
+        const std::filesystem::path& filePath,
+        ImageDesc& outImageDesc,
+        std::vector<std::byte>& outImageData) const;
+
 private:
 #pragma pack(push, 4)
     struct KTXHeader {
@@ -59,13 +65,8 @@ private:
         ImageDesc& outImageDesc,
         std::vector<std::byte>& outImageData) const;
 
-    void convertEquiRectangularMapToVerticalCross(
-        const ImageDesc& inImageDesc,
-        const std::vector<std::byte>& inImageData,
-        ImageDesc* outImageDesc,
-        std::vector<std::byte>* outImageData) const;
-
-    void convertVerticalCrossToCubeMapFaces(
+    // bilinearly samples the six faces directly from the panorama, in parallel rows of SIMD batches
+    void convertEquiRectangularMapToCubeMapFaces(
         const ImageDesc& inImageDesc,
         const std::vector<std::byte>& inImageData,
         ImageDesc* outImageDesc,
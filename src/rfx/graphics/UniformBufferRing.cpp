@@ -0,0 +1,76 @@
+#include "rfx/pch.h"
+#include "rfx/graphics/UniformBufferRing.h"
+#include "rfx/common/Math.h"
+
+using namespace rfx;
+using namespace std;
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+UniformBufferRing::UniformBufferRing(
+    const GraphicsDevicePtr& graphicsDevice,
+    VkDeviceSize frameCapacity,
+    uint32_t frameCount)
+        : alignment(graphicsDevice->getDesc().properties.limits.minUniformBufferOffsetAlignment),
+          frameCount(frameCount)
+{
+    RFX_CHECK_ARGUMENT(frameCount > 0);
+
+    this->frameCapacity = getAlignedSize(max<VkDeviceSize>(frameCapacity, 1));
+
+    buffer = graphicsDevice->createBuffer(
+        this->frameCapacity * frameCount,
+        VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    graphicsDevice->bind(buffer);
+
+    mappedData = static_cast<std::byte*>(buffer->getMappedData());
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void UniformBufferRing::beginFrame(uint32_t frameIndex)
+{
+    RFX_CHECK_ARGUMENT(frameIndex < frameCount);
+
+    frameStart = frameIndex * frameCapacity;
+    head = frameStart;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+uint32_t UniformBufferRing::push(const void* data, VkDeviceSize size)
+{
+    const VkDeviceSize alignedSize = getAlignedSize(size);
+    RFX_CHECK_STATE(head + alignedSize <= frameStart + frameCapacity, "Uniform buffer ring frame capacity exceeded");
+
+    memcpy(mappedData + head, data, size);
+
+    const auto offset = static_cast<uint32_t>(head);
+    head += alignedSize;
+
+    return offset;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+VkDeviceSize UniformBufferRing::getAlignedSize(VkDeviceSize size) const
+{
+    return Math::alignUp(size, alignment);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+VkDeviceSize UniformBufferRing::getAlignedSize(const GraphicsDevice& graphicsDevice, VkDeviceSize size)
+{
+    return Math::alignUp(size, graphicsDevice.getDesc().properties.limits.minUniformBufferOffsetAlignment);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+const BufferPtr& UniformBufferRing::getBuffer() const
+{
+    return buffer;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "rfx/graphics/GraphicsDevice.h"
+
+
+namespace rfx {
+
+/**
+ *  Persistently mapped uniform buffer that is divided into one region per frame in flight. Per-draw data is appended
+ *  to the region of the current frame by bumping an offset; the returned offsets are meant to be used as dynamic
+ *  offsets of a VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC descriptor that points at the start of the buffer.
+ */
+class UniformBufferRing
+{
+public:
+    UniformBufferRing(
+        const GraphicsDevicePtr& graphicsDevice,
+        VkDeviceSize frameCapacity,
+        uint32_t frameCount);
+
+    // the frame's previous submission must have completed
+    void beginFrame(uint32_t frameIndex);
+
+    [[nodiscard]] uint32_t push(const void* data, VkDeviceSize size);
+
+    template<typename T>
+    [[nodiscard]] uint32_t push(const T& data)
+    {
+        return push(&data, sizeof(T));
+    }
+
+    [[nodiscard]] VkDeviceSize getAlignedSize(VkDeviceSize size) const;
+
+    // for sizing the frame capacity before a ring exists
+    [[nodiscard]] static VkDeviceSize getAlignedSize(const GraphicsDevice& graphicsDevice, VkDeviceSize size);
+    [[nodiscard]] const BufferPtr& getBuffer() const;
+
+private:
+    BufferPtr buffer;
+    std::byte* mappedData = nullptr;
+    VkDeviceSize alignment = 0;
+    VkDeviceSize frameCapacity = 0;
+    uint32_t frameCount = 0;
+    VkDeviceSize frameStart = 0;
+    VkDeviceSize head = 0;
+};
+
+using UniformBufferRingPtr = std::shared_ptr<UniformBufferRing>;
+
+} // namespace rfx
@@ -0,0 +1,575 @@
+#include "rfx/pch.h"
+#include "rfx/graphics/UploadQueue.h"
+#include "rfx/common/Math.h"
+
+
+using namespace rfx;
+using namespace std;
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+UploadQueue::UploadQueue(
+    VkDevice device,
+    QueuePtr queue,
+    BufferPtr stagingBuffer,
+    function<BufferPtr(VkDeviceSize)> stagingBufferFactory)
+        : device(device),
+          queue(move(queue)),
+          stagingBuffer(move(stagingBuffer)),
+          stagingBufferFactory(move(stagingBufferFactory))
+{
+    RFX_CHECK_ARGUMENT(this->stagingBuffer->getMappedData() != nullptr);
+
+    createCommandPool(this->queue->getFamilyIndex());
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void UploadQueue::createCommandPool(uint32_t queueFamilyIndex)
+{
+    const VkCommandPoolCreateInfo poolInfo {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+        .flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
+        .queueFamilyIndex = queueFamilyIndex
+    };
+
+    ThrowIfFailed(vkCreateCommandPool(
+        device,
+        &poolInfo,
+        nullptr,
+        &commandPool));
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+UploadQueue::~UploadQueue()
+{
+    if (hasPendingWork) {
+        submit();
+    }
+    wait(lastSubmittedTicket);
+
+    for (VkFence fence : freeFences) {
+        vkDestroyFence(device, fence, nullptr);
+    }
+
+    // command buffers are freed together with their pool
+    vkDestroyCommandPool(device, commandPool, nullptr);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void UploadQueue::uploadBuffer(
+    const BufferPtr& buffer,
+    const void* data,
+    VkDeviceSize size,
+    VkDeviceSize destOffset)
+{
+    RFX_CHECK_ARGUMENT(destOffset + size <= buffer->getSize());
+
+    const auto [sourceBuffer, sourceOffset] = allocateStaging(size, 16);
+    memcpy(static_cast<std::byte*>(sourceBuffer->getMappedData()) + sourceOffset, data, size);
+
+    const VkBufferCopy copyRegion {
+        .srcOffset = sourceOffset,
+        .dstOffset = destOffset,
+        .size = size
+    };
+
+    vkCmdCopyBuffer(
+        getCommandBuffer()->getHandle(),
+        sourceBuffer->getHandle(),
+        buffer->getHandle(),
+        1,
+        &copyRegion);
+
+    hasPendingBufferCopies = true;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BufferPtr UploadQueue::createStagingBuffer(VkDeviceSize size) const
+{
+    return stagingBufferFactory(size);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void UploadQueue::uploadBuffer(
+    const BufferPtr& buffer,
+    const BufferPtr& filledStagingBuffer,
+    VkDeviceSize size,
+    VkDeviceSize destOffset)
+{
+    RFX_CHECK_ARGUMENT(size <= filledStagingBuffer->getSize());
+    RFX_CHECK_ARGUMENT(destOffset + size <= buffer->getSize());
+
+    const VkBufferCopy copyRegion {
+        .srcOffset = 0,
+        .dstOffset = destOffset,
+        .size = size
+    };
+
+    vkCmdCopyBuffer(
+        getCommandBuffer()->getHandle(),
+        filledStagingBuffer->getHandle(),
+        buffer->getHandle(),
+        1,
+        &copyRegion);
+
+    recordingTemporaryBuffers.push_back(filledStagingBuffer);
+    hasPendingBufferCopies = true;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void UploadQueue::setMipmapGenerator(MipmapGeneratorPtr mipmapGenerator)
+{
+    this->mipmapGenerator = move(mipmapGenerator);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+const MipmapGeneratorPtr& UploadQueue::getMipmapGenerator() const
+{
+    return mipmapGenerator;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void UploadQueue::uploadImage(
+    const ImagePtr& image,
+    const void* data,
+    VkDeviceSize size,
+    bool isGenerateMipmaps)
+{
+    const ImageDesc& imageDesc = image->getDesc();
+
+    // buffer offsets of image copies must be a multiple of the texel size and of 4
+    const VkDeviceSize alignment = lcm<VkDeviceSize>(16, max(imageDesc.bytesPerPixel, 1U));
+    const auto [sourceBuffer, sourceOffset] = allocateStaging(size, alignment);
+    memcpy(static_cast<std::byte*>(sourceBuffer->getMappedData()) + sourceOffset, data, size);
+
+    vector<VkBufferImageCopy> imageCopies;
+
+    // mipLevels is the level count of the image, mipOffsets only lists the levels contained in data
+    RFX_CHECK_ARGUMENT(!imageDesc.mipOffsets.empty() && imageDesc.mipOffsets.size() <= imageDesc.mipLevels);
+    const uint32_t mipLevelCount = isGenerateMipmaps
+        ? 1
+        : static_cast<uint32_t>(imageDesc.mipOffsets.size());
+
+    for (uint32_t mipLevel = 0; mipLevel < mipLevelCount; ++mipLevel) {
+        imageCopies.push_back({
+            .bufferOffset = sourceOffset + imageDesc.mipOffsets[mipLevel],
+            .imageSubresource {
+                .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                .mipLevel = mipLevel,
+                .baseArrayLayer = 0,
+                .layerCount = imageDesc.layers
+            },
+            .imageExtent {
+                .width = imageDesc.width >> mipLevel,
+                .height = imageDesc.height >> mipLevel,
+                .depth = 1
+            }
+        });
+    }
+
+    const CommandBufferPtr& commandBuffer = getCommandBuffer();
+
+    commandBuffer->setImageMemoryBarrier(
+        image,
+        0,
+        VK_ACCESS_TRANSFER_WRITE_BIT,
+        VK_IMAGE_LAYOUT_UNDEFINED,
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+        VK_PIPELINE_STAGE_TRANSFER_BIT);
+
+    commandBuffer->copyBufferToImage(sourceBuffer, image, imageCopies);
+
+    if (isGenerateMipmaps && mipmapGenerator && mipmapGenerator->isSupported(imageDesc.format)) {
+        MipmapGenerator::TargetPtr mipmapTarget = mipmapGenerator->createTarget(image, {});
+        mipmapGenerator->record(
+            commandBuffer,
+            mipmapTarget,
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            VK_ACCESS_TRANSFER_WRITE_BIT,
+            VK_PIPELINE_STAGE_TRANSFER_BIT);
+        recordingMipmapTargets.push_back(move(mipmapTarget));
+    }
+    else if (isGenerateMipmaps) {
+        recordMipmapGeneration(image);
+    }
+    else {
+        commandBuffer->setImageMemoryBarrier(
+            image,
+            VK_ACCESS_TRANSFER_WRITE_BIT,
+            VK_ACCESS_SHADER_READ_BIT,
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void UploadQueue::recordMipmapGeneration(const ImagePtr& image) const
+{
+    const ImageDesc& imageDesc = image->getDesc();
+    const VkCommandBuffer commandBuffer = recordingCommandBuffer->getHandle();
+
+    VkImageMemoryBarrier barrier {
+        .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .image = image->getHandle(),
+        .subresourceRange = {
+            .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+            .levelCount = 1,
+            .baseArrayLayer = 0,
+            .layerCount = imageDesc.layers
+        }
+    };
+
+    auto mipWidth = static_cast<int32_t>(imageDesc.width);
+    auto mipHeight = static_cast<int32_t>(imageDesc.height);
+
+    for (uint32_t i = 1; i < imageDesc.mipLevels; i++) {
+        barrier.subresourceRange.baseMipLevel = i - 1;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
+        vkCmdPipelineBarrier(
+            commandBuffer,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            0,
+            0,
+            nullptr,
+            0,
+            nullptr,
+            1,
+            &barrier);
+
+        const VkImageBlit blit {
+            .srcSubresource = {
+                .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                .mipLevel = i - 1,
+                .baseArrayLayer = 0,
+                .layerCount = imageDesc.layers,
+            },
+            .srcOffsets = {
+                { 0, 0, 0 },
+                { mipWidth, mipHeight, 1 }
+            },
+            .dstSubresource = {
+                .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                .mipLevel = i,
+                .baseArrayLayer = 0,
+                .layerCount = imageDesc.layers
+            },
+            .dstOffsets = {
+                { 0, 0, 0 },
+                { mipWidth > 1 ? mipWidth / 2 : 1, mipHeight > 1 ? mipHeight / 2 : 1, 1 }
+            }
+        };
+
+        vkCmdBlitImage(
+            commandBuffer,
+            image->getHandle(),
+            VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+            image->getHandle(),
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            1,
+            &blit,
+            VK_FILTER_LINEAR);
+
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+        vkCmdPipelineBarrier(
+            commandBuffer,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            0,
+            0,
+            nullptr,
+            0,
+            nullptr,
+            1,
+            &barrier);
+
+        if (mipWidth > 1) mipWidth /= 2;
+        if (mipHeight > 1) mipHeight /= 2;
+    }
+
+    barrier.subresourceRange.baseMipLevel = imageDesc.mipLevels - 1;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+    vkCmdPipelineBarrier(
+        commandBuffer,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        0,
+        0,
+        nullptr,
+        0,
+        nullptr,
+        1,
+        &barrier);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+const CommandBufferPtr& UploadQueue::getCommandBuffer()
+{
+    if (!recordingCommandBuffer) {
+        if (!freeCommandBuffers.empty()) {
+            recordingCommandBuffer = move(freeCommandBuffers.back());
+            freeCommandBuffers.pop_back();
+        }
+        else {
+            const VkCommandBufferAllocateInfo allocInfo {
+                .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+                .commandPool = commandPool,
+                .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+                .commandBufferCount = 1
+            };
+
+            VkCommandBuffer vkCommandBuffer = VK_NULL_HANDLE;
+            ThrowIfFailed(vkAllocateCommandBuffers(
+                device,
+                &allocInfo,
+                &vkCommandBuffer));
+
+            recordingCommandBuffer = make_shared<CommandBuffer>(device, vkCommandBuffer);
+        }
+
+        recordingCommandBuffer->begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+    }
+
+    hasPendingWork = true;
+
+    return recordingCommandBuffer;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+VkFence UploadQueue::acquireFence()
+{
+    if (!freeFences.empty()) {
+        VkFence fence = freeFences.back();
+        freeFences.pop_back();
+        return fence;
+    }
+
+    const VkFenceCreateInfo createInfo {
+        .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO
+    };
+
+    VkFence fence = VK_NULL_HANDLE;
+    ThrowIfFailed(vkCreateFence(
+        device,
+        &createInfo,
+        nullptr,
+        &fence));
+
+    return fence;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+pair<BufferPtr, VkDeviceSize> UploadQueue::allocateStaging(VkDeviceSize size, VkDeviceSize alignment)
+{
+    const VkDeviceSize capacity = stagingBuffer->getSize();
+
+    if (size > capacity / 2) {
+        BufferPtr temporaryBuffer = stagingBufferFactory(size);
+        recordingTemporaryBuffers.push_back(temporaryBuffer);
+        return { temporaryBuffer, 0 };
+    }
+
+    for (;;) {
+        const VkDeviceSize headOffset = ringHead % capacity;
+        VkDeviceSize offset = Math::alignUp(headOffset, alignment);
+        VkDeviceSize newHead = ringHead + (offset - headOffset) + size;
+        if (offset + size > capacity) {
+            // wrap around, the remainder of the ring is wasted until the tail passes it
+            offset = 0;
+            newHead = ringHead + (capacity - headOffset) + size;
+        }
+
+        if (newHead - ringTail <= capacity) {
+            ringHead = newHead;
+            return { stagingBuffer, offset };
+        }
+
+        makeRoom();
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void UploadQueue::makeRoom()
+{
+    retireCompleted();
+
+    if (submissions.empty()) {
+        RFX_CHECK_STATE(hasPendingWork, "Staging ring exhausted without pending uploads");
+        submit();
+    }
+
+    Submission& oldest = submissions.front();
+    ThrowIfFailed(vkWaitForFences(
+        device,
+        1,
+        &oldest.fence,
+        VK_TRUE,
+        DEFAULT_FENCE_TIMEOUT));
+
+    retireCompleted();
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+uint64_t UploadQueue::submit()
+{
+    if (!hasPendingWork) {
+        return lastSubmittedTicket;
+    }
+
+    if (hasPendingBufferCopies) {
+        VkMemoryBarrier memoryBarrier {
+            .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+            .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+            .dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT
+                | VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT
+                | VK_ACCESS_INDEX_READ_BIT
+                | VK_ACCESS_UNIFORM_READ_BIT
+                | VK_ACCESS_SHADER_READ_BIT
+        };
+        recordingCommandBuffer->pipelineBarrier(
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT
+                | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT
+                | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT
+                | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT
+                | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            memoryBarrier);
+    }
+
+    recordingCommandBuffer->end();
+
+    Submission submission {
+        .ticket = ++lastSubmittedTicket,
+        .fence = acquireFence(),
+        .commandBuffer = move(recordingCommandBuffer),
+        .ringEnd = ringHead,
+        .temporaryBuffers = move(recordingTemporaryBuffers),
+        .mipmapTargets = move(recordingMipmapTargets)
+    };
+
+    queue->submit(submission.commandBuffer, submission.fence);
+    submissions.push_back(move(submission));
+
+    recordingCommandBuffer.reset();
+    recordingTemporaryBuffers.clear();
+    recordingMipmapTargets.clear();
+    hasPendingBufferCopies = false;
+    hasPendingWork = false;
+
+    return lastSubmittedTicket;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+bool UploadQueue::isComplete(uint64_t ticket)
+{
+    retireCompleted();
+
+    return ticket <= lastCompletedTicket;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void UploadQueue::wait(uint64_t ticket)
+{
+    RFX_CHECK_ARGUMENT(ticket <= lastSubmittedTicket);
+
+    while (lastCompletedTicket < ticket) {
+        Submission& oldest = submissions.front();
+        ThrowIfFailed(vkWaitForFences(
+            device,
+            1,
+            &oldest.fence,
+            VK_TRUE,
+            DEFAULT_FENCE_TIMEOUT));
+        retireCompleted();
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void UploadQueue::flush()
+{
+    wait(submit());
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void UploadQueue::retireCompleted()
+{
+    while (!submissions.empty()
+            && vkGetFenceStatus(device, submissions.front().fence) == VK_SUCCESS) {
+        retire(submissions.front());
+        submissions.pop_front();
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void UploadQueue::retire(Submission& submission)
+{
+    ThrowIfFailed(vkResetFences(device, 1, &submission.fence));
+    freeFences.push_back(submission.fence);
+
+    ThrowIfFailed(vkResetCommandBuffer(submission.commandBuffer->getHandle(), 0));
+    freeCommandBuffers.push_back(move(submission.commandBuffer));
+
+    ringTail = submission.ringEnd;
+    lastCompletedTicket = submission.ticket;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void UploadQueue::beginBatch()
+{
+    batchDepth++;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+uint64_t UploadQueue::endBatch()
+{
+    RFX_CHECK_STATE(batchDepth > 0, "endBatch() without matching beginBatch()");
+
+    return --batchDepth == 0 ? submit() : lastSubmittedTicket;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+bool UploadQueue::isBatching() const
+{
+    return batchDepth > 0;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <deque>
+
+#include "rfx/graphics/Queue.h"
+#include "rfx/graphics/Buffer.h"
+#include "rfx/graphics/Image.h"
+#include "rfx/graphics/CommandBuffer.h"
+#include "rfx/graphics/MipmapGenerator.h"
+
+namespace rfx {
+
+/**
+ *  Batches resource uploads: source data is copied into a persistently mapped ring staging buffer and the copies
+ *  are recorded into a single command buffer, which is submitted once.
+ *
+ *  submit() returns a ticket that can be polled with isComplete() or waited on with wait(). Staging memory of a
+ *  submission is recycled as soon as its fence has signaled. Uploads larger than half the ring get a temporary
+ *  staging buffer that is released together with the submission.
+ *
+ *  Mip levels are generated with the MipmapGenerator, if one is set and supports the image format, otherwise they
+ *  are blitted level by level.
+ *
+ *  Not thread-safe - uploads must be issued from the thread that owns the queue.
+ */
+class UploadQueue
+{
+public:
+    static constexpr VkDeviceSize DEFAULT_STAGING_BUFFER_SIZE = 64 * 1024 * 1024;
+
+    UploadQueue(
+        VkDevice device,
+        QueuePtr queue,
+        BufferPtr stagingBuffer,
+        std::function<BufferPtr(VkDeviceSize)> stagingBufferFactory);
+
+    ~UploadQueue();
+
+    void uploadBuffer(
+        const BufferPtr& buffer,
+        const void* data,
+        VkDeviceSize size,
+        VkDeviceSize destOffset = 0);
+
+    // for producers that write straight into staging memory: fill the mapped buffer, then pass it to uploadBuffer()
+    [[nodiscard]] BufferPtr createStagingBuffer(VkDeviceSize size) const;
+
+    void uploadBuffer(
+        const BufferPtr& buffer,
+        const BufferPtr& filledStagingBuffer,
+        VkDeviceSize size,
+        VkDeviceSize destOffset = 0);
+
+    // optional, images with generated mip levels must have been created with its usage and flags if it supports them
+    void setMipmapGenerator(MipmapGeneratorPtr mipmapGenerator);
+    [[nodiscard]] const MipmapGeneratorPtr& getMipmapGenerator() const;
+
+    // leaves the image in VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+    void uploadImage(
+        const ImagePtr& image,
+        const void* data,
+        VkDeviceSize size,
+        bool isGenerateMipmaps);
+
+    // while batching, GraphicsDevice doesn't flush uploads on resource creation
+    void beginBatch();
+    uint64_t endBatch();
+    [[nodiscard]] bool isBatching() const;
+
+    uint64_t submit();
+    [[nodiscard]] bool isComplete(uint64_t ticket);
+    void wait(uint64_t ticket);
+    void flush();
+
+private:
+    struct Submission
+    {
+        uint64_t ticket = 0;
+        VkFence fence = VK_NULL_HANDLE;
+        CommandBufferPtr commandBuffer;
+        VkDeviceSize ringEnd = 0;
+        std::vector<BufferPtr> temporaryBuffers;
+        std::vector<MipmapGenerator::TargetPtr> mipmapTargets;
+    };
+
+    void createCommandPool(uint32_t queueFamilyIndex);
+    const CommandBufferPtr& getCommandBuffer();
+    [[nodiscard]] VkFence acquireFence();
+
+    // returns the offset into the returned buffer
+    [[nodiscard]] std::pair<BufferPtr, VkDeviceSize> allocateStaging(VkDeviceSize size, VkDeviceSize alignment);
+    void makeRoom();
+    void retire(Submission& submission);
+    void retireCompleted();
+
+    void recordMipmapGeneration(const ImagePtr& image) const;
+
+    VkDevice device = VK_NULL_HANDLE;
+    QueuePtr queue;
+    BufferPtr stagingBuffer;
+    std::function<BufferPtr(VkDeviceSize)> stagingBufferFactory;
+    MipmapGeneratorPtr mipmapGenerator;
+    VkCommandPool commandPool = VK_NULL_HANDLE;
+
+    // ring positions are monotonic, the physical offset is position % stagingBuffer->getSize()
+    VkDeviceSize ringHead = 0;
+    VkDeviceSize ringTail = 0;
+
+    CommandBufferPtr recordingCommandBuffer;
+    std::vector<BufferPtr> recordingTemporaryBuffers;
+    std::vector<MipmapGenerator::TargetPtr> recordingMipmapTargets;
+    bool hasPendingBufferCopies = false;
+    bool hasPendingWork = false;
+
+    std::deque<Submission> submissions;
+    std::vector<CommandBufferPtr> freeCommandBuffers;
+    std::vector<VkFence> freeFences;
+    uint64_t lastSubmittedTicket = 0;
+    uint64_t lastCompletedTicket = 0;
+    uint32_t batchDepth = 0;
+};
+
+using UploadQueuePtr = std::shared_ptr<UploadQueue>;
+
+} // namespace rfx
@@ -11,8 +11,9 @@ VertexBuffer::VertexBuffer(
     const VertexFormat& vertexFormat,
     VkDevice device,
     VkBuffer buffer,
-    VkDeviceMemory deviceMemory)
-        : Buffer(vertexCount * vertexFormat.getVertexSize(), device, buffer, deviceMemory),
+    const DeviceMemoryAllocation& allocation,
+    DeviceMemoryAllocatorPtr allocator)
+        : Buffer(vertexCount * vertexFormat.getVertexSize(), device, buffer, allocation, move(allocator)),
           vertexCount(vertexCount),
           vertexFormat(vertexFormat) {}
 
@@ -13,7 +13,8 @@ public:
         const VertexFormat& vertexFormat,
         VkDevice device,
         VkBuffer buffer,
-        VkDeviceMemory deviceMemory);
+        const DeviceMemoryAllocation& allocation,
+        DeviceMemoryAllocatorPtr allocator);
 
     [[nodiscard]] uint32_t getVertexCount() const;
     [[nodiscard]] const VertexFormat& getVertexFormat() const;
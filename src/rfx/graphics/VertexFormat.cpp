@@ -1,6 +1,8 @@
 #include "rfx/pch.h"
 #include "rfx/graphics/VertexFormat.h"
 
+#include <glm/gtc/packing.hpp>
+
 using namespace rfx;
 using namespace glm;
 using namespace std;
@@ -17,12 +19,16 @@ VertexFormat::VertexFormat(
     uint32_t texCoordSetCount)
 {
     RFX_CHECK_ARGUMENT(formatMask & COORDINATES);
+    RFX_CHECK_ARGUMENT(!(formatMask & PACKED_NORMALS) || (formatMask & NORMALS));
+    RFX_CHECK_ARGUMENT(!(formatMask & PACKED_TEXCOORDS) || (formatMask & TEXCOORDS));
+    RFX_CHECK_ARGUMENT(!(formatMask & PACKED_TANGENTS) || (formatMask & TANGENTS));
 
     formatMask_ = formatMask;
 
     if (formatMask & COORDINATES) {
         coordinates_ = true;
-        vertexSize_ += 12;
+        packedCoordinates_ = formatMask & PACKED_COORDINATES;
+        vertexSize_ += packedCoordinates_ ? 8 : 12;
     }
 
     if (formatMask & COLORS_3) {
@@ -36,7 +42,8 @@ VertexFormat::VertexFormat(
 
     if (formatMask & NORMALS) {
         normals_ = true;
-        vertexSize_ += 12;
+        packedNormals_ = formatMask & PACKED_NORMALS;
+        vertexSize_ += packedNormals_ ? 4 : 12;
     }
 
     if (formatMask & TEXCOORDS) {
@@ -46,12 +53,14 @@ VertexFormat::VertexFormat(
         }
         RFX_CHECK_STATE(texCoordSetCount <= MAX_TEXCOORDSET_COUNT, "Requested texture coord set count not supported yet!");
         texCoordSetCount_ = texCoordSetCount;
-        vertexSize_ += 8 * texCoordSetCount;
+        packedTexCoords_ = formatMask & PACKED_TEXCOORDS;
+        vertexSize_ += (packedTexCoords_ ? 4 : 8) * texCoordSetCount;
     }
 
     if (formatMask & TANGENTS) {
         tangents_ = true;
-        vertexSize_ += 16;
+        packedTangents_ = formatMask & PACKED_TANGENTS;
+        vertexSize_ += packedTangents_ ? 4 : 16;
     }
 }
 
@@ -125,6 +134,34 @@ bool VertexFormat::containsTangents() const
 
 // ---------------------------------------------------------------------------------------------------------------------
 
+bool VertexFormat::containsPackedCoordinates() const
+{
+    return packedCoordinates_;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+bool VertexFormat::containsPackedNormals() const
+{
+    return packedNormals_;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+bool VertexFormat::containsPackedTexCoords() const
+{
+    return packedTexCoords_;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+bool VertexFormat::containsPackedTangents() const
+{
+    return packedTangents_;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
 bool VertexFormat::operator==(const VertexFormat& rhs) const
 {
     return formatMask_ == rhs.formatMask_
@@ -132,3 +169,51 @@ bool VertexFormat::operator==(const VertexFormat& rhs) const
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
+
+static vec2 encodeOctahedral(const vec3& direction)
+{
+    const vec3 n = direction / (abs(direction.x) + abs(direction.y) + abs(direction.z));
+    if (n.z >= 0.0f) {
+        return { n.x, n.y };
+    }
+
+    // fold the lower hemisphere over the diagonals
+    return {
+        (1.0f - abs(n.y)) * (n.x >= 0.0f ? 1.0f : -1.0f),
+        (1.0f - abs(n.x)) * (n.y >= 0.0f ? 1.0f : -1.0f)
+    };
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+uint64_t VertexFormat::packCoordinates(const vec3& coordinates)
+{
+    return packHalf4x16(vec4(coordinates, 0.0f));
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+uint32_t VertexFormat::packNormal(const vec3& normal)
+{
+    return packSnorm2x16(encodeOctahedral(normal));
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+uint32_t VertexFormat::packTexCoord(const vec2& texCoord)
+{
+    return packUnorm2x16(texCoord);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+uint32_t VertexFormat::packTangent(const vec4& tangent)
+{
+    static constexpr uint32_t BITANGENT_SIGN_BIT = 1u << 16;
+
+    const uint32_t packedTangent = packNormal(vec3(tangent)) & ~BITANGENT_SIGN_BIT;
+
+    return tangent.w < 0.0f ? packedTangent | BITANGENT_SIGN_BIT : packedTangent;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
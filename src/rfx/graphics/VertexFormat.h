@@ -12,6 +12,15 @@ public:
     static const unsigned int TEXCOORDS = 16;
     static const unsigned int TANGENTS = 32;
 
+    // packed variants of the attributes above, combined with their flag
+    static const unsigned int PACKED_COORDINATES = 64;  // half floats, padded to 8 bytes
+    static const unsigned int PACKED_NORMALS = 128;     // octahedral, 2 x 16 bit snorm - see packNormal()
+    static const unsigned int PACKED_TEXCOORDS = 256;   // 2 x 16 bit unorm, only for coordinates in [0, 1]
+    static const unsigned int PACKED_TANGENTS = 512;    // octahedral + bitangent sign - see packTangent()
+
+    static const unsigned int PACKED_ATTRIBUTES =
+        PACKED_COORDINATES | PACKED_NORMALS | PACKED_TEXCOORDS | PACKED_TANGENTS;
+
     static const unsigned int MAX_TEXCOORDSET_COUNT = 8;
 
     VertexFormat();
@@ -45,8 +54,32 @@ public:
     [[nodiscard]]
     bool containsTangents() const;
 
+    [[nodiscard]]
+    bool containsPackedCoordinates() const;
+
+    [[nodiscard]]
+    bool containsPackedNormals() const;
+
+    [[nodiscard]]
+    bool containsPackedTexCoords() const;
+
+    [[nodiscard]]
+    bool containsPackedTangents() const;
+
     bool operator==(const VertexFormat& rhs) const;
 
+    // half-float x, y, z and zero w, i.e. VK_FORMAT_R16G16B16A16_SFLOAT
+    static uint64_t packCoordinates(const glm::vec3& coordinates);
+
+    // octahedral encoding as 2 x 16 bit snorm, decode with unpackSnorm2x16() in the shader
+    static uint32_t packNormal(const glm::vec3& normal);
+
+    // VK_FORMAT_R16G16_UNORM, the coordinates are clamped to [0, 1]
+    static uint32_t packTexCoord(const glm::vec2& texCoord);
+
+    // like packNormal(), the least significant bit of the second component is set for a negative bitangent sign
+    static uint32_t packTangent(const glm::vec4& tangent);
+
 private:
     uint32_t formatMask_ = 0;
     uint32_t vertexSize_ = 0;
@@ -58,6 +91,10 @@ private:
     bool texCoords_ = false;
     uint32_t texCoordSetCount_ = 0;
     bool tangents_ = false;
+    bool packedCoordinates_ = false;
+    bool packedNormals_ = false;
+    bool packedTexCoords_ = false;
+    bool packedTangents_ = false;
 };
 
 } // namespace rfx
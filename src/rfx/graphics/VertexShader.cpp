@@ -31,14 +31,17 @@ void VertexShader::createVertexInputState()
     uint32_t location = 0;
     uint32_t offset = 0;
 
+    // half float and unorm attributes are converted on fetch, packed directions are decoded by the shader
     VkVertexInputAttributeDescription attributeDescription = {
         .location = location++,
         .binding = VERTEX_BUFFER_BIND_ID,
-        .format = VK_FORMAT_R32G32B32_SFLOAT,
+        .format = vertexFormat.containsPackedCoordinates()
+            ? VK_FORMAT_R16G16B16A16_SFLOAT
+            : VK_FORMAT_R32G32B32_SFLOAT,
         .offset = offset
     };
     vertexAttributeDescriptions.push_back(attributeDescription);
-    offset += 12;
+    offset += vertexFormat.containsPackedCoordinates() ? 8 : 12;
 
     if (vertexFormat.containsColors3()) {
         attributeDescription = {
@@ -65,11 +68,13 @@ void VertexShader::createVertexInputState()
         attributeDescription = {
             .location = location++,
             .binding = VERTEX_BUFFER_BIND_ID,
-            .format = VK_FORMAT_R32G32B32_SFLOAT,
+            .format = vertexFormat.containsPackedNormals()
+                ? VK_FORMAT_R32_UINT
+                : VK_FORMAT_R32G32B32_SFLOAT,
             .offset = offset
         };
         vertexAttributeDescriptions.push_back(attributeDescription);
-        offset += 12;
+        offset += vertexFormat.containsPackedNormals() ? 4 : 12;
     }
 
     if (vertexFormat.containsTexCoords()) {
@@ -77,11 +82,13 @@ void VertexShader::createVertexInputState()
             attributeDescription = {
                 .location = location++,
                 .binding = VERTEX_BUFFER_BIND_ID,
-                .format = VK_FORMAT_R32G32_SFLOAT,
+                .format = vertexFormat.containsPackedTexCoords()
+                    ? VK_FORMAT_R16G16_UNORM
+                    : VK_FORMAT_R32G32_SFLOAT,
                 .offset = offset
             };
             vertexAttributeDescriptions.push_back(attributeDescription);
-            offset += 8;
+            offset += vertexFormat.containsPackedTexCoords() ? 4 : 8;
         }
     }
 
@@ -89,11 +96,13 @@ void VertexShader::createVertexInputState()
         attributeDescription = {
             .location = location++,
             .binding = VERTEX_BUFFER_BIND_ID,
-            .format = VK_FORMAT_R32G32B32A32_SFLOAT,
+            .format = vertexFormat.containsPackedTangents()
+                ? VK_FORMAT_R32_UINT
+                : VK_FORMAT_R32G32B32A32_SFLOAT,
             .offset = offset
         };
         vertexAttributeDescriptions.push_back(attributeDescription);
-        offset += 16;
+        offset += vertexFormat.containsPackedTangents() ? 4 : 16;
     }
 
     vertexInputStateCreateInfo = {
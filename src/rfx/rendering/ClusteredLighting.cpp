@@ -0,0 +1,130 @@
+#include "rfx/pch.h"
+#include "rfx/rendering/ClusteredLighting.h"
+#include "rfx/common/Math.h"
+
+using namespace rfx;
+using namespace glm;
+using namespace std;
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+ClusteredLighting::ClusteredLighting(
+    GraphicsDevicePtr graphicsDevice,
+    uint32_t frameCount)
+        : graphicsDevice(move(graphicsDevice)),
+          frameCount(frameCount)
+{
+    RFX_CHECK_ARGUMENT(frameCount > 0);
+
+    createBuffer();
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void ClusteredLighting::createBuffer()
+{
+    const VkDeviceSize alignment = graphicsDevice->getDesc().properties.limits.minStorageBufferOffsetAlignment;
+
+    lightBufferSize =
+        sizeof(LightClusters::ClusterParams) + LightClusters::MAX_LIGHTS * sizeof(LightClusters::LightData);
+    clusterBufferOffset = Math::alignUp(lightBufferSize, alignment);
+    lightIndexBufferOffset =
+        Math::alignUp(clusterBufferOffset + LightClusters::CLUSTER_COUNT * sizeof(LightClusters::Cluster), alignment);
+    sliceSize =
+        Math::alignUp(lightIndexBufferOffset + LightClusters::MAX_LIGHT_INDEX_COUNT * sizeof(uint32_t), alignment);
+
+    buffer = graphicsDevice->createBuffer(
+        sliceSize * frameCount,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+    graphicsDevice->bind(buffer);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void ClusteredLighting::setProjection(
+    const mat4& projMatrix,
+    const VkExtent2D& extent)
+{
+    lightClusters.setProjection(projMatrix, extent);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void ClusteredLighting::update(
+    uint32_t frameIndex,
+    const vector<LightPtr>& lights,
+    const mat4& viewMatrix)
+{
+    RFX_CHECK_ARGUMENT(frameIndex < frameCount);
+
+    lightClusters.update(lights, viewMatrix);
+    writeBuffer(frameIndex);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void ClusteredLighting::writeBuffer(uint32_t frameIndex)
+{
+    // only the slice of the given frame is written - the other slices may still be read by frames in flight
+    auto* sliceData = static_cast<std::byte*>(buffer->getMappedData()) + frameIndex * sliceSize;
+
+    const auto& lightData = lightClusters.getLightData();
+    const auto& clusters = lightClusters.getClusters();
+    const auto& lightIndices = lightClusters.getLightIndices();
+
+    memcpy(sliceData, &lightClusters.getParams(), sizeof(LightClusters::ClusterParams));
+    memcpy(sliceData + sizeof(LightClusters::ClusterParams), lightData.data(),
+        lightData.size() * sizeof(LightClusters::LightData));
+    memcpy(sliceData + clusterBufferOffset, clusters.data(), clusters.size() * sizeof(LightClusters::Cluster));
+    memcpy(sliceData + lightIndexBufferOffset, lightIndices.data(), lightIndices.size() * sizeof(uint32_t));
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+vector<VkDescriptorSetLayoutBinding> ClusteredLighting::getDescriptorSetLayoutBindings(uint32_t firstBinding)
+{
+    vector<VkDescriptorSetLayoutBinding> bindings(BINDING_COUNT);
+    for (uint32_t i = 0; i < BINDING_COUNT; ++i) {
+        bindings[i] = {
+            .binding = firstBinding + i,
+            .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            .descriptorCount = 1,
+            .stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT
+        };
+    }
+
+    return bindings;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+array<VkDescriptorBufferInfo, ClusteredLighting::BINDING_COUNT> ClusteredLighting::getDescriptorBufferInfos(
+    uint32_t frameIndex) const
+{
+    const VkDeviceSize sliceOffset = frameIndex * sliceSize;
+
+    return {{
+        { buffer->getHandle(), sliceOffset, lightBufferSize },
+        {
+            buffer->getHandle(),
+            sliceOffset + clusterBufferOffset,
+            LightClusters::CLUSTER_COUNT * sizeof(LightClusters::Cluster)
+        },
+        {
+            buffer->getHandle(),
+            sliceOffset + lightIndexBufferOffset,
+            LightClusters::MAX_LIGHT_INDEX_COUNT * sizeof(uint32_t)
+        }
+    }};
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+const ClusteredLighting::Stats& ClusteredLighting::getStats() const
+{
+    return lightClusters.getStats();
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "rfx/graphics/GraphicsDevice.h"
+#include "rfx/rendering/LightClusters.h"
+
+#include <array>
+
+
+namespace rfx {
+
+/**
+ *  Clustered forward lighting: each froxel of the view frustum gets the list of point and spot lights whose range
+ *  overlaps it, see LightClusters for the froxels and the binning. Fragment shaders look up the froxel of the
+ *  fragment and evaluate only the lights in its list (see clustered.glsl), so the shading cost depends on the local
+ *  light density instead of the total light count.
+ *
+ *  update() bins the enabled lights on the CPU with LightClusters and writes the slice of the given frame in flight,
+ *  which holds three storage buffers:
+ *
+ *  1. the cluster parameters followed by the light data, directional lights first - they affect every froxel
+ *  2. offset and count of the light list of each froxel
+ *  3. the light lists, as indices into the light data
+ */
+class ClusteredLighting
+{
+public:
+    static constexpr uint32_t BINDING_COUNT = 3;
+
+    using Stats = LightClusters::Stats;
+
+    ClusteredLighting(
+        GraphicsDevicePtr graphicsDevice,
+        uint32_t frameCount);
+
+    // perspective projection with zero to one depth range, recomputes the froxel bounds if anything changed
+    void setProjection(
+        const glm::mat4& projMatrix,
+        const VkExtent2D& extent);
+
+    void update(
+        uint32_t frameIndex,
+        const std::vector<LightPtr>& lights,
+        const glm::mat4& viewMatrix);
+
+    // bindings firstBinding .. firstBinding + BINDING_COUNT - 1, in the order of the buffers above
+    [[nodiscard]] static std::vector<VkDescriptorSetLayoutBinding> getDescriptorSetLayoutBindings(
+        uint32_t firstBinding);
+
+    [[nodiscard]] std::array<VkDescriptorBufferInfo, BINDING_COUNT> getDescriptorBufferInfos(
+        uint32_t frameIndex) const;
+
+    [[nodiscard]] const Stats& getStats() const;
+
+private:
+    void createBuffer();
+    void writeBuffer(uint32_t frameIndex);
+
+
+    GraphicsDevicePtr graphicsDevice;
+    uint32_t frameCount = 0;
+
+    BufferPtr buffer;                       // one slice per frame in flight
+    VkDeviceSize lightBufferSize = 0;
+    VkDeviceSize clusterBufferOffset = 0;
+    VkDeviceSize lightIndexBufferOffset = 0;
+    VkDeviceSize sliceSize = 0;
+
+    LightClusters lightClusters;
+};
+
+using ClusteredLightingPtr = std::shared_ptr<ClusteredLighting>;
+
+} // namespace rfx
@@ -0,0 +1,364 @@
+#include "rfx/pch.h"
+#include "rfx/rendering/LightClusters.h"
+#include "rfx/scene/DirectionalLight.h"
+#include "rfx/scene/SpotLight.h"
+
+using namespace rfx;
+using namespace glm;
+using namespace std;
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+LightClusters::LightClusters()
+{
+    lightData.reserve(MAX_LIGHTS);
+    clusters.resize(CLUSTER_COUNT);
+    clusterFillCounts.resize(CLUSTER_COUNT);
+    lightIndices.reserve(MAX_LIGHT_INDEX_COUNT);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void LightClusters::setProjection(
+    const mat4& projMatrix,
+    const VkExtent2D& extent)
+{
+    RFX_CHECK_ARGUMENT(extent.width > 0 && extent.height > 0);
+
+    if (projMatrix == this->projMatrix
+            && extent.width == this->extent.width
+            && extent.height == this->extent.height) {
+        return;
+    }
+
+    this->projMatrix = projMatrix;
+    this->extent = extent;
+
+    // inverse of the depth mapping of a right handed perspective projection with zero to one depth range
+    nearPlane = projMatrix[3][2] / projMatrix[2][2];
+    farPlane = projMatrix[3][2] / (projMatrix[2][2] + 1.0f);
+    RFX_CHECK_ARGUMENT(nearPlane > 0.0f && farPlane > nearPlane);
+
+    const float logDepthRange = log(farPlane / nearPlane);
+    params.tileScale = {
+        static_cast<float>(TILE_COUNT_X) / static_cast<float>(extent.width),
+        static_cast<float>(TILE_COUNT_Y) / static_cast<float>(extent.height)
+    };
+    params.sliceScale = static_cast<float>(SLICE_COUNT) / logDepthRange;
+    params.sliceBias = -static_cast<float>(SLICE_COUNT) * log(nearPlane) / logDepthRange;
+
+    updateClusterBounds();
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void LightClusters::updateClusterBounds()
+{
+    const mat4 inverseProjMatrix = inverse(projMatrix);
+    const float depthRatio = farPlane / nearPlane;
+
+    // view space direction through a point in normalized device coordinates, scaled to a view depth of 1
+    const auto getViewRay = [&inverseProjMatrix](float x, float y) {
+        const vec4 point = inverseProjMatrix * vec4(x, y, 0.0f, 1.0f);
+        return vec3(point) / -point.z;
+    };
+
+    clusterBounds.resize(CLUSTER_COUNT);
+
+    for (uint32_t y = 0; y < TILE_COUNT_Y; ++y)
+    {
+        for (uint32_t x = 0; x < TILE_COUNT_X; ++x)
+        {
+            const float left = static_cast<float>(x) / TILE_COUNT_X * 2.0f - 1.0f;
+            const float right = static_cast<float>(x + 1) / TILE_COUNT_X * 2.0f - 1.0f;
+            const float top = static_cast<float>(y) / TILE_COUNT_Y * 2.0f - 1.0f;
+            const float bottom = static_cast<float>(y + 1) / TILE_COUNT_Y * 2.0f - 1.0f;
+
+            const vec3 corners[] = {
+                getViewRay(left, top),
+                getViewRay(right, top),
+                getViewRay(left, bottom),
+                getViewRay(right, bottom)
+            };
+
+            for (uint32_t slice = 0; slice < SLICE_COUNT; ++slice)
+            {
+                const float sliceNear = nearPlane * pow(depthRatio, static_cast<float>(slice) / SLICE_COUNT);
+                const float sliceFar = nearPlane * pow(depthRatio, static_cast<float>(slice + 1) / SLICE_COUNT);
+
+                BoundingBox& bounds = clusterBounds[(slice * TILE_COUNT_Y + y) * TILE_COUNT_X + x];
+                bounds = {};
+                for (const vec3& corner : corners) {
+                    bounds.extend(corner * sliceNear);
+                    bounds.extend(corner * sliceFar);
+                }
+            }
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void LightClusters::update(
+    const vector<LightPtr>& lights,
+    const mat4& viewMatrix)
+{
+    RFX_CHECK_STATE(!clusterBounds.empty(), "setProjection() must be called before update()");
+
+    lightData.clear();
+    clusterLights.clear();
+    stats = {};
+
+    for (const LightPtr& light : lights) {
+        if (light->isEnabled() && light->getType() == Light::DIRECTIONAL && lightData.size() < MAX_LIGHTS) {
+            lightData.push_back(createLightData(light));
+        }
+    }
+    params.directionalLightCount = static_cast<uint32_t>(lightData.size());
+
+    for (const LightPtr& light : lights)
+    {
+        if (!light->isEnabled() || light->getType() == Light::DIRECTIONAL) {
+            continue;
+        }
+        if (lightData.size() == MAX_LIGHTS) {
+            stats.droppedLightCount++;
+            continue;
+        }
+
+        BoundingSphere sphere = getBoundingSphere(light);
+        sphere.center = vec3(viewMatrix * vec4(sphere.center, 1.0f));
+
+        const auto lightIndex = static_cast<uint32_t>(lightData.size());
+        lightData.push_back(createLightData(light));
+        binLight(lightIndex, sphere);
+    }
+
+    buildLightLists();
+
+    stats.lightCount = static_cast<uint32_t>(lightData.size());
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+LightClusters::LightData LightClusters::createLightData(const LightPtr& light)
+{
+    LightData data {
+        .color = light->getColor()
+    };
+    data.type = light->getType();
+
+    switch (light->getType())
+    {
+    case Light::DIRECTIONAL:
+        data.direction = static_pointer_cast<DirectionalLight>(light)->getDirection();
+        break;
+
+    case Light::SPOT: {
+        const auto spotLight = static_pointer_cast<SpotLight>(light);
+        data.direction = spotLight->getDirection();
+        data.innerConeCos = cos(spotLight->getInnerConeAngle());
+        data.outerConeCos = cos(spotLight->getOuterConeAngle());
+        [[fallthrough]];
+    }
+
+    case Light::POINT: {
+        const auto pointLight = static_pointer_cast<PointLight>(light);
+        data.position = pointLight->getPosition();
+        data.range = pointLight->getRange();
+        break;
+    }
+    }
+
+    return data;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+LightClusters::BoundingSphere LightClusters::getBoundingSphere(const LightPtr& light)
+{
+    const auto pointLight = static_pointer_cast<PointLight>(light);
+    const vec3& color = light->getColor();
+
+    // the intensity falls off with the squared distance
+    float radius = pointLight->getRange();
+    if (radius <= 0.0f) {
+        radius = sqrt(std::max({ color.r, color.g, color.b }) / MIN_INTENSITY);
+    }
+
+    if (light->getType() != Light::SPOT) {
+        return { pointLight->getPosition(), radius };
+    }
+
+    // the spherical sector lit by the spot light: narrow cones are bounded by a sphere through the apex and the rim
+    // of the cap, wide ones by a sphere around the rim
+    const auto spotLight = static_pointer_cast<SpotLight>(light);
+    const vec3 direction = normalize(spotLight->getDirection());
+    const float coneAngle = std::min(spotLight->getOuterConeAngle(), radians(90.0f));
+    const float coneCos = cos(coneAngle);
+
+    if (coneCos * coneCos >= 0.5f) {
+        const float sectorRadius = radius / (2.0f * coneCos);
+        return { spotLight->getPosition() + direction * sectorRadius, sectorRadius };
+    }
+
+    return { spotLight->getPosition() + direction * (radius * coneCos), radius * sin(coneAngle) };
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void LightClusters::binLight(uint32_t lightIndex, const BoundingSphere& viewSpaceSphere)
+{
+    const vec3& center = viewSpaceSphere.center;
+    const float radius = viewSpaceSphere.radius;
+
+    const float minDepth = -center.z - radius;
+    const float maxDepth = -center.z + radius;
+    if (maxDepth <= nearPlane || minDepth >= farPlane) {
+        return;
+    }
+
+    const uint32_t firstSlice = getSlice(minDepth);
+    const uint32_t lastSlice = getSlice(maxDepth);
+
+    // the projection of the sphere's bounds is bounded by the projection of their corners, unless they cross the
+    // near plane
+    uvec2 firstTile { 0 };
+    uvec2 lastTile { TILE_COUNT_X - 1, TILE_COUNT_Y - 1 };
+    if (minDepth > nearPlane)
+    {
+        vec2 min { numeric_limits<float>::max() };
+        vec2 max { numeric_limits<float>::lowest() };
+        for (uint32_t i = 0; i < 8; ++i)
+        {
+            const vec3 corner = center + vec3(
+                i & 1 ? radius : -radius,
+                i & 2 ? radius : -radius,
+                i & 4 ? radius : -radius);
+            const vec4 clipCoords = projMatrix * vec4(corner, 1.0f);
+            const vec2 normalizedDeviceCoords = vec2(clipCoords) / clipCoords.w;
+            min = glm::min(min, normalizedDeviceCoords);
+            max = glm::max(max, normalizedDeviceCoords);
+        }
+
+        if (max.x < -1.0f || min.x > 1.0f || max.y < -1.0f || min.y > 1.0f) {
+            return;
+        }
+
+        firstTile = getTile(min);
+        lastTile = getTile(max);
+    }
+
+    for (uint32_t slice = firstSlice; slice <= lastSlice; ++slice) {
+        for (uint32_t y = firstTile.y; y <= lastTile.y; ++y) {
+            for (uint32_t x = firstTile.x; x <= lastTile.x; ++x)
+            {
+                const uint32_t clusterIndex = (slice * TILE_COUNT_Y + y) * TILE_COUNT_X + x;
+                const BoundingBox& bounds = clusterBounds[clusterIndex];
+                const vec3 offset = glm::clamp(center, bounds.min, bounds.max) - center;
+                if (dot(offset, offset) <= radius * radius) {
+                    clusterLights.emplace_back(clusterIndex, lightIndex);
+                }
+            }
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+uint32_t LightClusters::getSlice(float viewDepth) const
+{
+    const float slice = log(std::max(viewDepth, nearPlane)) * params.sliceScale + params.sliceBias;
+
+    return static_cast<uint32_t>(std::clamp(slice, 0.0f, static_cast<float>(SLICE_COUNT - 1)));
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+uvec2 LightClusters::getTile(const vec2& normalizedDeviceCoords) const
+{
+    const vec2 tile = (glm::clamp(normalizedDeviceCoords, -1.0f, 1.0f) * 0.5f + 0.5f)
+        * vec2(TILE_COUNT_X, TILE_COUNT_Y);
+
+    return glm::min(uvec2(tile), uvec2(TILE_COUNT_X - 1, TILE_COUNT_Y - 1));
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void LightClusters::buildLightLists()
+{
+    // counting sort of the binned lights by cluster, the lights of a cluster stay in light order
+    ranges::fill(clusterFillCounts, 0);
+    for (const auto& [clusterIndex, lightIndex] : clusterLights) {
+        clusterFillCounts[clusterIndex]++;
+    }
+
+    uint32_t offset = 0;
+    for (uint32_t i = 0; i < CLUSTER_COUNT; ++i)
+    {
+        const uint32_t binnedCount = clusterFillCounts[i];
+        const uint32_t count = std::min(binnedCount, MAX_LIGHT_INDEX_COUNT - offset);
+        stats.maxClusterLightCount = std::max(stats.maxClusterLightCount, binnedCount);
+        stats.droppedLightIndexCount += binnedCount - count;
+
+        clusters[i] = { offset, count };
+        clusterFillCounts[i] = 0;
+        offset += count;
+    }
+
+    lightIndices.resize(offset);
+    for (const auto& [clusterIndex, lightIndex] : clusterLights)
+    {
+        const Cluster& cluster = clusters[clusterIndex];
+        uint32_t& fillCount = clusterFillCounts[clusterIndex];
+        if (fillCount < cluster.count) {
+            lightIndices[cluster.offset + fillCount++] = lightIndex;
+        }
+    }
+
+    stats.lightIndexCount = offset;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+const LightClusters::ClusterParams& LightClusters::getParams() const
+{
+    return params;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+const vector<LightClusters::LightData>& LightClusters::getLightData() const
+{
+    return lightData;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+const vector<LightClusters::Cluster>& LightClusters::getClusters() const
+{
+    return clusters;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+const vector<uint32_t>& LightClusters::getLightIndices() const
+{
+    return lightIndices;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+const vector<BoundingBox>& LightClusters::getClusterBounds() const
+{
+    return clusterBounds;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+const LightClusters::Stats& LightClusters::getStats() const
+{
+    return stats;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,127 @@
+#pragma once
+
+#include "rfx/scene/Light.h"
+#include "rfx/scene/BoundingBox.h"
+
+
+namespace rfx {
+
+/**
+ *  The CPU side of ClusteredLighting: the view frustum is divided into froxels - screen tiles times exponentially
+ *  spaced depth slices - and update() bins the enabled point and spot lights into the froxels their bounding sphere
+ *  overlaps. The results are laid out like the storage buffers of clustered.glsl.
+ *
+ *  A light is tested against the view space bounds of the froxels in its slice and tile range only. The tile range
+ *  is the projection of the light's bounds, the lights of a froxel are sorted with a counting sort.
+ *
+ *  Lights with a range <= 0 (unlimited) are cut off where their intensity falls below MIN_INTENSITY.
+ */
+class LightClusters
+{
+public:
+    static constexpr uint32_t TILE_COUNT_X = 16;
+    static constexpr uint32_t TILE_COUNT_Y = 9;
+    static constexpr uint32_t SLICE_COUNT = 24;
+    static constexpr uint32_t CLUSTER_COUNT = TILE_COUNT_X * TILE_COUNT_Y * SLICE_COUNT;
+    static constexpr uint32_t MAX_LIGHTS = 1024;
+    static constexpr uint32_t MAX_LIGHT_INDEX_COUNT = CLUSTER_COUNT * 32;
+    static constexpr float MIN_INTENSITY = 1.0f / 256.0f;
+
+    // counters of the last update()
+    struct Stats
+    {
+        uint32_t lightCount = 0;            // including the directional lights
+        uint32_t droppedLightCount = 0;     // lights beyond MAX_LIGHTS
+        uint32_t lightIndexCount = 0;
+        uint32_t droppedLightIndexCount = 0; // light list entries beyond MAX_LIGHT_INDEX_COUNT
+        uint32_t maxClusterLightCount = 0;
+    };
+
+    // layout of Light in punctual.glsl
+    struct LightData
+    {
+        glm::vec3 direction { 0.0f };
+        float range = 0.0f;
+
+        glm::vec3 color { 0.0f };
+        float intensity = 1.0f;
+
+        glm::vec3 position { 0.0f };
+        float innerConeCos = 0.0f;
+
+        float outerConeCos = 0.0f;
+        int32_t type = 0;
+        uint32_t enabled = 1;
+        float pad = 0.0f;
+    };
+
+    // layout of ClusterParams in clustered.glsl
+    struct ClusterParams
+    {
+        glm::vec2 tileScale { 0.0f };       // framebuffer coordinates -> tile
+        float sliceScale = 0.0f;            // log(view depth) -> slice
+        float sliceBias = 0.0f;
+        uint32_t tileCountX = TILE_COUNT_X;
+        uint32_t tileCountY = TILE_COUNT_Y;
+        uint32_t sliceCount = SLICE_COUNT;
+        uint32_t directionalLightCount = 0;
+    };
+
+    struct Cluster
+    {
+        uint32_t offset = 0;
+        uint32_t count = 0;
+    };
+
+    struct BoundingSphere
+    {
+        glm::vec3 center { 0.0f };
+        float radius = 0.0f;
+    };
+
+    LightClusters();
+
+    // perspective projection with zero to one depth range, recomputes the froxel bounds if anything changed
+    void setProjection(
+        const glm::mat4& projMatrix,
+        const VkExtent2D& extent);
+
+    void update(
+        const std::vector<LightPtr>& lights,
+        const glm::mat4& viewMatrix);
+
+    // world space bounds of the volume lit by a point or spot light
+    [[nodiscard]] static BoundingSphere getBoundingSphere(const LightPtr& light);
+
+    [[nodiscard]] const ClusterParams& getParams() const;
+    [[nodiscard]] const std::vector<LightData>& getLightData() const;          // directional lights first
+    [[nodiscard]] const std::vector<Cluster>& getClusters() const;
+    [[nodiscard]] const std::vector<uint32_t>& getLightIndices() const;
+    [[nodiscard]] const std::vector<BoundingBox>& getClusterBounds() const;     // view space
+    [[nodiscard]] const Stats& getStats() const;
+
+private:
+    void updateClusterBounds();
+    [[nodiscard]] static LightData createLightData(const LightPtr& light);
+    void binLight(uint32_t lightIndex, const BoundingSphere& viewSpaceSphere);
+    [[nodiscard]] uint32_t getSlice(float viewDepth) const;
+    [[nodiscard]] glm::uvec2 getTile(const glm::vec2& normalizedDeviceCoords) const;
+    void buildLightLists();
+
+
+    glm::mat4 projMatrix { 0.0f };
+    VkExtent2D extent {};
+    float nearPlane = 0.0f;
+    float farPlane = 0.0f;
+    std::vector<BoundingBox> clusterBounds; // view space
+
+    ClusterParams params;
+    std::vector<LightData> lightData;
+    std::vector<std::pair<uint32_t, uint32_t>> clusterLights; // (cluster, light index) of the binned lights
+    std::vector<Cluster> clusters;
+    std::vector<uint32_t> clusterFillCounts;
+    std::vector<uint32_t> lightIndices;
+    Stats stats;
+};
+
+} // namespace rfx
@@ -25,20 +25,32 @@ void MaterialNode::add(
     const MaterialPtr& material,
     const ModelPtr& model)
 {
-    for (const auto& mesh : model->getMeshes())
+    // a mesh is drawn once per geometry node that references it, meshes without nodes aren't drawn
+    unordered_map<const Mesh*, size_t> childNodeIndices;
+
+    for (const auto& node : model->getGeometryNodes())
     {
-        MeshNode childNode(mesh, material, shader);
-        if (!childNode.isEmpty()) {
-            childNodes.push_back(childNode);
+        const vector<MeshPtr>& meshes = node->getMeshes();
+
+        for (uint32_t i = 0; i < meshes.size(); ++i)
+        {
+            auto [it, isNew] = childNodeIndices.try_emplace(meshes[i].get(), childNodes.size());
+            if (isNew) {
+                childNodes.emplace_back(meshes[i], material, shader);
+            }
+
+            childNodes[it->second].addInstance({ node.get(), i });
         }
     }
+
+    erase_if(childNodes, [](const MeshNode& childNode) { return childNode.isEmpty(); });
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
 
 void MaterialNode::record(const CommandBufferPtr& commandBuffer) const
 {
-    bindMaterial(commandBuffer, shader);
+    bindMaterial(commandBuffer);
 
     for (const auto& meshNode : childNodes) {
         meshNode.record(commandBuffer);
@@ -47,10 +59,12 @@ void MaterialNode::record(const CommandBufferPtr& commandBuffer) const
 
 // ---------------------------------------------------------------------------------------------------------------------
 
-void MaterialNode::bindMaterial(
-    const CommandBufferPtr& commandBuffer,
-    const MaterialShaderPtr& shader) const
+void MaterialNode::bindMaterial(const CommandBufferPtr& commandBuffer) const
 {
+    if (isBindless()) {
+        return;
+    }
+
     commandBuffer->bindDescriptorSet(
         VK_PIPELINE_BIND_POINT_GRAPHICS,
         shader->getPipelineLayout(),
@@ -59,3 +73,31 @@ void MaterialNode::bindMaterial(
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
+
+void MaterialNode::setBindlessMaterialIndex(uint32_t materialIndex)
+{
+    bindlessMaterialIndex = materialIndex;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+bool MaterialNode::isBindless() const
+{
+    return bindlessMaterialIndex != UINT32_MAX;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+const vector<MeshNode>& MaterialNode::getChildNodes() const
+{
+    return childNodes;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+const MaterialPtr& MaterialNode::getMaterial() const
+{
+    return material;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
@@ -19,18 +19,25 @@ public:
 
     void record(const CommandBufferPtr& commandBuffer) const override;
 
+    // binds the material descriptor set, nothing when bindless - the shader node binds the material table
+    void bindMaterial(const CommandBufferPtr& commandBuffer) const;
+
+    // index into a BindlessMaterialTable, UINT32_MAX disables bindless mode
+    void setBindlessMaterialIndex(uint32_t materialIndex);
+    [[nodiscard]] bool isBindless() const;
+
+    [[nodiscard]] const std::vector<MeshNode>& getChildNodes() const;
+    [[nodiscard]] const MaterialPtr& getMaterial() const;
+
 private:
     void add(
         const MaterialPtr& material,
         const ModelPtr& model);
 
-    void bindMaterial(
-        const CommandBufferPtr& commandBuffer,
-        const MaterialShaderPtr& shader) const;
-
     MaterialPtr material;
     MaterialShaderPtr shader;
     std::vector<MeshNode> childNodes;
+    uint32_t bindlessMaterialIndex = UINT32_MAX;
 };
 
 } // namespace rfx
@@ -24,9 +24,27 @@ MeshNode::MeshNode(
 
 // ---------------------------------------------------------------------------------------------------------------------
 
+void MeshNode::addInstance(const Instance& instance)
+{
+    instances.push_back(instance);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
 void MeshNode::record(const CommandBufferPtr& commandBuffer) const
 {
-    bindObject(commandBuffer, shader);
+    for (const auto& instance : instances) {
+        record(commandBuffer, instance);
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void MeshNode::record(
+    const CommandBufferPtr& commandBuffer,
+    const Instance& instance) const
+{
+    bindObject(commandBuffer, instance);
 
     for (const auto& subMesh : subMeshes) {
         commandBuffer->drawIndexed(subMesh.getIndexCount(), subMesh.getFirstIndex());
@@ -37,21 +55,43 @@ void MeshNode::record(const CommandBufferPtr& commandBuffer) const
 
 void MeshNode::bindObject(
     const CommandBufferPtr& commandBuffer,
-    const MaterialShaderPtr& shader) const
+    const Instance& instance) const
 {
     commandBuffer->bindDescriptorSet(
         VK_PIPELINE_BIND_POINT_GRAPHICS,
         shader->getPipelineLayout(),
         3,
-        mesh->getDescriptorSet());
+        mesh->getDescriptorSet(),
+        instance.node->getDataOffset());
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
 
 bool MeshNode::isEmpty() const
 {
-    return subMeshes.empty();
+    return subMeshes.empty() || instances.empty();
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
 
+
+const MeshPtr& MeshNode::getMesh() const
+{
+    return mesh;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+const vector<SubMesh>& MeshNode::getSubMeshes() const
+{
+    return subMeshes;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+const vector<MeshNode::Instance>& MeshNode::getInstances() const
+{
+    return instances;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
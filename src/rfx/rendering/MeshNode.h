@@ -2,6 +2,7 @@
 
 #include "rfx/rendering/RenderGraphNode.h"
 #include "rfx/scene/Mesh.h"
+#include "rfx/scene/ModelNode.h"
 #include "rfx/scene/MaterialShader.h"
 
 
@@ -10,22 +11,37 @@ namespace rfx {
 class MeshNode : public RenderGraphNode
 {
 public:
+    // a geometry node that references the mesh
+    struct Instance
+    {
+        const ModelNode* node = nullptr;
+        uint32_t meshIndex = 0;     // of the mesh within the node
+    };
+
     MeshNode(
         const MeshPtr& mesh,
         const MaterialPtr& material,
         MaterialShaderPtr shader);
 
+    void addInstance(const Instance& instance);
+
+    // draws all instances
     void record(const CommandBufferPtr& commandBuffer) const override;
+    void record(const CommandBufferPtr& commandBuffer, const Instance& instance) const;
 
     [[nodiscard]] bool isEmpty() const;
+    [[nodiscard]] const MeshPtr& getMesh() const;
+    [[nodiscard]] const std::vector<SubMesh>& getSubMeshes() const;
+    [[nodiscard]] const std::vector<Instance>& getInstances() const;
 
 private:
     void bindObject(
         const CommandBufferPtr& commandBuffer,
-        const MaterialShaderPtr& shader) const;
+        const Instance& instance) const;
 
     MeshPtr mesh;
     std::vector<SubMesh> subMeshes;
+    std::vector<Instance> instances;
     MaterialShaderPtr shader;
 };
 
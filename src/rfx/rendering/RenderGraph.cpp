@@ -8,9 +8,98 @@ using namespace std;
 
 RenderGraph::RenderGraph(
     GraphicsDevicePtr graphicsDevice,
-    VkDescriptorSet sceneDescriptorSet)
+    vector<VkDescriptorSet> sceneDescriptorSets)
         : graphicsDevice(move(graphicsDevice)),
-          sceneDescriptorSet(sceneDescriptorSet) {}
+          sceneDescriptorSets(move(sceneDescriptorSets))
+{
+    RFX_CHECK_ARGUMENT(!this->sceneDescriptorSets.empty());
+
+    sceneDescriptorSet = this->sceneDescriptorSets[0];
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+RenderGraph::~RenderGraph()
+{
+    recordThreadPool.reset();
+    destroyRecordCommandPools();
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+RenderGraph::Stats& RenderGraph::Stats::operator+=(const Stats& other)
+{
+    drawCount += other.drawCount;
+    instanceCount += other.instanceCount;
+    drawCallCount += other.drawCallCount;
+    pipelineBindCount += other.pipelineBindCount;
+    descriptorSetBindCount += other.descriptorSetBindCount;
+    vertexBufferBindCount += other.vertexBufferBindCount;
+    indexBufferBindCount += other.indexBufferBindCount;
+
+    return *this;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void RenderGraph::setRecordThreadCount(uint32_t threadCount)
+{
+    RFX_CHECK_ARGUMENT(threadCount > 0);
+
+    if (threadCount == recordThreadCount) {
+        return;
+    }
+
+    recordThreadPool.reset();
+    destroyRecordCommandPools();
+
+    recordThreadCount = threadCount;
+
+    if (recordThreadCount > 1) {
+        recordThreadPool = make_unique<ThreadPool>(recordThreadCount);
+        createRecordCommandPools(recordThreadCount);
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+uint32_t RenderGraph::getRecordThreadCount() const
+{
+    return recordThreadCount;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void RenderGraph::createRecordCommandPools(uint32_t count)
+{
+    const VkCommandPoolCreateInfo poolInfo = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+        .flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
+        .queueFamilyIndex = graphicsDevice->getGraphicsQueue()->getFamilyIndex()
+    };
+
+    recordCommandPools.resize(count);
+    for (VkCommandPool& commandPool : recordCommandPools) {
+        ThrowIfFailed(vkCreateCommandPool(
+            graphicsDevice->getLogicalDevice(),
+            &poolInfo,
+            nullptr,
+            &commandPool));
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void RenderGraph::destroyRecordCommandPools()
+{
+    // destroying the pools frees the secondary command buffers allocated from them
+    for (VkCommandPool commandPool : recordCommandPools) {
+        vkDestroyCommandPool(graphicsDevice->getLogicalDevice(), commandPool, nullptr);
+    }
+
+    recordCommandPools.clear();
+    secondaryCommandBuffers.clear();
+}
 
 // ---------------------------------------------------------------------------------------------------------------------
 
@@ -19,9 +108,14 @@ void RenderGraph::add(
     const unordered_map<MaterialShaderPtr, std::vector<MaterialPtr>>& materialShaderMap)
 {
     ranges::for_each(scene->getModels(),
-        [this, materialShaderMap](const ModelPtr& model) {
-            add(model, materialShaderMap);
+        [this, &materialShaderMap](const ModelPtr& model) {
+            for (const auto& [shader, materials] : materialShaderMap) {
+                add(shader, materials, model);
+            }
         });
+
+    // once for all models, rebuilding the hierarchy per model would make loading quadratic
+    updateBounds();
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
@@ -33,6 +127,8 @@ void RenderGraph::add(
     for (const auto& [shader, materials] : materialShaderMap) {
         add(shader, materials, model);
     }
+
+    updateBounds();
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
@@ -42,6 +138,8 @@ void RenderGraph::add(
     const vector<MaterialPtr>& materials,
     const ModelPtr& model)
 {
+    RFX_CHECK_STATE(drawDataDescriptorSets.empty(), "Models must be added before enabling indirect drawing");
+
     ShaderNode childNode(shader, materials, model, sceneDescriptorSet);
     childNodeMap[model].push_back(childNode);
 }
@@ -55,28 +153,661 @@ void RenderGraph::add(RenderGraphNodePtr userDefinedNode)
 
 // ---------------------------------------------------------------------------------------------------------------------
 
+void RenderGraph::setCamera(CameraPtr camera)
+{
+    this->camera = move(camera);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void RenderGraph::updateBounds()
+{
+    vector<BoundingBox> itemBounds;
+
+    meshHierarchyItems.clear();
+    nodeItems.clear();
+
+    // one item per mesh of a node, so that a mesh referenced by several nodes is culled per node; meshes without
+    // bounds aren't part of the hierarchy and are never culled
+    for (const auto& [model, shaderNodes] : childNodeMap) {
+        for (const auto& node : model->getGeometryNodes())
+        {
+            const vector<BoundingBox>& bounds = node->getMeshWorldBounds();
+            vector<uint32_t>& items = nodeItems[node.get()];
+            items.assign(node->getMeshCount(), UINT32_MAX);
+
+            for (uint32_t i = 0; i < items.size() && i < bounds.size(); ++i)
+            {
+                if (!bounds[i].isValid()) {
+                    continue;
+                }
+
+                items[i] = static_cast<uint32_t>(itemBounds.size());
+                meshHierarchyItems.emplace_back(node.get(), i);
+                itemBounds.push_back(bounds[i]);
+            }
+        }
+    }
+
+    meshHierarchy.build(move(itemBounds));
+    visibleMeshItems.assign(meshHierarchy.getItemCount(), true);
+
+    // the draw items and the indirect instances reference hierarchy items
+    updateDrawItems();
+    for (IndirectInstance& instance : indirectInstances) {
+        instance.boundsItem = getBoundsItem(*instance.meshInstance);
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+uint32_t RenderGraph::getBoundsItem(const MeshNode::Instance& instance) const
+{
+    const auto it = nodeItems.find(instance.node);
+
+    return it != nodeItems.end() && instance.meshIndex < it->second.size()
+        ? it->second[instance.meshIndex]
+        : UINT32_MAX;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void RenderGraph::refitBounds()
+{
+    for (uint32_t item = 0; item < meshHierarchyItems.size(); ++item)
+    {
+        const auto& [node, meshIndex] = meshHierarchyItems[item];
+        const BoundingBox& bounds = node->getMeshWorldBounds()[meshIndex];
+        if (bounds.isValid()) {
+            meshHierarchy.setItemBounds(item, bounds);
+        }
+    }
+
+    meshHierarchy.refit();
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
 void RenderGraph::record(
     const CommandBufferPtr& commandBuffer,
     VkRenderPass renderPass,
-    VkFramebuffer renderTarget)
+    VkFramebuffer renderTarget,
+    uint32_t frameIndex)
 {
-    begin(commandBuffer, renderPass, renderTarget);
+    setSceneDescriptorSet(sceneDescriptorSets[frameIndex % sceneDescriptorSets.size()]);
+
+    cullMeshes();
+
+    if (!drawDataDescriptorSets.empty())
+    {
+        const auto indirectFrameIndex = static_cast<uint32_t>(frameIndex % drawDataDescriptorSets.size());
+        updateIndirectDraws(indirectFrameIndex);
+
+        begin(commandBuffer, renderPass, renderTarget, VK_SUBPASS_CONTENTS_INLINE);
+        setViewportAndScissor(commandBuffer);
+        recordUserDefinedNodes(commandBuffer);
+        stats = recordIndirectDraws(commandBuffer, indirectFrameIndex);
+        end(commandBuffer);
+        return;
+    }
+
+    if (recordThreadCount > 1)
+    {
+        const vector<CommandBufferPtr>& secondaryBuffers = recordSecondaryCommandBuffers(
+            renderPass,
+            renderTarget,
+            frameIndex);
+
+        begin(commandBuffer, renderPass, renderTarget, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+        commandBuffer->executeCommands(secondaryBuffers);
+        end(commandBuffer);
+        return;
+    }
+
+    begin(commandBuffer, renderPass, renderTarget, VK_SUBPASS_CONTENTS_INLINE);
 
     setViewportAndScissor(commandBuffer);
+    recordUserDefinedNodes(commandBuffer);
+    stats = recordDrawItems(commandBuffer, sortDrawItems());
+    end(commandBuffer);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+const RenderGraph::Stats& RenderGraph::getStats() const
+{
+    return stats;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void RenderGraph::enableIndirectDrawing(
+    vector<VkDescriptorSet> drawDataDescriptorSets,
+    BindlessMaterialTablePtr materialTable)
+{
+    RFX_CHECK_ARGUMENT(!drawDataDescriptorSets.empty());
+    RFX_CHECK_STATE(graphicsDevice->isIndirectDrawingSupported(),
+        "Indirect drawing requires the multiDrawIndirect and drawIndirectFirstInstance features");
+
+    this->drawDataDescriptorSets = move(drawDataDescriptorSets);
+
+    if (materialTable) {
+        bindlessMaterialTable = move(materialTable);
+
+        for (auto& [model, shaderNodes] : childNodeMap) {
+            for (auto& shaderNode : shaderNodes) {
+                setBindlessMaterials(shaderNode);
+            }
+        }
+    }
+
+    buildIndirectDraws();
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void RenderGraph::setBindlessMaterials(ShaderNode& shaderNode) const
+{
+    shaderNode.setMaterialDescriptorSet(bindlessMaterialTable->getDescriptorSet());
+
+    for (auto& materialNode : shaderNode.getChildNodes()) {
+        materialNode.setBindlessMaterialIndex(bindlessMaterialTable->getMaterialIndex(materialNode.getMaterial()));
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void RenderGraph::buildIndirectDraws()
+{
+    indirectCommands.clear();
+    indirectInstances.clear();
+    indirectBuckets.clear();
+
+    const auto addBucket = [&](IndirectBucket bucket) {
+        bucket.drawCount = static_cast<uint32_t>(indirectCommands.size()) - bucket.firstDraw;
+        if (bucket.drawCount > 0) {
+            bucket.sortKey = createSortKey(*bucket.model, *bucket.shaderNode, bucket.materialNode);
+            indirectBuckets.push_back(bucket);
+        }
+    };
+
+    for (const auto& [model, shaderNodes] : childNodeMap)
+    {
+        const vector<MaterialPtr>& materials = model->getMaterials();
+
+        for (const auto& shaderNode : shaderNodes)
+        {
+            // bindless materials are selected per draw, so a single bucket covers all materials of the shader
+            IndirectBucket bucket {
+                .model = &model,
+                .shaderNode = &shaderNode,
+                .firstDraw = static_cast<uint32_t>(indirectCommands.size())
+            };
+
+            for (const auto& materialNode : shaderNode.getChildNodes())
+            {
+                const auto materialIndex = bindlessMaterialTable
+                    ? bindlessMaterialTable->getMaterialIndex(materialNode.getMaterial())
+                    : static_cast<uint32_t>(ranges::find(materials, materialNode.getMaterial()) - materials.begin());
+
+                if (!bindlessMaterialTable) {
+                    bucket = {
+                        .model = &model,
+                        .shaderNode = &shaderNode,
+                        .materialNode = &materialNode,
+                        .firstDraw = static_cast<uint32_t>(indirectCommands.size())
+                    };
+                }
+
+                // a mesh referenced by several nodes is drawn with one command per submesh, one instance per node
+                for (const auto& meshNode : materialNode.getChildNodes())
+                {
+                    const vector<MeshNode::Instance>& instances = meshNode.getInstances();
+
+                    for (const auto& subMesh : meshNode.getSubMeshes())
+                    {
+                        indirectCommands.push_back({
+                            .indexCount = subMesh.getIndexCount(),
+                            .instanceCount = static_cast<uint32_t>(instances.size()),
+                            .firstIndex = subMesh.getFirstIndex(),
+                            .vertexOffset = 0,
+                            .firstInstance = static_cast<uint32_t>(indirectInstances.size())
+                        });
+
+                        for (const auto& instance : instances) {
+                            indirectInstances.push_back({
+                                .meshInstance = &instance,
+                                .materialIndex = materialIndex,
+                                .boundsItem = getBoundsItem(instance)
+                            });
+                        }
+                    }
+                }
+
+                if (!bindlessMaterialTable) {
+                    addBucket(bucket);
+                }
+            }
+
+            if (bindlessMaterialTable) {
+                addBucket(bucket);
+            }
+        }
+    }
+
+    indirectCommandsBuffers.clear();
+    drawDataBuffers.clear();
+    visibleInstanceCounts.assign(indirectCommands.size(), 0);
+
+    if (indirectCommands.empty()) {
+        return;
+    }
+
+    // the buckets reference their draws by offset, so they can be reordered to minimize state changes
+    ranges::sort(indirectBuckets, {}, &IndirectBucket::sortKey);
+
+    for (VkDescriptorSet drawDataDescriptorSet : drawDataDescriptorSets)
+    {
+        indirectCommandsBuffers.push_back(createHostVisibleBuffer(
+            VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+            indirectCommands.size() * sizeof(VkDrawIndexedIndirectCommand)));
+
+        drawDataBuffers.push_back(createHostVisibleBuffer(
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+            indirectInstances.size() * sizeof(DrawData)));
+
+        const VkDescriptorBufferInfo bufferInfo {
+            .buffer = drawDataBuffers.back()->getHandle(),
+            .offset = 0,
+            .range = VK_WHOLE_SIZE
+        };
+
+        const VkWriteDescriptorSet writeDescriptorSet {
+            .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            .dstSet = drawDataDescriptorSet,
+            .dstBinding = 0,
+            .dstArrayElement = 0,
+            .descriptorCount = 1,
+            .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            .pBufferInfo = &bufferInfo
+        };
+
+        vkUpdateDescriptorSets(
+            graphicsDevice->getLogicalDevice(),
+            1,
+            &writeDescriptorSet,
+            0,
+            nullptr);
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BufferPtr RenderGraph::createHostVisibleBuffer(
+    VkBufferUsageFlags usage,
+    VkDeviceSize size) const
+{
+    BufferPtr buffer = graphicsDevice->createBuffer(
+        size,
+        usage,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    graphicsDevice->bind(buffer);
 
+    return buffer;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void RenderGraph::updateIndirectDraws(uint32_t indirectFrameIndex)
+{
+    if (indirectCommands.empty()) {
+        return;
+    }
+
+    // the previous submission of this frame index has completed, so its buffers can be rewritten
+    auto* commands = static_cast<VkDrawIndexedIndirectCommand*>(
+        indirectCommandsBuffers[indirectFrameIndex]->getMappedData());
+    auto* drawData = static_cast<DrawData*>(drawDataBuffers[indirectFrameIndex]->getMappedData());
+
+    // the visible instances of a command are moved to the front of its instance range, culled commands keep their
+    // slot with an instance count of 0
+    for (size_t i = 0; i < indirectCommands.size(); ++i)
+    {
+        VkDrawIndexedIndirectCommand command = indirectCommands[i];
+        uint32_t visibleInstanceCount = 0;
+
+        for (uint32_t j = command.firstInstance; j < command.firstInstance + command.instanceCount; ++j)
+        {
+            const IndirectInstance& instance = indirectInstances[j];
+            if (!isVisible(instance.boundsItem)) {
+                continue;
+            }
+
+            drawData[command.firstInstance + visibleInstanceCount++] = {
+                .modelMatrix = instance.meshInstance->node->getWorldTransform(),
+                .materialIndex = instance.materialIndex
+            };
+        }
+
+        command.instanceCount = visibleInstanceCount;
+        commands[i] = command;
+        visibleInstanceCounts[i] = visibleInstanceCount;
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+RenderGraph::Stats RenderGraph::recordIndirectDraws(
+    const CommandBufferPtr& commandBuffer,
+    uint32_t indirectFrameIndex) const
+{
+    Stats indirectStats;
+    const ModelPtr* boundModel = nullptr;
+    const MaterialShader* boundShader = nullptr;
+    const Material* boundMaterial = nullptr;
+
+    for (const IndirectBucket& bucket : indirectBuckets)
+    {
+        if (bucket.model != boundModel) {
+            bindGeometryBuffers(commandBuffer, *bucket.model);
+            boundModel = bucket.model;
+            indirectStats.vertexBufferBindCount++;
+            indirectStats.indexBufferBindCount++;
+        }
+
+        const MaterialShader* shader = bucket.shaderNode->getShader().get();
+        if (shader != boundShader) {
+            bucket.shaderNode->bindShader(commandBuffer);
+            commandBuffer->bindDescriptorSet(
+                VK_PIPELINE_BIND_POINT_GRAPHICS,
+                bucket.shaderNode->getShader()->getPipelineLayout(),
+                3,
+                drawDataDescriptorSets[indirectFrameIndex]);
+            boundShader = shader;
+            boundMaterial = nullptr;
+            indirectStats.pipelineBindCount++;
+            indirectStats.descriptorSetBindCount += bucket.shaderNode->getDescriptorSetCount() + 1;
+        }
+
+        if (bucket.materialNode != nullptr && bucket.materialNode->getMaterial().get() != boundMaterial) {
+            bucket.materialNode->bindMaterial(commandBuffer);
+            boundMaterial = bucket.materialNode->getMaterial().get();
+            indirectStats.descriptorSetBindCount += bucket.materialNode->isBindless() ? 0 : 1;
+        }
+
+        commandBuffer->drawIndexedIndirect(
+            indirectCommandsBuffers[indirectFrameIndex],
+            bucket.firstDraw * sizeof(VkDrawIndexedIndirectCommand),
+            bucket.drawCount);
+        indirectStats.drawCount += bucket.drawCount;
+        indirectStats.drawCallCount++;
+        for (uint32_t i = bucket.firstDraw; i < bucket.firstDraw + bucket.drawCount; ++i) {
+            indirectStats.instanceCount += visibleInstanceCounts[i];
+        }
+    }
+
+    return indirectStats;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void RenderGraph::setSceneDescriptorSet(VkDescriptorSet sceneDescriptorSet)
+{
+    if (sceneDescriptorSet == this->sceneDescriptorSet) {
+        return;
+    }
+
+    this->sceneDescriptorSet = sceneDescriptorSet;
+
+    for (auto& [model, shaderNodes] : childNodeMap) {
+        for (auto& shaderNode : shaderNodes) {
+            shaderNode.setSceneDescriptorSet(sceneDescriptorSet);
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void RenderGraph::recordUserDefinedNodes(const CommandBufferPtr& commandBuffer) const
+{
     for (const auto& userDefinedNode : userDefinedNodes) {
         if (userDefinedNode->isEnabled()) {
             userDefinedNode->record(commandBuffer);
         }
     }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+const vector<CommandBufferPtr>& RenderGraph::recordSecondaryCommandBuffers(
+    VkRenderPass renderPass,
+    VkFramebuffer renderTarget,
+    uint32_t frameIndex)
+{
+    // the caller guarantees that the primary command buffer of this frame index isn't pending execution, so its
+    // secondary command buffers can be re-recorded; they're re-recorded every frame, so recreated framebuffers are
+    // picked up with the next recording
+    if (frameIndex >= secondaryCommandBuffers.size()) {
+        secondaryCommandBuffers.resize(frameIndex + 1);
+    }
+
+    vector<CommandBufferPtr>& commandBuffers = secondaryCommandBuffers[frameIndex];
+    if (commandBuffers.empty()) {
+        for (VkCommandPool commandPool : recordCommandPools) {
+            commandBuffers.push_back(graphicsDevice->createCommandBuffers(
+                commandPool, 1, VK_COMMAND_BUFFER_LEVEL_SECONDARY).at(0));
+        }
+    }
+
+    const vector<DrawItem>& visibleDrawItems = sortDrawItems();
+    const size_t chunkCount = commandBuffers.size();
+    const size_t chunkSize = (visibleDrawItems.size() + chunkCount - 1) / chunkCount;
+    vector<Stats> chunkStats(chunkCount);
+
+    const VkCommandBufferInheritanceInfo inheritanceInfo = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO,
+        .renderPass = renderPass,
+        .subpass = 0,
+        .framebuffer = renderTarget
+    };
+
+    vector<future<void>> tasks;
+    tasks.reserve(chunkCount);
+
+    // chunk i is recorded into a command buffer from recordCommandPools[i] only, so no pool is used concurrently
+    for (size_t i = 0; i < chunkCount; ++i)
+    {
+        const size_t first = min(i * chunkSize, visibleDrawItems.size());
+        const size_t last = min(first + chunkSize, visibleDrawItems.size());
+
+        tasks.push_back(recordThreadPool->submit([&, i, first, last] {
+            const CommandBufferPtr& commandBuffer = commandBuffers[i];
+            commandBuffer->begin(VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT, inheritanceInfo);
+            setViewportAndScissor(commandBuffer);
+            if (i == 0) {
+                recordUserDefinedNodes(commandBuffer);
+            }
+            chunkStats[i] = recordDrawItems(commandBuffer, span(visibleDrawItems).subspan(first, last - first));
+            commandBuffer->end();
+        }));
+    }
+
+    // wait for all chunks before rethrowing, the tasks reference locals of this function
+    for (auto& task : tasks) {
+        task.wait();
+    }
+    for (auto& task : tasks) {
+        task.get();
+    }
+
+    stats = {};
+    for (const Stats& chunk : chunkStats) {
+        stats += chunk;
+    }
+
+    return commandBuffers;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void RenderGraph::updateDrawItems()
+{
+    drawItems.clear();
+    pipelineIds.clear();
+    materialIds.clear();
+    geometryIds.clear();
 
     for (const auto& [model, shaderNodes] : childNodeMap)
     {
-        bindGeometryBuffers(commandBuffer, model);
-        recordShaderNodes(shaderNodes, commandBuffer);
+        geometryIds.try_emplace(model.get(), static_cast<uint32_t>(geometryIds.size()));
+
+        for (const auto& shaderNode : shaderNodes)
+        {
+            pipelineIds.try_emplace(shaderNode.getShader().get(), static_cast<uint32_t>(pipelineIds.size()));
+
+            for (const auto& materialNode : shaderNode.getChildNodes())
+            {
+                materialIds.try_emplace(materialNode.getMaterial().get(), static_cast<uint32_t>(materialIds.size()));
+                const uint64_t sortKey = createSortKey(model, shaderNode, &materialNode);
+
+                for (const auto& meshNode : materialNode.getChildNodes()) {
+                    for (const auto& instance : meshNode.getInstances()) {
+                        drawItems.push_back({
+                            .model = &model,
+                            .shaderNode = &shaderNode,
+                            .materialNode = &materialNode,
+                            .meshNode = &meshNode,
+                            .instance = &instance,
+                            .sortKey = sortKey,
+                            .boundsItem = getBoundsItem(instance)
+                        });
+                    }
+                }
+            }
+        }
     }
+}
 
-    end(commandBuffer);
+// ---------------------------------------------------------------------------------------------------------------------
+
+uint64_t RenderGraph::createSortKey(
+    const ModelPtr& model,
+    const ShaderNode& shaderNode,
+    const MaterialNode* materialNode) const
+{
+    // only opaque geometry so far, everything is drawn in pass 0
+    return RenderQueue::createKey(
+        0,
+        pipelineIds.at(shaderNode.getShader().get()),
+        materialNode != nullptr ? materialIds.at(materialNode->getMaterial().get()) : 0,
+        geometryIds.at(model.get()));
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+const vector<RenderGraph::DrawItem>& RenderGraph::sortDrawItems()
+{
+    const glm::mat4 viewMatrix = camera ? camera->getViewMatrix() : glm::mat4(1.0f);
+
+    renderQueue.clear();
+
+    for (uint32_t i = 0; i < drawItems.size(); ++i)
+    {
+        const DrawItem& drawItem = drawItems[i];
+        if (!isVisible(drawItem.boundsItem)) {
+            continue;
+        }
+
+        float depth = 0.0f;
+        if (camera && drawItem.boundsItem != UINT32_MAX) {
+            const glm::vec3 center = meshHierarchy.getItemBounds(drawItem.boundsItem).getCenter();
+            depth = -(viewMatrix * glm::vec4(center, 1.0f)).z;
+        }
+
+        renderQueue.add(drawItem.sortKey | RenderQueue::createDepthKey(depth), i);
+    }
+
+    renderQueue.sort();
+
+    sortedDrawItems.clear();
+    for (const RenderQueue::Entry& entry : renderQueue.getEntries()) {
+        sortedDrawItems.push_back(drawItems[entry.item]);
+    }
+
+    return sortedDrawItems;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void RenderGraph::cullMeshes()
+{
+    if (!camera) {
+        return;
+    }
+
+    const Frustum frustum(camera->getProjectionMatrix() * camera->getViewMatrix());
+
+    visibleMeshItems.assign(visibleMeshItems.size(), false);
+    meshHierarchy.query(frustum, [this](uint32_t item) {
+        visibleMeshItems[item] = true;
+    });
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+bool RenderGraph::isVisible(uint32_t boundsItem) const
+{
+    return !camera || boundsItem == UINT32_MAX || visibleMeshItems[boundsItem];
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+RenderGraph::Stats RenderGraph::recordDrawItems(
+    const CommandBufferPtr& commandBuffer,
+    span<const DrawItem> drawItems)
+{
+    Stats drawStats;
+    const ModelPtr* boundModel = nullptr;
+    const MaterialShader* boundShader = nullptr;
+    const Material* boundMaterial = nullptr;
+
+    // the shader nodes of different models share their descriptor sets, so state is compared by shader and
+    // material instead of by node
+    for (const DrawItem& drawItem : drawItems)
+    {
+        if (drawItem.model != boundModel) {
+            bindGeometryBuffers(commandBuffer, *drawItem.model);
+            boundModel = drawItem.model;
+            drawStats.vertexBufferBindCount++;
+            drawStats.indexBufferBindCount++;
+        }
+
+        const MaterialShader* shader = drawItem.shaderNode->getShader().get();
+        if (shader != boundShader) {
+            drawItem.shaderNode->bindShader(commandBuffer);
+            boundShader = shader;
+            boundMaterial = nullptr;
+            drawStats.pipelineBindCount++;
+            drawStats.descriptorSetBindCount += drawItem.shaderNode->getDescriptorSetCount();
+        }
+
+        const Material* material = drawItem.materialNode->getMaterial().get();
+        if (material != boundMaterial) {
+            drawItem.materialNode->bindMaterial(commandBuffer);
+            boundMaterial = material;
+            drawStats.descriptorSetBindCount += drawItem.materialNode->isBindless() ? 0 : 1;
+        }
+
+        drawItem.meshNode->record(commandBuffer, *drawItem.instance);
+
+        const auto subMeshCount = static_cast<uint32_t>(drawItem.meshNode->getSubMeshes().size());
+        drawStats.descriptorSetBindCount++;
+        drawStats.drawCount += subMeshCount;
+        drawStats.instanceCount += subMeshCount;
+        drawStats.drawCallCount += subMeshCount;
+    }
+
+    return drawStats;
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
@@ -84,7 +815,8 @@ void RenderGraph::record(
 void RenderGraph::begin(
     const CommandBufferPtr& commandBuffer,
     VkRenderPass renderPass,
-    VkFramebuffer renderTarget)
+    VkFramebuffer renderTarget,
+    VkSubpassContents contents)
 {
     const unique_ptr<SwapChain>& swapChain = graphicsDevice->getSwapChain();
     const SwapChainDesc& swapChainDesc = swapChain->getDesc();
@@ -114,7 +846,7 @@ void RenderGraph::begin(
     };
 
     commandBuffer->begin();
-    commandBuffer->beginRenderPass(renderPassBeginInfo);
+    commandBuffer->beginRenderPass(renderPassBeginInfo, contents);
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
@@ -154,17 +886,6 @@ void RenderGraph::bindGeometryBuffers(
 
 // ---------------------------------------------------------------------------------------------------------------------
 
-void RenderGraph::recordShaderNodes(
-    const vector<ShaderNode>& shaderNodes,
-    const CommandBufferPtr& commandBuffer)
-{
-    for (const auto& shaderNode : shaderNodes) {
-        shaderNode.record(commandBuffer);
-    }
-}
-
-// ---------------------------------------------------------------------------------------------------------------------
-
 void RenderGraph::end(const CommandBufferPtr& commandBuffer)
 {
     commandBuffer->endRenderPass();
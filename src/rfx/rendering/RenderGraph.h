@@ -1,22 +1,75 @@
 #pragma once
 
+#include <span>
+
 #include "rfx/scene/Scene.h"
 #include "rfx/scene/Model.h"
 #include "rfx/scene/MaterialShader.h"
+#include "rfx/scene/Camera.h"
+#include "rfx/scene/BoundingVolumeHierarchy.h"
+#include "rfx/scene/BindlessMaterialTable.h"
 #include "rfx/rendering/ShaderNode.h"
+#include "rfx/rendering/RenderQueue.h"
+#include "rfx/common/ThreadPool.h"
 
 
 namespace rfx {
 
 /**
  *  TODO: support for multiple models
+ *
+ *  The scene descriptor sets are indexed by the frame index passed to record(), so that per-frame scene data can be
+ *  written while previous frames are still in flight.
+ *
+ *  The draws of all models are kept in a flat list. Each record() sorts the visible ones with a RenderQueue by
+ *  pipeline, material, geometry buffers and depth, and binds state only when it differs from the previous draw.
+ *
+ *  By default the graph is recorded inline into the given primary command buffer. With a record thread count > 1
+ *  the draws are split into contiguous chunks which are recorded in parallel into secondary command buffers, one
+ *  command pool per chunk, and then executed from the primary command buffer.
+ *
+ *  With indirect drawing enabled, each (model, shader, material) bucket is drawn with a single
+ *  vkCmdDrawIndexedIndirect. The shaders read the per-instance data (model matrix, material index) from a storage
+ *  buffer at set 3, indexed with gl_InstanceIndex. A mesh referenced by several nodes, e.g. repeated parts, is drawn
+ *  with one command whose instances are the referencing nodes. The commands and the per-instance data are kept in
+ *  host visible buffers per frame index and rewritten by each record(), so moved nodes are picked up without
+ *  rebuilding the draws. Indirect drawing is recorded inline.
+ *
+ *  Bindless materials are enabled together with indirect drawing, since the shaders take the material index from the
+ *  per-instance data. The descriptor set of a BindlessMaterialTable is bound at set 2 once per shader instead of a
+ *  descriptor set per material, so all materials of a (model, shader) pair are drawn with a single command.
+ *
+ *  With a camera set, meshes whose world bounds are outside the view frustum are skipped while recording. The
+ *  bounds are kept in a bounding volume hierarchy, which is culled top-down once per record(). It is built when a
+ *  model is added - call refitBounds() after re-compiling moved nodes. A mesh referenced by several nodes is culled
+ *  per node. Indirect draws are culled per instance: the visible instances of a command are written to the front of
+ *  its per-frame instance range and its instance count is set to their number.
  */
 class RenderGraph
 {
 public:
+    // counters of the last record(), user defined nodes aren't included
+    struct Stats
+    {
+        uint32_t drawCount = 0;             // including the draws of indirect draw calls
+        uint32_t instanceCount = 0;
+        uint32_t drawCallCount = 0;
+        uint32_t pipelineBindCount = 0;
+        uint32_t descriptorSetBindCount = 0;
+        uint32_t vertexBufferBindCount = 0;
+        uint32_t indexBufferBindCount = 0;
+
+        Stats& operator+=(const Stats& other);
+    };
+
     RenderGraph(
         GraphicsDevicePtr graphicsDevice,
-        VkDescriptorSet sceneDescriptorSet);
+        std::vector<VkDescriptorSet> sceneDescriptorSets);
+
+    ~RenderGraph();
+
+    void setRecordThreadCount(uint32_t threadCount);
+    [[nodiscard]] uint32_t getRecordThreadCount() const;
 
     void add(
         const ScenePtr& scene,
@@ -28,12 +81,66 @@ public:
 
     void add(RenderGraphNodePtr userDefinedNode);
 
+    // enables frustum culling, nullptr disables it
+    void setCamera(CameraPtr camera);
+    void updateBounds();     // rebuilds the hierarchy
+    void refitBounds();      // keeps the hierarchy topology, for moved nodes
+
+    // must be called after all models have been added; one descriptor set per frame index, like the scene
+    // descriptor sets, each with a single storage buffer binding. A material table enables bindless materials, it
+    // must contain the materials of all added models
+    void enableIndirectDrawing(
+        std::vector<VkDescriptorSet> drawDataDescriptorSets,
+        BindlessMaterialTablePtr materialTable = nullptr);
+
+    // frameIndex selects the scene descriptor set and the secondary command buffers, the previous submission of that
+    // frame index must have completed
     void record(
         const CommandBufferPtr& commandBuffer,
         VkRenderPass renderPass,
-        VkFramebuffer renderTarget);
+        VkFramebuffer renderTarget,
+        uint32_t frameIndex = 0);
+
+    [[nodiscard]] const Stats& getStats() const;
 
 private:
+    struct DrawData
+    {
+        glm::mat4 modelMatrix;
+        uint32_t materialIndex = 0;
+        uint32_t pad0 = 0;
+        uint32_t pad1 = 0;
+        uint32_t pad2 = 0;
+    };
+
+    struct IndirectBucket
+    {
+        const ModelPtr* model = nullptr;
+        const ShaderNode* shaderNode = nullptr;
+        const MaterialNode* materialNode = nullptr;     // nullptr for bindless materials
+        uint32_t firstDraw = 0;
+        uint32_t drawCount = 0;
+        uint64_t sortKey = 0;
+    };
+
+    struct IndirectInstance
+    {
+        const MeshNode::Instance* meshInstance = nullptr;
+        uint32_t materialIndex = 0;
+        uint32_t boundsItem = UINT32_MAX;       // item of the mesh hierarchy, UINT32_MAX if never culled
+    };
+
+    struct DrawItem
+    {
+        const ModelPtr* model = nullptr;
+        const ShaderNode* shaderNode = nullptr;
+        const MaterialNode* materialNode = nullptr;
+        const MeshNode* meshNode = nullptr;
+        const MeshNode::Instance* instance = nullptr;
+        uint64_t sortKey = 0;                   // without depth
+        uint32_t boundsItem = UINT32_MAX;       // item of the mesh hierarchy, UINT32_MAX if never culled
+    };
+
     void add(
         const MaterialShaderPtr& shader,
         const std::vector<MaterialPtr>& materials,
@@ -42,24 +149,85 @@ private:
     void begin(
         const CommandBufferPtr& commandBuffer,
         VkRenderPass renderPass,
-        VkFramebuffer renderTarget);
+        VkFramebuffer renderTarget,
+        VkSubpassContents contents);
     void setViewportAndScissor(const CommandBufferPtr& commandBuffer) const;
+    void setSceneDescriptorSet(VkDescriptorSet sceneDescriptorSet);
+    void setBindlessMaterials(ShaderNode& shaderNode) const;
+    void recordUserDefinedNodes(const CommandBufferPtr& commandBuffer) const;
+
+    const std::vector<CommandBufferPtr>& recordSecondaryCommandBuffers(
+        VkRenderPass renderPass,
+        VkFramebuffer renderTarget,
+        uint32_t frameIndex);
+
+    void updateDrawItems();
+    [[nodiscard]] uint64_t createSortKey(
+        const ModelPtr& model,
+        const ShaderNode& shaderNode,
+        const MaterialNode* materialNode) const;
+    const std::vector<DrawItem>& sortDrawItems();
+    void cullMeshes();
+    [[nodiscard]] uint32_t getBoundsItem(const MeshNode::Instance& instance) const;
+    [[nodiscard]] bool isVisible(uint32_t boundsItem) const;
+
+    static Stats recordDrawItems(
+        const CommandBufferPtr& commandBuffer,
+        std::span<const DrawItem> drawItems);
+
+    void buildIndirectDraws();
+    void updateIndirectDraws(uint32_t indirectFrameIndex);
+    [[nodiscard]] Stats recordIndirectDraws(
+        const CommandBufferPtr& commandBuffer,
+        uint32_t indirectFrameIndex) const;
+    [[nodiscard]] BufferPtr createHostVisibleBuffer(
+        VkBufferUsageFlags usage,
+        VkDeviceSize size) const;
+
+    void createRecordCommandPools(uint32_t count);
+    void destroyRecordCommandPools();
 
     static void bindGeometryBuffers(
         const CommandBufferPtr& commandBuffer,
         const ModelPtr& model);
 
-    static void recordShaderNodes(
-        const std::vector<ShaderNode>& shaderNodes,
-        const CommandBufferPtr& commandBuffer);
-
     static void end(const CommandBufferPtr& commandBuffer);
 
 
     GraphicsDevicePtr graphicsDevice;
+    std::vector<VkDescriptorSet> sceneDescriptorSets;
     VkDescriptorSet sceneDescriptorSet = VK_NULL_HANDLE;
     std::unordered_map<ModelPtr, std::vector<ShaderNode>> childNodeMap;
     std::vector<RenderGraphNodePtr> userDefinedNodes;
+
+    CameraPtr camera;
+    BoundingVolumeHierarchy meshHierarchy;
+    std::vector<std::pair<const ModelNode*, uint32_t>> meshHierarchyItems;
+    std::unordered_map<const ModelNode*, std::vector<uint32_t>> nodeItems;     // per mesh of the node
+    std::vector<bool> visibleMeshItems;
+
+    std::vector<DrawItem> drawItems;
+    std::unordered_map<const MaterialShader*, uint32_t> pipelineIds;
+    std::unordered_map<const Material*, uint32_t> materialIds;
+    std::unordered_map<const Model*, uint32_t> geometryIds;
+    RenderQueue renderQueue;
+    std::vector<DrawItem> sortedDrawItems;
+    Stats stats;
+
+    uint32_t recordThreadCount = 1;
+    std::unique_ptr<ThreadPool> recordThreadPool;
+    std::vector<VkCommandPool> recordCommandPools;
+    std::vector<std::vector<CommandBufferPtr>> secondaryCommandBuffers;     // per frame index
+
+    BindlessMaterialTablePtr bindlessMaterialTable;
+
+    std::vector<VkDescriptorSet> drawDataDescriptorSets;      // per frame index, empty without indirect drawing
+    std::vector<BufferPtr> indirectCommandsBuffers;           // per frame index
+    std::vector<BufferPtr> drawDataBuffers;                   // per frame index
+    std::vector<VkDrawIndexedIndirectCommand> indirectCommands;
+    std::vector<IndirectInstance> indirectInstances;          // in draw data order
+    std::vector<uint32_t> visibleInstanceCounts;              // per indirect command, of the last record()
+    std::vector<IndirectBucket> indirectBuckets;
 };
 
 using RenderGraphPtr = std::shared_ptr<RenderGraph>;
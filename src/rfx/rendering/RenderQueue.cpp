@@ -0,0 +1,111 @@
+#include "rfx/pch.h"
+#include "rfx/rendering/RenderQueue.h"
+
+#include <array>
+
+using namespace rfx;
+using namespace std;
+
+static constexpr uint32_t RADIX_BITS = 8;
+static constexpr uint32_t RADIX_SIZE = 1u << RADIX_BITS;
+static constexpr uint64_t RADIX_MASK = RADIX_SIZE - 1;
+
+// below this the counting passes cost more than a comparison sort
+static constexpr size_t MIN_RADIX_SORT_SIZE = 256;
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+static uint64_t truncate(uint32_t value, uint32_t bitCount)
+{
+    return value & ((1ull << bitCount) - 1);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+uint64_t RenderQueue::createKey(
+    uint32_t pass,
+    uint32_t pipeline,
+    uint32_t material,
+    uint32_t geometry)
+{
+    uint64_t key = truncate(pass, PASS_BITS);
+    key = key << PIPELINE_BITS | truncate(pipeline, PIPELINE_BITS);
+    key = key << MATERIAL_BITS | truncate(material, MATERIAL_BITS);
+    key = key << GEOMETRY_BITS | truncate(geometry, GEOMETRY_BITS);
+
+    return key << DEPTH_BITS;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+uint64_t RenderQueue::createDepthKey(float depth)
+{
+    // the bit patterns of non-negative floats are ordered like their values,
+    // so the upper bits are a quantization with constant relative precision
+    const float clampedDepth = depth > 0.0f ? depth : 0.0f;
+    uint32_t depthBits = 0;
+    memcpy(&depthBits, &clampedDepth, sizeof(depthBits));
+
+    return depthBits >> (31 - DEPTH_BITS);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void RenderQueue::clear()
+{
+    entries.clear();
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void RenderQueue::add(uint64_t key, uint32_t item)
+{
+    entries.push_back({ key, item });
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void RenderQueue::sort()
+{
+    if (entries.size() < MIN_RADIX_SORT_SIZE) {
+        ranges::stable_sort(entries, {}, &Entry::key);
+        return;
+    }
+
+    sortBuffer.resize(entries.size());
+
+    for (uint32_t shift = 0; shift < 64; shift += RADIX_BITS)
+    {
+        array<uint32_t, RADIX_SIZE> offsets {};
+        for (const Entry& entry : entries) {
+            offsets[(entry.key >> shift) & RADIX_MASK]++;
+        }
+
+        // most digits are equal for all keys, e.g. the pass or unused id bits
+        if (offsets[(entries[0].key >> shift) & RADIX_MASK] == entries.size()) {
+            continue;
+        }
+
+        uint32_t offset = 0;
+        for (uint32_t& digitOffset : offsets) {
+            const uint32_t count = digitOffset;
+            digitOffset = offset;
+            offset += count;
+        }
+
+        for (const Entry& entry : entries) {
+            sortBuffer[offsets[(entry.key >> shift) & RADIX_MASK]++] = entry;
+        }
+
+        entries.swap(sortBuffer);
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+const vector<RenderQueue::Entry>& RenderQueue::getEntries() const
+{
+    return entries;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,52 @@
+#pragma once
+
+
+namespace rfx {
+
+/**
+ *  Flat list of draws, sorted by a 64-bit key so that draws sharing state end up next to each other.
+ *
+ *  Key layout from the most significant bit: pass (4 bits), pipeline (12), material (16), geometry buffers (12),
+ *  depth (20). The ids are truncated to their bit count - colliding ids only make the order less optimal, callers
+ *  still compare the actual state before binding it. Depth is sorted front to back.
+ */
+class RenderQueue
+{
+public:
+    static constexpr uint32_t PASS_BITS = 4;
+    static constexpr uint32_t PIPELINE_BITS = 12;
+    static constexpr uint32_t MATERIAL_BITS = 16;
+    static constexpr uint32_t GEOMETRY_BITS = 12;
+    static constexpr uint32_t DEPTH_BITS = 20;
+
+    struct Entry
+    {
+        uint64_t key = 0;
+        uint32_t item = 0;      // caller defined, e.g. an index into a list of draws
+    };
+
+    // the state part of a key, the depth bits are 0
+    [[nodiscard]] static uint64_t createKey(
+        uint32_t pass,
+        uint32_t pipeline,
+        uint32_t material,
+        uint32_t geometry);
+
+    // the depth part of a key, to be or-ed with the state part; depth is the view space distance, negative values
+    // are clamped to 0
+    [[nodiscard]] static uint64_t createDepthKey(float depth);
+
+    void clear();
+    void add(uint64_t key, uint32_t item);
+
+    // stable LSD radix sort by key
+    void sort();
+
+    [[nodiscard]] const std::vector<Entry>& getEntries() const;
+
+private:
+    std::vector<Entry> entries;
+    std::vector<Entry> sortBuffer;
+};
+
+} // namespace rfx
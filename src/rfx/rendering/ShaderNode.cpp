@@ -58,6 +58,56 @@ void ShaderNode::bindShader(const CommandBufferPtr& commandBuffer) const
         shader->getPipelineLayout(),
         1,
         shader->getShaderDescriptorSet());
+
+    if (materialDescriptorSet != VK_NULL_HANDLE) {
+        commandBuffer->bindDescriptorSet(
+            VK_PIPELINE_BIND_POINT_GRAPHICS,
+            shader->getPipelineLayout(),
+            2,
+            materialDescriptorSet);
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+uint32_t ShaderNode::getDescriptorSetCount() const
+{
+    return materialDescriptorSet != VK_NULL_HANDLE ? 3 : 2;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+const vector<MaterialNode>& ShaderNode::getChildNodes() const
+{
+    return childNodes;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+vector<MaterialNode>& ShaderNode::getChildNodes()
+{
+    return childNodes;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void ShaderNode::setSceneDescriptorSet(VkDescriptorSet sceneDescriptorSet)
+{
+    this->sceneDescriptorSet = sceneDescriptorSet;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void ShaderNode::setMaterialDescriptorSet(VkDescriptorSet materialDescriptorSet)
+{
+    this->materialDescriptorSet = materialDescriptorSet;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+const MaterialShaderPtr& ShaderNode::getShader() const
+{
+    return shader;
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
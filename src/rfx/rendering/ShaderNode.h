@@ -19,14 +19,27 @@ public:
 
     void record(const CommandBufferPtr& commandBuffer) const override;
 
+    void bindShader(const CommandBufferPtr& commandBuffer) const;
+
+    // number of descriptor sets bound by bindShader()
+    [[nodiscard]] uint32_t getDescriptorSetCount() const;
+
+    void setSceneDescriptorSet(VkDescriptorSet sceneDescriptorSet);
+
+    // bound at set 2 together with the shader, for bindless materials shared by all child nodes
+    void setMaterialDescriptorSet(VkDescriptorSet materialDescriptorSet);
+
+    [[nodiscard]] const std::vector<MaterialNode>& getChildNodes() const;
+    [[nodiscard]] std::vector<MaterialNode>& getChildNodes();
+    [[nodiscard]] const MaterialShaderPtr& getShader() const;
+
 private:
     void add(const std::vector<MaterialPtr>& materials, const ModelPtr& model);
 
-    void bindShader(const CommandBufferPtr& commandBuffer) const;
-
     MaterialShaderPtr shader;
     std::vector<MaterialNode> childNodes;
     VkDescriptorSet sceneDescriptorSet = VK_NULL_HANDLE;
+    VkDescriptorSet materialDescriptorSet = VK_NULL_HANDLE;
 };
 
 } // namespace rfx
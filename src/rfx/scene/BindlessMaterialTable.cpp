@@ -0,0 +1,331 @@
+#include "rfx/pch.h"
+#include "rfx/scene/BindlessMaterialTable.h"
+
+#include <array>
+
+using namespace rfx;
+using namespace std;
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BindlessMaterialTable::BindlessMaterialTable(
+    GraphicsDevicePtr graphicsDevice,
+    uint32_t maxTextureCount)
+        : graphicsDevice(move(graphicsDevice))
+{
+    RFX_CHECK_STATE(this->graphicsDevice->isBindlessSupported(), "Bindless textures are not supported by the device");
+
+    const VkPhysicalDeviceLimits& limits = this->graphicsDevice->getDesc().properties.limits;
+    this->maxTextureCount = min({
+        maxTextureCount,
+        limits.maxPerStageDescriptorSampledImages,
+        limits.maxPerStageDescriptorSamplers,
+        limits.maxDescriptorSetSampledImages,
+        limits.maxDescriptorSetSamplers
+    });
+
+    createDescriptorSetLayout();
+    createDescriptorPool();
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BindlessMaterialTable::~BindlessMaterialTable()
+{
+    const VkDevice device = graphicsDevice->getLogicalDevice();
+
+    vkDestroyDescriptorPool(device, descriptorPool, nullptr);
+    vkDestroyDescriptorSetLayout(device, descriptorSetLayout, nullptr);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void BindlessMaterialTable::createDescriptorSetLayout()
+{
+    const array<VkDescriptorSetLayoutBinding, 2> bindings {{
+        {
+            .binding = MATERIAL_DATA_BINDING,
+            .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            .descriptorCount = 1,
+            .stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT
+        },
+        {
+            .binding = TEXTURES_BINDING,
+            .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+            .descriptorCount = maxTextureCount,
+            .stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT
+        }
+    }};
+
+    // the actual texture count is set per descriptor set, see allocateDescriptorSet()
+    const array<VkDescriptorBindingFlags, 2> bindingFlags {
+        0,
+        VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT | VK_DESCRIPTOR_BINDING_VARIABLE_DESCRIPTOR_COUNT_BIT
+    };
+
+    const VkDescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsCreateInfo {
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO,
+        .bindingCount = static_cast<uint32_t>(bindingFlags.size()),
+        .pBindingFlags = bindingFlags.data()
+    };
+
+    const VkDescriptorSetLayoutCreateInfo createInfo {
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+        .pNext = &bindingFlagsCreateInfo,
+        .bindingCount = static_cast<uint32_t>(bindings.size()),
+        .pBindings = bindings.data()
+    };
+
+    ThrowIfFailed(vkCreateDescriptorSetLayout(
+        graphicsDevice->getLogicalDevice(),
+        &createInfo,
+        nullptr,
+        &descriptorSetLayout));
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void BindlessMaterialTable::createDescriptorPool()
+{
+    const array<VkDescriptorPoolSize, 2> poolSizes {{
+        { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1 },
+        { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, maxTextureCount }
+    }};
+
+    const VkDescriptorPoolCreateInfo createInfo {
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+        .maxSets = 1,
+        .poolSizeCount = static_cast<uint32_t>(poolSizes.size()),
+        .pPoolSizes = poolSizes.data()
+    };
+
+    ThrowIfFailed(vkCreateDescriptorPool(
+        graphicsDevice->getLogicalDevice(),
+        &createInfo,
+        nullptr,
+        &descriptorPool));
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void BindlessMaterialTable::build(const ScenePtr& scene)
+{
+    materials.clear();
+    materialIndices.clear();
+    textures.clear();
+    textureIndices.clear();
+
+    for (const auto& model : scene->getModels()) {
+        for (const auto& material : model->getMaterials())
+        {
+            if (materialIndices.contains(material.get())) {
+                continue;
+            }
+
+            materialIndices.emplace(material.get(), static_cast<uint32_t>(materials.size()));
+            materials.push_back(material);
+        }
+    }
+
+    for (const auto& material : materials) {
+        addTexture(material->getBaseColorTexture());
+        addTexture(material->getMetallicRoughnessTexture());
+        addTexture(material->getNormalTexture());
+        addTexture(material->getOcclusionTexture());
+        addTexture(material->getEmissiveTexture());
+    }
+
+    RFX_CHECK_STATE(textures.size() <= maxTextureCount,
+        fmt::format("Scene has {} textures, at most {} are supported", textures.size(), maxTextureCount));
+
+    createMaterialDataBuffer();
+    allocateDescriptorSet();
+    writeDescriptorSet();
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+int32_t BindlessMaterialTable::addTexture(const shared_ptr<Texture2D>& texture)
+{
+    if (texture == nullptr) {
+        return -1;
+    }
+
+    const auto [it, inserted] = textureIndices.try_emplace(texture.get(), static_cast<int32_t>(textures.size()));
+    if (inserted) {
+        textures.push_back(texture);
+    }
+
+    return it->second;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void BindlessMaterialTable::createMaterialDataBuffer()
+{
+    // an empty storage buffer isn't allowed, so there's always room for at least one material
+    const size_t materialCount = max<size_t>(materials.size(), 1);
+
+    materialDataBuffer = graphicsDevice->createBuffer(
+        materialCount * sizeof(MaterialData),
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    graphicsDevice->bind(materialDataBuffer);
+
+    vector<MaterialData> materialData(materialCount);
+    ranges::transform(materials, materialData.begin(),
+        [this](const MaterialPtr& material) { return createDataFor(material); });
+
+    materialDataBuffer->load(materialData.size() * sizeof(MaterialData), materialData.data());
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void BindlessMaterialTable::allocateDescriptorSet()
+{
+    ThrowIfFailed(vkResetDescriptorPool(graphicsDevice->getLogicalDevice(), descriptorPool, 0));
+
+    const auto textureCount = static_cast<uint32_t>(textures.size());
+
+    const VkDescriptorSetVariableDescriptorCountAllocateInfo variableCountAllocateInfo {
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_VARIABLE_DESCRIPTOR_COUNT_ALLOCATE_INFO,
+        .descriptorSetCount = 1,
+        .pDescriptorCounts = &textureCount
+    };
+
+    const VkDescriptorSetAllocateInfo allocInfo {
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+        .pNext = &variableCountAllocateInfo,
+        .descriptorPool = descriptorPool,
+        .descriptorSetCount = 1,
+        .pSetLayouts = &descriptorSetLayout
+    };
+
+    ThrowIfFailed(vkAllocateDescriptorSets(
+        graphicsDevice->getLogicalDevice(),
+        &allocInfo,
+        &descriptorSet));
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void BindlessMaterialTable::writeDescriptorSet()
+{
+    vector<VkDescriptorImageInfo> imageInfos;
+    imageInfos.reserve(textures.size());
+    ranges::transform(textures, back_inserter(imageInfos),
+        [](const shared_ptr<Texture2D>& texture) { return texture->getDescriptorImageInfo(); });
+
+    vector<VkWriteDescriptorSet> writeDescriptorSets {
+        {
+            .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            .dstSet = descriptorSet,
+            .dstBinding = MATERIAL_DATA_BINDING,
+            .dstArrayElement = 0,
+            .descriptorCount = 1,
+            .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            .pBufferInfo = &materialDataBuffer->getDescriptorBufferInfo()
+        }
+    };
+
+    if (!imageInfos.empty()) {
+        writeDescriptorSets.push_back({
+            .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            .dstSet = descriptorSet,
+            .dstBinding = TEXTURES_BINDING,
+            .dstArrayElement = 0,
+            .descriptorCount = static_cast<uint32_t>(imageInfos.size()),
+            .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+            .pImageInfo = imageInfos.data()
+        });
+    }
+
+    vkUpdateDescriptorSets(
+        graphicsDevice->getLogicalDevice(),
+        static_cast<uint32_t>(writeDescriptorSets.size()),
+        writeDescriptorSets.data(),
+        0,
+        nullptr);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BindlessMaterialTable::MaterialData BindlessMaterialTable::createDataFor(const MaterialPtr& material) const
+{
+    const auto getTextureIndex = [this](const shared_ptr<Texture2D>& texture) {
+        return texture != nullptr ? textureIndices.at(texture.get()) : -1;
+    };
+
+    const auto getTexCoordSet = [](int texCoordSet) {
+        return static_cast<uint32_t>(max(texCoordSet, 0)) & 0xFu;
+    };
+
+    return {
+        .baseColorFactor = material->getBaseColorFactor(),
+        .emissiveFactor = material->getEmissiveFactor(),
+        .metallicFactor = material->getMetallicFactor(),
+        .roughnessFactor = material->getRoughnessFactor(),
+        .occlusionStrength = material->getOcclusionStrength(),
+        .texCoordSets = getTexCoordSet(material->getBaseColorTexCoordSet())
+            | getTexCoordSet(material->getMetallicRoughnessTexCoordSet()) << 4
+            | getTexCoordSet(material->getNormalTexCoordSet()) << 8
+            | getTexCoordSet(material->getOcclusionTexCoordSet()) << 12
+            | getTexCoordSet(material->getEmissiveTexCoordSet()) << 16,
+        .baseColorTexture = getTextureIndex(material->getBaseColorTexture()),
+        .metallicRoughnessTexture = getTextureIndex(material->getMetallicRoughnessTexture()),
+        .normalTexture = getTextureIndex(material->getNormalTexture()),
+        .occlusionTexture = getTextureIndex(material->getOcclusionTexture()),
+        .emissiveTexture = getTextureIndex(material->getEmissiveTexture())
+    };
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void BindlessMaterialTable::update(const MaterialPtr& material)
+{
+    const MaterialData materialData = createDataFor(material);
+    const uint32_t materialIndex = getMaterialIndex(material);
+
+    auto* mappedData = static_cast<MaterialData*>(materialDataBuffer->getMappedData());
+    mappedData[materialIndex] = materialData;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+uint32_t BindlessMaterialTable::getMaterialIndex(const MaterialPtr& material) const
+{
+    const auto it = materialIndices.find(material.get());
+    RFX_CHECK_ARGUMENT(it != materialIndices.end());
+
+    return it->second;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+uint32_t BindlessMaterialTable::getMaterialCount() const
+{
+    return static_cast<uint32_t>(materials.size());
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+uint32_t BindlessMaterialTable::getTextureCount() const
+{
+    return static_cast<uint32_t>(textures.size());
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+VkDescriptorSetLayout BindlessMaterialTable::getDescriptorSetLayout() const
+{
+    return descriptorSetLayout;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+VkDescriptorSet BindlessMaterialTable::getDescriptorSet() const
+{
+    return descriptorSet;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "rfx/scene/Scene.h"
+#include "rfx/graphics/GraphicsDevice.h"
+
+
+namespace rfx {
+
+/**
+ *  Parameters and textures of all materials of a scene in a single descriptor set, requires
+ *  GraphicsDevice::isBindlessSupported().
+ *
+ *  Binding 0 is a storage buffer with one MaterialData per material, indexed by getMaterialIndex(). Binding 1 is a
+ *  runtime sized array with all textures, MaterialData references them by index (-1 if the material has none).
+ *  Shaders select the material by index instead of binding a descriptor set per material, so draws with different
+ *  materials but the same shader permutation can be merged.
+ */
+class BindlessMaterialTable
+{
+public:
+    static constexpr uint32_t MATERIAL_DATA_BINDING = 0;
+    static constexpr uint32_t TEXTURES_BINDING = 1;
+    static constexpr uint32_t DEFAULT_MAX_TEXTURE_COUNT = 4096;
+
+    // std430 layout, must match assets/shaders/pbr_gltf/bindless.glsl
+    struct MaterialData
+    {
+        glm::vec4 baseColorFactor { 1.0f };
+        glm::vec3 emissiveFactor { 0.0f };
+        float metallicFactor = 1.0f;
+        float roughnessFactor = 1.0f;
+        float occlusionStrength = 1.0f;
+        uint32_t texCoordSets = 0;          // 4 bits per texture, in the order of the texture indices below
+        uint32_t pad0 = 0;
+        int32_t baseColorTexture = -1;
+        int32_t metallicRoughnessTexture = -1;
+        int32_t normalTexture = -1;
+        int32_t occlusionTexture = -1;
+        int32_t emissiveTexture = -1;
+        uint32_t pad1 = 0;
+        uint32_t pad2 = 0;
+        uint32_t pad3 = 0;
+    };
+
+    explicit BindlessMaterialTable(
+        GraphicsDevicePtr graphicsDevice,
+        uint32_t maxTextureCount = DEFAULT_MAX_TEXTURE_COUNT);
+
+    ~BindlessMaterialTable();
+
+    BindlessMaterialTable(const BindlessMaterialTable&) = delete;
+    BindlessMaterialTable& operator=(const BindlessMaterialTable&) = delete;
+
+    // Replaces the previous content, descriptor sets returned before are invalid afterwards. Must not be called while
+    // frames that use the table are in flight.
+    void build(const ScenePtr& scene);
+
+    // rewrites the parameters of a material of the table, its textures must not change
+    void update(const MaterialPtr& material);
+
+    [[nodiscard]] uint32_t getMaterialIndex(const MaterialPtr& material) const;
+    [[nodiscard]] uint32_t getMaterialCount() const;
+    [[nodiscard]] uint32_t getTextureCount() const;
+
+    [[nodiscard]] VkDescriptorSetLayout getDescriptorSetLayout() const;
+    [[nodiscard]] VkDescriptorSet getDescriptorSet() const;
+
+private:
+    void createDescriptorSetLayout();
+    void createDescriptorPool();
+    void allocateDescriptorSet();
+    void createMaterialDataBuffer();
+    void writeDescriptorSet();
+
+    int32_t addTexture(const std::shared_ptr<Texture2D>& texture);
+    [[nodiscard]] MaterialData createDataFor(const MaterialPtr& material) const;
+
+    GraphicsDevicePtr graphicsDevice;
+    uint32_t maxTextureCount = 0;
+
+    VkDescriptorSetLayout descriptorSetLayout = VK_NULL_HANDLE;
+    VkDescriptorPool descriptorPool = VK_NULL_HANDLE;
+    VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+
+    std::vector<MaterialPtr> materials;
+    std::unordered_map<const Material*, uint32_t> materialIndices;
+    std::vector<std::shared_ptr<Texture2D>> textures;
+    std::unordered_map<const Texture2D*, int32_t> textureIndices;
+    BufferPtr materialDataBuffer;
+};
+
+using BindlessMaterialTablePtr = std::shared_ptr<BindlessMaterialTable>;
+
+} // namespace rfx
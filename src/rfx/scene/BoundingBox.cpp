@@ -0,0 +1,78 @@
+#include "rfx/pch.h"
+#include "rfx/scene/BoundingBox.h"
+
+using namespace rfx;
+using namespace glm;
+using namespace std;
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+bool BoundingBox::isValid() const
+{
+    return min.x <= max.x && min.y <= max.y && min.z <= max.z;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+vec3 BoundingBox::getCenter() const
+{
+    return (min + max) * 0.5f;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+vec3 BoundingBox::getExtents() const
+{
+    return (max - min) * 0.5f;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void BoundingBox::extend(const vec3& point)
+{
+    min = glm::min(min, point);
+    max = glm::max(max, point);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void BoundingBox::extend(const BoundingBox& other)
+{
+    if (!other.isValid()) {
+        return;
+    }
+
+    min = glm::min(min, other.min);
+    max = glm::max(max, other.max);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+bool BoundingBox::overlaps(const BoundingBox& other) const
+{
+    return min.x <= other.max.x && max.x >= other.min.x
+        && min.y <= other.max.y && max.y >= other.min.y
+        && min.z <= other.max.z && max.z >= other.min.z;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BoundingBox BoundingBox::transform(const mat4& matrix) const
+{
+    if (!isValid()) {
+        return {};
+    }
+
+    // Arvo's method: transformed extents are the absolute rotation/scale part applied to the local extents
+    const vec3 center = vec3(matrix * vec4(getCenter(), 1.0f));
+    const mat3 absMatrix {
+        abs(vec3(matrix[0])),
+        abs(vec3(matrix[1])),
+        abs(vec3(matrix[2]))
+    };
+    const vec3 extents = absMatrix * getExtents();
+
+    return { center - extents, center + extents };
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,24 @@
+#pragma once
+
+
+namespace rfx {
+
+// Axis aligned bounding box, invalid (empty) until extended by the first point
+struct BoundingBox
+{
+    glm::vec3 min { std::numeric_limits<float>::max() };
+    glm::vec3 max { std::numeric_limits<float>::lowest() };
+
+    [[nodiscard]] bool isValid() const;
+    [[nodiscard]] glm::vec3 getCenter() const;
+    [[nodiscard]] glm::vec3 getExtents() const;
+
+    void extend(const glm::vec3& point);
+    void extend(const BoundingBox& other);
+
+    [[nodiscard]] bool overlaps(const BoundingBox& other) const;
+
+    [[nodiscard]] BoundingBox transform(const glm::mat4& matrix) const;
+};
+
+} // namespace rfx
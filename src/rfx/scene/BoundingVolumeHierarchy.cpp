@@ -0,0 +1,358 @@
+#include "rfx/pch.h"
+#include "rfx/scene/BoundingVolumeHierarchy.h"
+
+#include <array>
+
+using namespace rfx;
+using namespace glm;
+using namespace std;
+
+// a median split tree over uint32_t items is at most 33 levels deep
+static constexpr size_t MAX_STACK_SIZE = 64;
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+static optional<float> intersect(
+    const vec3& min,
+    const vec3& max,
+    const Ray& ray,
+    const vec3& inverseDirection,
+    float maxDistance)
+{
+    const vec3 t0 = (min - ray.origin) * inverseDirection;
+    const vec3 t1 = (max - ray.origin) * inverseDirection;
+    const vec3 tMin = glm::min(t0, t1);
+    const vec3 tMax = glm::max(t0, t1);
+
+    const float entry = std::max({ tMin.x, tMin.y, tMin.z, 0.0f });
+    const float exit = std::min({ tMax.x, tMax.y, tMax.z, maxDistance });
+
+    if (entry > exit) {
+        return nullopt;
+    }
+
+    return entry;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void BoundingVolumeHierarchy::build(vector<BoundingBox> itemBounds)
+{
+    RFX_CHECK_ARGUMENT(ranges::all_of(itemBounds, &BoundingBox::isValid));
+
+    this->itemBounds = move(itemBounds);
+    const auto itemCount = static_cast<uint32_t>(this->itemBounds.size());
+
+    nodes.clear();
+    parents.clear();
+    dirtyNodes.clear();
+
+    items.resize(itemCount);
+    iota(items.begin(), items.end(), 0u);
+    itemLeaves.assign(itemCount, UINT32_MAX);
+
+    if (itemCount > 0) {
+        nodes.reserve(2 * itemCount);
+        parents.reserve(2 * itemCount);
+        buildNode(UINT32_MAX, 0, itemCount);
+    }
+
+    dirtyFlags.assign(nodes.size(), false);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+uint32_t BoundingVolumeHierarchy::buildNode(uint32_t parent, uint32_t first, uint32_t count)
+{
+    const auto nodeIndex = static_cast<uint32_t>(nodes.size());
+    nodes.emplace_back();
+    parents.push_back(parent);
+
+    BoundingBox bounds;
+    BoundingBox centroidBounds;
+    for (uint32_t i = first; i < first + count; ++i) {
+        bounds.extend(itemBounds[items[i]]);
+        centroidBounds.extend(itemBounds[items[i]].getCenter());
+    }
+
+    if (count <= MAX_LEAF_SIZE)
+    {
+        for (uint32_t i = first; i < first + count; ++i) {
+            itemLeaves[items[i]] = nodeIndex;
+        }
+
+        nodes[nodeIndex] = {
+            .min = bounds.min,
+            .offset = first,
+            .max = bounds.max,
+            .itemCount = count
+        };
+
+        return nodeIndex;
+    }
+
+    // median split along the longest axis of the item centers
+    const vec3 size = centroidBounds.max - centroidBounds.min;
+    const int axis = size.x > size.y ? (size.x > size.z ? 0 : 2) : (size.y > size.z ? 1 : 2);
+    const uint32_t leftCount = count / 2;
+
+    nth_element(
+        items.begin() + first,
+        items.begin() + first + leftCount,
+        items.begin() + first + count,
+        [this, axis](uint32_t lhs, uint32_t rhs) {
+            return itemBounds[lhs].getCenter()[axis] < itemBounds[rhs].getCenter()[axis];
+        });
+
+    buildNode(nodeIndex, first, leftCount);
+    const uint32_t rightChild = buildNode(nodeIndex, first + leftCount, count - leftCount);
+
+    nodes[nodeIndex] = {
+        .min = bounds.min,
+        .offset = rightChild,
+        .max = bounds.max,
+        .itemCount = 0
+    };
+
+    return nodeIndex;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void BoundingVolumeHierarchy::setItemBounds(uint32_t item, const BoundingBox& bounds)
+{
+    RFX_CHECK_ARGUMENT(item < itemBounds.size());
+    RFX_CHECK_ARGUMENT(bounds.isValid());
+
+    itemBounds[item] = bounds;
+
+    for (uint32_t nodeIndex = itemLeaves[item];
+         nodeIndex != UINT32_MAX && !dirtyFlags[nodeIndex];
+         nodeIndex = parents[nodeIndex]) {
+        dirtyFlags[nodeIndex] = true;
+        dirtyNodes.push_back(nodeIndex);
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void BoundingVolumeHierarchy::refit()
+{
+    // children are stored after their parents, so descending order refits children first
+    ranges::sort(dirtyNodes, greater<>());
+
+    for (uint32_t nodeIndex : dirtyNodes) {
+        refitNode(nodeIndex);
+        dirtyFlags[nodeIndex] = false;
+    }
+
+    dirtyNodes.clear();
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void BoundingVolumeHierarchy::refitNode(uint32_t nodeIndex)
+{
+    Node& node = nodes[nodeIndex];
+    BoundingBox bounds;
+
+    if (node.isLeaf()) {
+        for (uint32_t i = node.offset; i < node.offset + node.itemCount; ++i) {
+            bounds.extend(itemBounds[items[i]]);
+        }
+    }
+    else {
+        const Node& leftChild = nodes[nodeIndex + 1];
+        const Node& rightChild = nodes[node.offset];
+        bounds = BoundingBox { leftChild.min, leftChild.max };
+        bounds.extend(BoundingBox { rightChild.min, rightChild.max });
+    }
+
+    node.min = bounds.min;
+    node.max = bounds.max;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void BoundingVolumeHierarchy::query(
+    const Frustum& frustum,
+    const function<void(uint32_t item)>& callback) const
+{
+    if (nodes.empty()) {
+        return;
+    }
+
+    array<uint32_t, MAX_STACK_SIZE> stack {};
+    size_t stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0)
+    {
+        const uint32_t nodeIndex = stack[--stackSize];
+        const Node& node = nodes[nodeIndex];
+
+        const Frustum::Containment containment = frustum.classify({ node.min, node.max });
+        if (containment == Frustum::Containment::OUTSIDE) {
+            continue;
+        }
+        if (containment == Frustum::Containment::INSIDE) {
+            forEachItem(nodeIndex, callback);
+            continue;
+        }
+
+        if (node.isLeaf()) {
+            for (uint32_t i = node.offset; i < node.offset + node.itemCount; ++i) {
+                if (frustum.isVisible(itemBounds[items[i]])) {
+                    callback(items[i]);
+                }
+            }
+        }
+        else {
+            stack[stackSize++] = node.offset;
+            stack[stackSize++] = nodeIndex + 1;
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void BoundingVolumeHierarchy::query(
+    const BoundingBox& range,
+    const function<void(uint32_t item)>& callback) const
+{
+    if (nodes.empty() || !range.isValid()) {
+        return;
+    }
+
+    array<uint32_t, MAX_STACK_SIZE> stack {};
+    size_t stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0)
+    {
+        const uint32_t nodeIndex = stack[--stackSize];
+        const Node& node = nodes[nodeIndex];
+
+        if (!range.overlaps({ node.min, node.max })) {
+            continue;
+        }
+
+        if (node.isLeaf()) {
+            for (uint32_t i = node.offset; i < node.offset + node.itemCount; ++i) {
+                if (range.overlaps(itemBounds[items[i]])) {
+                    callback(items[i]);
+                }
+            }
+        }
+        else {
+            stack[stackSize++] = node.offset;
+            stack[stackSize++] = nodeIndex + 1;
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+optional<BoundingVolumeHierarchy::RayHit> BoundingVolumeHierarchy::raycast(
+    const Ray& ray,
+    float maxDistance) const
+{
+    if (nodes.empty()) {
+        return nullopt;
+    }
+
+    const vec3 inverseDirection = 1.0f / ray.direction;
+    optional<RayHit> nearestHit;
+    float nearestDistance = maxDistance;
+
+    array<uint32_t, MAX_STACK_SIZE> stack {};
+    size_t stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0)
+    {
+        const uint32_t nodeIndex = stack[--stackSize];
+        const Node& node = nodes[nodeIndex];
+
+        if (!intersect(node.min, node.max, ray, inverseDirection, nearestDistance)) {
+            continue;
+        }
+
+        if (node.isLeaf()) {
+            for (uint32_t i = node.offset; i < node.offset + node.itemCount; ++i)
+            {
+                const BoundingBox& bounds = itemBounds[items[i]];
+                const optional<float> distance = intersect(bounds.min, bounds.max, ray, inverseDirection, nearestDistance);
+                if (distance) {
+                    nearestDistance = *distance;
+                    nearestHit = RayHit { .item = items[i], .distance = *distance };
+                }
+            }
+        }
+        else {
+            stack[stackSize++] = node.offset;
+            stack[stackSize++] = nodeIndex + 1;
+        }
+    }
+
+    return nearestHit;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void BoundingVolumeHierarchy::forEachItem(
+    uint32_t nodeIndex,
+    const function<void(uint32_t item)>& callback) const
+{
+    // the leaves of a subtree reference a contiguous range of the item permutation
+    uint32_t firstLeaf = nodeIndex;
+    while (!nodes[firstLeaf].isLeaf()) {
+        ++firstLeaf;
+    }
+
+    uint32_t lastLeaf = nodeIndex;
+    while (!nodes[lastLeaf].isLeaf()) {
+        lastLeaf = nodes[lastLeaf].offset;
+    }
+
+    const uint32_t first = nodes[firstLeaf].offset;
+    const uint32_t last = nodes[lastLeaf].offset + nodes[lastLeaf].itemCount;
+
+    for (uint32_t i = first; i < last; ++i) {
+        callback(items[i]);
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+const BoundingBox& BoundingVolumeHierarchy::getItemBounds(uint32_t item) const
+{
+    return itemBounds.at(item);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+uint32_t BoundingVolumeHierarchy::getItemCount() const
+{
+    return static_cast<uint32_t>(itemBounds.size());
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+uint32_t BoundingVolumeHierarchy::getNodeCount() const
+{
+    return static_cast<uint32_t>(nodes.size());
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BoundingBox BoundingVolumeHierarchy::getBounds() const
+{
+    if (nodes.empty()) {
+        return {};
+    }
+
+    return { nodes[0].min, nodes[0].max };
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "rfx/scene/BoundingBox.h"
+#include "rfx/scene/Frustum.h"
+#include "rfx/scene/Ray.h"
+
+
+namespace rfx {
+
+/**
+ *  Binary AABB tree over items identified by their index in the bounds passed to build().
+ *
+ *  The nodes are stored depth-first in a flat array: the left child of an inner node directly follows its parent,
+ *  the right child is referenced by index. Leaves reference a contiguous range of the item permutation.
+ *
+ *  Moving items doesn't require a rebuild: setItemBounds() marks the path to the root and refit() recomputes only
+ *  the marked nodes. The topology isn't changed by a refit, so query performance degrades when items move far -
+ *  rebuild in that case.
+ */
+class BoundingVolumeHierarchy
+{
+public:
+    static constexpr uint32_t MAX_LEAF_SIZE = 4;
+
+    struct RayHit
+    {
+        uint32_t item = UINT32_MAX;
+        float distance = 0.0f;      // distance along the ray to the item bounds
+    };
+
+    // all bounds must be valid
+    void build(std::vector<BoundingBox> itemBounds);
+
+    void setItemBounds(uint32_t item, const BoundingBox& bounds);
+    void refit();
+
+    void query(const Frustum& frustum, const std::function<void(uint32_t item)>& callback) const;
+    void query(const BoundingBox& range, const std::function<void(uint32_t item)>& callback) const;
+
+    // nearest item whose bounds are hit by the ray
+    [[nodiscard]] std::optional<RayHit> raycast(
+        const Ray& ray,
+        float maxDistance = std::numeric_limits<float>::max()) const;
+
+    [[nodiscard]] const BoundingBox& getItemBounds(uint32_t item) const;
+    [[nodiscard]] uint32_t getItemCount() const;
+    [[nodiscard]] uint32_t getNodeCount() const;
+    [[nodiscard]] BoundingBox getBounds() const;
+
+private:
+    struct Node
+    {
+        glm::vec3 min;
+        uint32_t offset = 0;        // first item permutation index (leaf) or right child index (inner node)
+        glm::vec3 max;
+        uint32_t itemCount = 0;     // 0 for inner nodes
+
+        [[nodiscard]] bool isLeaf() const { return itemCount > 0; }
+    };
+
+    uint32_t buildNode(uint32_t parent, uint32_t first, uint32_t count);
+    void refitNode(uint32_t nodeIndex);
+    void forEachItem(uint32_t nodeIndex, const std::function<void(uint32_t item)>& callback) const;
+
+    std::vector<Node> nodes;
+    std::vector<uint32_t> parents;
+    std::vector<uint32_t> items;            // item permutation, leaves reference ranges of it
+    std::vector<uint32_t> itemLeaves;
+    std::vector<BoundingBox> itemBounds;
+    std::vector<uint32_t> dirtyNodes;
+    std::vector<bool> dirtyFlags;
+};
+
+} // namespace rfx
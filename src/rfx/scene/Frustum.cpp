@@ -0,0 +1,117 @@
+#include "rfx/pch.h"
+#include "rfx/scene/Frustum.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#define RFX_FRUSTUM_SSE
+#include <emmintrin.h>
+#endif
+
+using namespace rfx;
+using namespace glm;
+using namespace std;
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+Frustum::Frustum(const mat4& viewProjection)
+{
+    const mat4 rows = transpose(viewProjection);
+    const vec4& row0 = rows[0];
+    const vec4& row1 = rows[1];
+    const vec4& row2 = rows[2];
+    const vec4& row3 = rows[3];
+
+    const vec4 planes[] = {
+        row3 + row0,    // left
+        row3 - row0,    // right
+        row3 + row1,    // bottom
+        row3 - row1,    // top
+        row2,           // near
+        row3 - row2     // far
+    };
+
+    for (size_t i = 0; i < size(planes); ++i) {
+        const vec4 plane = planes[i] / length(vec3(planes[i]));
+        planeX[i] = plane.x;
+        planeY[i] = plane.y;
+        planeZ[i] = plane.z;
+        planeW[i] = plane.w;
+    }
+
+    // the padding planes accept everything
+    for (size_t i = size(planes); i < PLANE_COUNT; ++i) {
+        planeW[i] = numeric_limits<float>::max();
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+bool Frustum::isVisible(const BoundingBox& box) const
+{
+    return classify(box) != Containment::OUTSIDE;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+Frustum::Containment Frustum::classify(const BoundingBox& box) const
+{
+    if (!box.isValid()) {
+        return Containment::INTERSECTING;
+    }
+
+    const vec3 center = box.getCenter();
+    const vec3 extents = box.getExtents();
+    bool isInside = true;
+
+#ifdef RFX_FRUSTUM_SSE
+    const __m128 centerX = _mm_set1_ps(center.x);
+    const __m128 centerY = _mm_set1_ps(center.y);
+    const __m128 centerZ = _mm_set1_ps(center.z);
+    const __m128 extentX = _mm_set1_ps(extents.x);
+    const __m128 extentY = _mm_set1_ps(extents.y);
+    const __m128 extentZ = _mm_set1_ps(extents.z);
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    const __m128 zero = _mm_setzero_ps();
+
+    for (size_t i = 0; i < PLANE_COUNT; i += 4)
+    {
+        const __m128 x = _mm_load_ps(&planeX[i]);
+        const __m128 y = _mm_load_ps(&planeY[i]);
+        const __m128 z = _mm_load_ps(&planeZ[i]);
+        const __m128 w = _mm_load_ps(&planeW[i]);
+
+        // signed distance of the box center and projected radius of the box onto each plane normal
+        const __m128 distance = _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(x, centerX), _mm_mul_ps(y, centerY)),
+            _mm_add_ps(_mm_mul_ps(z, centerZ), w));
+        const __m128 radius = _mm_add_ps(
+            _mm_add_ps(
+                _mm_mul_ps(_mm_andnot_ps(signMask, x), extentX),
+                _mm_mul_ps(_mm_andnot_ps(signMask, y), extentY)),
+            _mm_mul_ps(_mm_andnot_ps(signMask, z), extentZ));
+
+        if (_mm_movemask_ps(_mm_cmplt_ps(_mm_add_ps(distance, radius), zero)) != 0) {
+            return Containment::OUTSIDE;
+        }
+        if (_mm_movemask_ps(_mm_cmplt_ps(_mm_sub_ps(distance, radius), zero)) != 0) {
+            isInside = false;
+        }
+    }
+#else
+    for (size_t i = 0; i < PLANE_COUNT; ++i)
+    {
+        const float distance = planeX[i] * center.x + planeY[i] * center.y + planeZ[i] * center.z + planeW[i];
+        const float radius = abs(planeX[i]) * extents.x + abs(planeY[i]) * extents.y + abs(planeZ[i]) * extents.z;
+
+        if (distance + radius < 0.0f) {
+            return Containment::OUTSIDE;
+        }
+        if (distance - radius < 0.0f) {
+            isInside = false;
+        }
+    }
+#endif // RFX_FRUSTUM_SSE
+
+    return isInside ? Containment::INSIDE : Containment::INTERSECTING;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
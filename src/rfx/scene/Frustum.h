@@ -0,0 +1,42 @@
+#pragma once
+
+#include "rfx/scene/BoundingBox.h"
+
+
+namespace rfx {
+
+/**
+ *  View frustum planes extracted from a view-projection matrix (Vulkan clip space, depth range [0, 1]).
+ *
+ *  The planes are stored as structure of arrays, padded to eight, so that the box test evaluates four planes per
+ *  SSE instruction.
+ */
+class Frustum
+{
+public:
+    enum class Containment
+    {
+        OUTSIDE,
+        INTERSECTING,
+        INSIDE
+    };
+
+    Frustum() = default;
+    explicit Frustum(const glm::mat4& viewProjection);
+
+    // conservative: boxes that intersect the frustum near its corners may be reported as visible
+    [[nodiscard]] bool isVisible(const BoundingBox& box) const;
+
+    // invalid boxes are reported as intersecting
+    [[nodiscard]] Containment classify(const BoundingBox& box) const;
+
+private:
+    static constexpr size_t PLANE_COUNT = 8;
+
+    alignas(16) float planeX[PLANE_COUNT] {};
+    alignas(16) float planeY[PLANE_COUNT] {};
+    alignas(16) float planeZ[PLANE_COUNT] {};
+    alignas(16) float planeW[PLANE_COUNT] {};
+};
+
+} // namespace rfx
@@ -1,9 +1,16 @@
 #include "rfx/scene/SceneImporter.h"
+#include "rfx/scene/MeshOptimizer.h"
+#include "rfx/graphics/IndexUtil.h"
 #include "rfx/scene/PointLight.h"
 #include "rfx/scene/SpotLight.h"
 #include "rfx/scene/LightNode.h"
 #include "rfx/common/Algorithm.h"
+#include "rfx/common/ThreadPool.h"
+#include "rfx/common/StopWatch.h"
+#include "rfx/common/Logger.h"
+#include "rfx/common/MappedFile.h"
 
+#include <glm/gtc/packing.hpp>
 #include <nlohmann/json.hpp>
 #define TINYGLTF_IMPLEMENTATION
 #define TINYGLTF_NO_INCLUDE_JSON
@@ -22,12 +29,36 @@ static const string GLTF_SPOT_LIGHT_TYPE = "spot";
 
 // ---------------------------------------------------------------------------------------------------------------------
 
+struct PrimitiveData
+{
+    uint32_t firstIndex = 0;
+    uint32_t indexCount = 0;
+    int material = -1;
+    BoundingBox bounds;
+};
+
+// ---------------------------------------------------------------------------------------------------------------------
+
 struct ModelData
 {
     VertexFormat vertexFormat;
     uint32_t vertexCount = 0;
-    vector<float> vertexData;
-    vector<uint32_t> indices;
+    // vertices and indices are written straight into mapped staging memory
+    BufferPtr vertexStagingBuffer;
+    BufferPtr indexStagingBuffer;
+    float* vertexData = nullptr;                        // 32 bit words, packed attributes are copied bitwise
+    uint32_t* indices = nullptr;
+    uint32_t indexCount = 0;
+    VkIndexType indexType = VK_INDEX_TYPE_UINT32;
+    vector<vector<PrimitiveData>> meshPrimitives;
+
+    // optimized geometry and 16 bit indices are built in cached memory first and then copied/narrowed into the
+    // staging buffers - reading back mapped staging memory is slow
+    vector<float> scratchVertexData;
+    vector<uint32_t> scratchIndices;
+    uint32_t unoptimizedVertexCount = 0;
+    MeshOptimizer::CacheStats unoptimizedCacheStats;
+    MeshOptimizer::CacheStats optimizedCacheStats;
 
     vector<uint32_t> gltfMeshIndices;
     unordered_map<uint32_t, uint32_t> gltfToModelMeshMap;
@@ -35,6 +66,23 @@ struct ModelData
 
 // ---------------------------------------------------------------------------------------------------------------------
 
+struct EncodedImage
+{
+    vector<unsigned char> data;
+    int requestedWidth = 0;
+    int requestedHeight = 0;
+};
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+struct DecodedImage
+{
+    ImageDesc imageDesc;
+    vector<std::byte> imageData;
+};
+
+// ---------------------------------------------------------------------------------------------------------------------
+
 struct GLTFLightProperties {
     string type;
     string name;
@@ -51,50 +99,90 @@ class GltfSceneImporter : public SceneImporter
 {
 public:
     explicit GltfSceneImporter(
-        GraphicsDevicePtr graphicsDevice)
-            : graphicsDevice_(move(graphicsDevice)) {}
+        GraphicsDevicePtr graphicsDevice,
+        const SceneImportOptions& options = {})
+            : graphicsDevice_(move(graphicsDevice)),
+              options_(options) {}
 
     ScenePtr import(const path& scenePath) override;
 
 private:
     void clear(const string& sceneId);
-    VertexFormat getVertexFormatFrom(const tinygltf::Primitive& primitive);
+    VertexFormat getVertexFormatFrom(const tinygltf::Mesh& mesh) const;
+    bool areTexCoordsNormalized(const tinygltf::Mesh& mesh) const;
     void checkCompatibility();
 
+    static bool deferImageDecoding(
+        tinygltf::Image* gltfImage,
+        int imageIndex,
+        string* error,
+        string* warning,
+        int requestedWidth,
+        int requestedHeight,
+        const unsigned char* bytes,
+        int size,
+        void* userData);
     void loadImages();
+    DecodedImage decodeImage(uint32_t imageIndex);
     static vector<std::byte> convertToRGBA(const tinygltf::Image& gltfImage);
     void loadSamplers();
     void loadTextures();
     void loadTexture(const tinygltf::Texture& gltfTexture);
 
-    void loadModels();
+    void startGeometryTasks();
+    void waitForGeometryTasks();
     void buildModelLookupTable();
+    void buildModelGeometry(ModelData& data) const;
+    static void optimizeModelGeometry(ModelData& data);
+    static void writeStagingBuffers(ModelData& data);
+    void loadModels();
     void loadModel();
 
     void loadMaterials();
     void loadMaterial(const tinygltf::Material& glTFMaterial) const;
 
     void loadMeshes();
-    void prepareGeometryBuffers();
-    void loadMesh(const tinygltf::Mesh& gltfMesh);
-    void loadVertices(const tinygltf::Primitive& glTFPrimitive);
-    const float* getBufferData(const tinygltf::Primitive& glTFPrimitive, const string& attribute);
-    void appendVertexData(
+    void prepareGeometryBuffers(ModelData& data);
+    void loadMeshGeometry(ModelData& data, const tinygltf::Mesh& gltfMesh) const;
+    void loadVertices(ModelData& data, const tinygltf::Primitive& glTFPrimitive) const;
+    const float* getBufferData(const tinygltf::Primitive& glTFPrimitive, const string& attribute) const;
+    static void appendVertexData(
+        ModelData& data,
         uint32_t vertexCount,
         const float* positionBuffer,
         const float* colorsBuffer,
         const float* normalsBuffer,
         const float** texCoordsBuffers,
         const float* tangentsBuffer);
-    uint32_t appendCoordinates(const float* positionBuffer, uint32_t vertexIndex, uint32_t destIndex);
-    uint32_t appendColors(const float* colorsBuffer, uint32_t vertexIndex, uint32_t destIndex);
-    uint32_t appendNormals(const float* normalsBuffer, uint32_t vertexIndex, uint32_t destIndex);
-    uint32_t appendTexCoords(
+    static uint32_t appendCoordinates(
+        ModelData& data,
+        const float* positionBuffer,
+        uint32_t vertexIndex,
+        uint32_t destIndex);
+    static uint32_t appendColors(
+        ModelData& data,
+        const float* colorsBuffer,
+        uint32_t vertexIndex,
+        uint32_t destIndex);
+    static uint32_t appendNormals(
+        ModelData& data,
+        const float* normalsBuffer,
+        uint32_t vertexIndex,
+        uint32_t destIndex);
+    static uint32_t appendTexCoords(
+        ModelData& data,
         const float** texCoordsBuffers,
         uint32_t vertexIndex,
         uint32_t destIndex);
-    uint32_t appendTangents(const float* tangentsBuffer, uint32_t vertexIndex, uint32_t destIndex);
-    uint32_t loadIndices(const tinygltf::Primitive& glTFPrimitive, uint32_t vertexStart);
+    static uint32_t appendTangents(
+        ModelData& data,
+        const float* tangentsBuffer,
+        uint32_t vertexIndex,
+        uint32_t destIndex);
+    uint32_t loadIndices(
+        ModelData& data,
+        const tinygltf::Primitive& glTFPrimitive,
+        uint32_t vertexStart) const;
 
     void loadLights();
     void loadLight(const tinygltf::Value::Object& gltfLight);
@@ -115,8 +203,13 @@ private:
     void buildVertexBuffer();
     void buildIndexBuffer();
 
+    void measure(const string& stage, const function<void()>& function);
+    void logStageTimings(const string& sceneId) const;
+
     shared_ptr<GraphicsDevice> graphicsDevice_;
+    SceneImportOptions options_;
     tinygltf::Model gltfModel_;
+    vector<EncodedImage> encodedImages_;
 
     vector<SamplerDesc> samplers_;
     vector<ImagePtr> images_;
@@ -126,6 +219,12 @@ private:
     ModelPtr currentModel;
     ModelData currentModelData;
     vector<ModelData> modelData;
+    vector<future<void>> geometryTasks_;
+
+    vector<pair<string, chrono::microseconds>> stageTimings_;
+
+    // declared last: joins the workers before the data they operate on is destroyed
+    ThreadPool threadPool_;
 };
 
 // ---------------------------------------------------------------------------------------------------------------------
@@ -138,29 +237,66 @@ ScenePtr GltfSceneImporter::import(const path& scenePath)
     clear(sceneId);
 
 
-    tinygltf::TinyGLTF gltfContext;
-    string error;
-    string warning;
-
-    bool result = gltfContext.LoadASCIIFromFile(&gltfModel_, &error, &warning, scenePath.string());
-    RFX_CHECK_STATE(result,
-        "Failed to load glTF file: " + scenePath.string() + "\n"
-        + "Errors: " + error
-        + "Warnings: " + warning);
+    StopWatch totalStopWatch;
+    totalStopWatch.start();
+
+    measure("parse", [this, &scenePath] {
+        tinygltf::TinyGLTF gltfContext;
+        gltfContext.SetImageLoader(deferImageDecoding, &encodedImages_);
+        string error;
+        string warning;
+
+        bool result = false;
+        if (scenePath.extension() == ".glb") {
+            // saves reading the file into memory, but tinygltf still copies the BIN chunk into its buffer
+            const MappedFile mappedFile(scenePath);
+            result = gltfContext.LoadBinaryFromMemory(
+                &gltfModel_,
+                &error,
+                &warning,
+                reinterpret_cast<const unsigned char*>(mappedFile.getData()),
+                static_cast<unsigned int>(mappedFile.getSize()),
+                scenePath.parent_path().string());
+        }
+        else {
+            result = gltfContext.LoadASCIIFromFile(&gltfModel_, &error, &warning, scenePath.string());
+        }
+        RFX_CHECK_STATE(result,
+            "Failed to load glTF file: " + scenePath.string() + "\n"
+            + "Errors: " + error
+            + "Warnings: " + warning);
+    });
 
     RFX_CHECK_STATE(!gltfModel_.meshes.empty(), "No meshes");
     RFX_CHECK_STATE(!gltfModel_.meshes[0].primitives.empty(), "Empty mesh");
 
     checkCompatibility();
 
-    loadImages();
-    loadSamplers();
-    loadTextures();
-    loadLights();
-    loadLightNodes();
-    loadModels();
+    // vertex/index streams only depend on the parsed buffers, so they are built while images are decoded
+    startGeometryTasks();
+
+    const UploadQueuePtr& uploadQueue = graphicsDevice_->getUploadQueue();
+    uploadQueue->beginBatch();
+
+    try {
+        measure("images", [this] { loadImages(); });
+        measure("textures", [this] { loadSamplers(); loadTextures(); });
+        measure("lights", [this] { loadLights(); loadLightNodes(); });
+        measure("models", [this] { loadModels(); });
+    }
+    catch (...) {
+        // the workers still read gltfModel_ and write into modelData
+        waitForGeometryTasks();
+        uploadQueue->endBatch();
+        throw;
+    }
 
-    scene_->compile();
+    measure("upload", [&uploadQueue] { uploadQueue->wait(uploadQueue->endBatch()); });
+    measure("compile", [this] { scene_->compile(); });
+
+    totalStopWatch.stop();
+    stageTimings_.emplace_back("total", totalStopWatch.getElapsedTime());
+    logStageTimings(sceneId);
 
     return scene_;
 }
@@ -169,7 +305,10 @@ ScenePtr GltfSceneImporter::import(const path& scenePath)
 
 void GltfSceneImporter::clear(const string& sceneId)
 {
+    waitForGeometryTasks();
+
     gltfModel_ = {};
+    encodedImages_.clear();
 
     samplers_.clear();
     images_.clear();
@@ -179,12 +318,41 @@ void GltfSceneImporter::clear(const string& sceneId)
     currentModel.reset();
     currentModelData = {};
     modelData.clear();
+    stageTimings_.clear();
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
 
-VertexFormat GltfSceneImporter::getVertexFormatFrom(const tinygltf::Primitive& primitive)
+void GltfSceneImporter::measure(const string& stage, const function<void()>& function)
 {
+    StopWatch stopWatch;
+    stopWatch.start();
+    function();
+    stopWatch.stop();
+
+    stageTimings_.emplace_back(stage, stopWatch.getElapsedTime());
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void GltfSceneImporter::logStageTimings(const string& sceneId) const
+{
+    string timings;
+    for (const auto& [stage, elapsedTime] : stageTimings_) {
+        timings += fmt::format("{}{}: {:.1f} ms",
+            timings.empty() ? "" : ", ",
+            stage,
+            chrono::duration<float, milli>(elapsedTime).count());
+    }
+
+    RFX_LOG_INFO << "Imported " << sceneId << " using " << threadPool_.getThreadCount() << " threads (" << timings << ")";
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+VertexFormat GltfSceneImporter::getVertexFormatFrom(const tinygltf::Mesh& mesh) const
+{
+    const tinygltf::Primitive& primitive = mesh.primitives[0];
     unsigned int formatMask = 0;
     unsigned int texCoordSetCount = 0;
 
@@ -229,7 +397,57 @@ VertexFormat GltfSceneImporter::getVertexFormatFrom(const tinygltf::Primitive& p
         formatMask |= VertexFormat::TANGENTS;
     }
 
-    return { formatMask, texCoordSetCount };
+    // unorm texture coordinates would clamp repeating textures
+    unsigned int packingMask = options_.vertexPackingMask & VertexFormat::PACKED_ATTRIBUTES;
+    if ((packingMask & VertexFormat::PACKED_TEXCOORDS) && !areTexCoordsNormalized(mesh)) {
+        packingMask &= ~VertexFormat::PACKED_TEXCOORDS;
+    }
+
+    if (!(formatMask & VertexFormat::NORMALS)) {
+        packingMask &= ~VertexFormat::PACKED_NORMALS;
+    }
+    if (!(formatMask & VertexFormat::TEXCOORDS)) {
+        packingMask &= ~VertexFormat::PACKED_TEXCOORDS;
+    }
+    if (!(formatMask & VertexFormat::TANGENTS)) {
+        packingMask &= ~VertexFormat::PACKED_TANGENTS;
+    }
+
+    return { formatMask | packingMask, texCoordSetCount };
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+bool GltfSceneImporter::areTexCoordsNormalized(const tinygltf::Mesh& mesh) const
+{
+    const auto isNormalized = [](float value) { return value >= 0.0f && value <= 1.0f; };
+
+    for (const tinygltf::Primitive& primitive : mesh.primitives) {
+        for (uint32_t i = 0; i < VertexFormat::MAX_TEXCOORDSET_COUNT; ++i)
+        {
+            const auto it = primitive.attributes.find("TEXCOORD_" + to_string(i));
+            if (it == primitive.attributes.end()) {
+                break;
+            }
+
+            // min/max are optional for texture coordinates, scan the data without them
+            const tinygltf::Accessor& accessor = gltfModel_.accessors[it->second];
+            if (accessor.minValues.size() == 2 && accessor.maxValues.size() == 2) {
+                if (!ranges::all_of(accessor.minValues, isNormalized)
+                    || !ranges::all_of(accessor.maxValues, isNormalized)) {
+                    return false;
+                }
+                continue;
+            }
+
+            const float* texCoords = getBufferData(primitive, it->first);
+            if (!all_of(texCoords, texCoords + accessor.count * 2, isNormalized)) {
+                return false;
+            }
+        }
+    }
+
+    return true;
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
@@ -258,30 +476,101 @@ void GltfSceneImporter::checkCompatibility()
 
 void GltfSceneImporter::loadImages()
 {
-    for (const auto& gltfImage : gltfModel_.images) {
-        vector<std::byte> imageData;
+    vector<future<DecodedImage>> decodeTasks;
+    decodeTasks.reserve(gltfModel_.images.size());
 
-        if (gltfImage.component == 3) {
-            imageData = convertToRGBA(gltfImage);
-        }
-        else {
-            VkDeviceSize imageDataSize = gltfImage.image.size();
-            imageData.resize(imageDataSize);
-            memcpy(imageData.data(), gltfImage.image.data(), imageDataSize);
-        }
+    for (uint32_t i = 0; i < gltfModel_.images.size(); ++i) {
+        decodeTasks.push_back(threadPool_.submit([this, i] { return decodeImage(i); }));
+    }
+
+    // Vulkan objects are only created on the importing thread, in image order
+    for (uint32_t i = 0; i < decodeTasks.size(); ++i) {
+        const DecodedImage decodedImage = decodeTasks[i].get();
+        const shared_ptr<Image> image = graphicsDevice_->createImage(
+            gltfModel_.images[i].name,
+            decodedImage.imageDesc,
+            decodedImage.imageData,
+            false);
+        images_.push_back(image);
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+bool GltfSceneImporter::deferImageDecoding(
+    tinygltf::Image* gltfImage,
+    int imageIndex,
+    string* error,
+    string* warning,
+    int requestedWidth,
+    int requestedHeight,
+    const unsigned char* bytes,
+    int size,
+    void* userData)
+{
+    auto& encodedImages = *static_cast<vector<EncodedImage>*>(userData);
+    if (encodedImages.size() <= static_cast<size_t>(imageIndex)) {
+        encodedImages.resize(imageIndex + 1);
+    }
+
+    encodedImages[imageIndex] = {
+        .data = vector<unsigned char>(bytes, bytes + size),
+        .requestedWidth = requestedWidth,
+        .requestedHeight = requestedHeight
+    };
+
+    return true;
+}
 
-        ImageDesc imageDesc = {
+// ---------------------------------------------------------------------------------------------------------------------
+
+DecodedImage GltfSceneImporter::decodeImage(uint32_t imageIndex)
+{
+    tinygltf::Image& gltfImage = gltfModel_.images[imageIndex];
+
+    if (imageIndex < encodedImages_.size() && !encodedImages_[imageIndex].data.empty()) {
+        EncodedImage& encodedImage = encodedImages_[imageIndex];
+        string error;
+        string warning;
+
+        const bool result = tinygltf::LoadImageData(
+            &gltfImage,
+            static_cast<int>(imageIndex),
+            &error,
+            &warning,
+            encodedImage.requestedWidth,
+            encodedImage.requestedHeight,
+            encodedImage.data.data(),
+            static_cast<int>(encodedImage.data.size()),
+            nullptr);
+        RFX_CHECK_STATE(result, "Failed to decode image " + gltfImage.name + ": " + error);
+
+        encodedImage.data = {};
+    }
+
+    DecodedImage decodedImage {
+        .imageDesc = {
             .format = VK_FORMAT_R8G8B8A8_UNORM,
             .width = static_cast<uint32_t>(gltfImage.width),
             .height = static_cast<uint32_t>(gltfImage.height),
             .bytesPerPixel = 4,
             .mipLevels = 1,
             .mipOffsets = { 0 }
-        };
+        }
+    };
 
-        const shared_ptr<Image> image = graphicsDevice_->createImage(gltfImage.name, imageDesc, imageData, false);
-        images_.push_back(image);
+    if (gltfImage.component == 3) {
+        decodedImage.imageData = convertToRGBA(gltfImage);
+    }
+    else {
+        VkDeviceSize imageDataSize = gltfImage.image.size();
+        decodedImage.imageData.resize(imageDataSize);
+        memcpy(decodedImage.imageData.data(), gltfImage.image.data(), imageDataSize);
     }
+
+    gltfImage.image = {};
+
+    return decodedImage;
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
@@ -381,13 +670,39 @@ void GltfSceneImporter::loadTexture(const tinygltf::Texture& gltfTexture)
 
 // ---------------------------------------------------------------------------------------------------------------------
 
-void GltfSceneImporter::loadModels()
+void GltfSceneImporter::startGeometryTasks()
 {
     buildModelLookupTable();
 
-    for (const auto& modelData : modelData)
+    geometryTasks_.reserve(modelData.size());
+    for (auto& data : modelData) {
+        prepareGeometryBuffers(data);
+        geometryTasks_.push_back(threadPool_.submit([this, &data] { buildModelGeometry(data); }));
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+// destroying a future of the pool doesn't join its task
+void GltfSceneImporter::waitForGeometryTasks()
+{
+    for (const future<void>& task : geometryTasks_) {
+        if (task.valid()) {
+            task.wait();
+        }
+    }
+
+    geometryTasks_.clear();
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void GltfSceneImporter::loadModels()
+{
+    for (size_t i = 0; i < modelData.size(); ++i)
     {
-        currentModelData = modelData;
+        geometryTasks_[i].get();
+        currentModelData = move(modelData[i]);
 
         loadModel();
     }
@@ -406,7 +721,7 @@ void GltfSceneImporter::buildModelLookupTable()
             continue;
         }
 
-        VertexFormat vertexFormat = getVertexFormatFrom(mesh.primitives[0]);
+        VertexFormat vertexFormat = getVertexFormatFrom(mesh);
         vertexFormatToMeshMap[vertexFormat].push_back(i);
     }
 
@@ -443,6 +758,17 @@ void GltfSceneImporter::loadModel()
     buildVertexBuffer();
     buildIndexBuffer();
 
+    if (options_.optimizeMeshes) {
+        RFX_LOG_INFO << fmt::format("Optimized {}: {} -> {} vertices, ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f}",
+            modelId,
+            currentModelData.unoptimizedVertexCount,
+            currentModelData.vertexCount,
+            currentModelData.unoptimizedCacheStats.acmr,
+            currentModelData.optimizedCacheStats.acmr,
+            currentModelData.unoptimizedCacheStats.atvr,
+            currentModelData.optimizedCacheStats.atvr);
+    }
+
     scene_->add(currentModel);
 }
 
@@ -515,21 +841,112 @@ void GltfSceneImporter::loadMaterial(const tinygltf::Material& glTFMaterial) con
 
 void GltfSceneImporter::loadMeshes()
 {
-    prepareGeometryBuffers();
+    for (const auto& primitives : currentModelData.meshPrimitives) {
+        auto mesh = make_unique<Mesh>();
+
+        for (const auto& primitive : primitives) {
+            SubMesh subMesh(
+                primitive.firstIndex,
+                primitive.indexCount,
+                currentModel->getMaterial(primitive.material));
+            subMesh.setBounds(primitive.bounds);
+            mesh->addSubMesh(subMesh);
+        }
+
+        currentModel->addMesh(move(mesh));
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void GltfSceneImporter::buildModelGeometry(ModelData& data) const
+{
+    for (uint32_t index : data.gltfMeshIndices) {
+        loadMeshGeometry(data, gltfModel_.meshes[index]);
+    }
+
+    if (options_.optimizeMeshes && data.indexCount > 0) {
+        optimizeModelGeometry(data);
+    }
+
+    writeStagingBuffers(data);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void GltfSceneImporter::optimizeModelGeometry(ModelData& data)
+{
+    const uint32_t vertexSize = data.vertexFormat.getVertexSize();
+    auto* vertices = reinterpret_cast<std::byte*>(data.vertexData);
+    const span<uint32_t> indices(data.indices, data.indexCount);
+
+    data.unoptimizedVertexCount = data.vertexCount;
+    data.unoptimizedCacheStats = MeshOptimizer::analyzeVertexCache(indices);
+
+    MeshOptimizer::deduplicateVertices(vertices, data.vertexCount, vertexSize, indices);
+
+    // coordinates are the first attribute of every vertex format
+    vector<vec3> positions(data.vertexCount);
+    for (uint32_t i = 0; i < data.vertexCount; ++i)
+    {
+        const std::byte* vertex = vertices + size_t { i } * vertexSize;
+        if (data.vertexFormat.containsPackedCoordinates()) {
+            uint64_t coordinates = 0;
+            memcpy(&coordinates, vertex, sizeof(coordinates));
+            positions[i] = vec3(unpackHalf4x16(coordinates));
+        }
+        else {
+            memcpy(&positions[i], vertex, sizeof(vec3));
+        }
+    }
+
+    // triangles are reordered within their submesh only
+    for (const vector<PrimitiveData>& primitives : data.meshPrimitives) {
+        for (const PrimitiveData& primitive : primitives) {
+            const span<uint32_t> primitiveIndices = indices.subspan(primitive.firstIndex, primitive.indexCount);
+            MeshOptimizer::optimizeVertexCache(primitiveIndices);
+            MeshOptimizer::optimizeOverdraw(primitiveIndices, positions);
+        }
+    }
+
+    data.vertexCount = MeshOptimizer::optimizeVertexFetch(vertices, data.vertexCount, vertexSize, indices);
+    data.optimizedCacheStats = MeshOptimizer::analyzeVertexCache(indices);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void GltfSceneImporter::writeStagingBuffers(ModelData& data)
+{
+    if (!data.scratchVertexData.empty()) {
+        const size_t vertexDataSize = size_t { data.vertexCount } * data.vertexFormat.getVertexSize();
+        memcpy(data.vertexStagingBuffer->getMappedData(), data.vertexData, vertexDataSize);
+        data.vertexData = static_cast<float*>(data.vertexStagingBuffer->getMappedData());
+        data.scratchVertexData = {};
+    }
 
-    for (uint32_t index : currentModelData.gltfMeshIndices) {
-        loadMesh(gltfModel_.meshes[index]);
+    if (!data.scratchIndices.empty())
+    {
+        void* stagingIndices = data.indexStagingBuffer->getMappedData();
+        if (data.indexType == VK_INDEX_TYPE_UINT16) {
+            IndexUtil::convert(data.indices, data.indexCount, static_cast<uint16_t*>(stagingIndices));
+            data.indices = nullptr;
+        }
+        else {
+            memcpy(stagingIndices, data.indices, data.indexCount * sizeof(uint32_t));
+            data.indices = static_cast<uint32_t*>(stagingIndices);
+        }
+        data.scratchIndices = {};
     }
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
 
-void GltfSceneImporter::prepareGeometryBuffers()
+void GltfSceneImporter::prepareGeometryBuffers(ModelData& data)
 {
     uint32_t vertexCount = 0;
     uint32_t indexCount = 0;
 
-    for (uint32_t index : currentModelData.gltfMeshIndices)
+    for (uint32_t index : data.gltfMeshIndices)
     {
         const auto& gltfMesh = gltfModel_.meshes[index];
 
@@ -550,37 +967,69 @@ void GltfSceneImporter::prepareGeometryBuffers()
         }
     }
 
-    currentModelData.vertexData.resize(vertexCount * (currentModelData.vertexFormat.getVertexSize() / sizeof(float)));
-    currentModelData.indices.reserve(indexCount);
+    const UploadQueuePtr& uploadQueue = graphicsDevice_->getUploadQueue();
+
+    // zero sized buffers are invalid, models without geometry get neither staging nor device buffers
+    if (vertexCount > 0) {
+        data.vertexStagingBuffer = uploadQueue->createStagingBuffer(vertexCount * data.vertexFormat.getVertexSize());
+        data.vertexData = static_cast<float*>(data.vertexStagingBuffer->getMappedData());
+    }
+
+    // the vertex count before optimization decides, deduplication doesn't change the index type
+    data.indexType = IndexUtil::getIndexType(vertexCount);
+    if (indexCount > 0) {
+        data.indexStagingBuffer = uploadQueue->createStagingBuffer(indexCount * IndexUtil::getIndexSize(data.indexType));
+        data.indices = static_cast<uint32_t*>(data.indexStagingBuffer->getMappedData());
+    }
+
+    if (options_.optimizeMeshes) {
+        data.scratchVertexData.resize(vertexCount * data.vertexFormat.getVertexSize() / sizeof(float));
+        data.vertexData = data.scratchVertexData.data();
+    }
+
+    if (options_.optimizeMeshes || data.indexType == VK_INDEX_TYPE_UINT16) {
+        data.scratchIndices.resize(indexCount);
+        data.indices = data.scratchIndices.data();
+    }
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
 
-void GltfSceneImporter::loadMesh(const tinygltf::Mesh& gltfMesh)
+void GltfSceneImporter::loadMeshGeometry(ModelData& data, const tinygltf::Mesh& gltfMesh) const
 {
-    auto mesh = make_unique<Mesh>();
+    vector<PrimitiveData>& primitives = data.meshPrimitives.emplace_back();
 
     for (const tinygltf::Primitive& glTFPrimitive : gltfMesh.primitives) {
 
-        auto firstIndex = static_cast<uint32_t>(currentModelData.indices.size());
-        auto vertexStart = currentModelData.vertexCount;
+        auto firstIndex = data.indexCount;
+        auto vertexStart = data.vertexCount;
 
-        loadVertices(glTFPrimitive);
-        uint32_t indexCount = loadIndices(glTFPrimitive, vertexStart);
+        loadVertices(data, glTFPrimitive);
+        uint32_t indexCount = loadIndices(data, glTFPrimitive, vertexStart);
+        if (indexCount == 0) {
+            continue;
+        }
 
-        mesh->addSubMesh({
-            firstIndex,
-            indexCount,
-            currentModel->getMaterial(glTFPrimitive.material)
+        // glTF requires min/max for POSITION accessors, missing values leave the bounds invalid (never culled)
+        BoundingBox bounds;
+        const auto& positionAccessor = gltfModel_.accessors[glTFPrimitive.attributes.find("POSITION")->second];
+        if (positionAccessor.minValues.size() == 3 && positionAccessor.maxValues.size() == 3) {
+            bounds.min = vec3(make_vec3(positionAccessor.minValues.data()));
+            bounds.max = vec3(make_vec3(positionAccessor.maxValues.data()));
+        }
+
+        primitives.push_back({
+            .firstIndex = firstIndex,
+            .indexCount = indexCount,
+            .material = glTFPrimitive.material,
+            .bounds = bounds
         });
     }
-
-    currentModel->addMesh(move(mesh));
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
 
-void GltfSceneImporter::loadVertices(const tinygltf::Primitive& glTFPrimitive)
+void GltfSceneImporter::loadVertices(ModelData& data, const tinygltf::Primitive& glTFPrimitive) const
 {
     const tinygltf::Accessor& accessor = gltfModel_.accessors[glTFPrimitive.attributes.find("POSITION")->second];
     const uint32_t vertexCount = accessor.count;
@@ -590,20 +1039,20 @@ void GltfSceneImporter::loadVertices(const tinygltf::Primitive& glTFPrimitive)
 
     // COLOR_0
     const float* colorsBuffer = nullptr;
-    if (currentModelData.vertexFormat.containsColors3() || currentModelData.vertexFormat.containsColors4()) {
+    if (data.vertexFormat.containsColors3() || data.vertexFormat.containsColors4()) {
         colorsBuffer = getBufferData(glTFPrimitive, "COLOR_0");
     }
 
     // NORMAL
     const float* normalsBuffer = nullptr;
-    if (currentModelData.vertexFormat.containsNormals()) {
+    if (data.vertexFormat.containsNormals()) {
         normalsBuffer = getBufferData(glTFPrimitive, "NORMAL");
         RFX_CHECK_STATE(normalsBuffer != nullptr, "Tangents generation not implemented yet!");
     }
 
     // TEXCOORD
     uint32_t inputTexCoordSetCount = 0;
-    uint32_t outputTexCoordSetCount = currentModelData.vertexFormat.getTexCoordSetCount();
+    uint32_t outputTexCoordSetCount = data.vertexFormat.getTexCoordSetCount();
     for (uint32_t i = 0; i < outputTexCoordSetCount; ++i) {
         const string attributeName = "TEXCOORD_" + to_string(i);
         if (!glTFPrimitive.attributes.contains(attributeName)) {
@@ -623,12 +1072,13 @@ void GltfSceneImporter::loadVertices(const tinygltf::Primitive& glTFPrimitive)
 
     // TANGENT
     const float* tangentsBuffer = nullptr;
-    if (currentModelData.vertexFormat.containsTangents()) {
+    if (data.vertexFormat.containsTangents()) {
         tangentsBuffer = getBufferData(glTFPrimitive, "TANGENT");
         RFX_CHECK_STATE(tangentsBuffer != nullptr, "Tangents generation not implemented yet!");
     }
 
     appendVertexData(
+        data,
         vertexCount,
         positionBuffer,
         colorsBuffer,
@@ -641,7 +1091,7 @@ void GltfSceneImporter::loadVertices(const tinygltf::Primitive& glTFPrimitive)
 
 const float* GltfSceneImporter::getBufferData(
     const tinygltf::Primitive& glTFPrimitive,
-    const string& attribute)
+    const string& attribute) const
 {
     if (!glTFPrimitive.attributes.contains(attribute)) {
         return nullptr;
@@ -656,6 +1106,7 @@ const float* GltfSceneImporter::getBufferData(
 // ---------------------------------------------------------------------------------------------------------------------
 
 void GltfSceneImporter::appendVertexData(
+    ModelData& data,
     uint32_t vertexCount,
     const float* positionBuffer,
     const float* colorsBuffer,
@@ -663,27 +1114,34 @@ void GltfSceneImporter::appendVertexData(
     const float** texCoordsBuffers,
     const float* tangentsBuffer)
 {
-    uint32_t destIndex = currentModelData.vertexCount * (currentModelData.vertexFormat.getVertexSize() / sizeof(float));
+    uint32_t destIndex = data.vertexCount * (data.vertexFormat.getVertexSize() / sizeof(float));
 
     for (uint32_t vertexIndex = 0; vertexIndex < vertexCount; vertexIndex++) {
-        destIndex += appendCoordinates(positionBuffer, vertexIndex, destIndex);
-        destIndex += appendColors(colorsBuffer, vertexIndex, destIndex);
-        destIndex += appendNormals(normalsBuffer, vertexIndex, destIndex);
-        destIndex += appendTexCoords(texCoordsBuffers, vertexIndex, destIndex);
-        destIndex += appendTangents(tangentsBuffer, vertexIndex, destIndex);
+        destIndex += appendCoordinates(data, positionBuffer, vertexIndex, destIndex);
+        destIndex += appendColors(data, colorsBuffer, vertexIndex, destIndex);
+        destIndex += appendNormals(data, normalsBuffer, vertexIndex, destIndex);
+        destIndex += appendTexCoords(data, texCoordsBuffers, vertexIndex, destIndex);
+        destIndex += appendTangents(data, tangentsBuffer, vertexIndex, destIndex);
     }
 
-    currentModelData.vertexCount += vertexCount;
+    data.vertexCount += vertexCount;
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
 
 uint32_t GltfSceneImporter::appendCoordinates(
+    ModelData& data,
     const float* positionBuffer,
     uint32_t vertexIndex,
     uint32_t destIndex)
 {
-    memcpy(&currentModelData.vertexData[destIndex], &positionBuffer[vertexIndex * 3], sizeof(vec3));
+    if (data.vertexFormat.containsPackedCoordinates()) {
+        const uint64_t coordinates = VertexFormat::packCoordinates(make_vec3(&positionBuffer[vertexIndex * 3]));
+        memcpy(&data.vertexData[destIndex], &coordinates, sizeof(coordinates));
+        return 2;
+    }
+
+    memcpy(&data.vertexData[destIndex], &positionBuffer[vertexIndex * 3], sizeof(vec3));
 
     return 3;
 }
@@ -691,6 +1149,7 @@ uint32_t GltfSceneImporter::appendCoordinates(
 // ---------------------------------------------------------------------------------------------------------------------
 
 uint32_t GltfSceneImporter::appendColors(
+    ModelData& data,
     const float* colorsBuffer,
     uint32_t vertexIndex,
     uint32_t destIndex)
@@ -699,12 +1158,12 @@ uint32_t GltfSceneImporter::appendColors(
         return 0;
     }
 
-    if (currentModelData.vertexFormat.containsColors3()) {
-        memcpy(&currentModelData.vertexData[destIndex], &colorsBuffer[vertexIndex * 3], sizeof(vec3));
+    if (data.vertexFormat.containsColors3()) {
+        memcpy(&data.vertexData[destIndex], &colorsBuffer[vertexIndex * 3], sizeof(vec3));
         return 3;
     }
-    else if (currentModelData.vertexFormat.containsColors4()){
-        memcpy(&currentModelData.vertexData[destIndex], &colorsBuffer[vertexIndex * 4], sizeof(vec4));
+    else if (data.vertexFormat.containsColors4()){
+        memcpy(&data.vertexData[destIndex], &colorsBuffer[vertexIndex * 4], sizeof(vec4));
         return 4;
     }
 
@@ -716,13 +1175,21 @@ uint32_t GltfSceneImporter::appendColors(
 // ---------------------------------------------------------------------------------------------------------------------
 
 uint32_t GltfSceneImporter::appendNormals(
+    ModelData& data,
     const float* normalsBuffer,
     uint32_t vertexIndex,
     uint32_t destIndex)
 {
     if (normalsBuffer) {
         vec3 normal = normalize(make_vec3(&normalsBuffer[vertexIndex * 3]));
-        memcpy(&currentModelData.vertexData[destIndex], &normal, sizeof(vec3));
+
+        if (data.vertexFormat.containsPackedNormals()) {
+            const uint32_t packedNormal = VertexFormat::packNormal(normal);
+            memcpy(&data.vertexData[destIndex], &packedNormal, sizeof(packedNormal));
+            return 1;
+        }
+
+        memcpy(&data.vertexData[destIndex], &normal, sizeof(vec3));
 
         return 3;
     }
@@ -733,6 +1200,7 @@ uint32_t GltfSceneImporter::appendNormals(
 // ---------------------------------------------------------------------------------------------------------------------
 
 uint32_t GltfSceneImporter::appendTexCoords(
+    ModelData& data,
     const float** texCoordsBuffers,
     const uint32_t vertexIndex,
     const uint32_t destIndex)
@@ -744,7 +1212,14 @@ uint32_t GltfSceneImporter::appendTexCoords(
             break;
         }
 
-        memcpy(&currentModelData.vertexData[destIndex + offset], &texCoordsBuffers[i][vertexIndex * 2], sizeof(vec2));
+        if (data.vertexFormat.containsPackedTexCoords()) {
+            const uint32_t texCoord = VertexFormat::packTexCoord(make_vec2(&texCoordsBuffers[i][vertexIndex * 2]));
+            memcpy(&data.vertexData[destIndex + offset], &texCoord, sizeof(texCoord));
+            offset += 1;
+            continue;
+        }
+
+        memcpy(&data.vertexData[destIndex + offset], &texCoordsBuffers[i][vertexIndex * 2], sizeof(vec2));
         offset += 2;
     }
 
@@ -754,12 +1229,19 @@ uint32_t GltfSceneImporter::appendTexCoords(
 // ---------------------------------------------------------------------------------------------------------------------
 
 uint32_t GltfSceneImporter::appendTangents(
+    ModelData& data,
     const float* tangentsBuffer,
     uint32_t vertexIndex,
     uint32_t destIndex)
 {
     if (tangentsBuffer) {
-        memcpy(&currentModelData.vertexData[destIndex], &tangentsBuffer[vertexIndex * 4], sizeof(vec4));
+        if (data.vertexFormat.containsPackedTangents()) {
+            const uint32_t tangent = VertexFormat::packTangent(make_vec4(&tangentsBuffer[vertexIndex * 4]));
+            memcpy(&data.vertexData[destIndex], &tangent, sizeof(tangent));
+            return 1;
+        }
+
+        memcpy(&data.vertexData[destIndex], &tangentsBuffer[vertexIndex * 4], sizeof(vec4));
         return 4;
     }
 
@@ -769,45 +1251,44 @@ uint32_t GltfSceneImporter::appendTangents(
 // ---------------------------------------------------------------------------------------------------------------------
 
 uint32_t GltfSceneImporter::loadIndices(
+    ModelData& data,
     const tinygltf::Primitive& glTFPrimitive,
-    uint32_t vertexStart)
+    uint32_t vertexStart) const
 {
+    // non-indexed primitives are drawn in vertex order
+    if (glTFPrimitive.indices < 0) {
+        const auto vertexCount = data.vertexCount - vertexStart;
+        iota(&data.indices[data.indexCount], &data.indices[data.indexCount] + vertexCount, vertexStart);
+        data.indexCount += vertexCount;
+
+        return vertexCount;
+    }
+
     const tinygltf::Accessor& accessor = gltfModel_.accessors[glTFPrimitive.indices];
     const tinygltf::BufferView& bufferView = gltfModel_.bufferViews[accessor.bufferView];
     const tinygltf::Buffer& buffer = gltfModel_.buffers[bufferView.buffer];
 
     auto indexCount = static_cast<uint32_t>(accessor.count);
+    const unsigned char* source = &buffer.data[accessor.byteOffset + bufferView.byteOffset];
+    uint32_t* dest = &data.indices[data.indexCount];
 
     // glTF supports different component types of indices_
     switch (accessor.componentType) {
-        case TINYGLTF_PARAMETER_TYPE_UNSIGNED_INT: {
-            vector<uint32_t> buf(accessor.count);
-            memcpy(&buf[0], &buffer.data[accessor.byteOffset + bufferView.byteOffset], accessor.count * sizeof(uint32_t));
-            for (size_t index = 0; index < accessor.count; index++) {
-                currentModelData.indices.push_back(buf[index] + vertexStart);
-            }
+        case TINYGLTF_PARAMETER_TYPE_UNSIGNED_INT:
+            IndexUtil::convert(reinterpret_cast<const uint32_t*>(source), indexCount, vertexStart, dest);
             break;
-        }
-        case TINYGLTF_PARAMETER_TYPE_UNSIGNED_SHORT: {
-            vector<uint16_t> buf(accessor.count);
-            memcpy(&buf[0], &buffer.data[accessor.byteOffset + bufferView.byteOffset], accessor.count * sizeof(uint16_t));
-            for (size_t index = 0; index < accessor.count; index++) {
-                currentModelData.indices.push_back(buf[index] + vertexStart);
-            }
+        case TINYGLTF_PARAMETER_TYPE_UNSIGNED_SHORT:
+            IndexUtil::convert(reinterpret_cast<const uint16_t*>(source), indexCount, vertexStart, dest);
             break;
-        }
-        case TINYGLTF_PARAMETER_TYPE_UNSIGNED_BYTE: {
-            vector<uint8_t> buf(accessor.count);
-            memcpy(&buf[0], &buffer.data[accessor.byteOffset + bufferView.byteOffset], accessor.count * sizeof(uint8_t));
-            for (size_t index = 0; index < accessor.count; index++) {
-                currentModelData.indices.push_back(buf[index] + vertexStart);
-            }
+        case TINYGLTF_PARAMETER_TYPE_UNSIGNED_BYTE:
+            IndexUtil::convert(source, indexCount, vertexStart, dest);
             break;
-        }
         default:
             RFX_THROW("Index component type "s + to_string(accessor.componentType) + " not supported!"s);
     }
 
+    data.indexCount += indexCount;
+
     return indexCount;
 }
 
@@ -1014,7 +1495,11 @@ mat4 GltfSceneImporter::getLocalTransformOf(const tinygltf::Node& gltfNode)
 
 void GltfSceneImporter::buildVertexBuffer()
 {
-    const size_t vertexDataSize = currentModelData.vertexData.size() * sizeof(float);
+    if (currentModelData.vertexCount == 0) {
+        return;
+    }
+
+    const size_t vertexDataSize = currentModelData.vertexCount * currentModelData.vertexFormat.getVertexSize();
 
     shared_ptr<VertexBuffer> vertexBuffer = graphicsDevice_->createVertexBuffer(
         currentModelData.vertexCount,
@@ -1022,58 +1507,34 @@ void GltfSceneImporter::buildVertexBuffer()
     currentModel->setVertexBuffer(vertexBuffer);
     graphicsDevice_->bind(vertexBuffer);
 
-    shared_ptr<Buffer> stagingBuffer = graphicsDevice_->createBuffer(
-        vertexDataSize,
-        VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-
-    void* mappedMemory = nullptr;
-    graphicsDevice_->bind(stagingBuffer);
-    graphicsDevice_->map(stagingBuffer, &mappedMemory);
-    memcpy(mappedMemory, currentModelData.vertexData.data(), vertexDataSize);
-    graphicsDevice_->unmap(stagingBuffer);
-
-    VkCommandPool graphicsCommandPool = graphicsDevice_->getGraphicsCommandPool();
-    shared_ptr<CommandBuffer> commandBuffer = graphicsDevice_->createCommandBuffer(graphicsCommandPool);
-    commandBuffer->begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
-    commandBuffer->copyBuffer(stagingBuffer, vertexBuffer);
-    commandBuffer->end();
-
-    graphicsDevice_->getGraphicsQueue()->flush(commandBuffer);
-
-    graphicsDevice_->destroyCommandBuffer(commandBuffer, graphicsCommandPool);
+    graphicsDevice_->getUploadQueue()->uploadBuffer(
+        vertexBuffer,
+        currentModelData.vertexStagingBuffer,
+        vertexDataSize);
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
 
 void GltfSceneImporter::buildIndexBuffer()
 {
-    const VkDeviceSize bufferSize = currentModelData.indices.size() * sizeof(uint32_t);
-    shared_ptr<Buffer> stagingBuffer = graphicsDevice_->createBuffer(
-        bufferSize,
-        VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-
-    void* mappedMemory = nullptr;
-    graphicsDevice_->bind(stagingBuffer);
-    graphicsDevice_->map(stagingBuffer, &mappedMemory);
-    memcpy(mappedMemory, currentModelData.indices.data(), stagingBuffer->getSize());
-    graphicsDevice_->unmap(stagingBuffer);
-
-    shared_ptr<IndexBuffer> indexBuffer = graphicsDevice_->createIndexBuffer(currentModelData.indices.size(), VK_INDEX_TYPE_UINT32);
-    currentModel->setIndexBuffer(indexBuffer);
+    if (currentModelData.indexCount == 0) {
+        return;
+    }
 
-    graphicsDevice_->bind(indexBuffer);
+    const VkDeviceSize bufferSize =
+        VkDeviceSize { currentModelData.indexCount } * IndexUtil::getIndexSize(currentModelData.indexType);
 
-    VkCommandPool graphicsCommandPool = graphicsDevice_->getGraphicsCommandPool();
-    shared_ptr<CommandBuffer> commandBuffer = graphicsDevice_->createCommandBuffer(graphicsCommandPool);
-    commandBuffer->begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
-    commandBuffer->copyBuffer(stagingBuffer, indexBuffer);
-    commandBuffer->end();
+    shared_ptr<IndexBuffer> indexBuffer = graphicsDevice_->createIndexBuffer(
+        currentModelData.indexCount,
+        currentModelData.indexType);
+    currentModel->setIndexBuffer(indexBuffer);
 
-    graphicsDevice_->getGraphicsQueue()->flush(commandBuffer);
+    graphicsDevice_->bind(indexBuffer);
 
-    graphicsDevice_->destroyCommandBuffer(commandBuffer, graphicsCommandPool);
+    graphicsDevice_->getUploadQueue()->uploadBuffer(
+        indexBuffer,
+        currentModelData.indexStagingBuffer,
+        bufferSize);
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
@@ -14,7 +14,10 @@ Material::Material(
     string shaderId)
         : id_(move(id)),
           vertexFormat_(vertexFormat),
-          shaderId_(move(shaderId)) {}
+          shaderId_(move(shaderId))
+{
+    updateShaderPermutationKey();
+}
 
 // ---------------------------------------------------------------------------------------------------------------------
 
@@ -52,6 +55,8 @@ void Material::setBaseColorTexture(
 {
     baseColorTexture_ = move(texture);
     baseColorTexCoordSet_ = texCoordSet;
+
+    updateShaderPermutationKey();
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
@@ -76,6 +81,8 @@ void Material::setMetallicRoughnessTexture(
 {
     metallicRoughnessTexture_ = move(texture);
     metallicRoughnessTexCoordSet_ = texCoordSet;
+
+    updateShaderPermutationKey();
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
@@ -128,6 +135,8 @@ void Material::setNormalTexture(
 {
     normalTexture_ = move(texture);
     normalTexCoordSet_ = texCoordSet;
+
+    updateShaderPermutationKey();
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
@@ -154,6 +163,8 @@ void Material::setOcclusionTexture(
     occlusionTexture_ = move(texture);
     occlusionTexCoordSet_ = texCoordSet;
     occlusionStrength_ = strength;
+
+    updateShaderPermutationKey();
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
@@ -192,6 +203,8 @@ void Material::setEmissiveTexture(
 {
     emissiveTexture_ = move(texture);
     emissiveTexCoordSet_ = texCoordSet;
+
+    updateShaderPermutationKey();
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
@@ -287,4 +300,25 @@ void Material::loadUniformBufferData(const vector<std::byte>& data)
 
 // ---------------------------------------------------------------------------------------------------------------------
 
+uint32_t Material::getShaderPermutationKey() const
+{
+    return shaderPermutationKey_;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void Material::updateShaderPermutationKey()
+{
+    uint32_t textureMask = 0;
+    textureMask |= baseColorTexture_ != nullptr ? 1u << 0 : 0;
+    textureMask |= metallicRoughnessTexture_ != nullptr ? 1u << 1 : 0;
+    textureMask |= normalTexture_ != nullptr ? 1u << 2 : 0;
+    textureMask |= occlusionTexture_ != nullptr ? 1u << 3 : 0;
+    textureMask |= emissiveTexture_ != nullptr ? 1u << 4 : 0;
+
+    shaderPermutationKey_ = textureMask
+        | (vertexFormat_.getFormatMask() & 0x3FFu) << 8
+        | vertexFormat_.getTexCoordSetCount() << 18;
+}
 
+// ---------------------------------------------------------------------------------------------------------------------
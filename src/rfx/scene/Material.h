@@ -19,6 +19,13 @@ public:
     [[nodiscard]] const VertexFormat& getVertexFormat() const;
     [[nodiscard]] const std::string& getShaderId() const;
 
+    // Packs everything that selects a shader permutation: which textures are present, the vertex format mask and
+    // the tex-coord set count. Kept up to date by the texture setters.
+    [[nodiscard]] uint32_t getShaderPermutationKey() const;
+
+    // the texture presence bits of the permutation key
+    static constexpr uint32_t TEXTURE_PERMUTATION_KEY_MASK = 0x1Fu;
+
     void setBaseColorFactor(const glm::vec4& baseColorFactor);
     [[nodiscard]] const glm::vec4& getBaseColorFactor() const;
 
@@ -71,6 +78,8 @@ public:
     [[nodiscard]] VkDescriptorSet getDescriptorSet() const;
 
 private:
+    void updateShaderPermutationKey();
+
     std::string id_;
 
     const VertexFormat vertexFormat_;
@@ -99,6 +108,8 @@ private:
     glm::vec3 specularFactor_ { 0.0f };
     float shininess_ = 0.0f; // 0-128
 
+    uint32_t shaderPermutationKey_ = 0;
+
     VkDescriptorSet descriptorSet_ = VK_NULL_HANDLE;
     std::shared_ptr<Buffer> uniformBuffer_; // TODO: consider refactoring to push constants or refactor to sub-buffer allocation
 };
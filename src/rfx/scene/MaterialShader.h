@@ -23,6 +23,8 @@ public:
     [[nodiscard]] const std::string& getFragmentShaderId() const;
     [[nodiscard]] const ShaderProgramPtr& getShaderProgram() const;
 
+    // Shaders are shared by all materials with the same Material::getShaderPermutationKey(), so these may only
+    // depend on the properties that make up the key.
     [[nodiscard]] virtual std::vector<std::string> getShaderDefinesFor(const MaterialPtr& material);
     [[nodiscard]] virtual std::vector<std::string> getVertexShaderInputsFor(const MaterialPtr& material);
     [[nodiscard]] virtual std::vector<std::string> getVertexShaderOutputsFor(const MaterialPtr& material);
@@ -7,29 +7,82 @@ using namespace std;
 
 // ---------------------------------------------------------------------------------------------------------------------
 
-void MaterialShaderCache::add(size_t hash, MaterialShaderPtr shader)
+static size_t mix(uint64_t key)
 {
-    RFX_CHECK_ARGUMENT(!cache.contains(hash));
+    // the keys are densely packed bit fields, spread them over the whole table
+    key ^= key >> 33;
+    key *= 0xFF51AFD7ED558CCDull;
+    key ^= key >> 33;
 
-    cache[hash] = move(shader);
+    return static_cast<size_t>(key);
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
 
-MaterialShaderPtr MaterialShaderCache::get(size_t hash) const
+void MaterialShaderCache::add(uint64_t key, MaterialShaderPtr shader)
 {
-    const auto it = cache.find(hash);
+    RFX_CHECK_ARGUMENT(shader != nullptr);
 
-    return it != cache.end()
-        ? it->second
-        : nullptr;
+    if (2 * (count + 1) > slots.size()) {
+        grow();
+    }
+
+    Slot& slot = slots[findSlot(key)];
+    RFX_CHECK_ARGUMENT(slot.shader == nullptr);
+
+    slot.key = key;
+    slot.shader = move(shader);
+    count++;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+const MaterialShaderPtr& MaterialShaderCache::get(uint64_t key) const
+{
+    static const MaterialShaderPtr NO_SHADER;
+
+    if (slots.empty()) {
+        return NO_SHADER;
+    }
+
+    return slots[findSlot(key)].shader;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+size_t MaterialShaderCache::findSlot(uint64_t key) const
+{
+    const size_t mask = slots.size() - 1;
+    size_t index = mix(key) & mask;
+
+    // terminates because the table is never more than half full
+    while (slots[index].shader != nullptr && slots[index].key != key) {
+        index = (index + 1) & mask;
+    }
+
+    return index;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void MaterialShaderCache::grow()
+{
+    vector<Slot> oldSlots = move(slots);
+    slots = vector<Slot>(oldSlots.empty() ? INITIAL_CAPACITY : 2 * oldSlots.size());
+
+    for (Slot& oldSlot : oldSlots) {
+        if (oldSlot.shader != nullptr) {
+            slots[findSlot(oldSlot.key)] = move(oldSlot);
+        }
+    }
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
 
 void MaterialShaderCache::clear()
 {
-    cache.clear();
+    slots.clear();
+    count = 0;
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
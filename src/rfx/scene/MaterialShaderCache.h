@@ -5,18 +5,34 @@
 
 namespace rfx {
 
+/**
+ *  Open addressing map from a shader permutation key to the shader, see MaterialShaderFactory::getKey().
+ *  Linear probing in a power of two table that is kept at most half full.
+ */
 class MaterialShaderCache
 {
 public:
-    void add(size_t hash, MaterialShaderPtr shader);
+    void add(uint64_t key, MaterialShaderPtr shader);
 
-    [[nodiscard]] MaterialShaderPtr get(size_t hash) const;
+    // null if there's no shader for the key
+    [[nodiscard]] const MaterialShaderPtr& get(uint64_t key) const;
 
     void clear();
 
 private:
-    std::unordered_map<size_t, MaterialShaderPtr> cache;
+    struct Slot
+    {
+        uint64_t key = 0;
+        MaterialShaderPtr shader;       // null for empty slots
+    };
+
+    [[nodiscard]] size_t findSlot(uint64_t key) const;
+    void grow();
+
+    static constexpr size_t INITIAL_CAPACITY = 64;
+
+    std::vector<Slot> slots;
+    size_t count = 0;
 };
 
 } // namespace rfx
-
@@ -2,6 +2,7 @@
 #include "rfx/scene/MaterialShaderFactory.h"
 #include "rfx/graphics/ShaderLoader.h"
 #include "rfx/common/Logger.h"
+#include "rfx/common/ThreadPool.h"
 
 
 using namespace rfx;
@@ -24,21 +25,26 @@ MaterialShaderFactory::MaterialShaderFactory(
 
 void MaterialShaderFactory::addAllocator(
     const string& shaderId,
-    const function<MaterialShaderPtr()>& allocator)
+    const function<MaterialShaderPtr()>& allocator,
+    uint32_t permutationKeyMask)
 {
-    RFX_CHECK_STATE(!allocatorMap.contains(shaderId), "");
+    RFX_CHECK_STATE(!allocatorIndices.contains(shaderId), "");
 
-    allocatorMap[shaderId] = allocator;
+    allocatorIndices[shaderId] = static_cast<uint32_t>(allocators.size());
+    allocators.push_back(allocator);
+    permutationKeyMasks.push_back(permutationKeyMask);
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
 
 MaterialShaderPtr MaterialShaderFactory::createShaderFor(const MaterialPtr& material)
 {
-    MaterialShaderPtr shader = getCachedShaderFor(material);
+    const uint64_t key = getKey(material);
+
+    MaterialShaderPtr shader = shaderCache.get(key);
     if (shader == nullptr) {
-        shader = createShader(material);
-        addToCache(shader, material);
+        shader = createShader(material, key);
+        shaderCache.add(key, shader);
     }
 
     return shader;
@@ -46,82 +52,118 @@ MaterialShaderPtr MaterialShaderFactory::createShaderFor(const MaterialPtr& mate
 
 // ---------------------------------------------------------------------------------------------------------------------
 
-MaterialShaderPtr MaterialShaderFactory::getCachedShaderFor(const MaterialPtr& material)
+unordered_map<MaterialShaderPtr, vector<MaterialPtr>> MaterialShaderFactory::createShadersFor(const ScenePtr& scene)
 {
-    const size_t shaderHash = hash(material);
+    struct Permutation
+    {
+        MaterialShaderPtr shader;
+        MaterialPtr material;
+        uint64_t key = 0;
+    };
 
-    return shaderCache.get(shaderHash);
-}
+    vector<Permutation> materialPermutations;
+    vector<Permutation> uncachedPermutations;
+    unordered_set<uint64_t> uncachedKeys;
+
+    for (const auto& model : scene->getModels()) {
+        for (const auto& material : model->getMaterials())
+        {
+            const uint64_t key = getKey(material);
+
+            // only the first material of an uncached permutation needs a shader instance
+            if (shaderCache.get(key) == nullptr && uncachedKeys.insert(key).second) {
+                uncachedPermutations.push_back({
+                    .shader = allocateShader(key),
+                    .material = material,
+                    .key = key
+                });
+            }
+
+            materialPermutations.push_back({
+                .material = material,
+                .key = key
+            });
+        }
+    }
 
-// ---------------------------------------------------------------------------------------------------------------------
+    if (!uncachedPermutations.empty())
+    {
+        RFX_LOG_INFO << "Compiling " << uncachedPermutations.size() << " shader permutations ...";
+
+        // only the GLSL -> SPIR-V compilation (one glslang TShader per task) and the shader module creation run
+        // concurrently, descriptor sets and buffers are created on this thread
+        ThreadPool threadPool(min(
+            ThreadPool::getDefaultThreadCount(),
+            static_cast<uint32_t>(uncachedPermutations.size())));
+
+        vector<future<ShaderProgramPtr>> shaderPrograms;
+        shaderPrograms.reserve(uncachedPermutations.size());
+
+        for (const Permutation& permutation : uncachedPermutations) {
+            shaderPrograms.push_back(threadPool.submit([this, &permutation] {
+                return createShaderProgramFor(permutation.shader, permutation.material);
+            }));
+        }
+
+        // wait for all tasks before rethrowing, they reference uncachedPermutations
+        for (auto& shaderProgram : shaderPrograms) {
+            shaderProgram.wait();
+        }
+
+        for (size_t i = 0; i < uncachedPermutations.size(); ++i)
+        {
+            const Permutation& permutation = uncachedPermutations[i];
+            initShader(permutation.shader, permutation.material, shaderPrograms[i].get());
+            shaderCache.add(permutation.key, permutation.shader);
+        }
+    }
 
-size_t MaterialShaderFactory::hash(const MaterialPtr& material)
-{
-    const auto& allocator = getAllocatorFor(material);
-    MaterialShaderPtr shader = allocator();
+    unordered_map<MaterialShaderPtr, vector<MaterialPtr>> materialShaderMap;
+    for (const Permutation& permutation : materialPermutations) {
+        materialShaderMap[shaderCache.get(permutation.key)].push_back(permutation.material);
+    }
 
-    return hash(shader, material);
+    return materialShaderMap;
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
 
-function<MaterialShaderPtr()> MaterialShaderFactory::getAllocatorFor(const MaterialPtr& material)
+uint64_t MaterialShaderFactory::getKey(const MaterialPtr& material) const
 {
-    string shaderId = material->getShaderId();
-    shaderId = shaderId.empty() ? defaultShaderId : shaderId;
+    const string& shaderId = material->getShaderId().empty() ? defaultShaderId : material->getShaderId();
 
-    const auto it = allocatorMap.find(shaderId);
-    RFX_CHECK_ARGUMENT(it != allocatorMap.end());
+    const auto it = allocatorIndices.find(shaderId);
+    RFX_CHECK_ARGUMENT(it != allocatorIndices.end());
 
-    return it->second;
+    const uint32_t permutationKey = material->getShaderPermutationKey() & permutationKeyMasks[it->second];
+
+    return static_cast<uint64_t>(it->second) << 32 | permutationKey;
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
 
-size_t MaterialShaderFactory::hash(const MaterialShaderPtr& shader, const MaterialPtr& material)
+MaterialShaderPtr MaterialShaderFactory::allocateShader(uint64_t key) const
 {
-    const vector<string> defines = shader->getShaderDefinesFor(material);
-    const vector<string> vertexShaderInputs = shader->getVertexShaderInputsFor(material);
-    const vector<string> vertexShaderOutputs = shader->getVertexShaderOutputsFor(material);
-    const vector<string> fragmentShaderInputs = shader->getFragmentShaderInputsFor(material);
-
-
-    size_t hashValue = 17;
-    hashValue = 31 * hashValue +
-                std::hash<string>()(shader->getId());
-
-    for (const string& define : defines) {
-        hashValue = 31 * hashValue +
-                    std::hash<string>()(define);
-    }
-
-    for (const string& input : vertexShaderInputs) {
-        hashValue = 31 * hashValue +
-                    std::hash<string>()(input);
-    }
+    return allocators[key >> 32]();
+}
 
-    for (const string& output : vertexShaderOutputs) {
-        hashValue = 31 * hashValue +
-                    std::hash<string>()(output);
-    }
+// ---------------------------------------------------------------------------------------------------------------------
 
-    for (const string& input : fragmentShaderInputs) {
-        hashValue = 31 * hashValue +
-                    std::hash<string>()(input);
-    }
+MaterialShaderPtr MaterialShaderFactory::createShader(const MaterialPtr& material, uint64_t key)
+{
+    MaterialShaderPtr shader = allocateShader(key);
+    initShader(shader, material, createShaderProgramFor(shader, material));
 
-    return hashValue;
+    return shader;
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
 
-MaterialShaderPtr MaterialShaderFactory::createShader(const MaterialPtr& material)
+void MaterialShaderFactory::initShader(
+    const MaterialShaderPtr& shader,
+    const MaterialPtr& material,
+    ShaderProgramPtr shaderProgram)
 {
-    const auto allocator = getAllocatorFor(material);
-
-    MaterialShaderPtr shader = allocator();
-
-    ShaderProgramPtr shaderProgram = createShaderProgramFor(shader, material);
     VkDescriptorSetLayout shaderDescriptorSetLayout = createShaderDescriptorSetLayout();
     BufferPtr shaderDataBuffer = createShaderDataBuffer(shader);
     VkDescriptorSet shaderDescriptorSet = createShaderDescriptorSet(
@@ -131,14 +173,11 @@ MaterialShaderPtr MaterialShaderFactory::createShader(const MaterialPtr& materia
         createMaterialDescriptorSetLayoutFor(material);
 
     shader->create(
-        shaderProgram,
+        move(shaderProgram),
         shaderDescriptorSetLayout,
         shaderDescriptorSet,
         shaderDataBuffer,
         materialDescriptorSetLayout);
-
-
-    return shader;
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
@@ -329,17 +368,6 @@ VkDescriptorSet MaterialShaderFactory::createShaderDescriptorSet(
 
 // ---------------------------------------------------------------------------------------------------------------------
 
-void MaterialShaderFactory::addToCache(
-    const MaterialShaderPtr& shader,
-    const MaterialPtr& material)
-{
-    const size_t shaderHash = hash(shader, material);
-
-    shaderCache.add(shaderHash, shader);
-}
-
-// ---------------------------------------------------------------------------------------------------------------------
-
 void MaterialShaderFactory::clearCache()
 {
     shaderCache.clear();
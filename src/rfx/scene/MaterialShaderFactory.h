@@ -3,6 +3,7 @@
 #include <rfx/graphics/ShaderProgram.h>
 #include "rfx/scene/MaterialShader.h"
 #include "rfx/scene/MaterialShaderCache.h"
+#include "rfx/scene/Scene.h"
 
 namespace rfx {
 
@@ -15,29 +16,36 @@ public:
         std::filesystem::path shadersDirectory,
         std::string defaultShaderId);
 
+    // Only the bits of Material::getShaderPermutationKey() in permutationKeyMask select a permutation of the
+    // shader, e.g. bindless shaders that look up textures at runtime mask out Material::TEXTURE_PERMUTATION_KEY_MASK.
     void addAllocator(
         const std::string& shaderId,
-        const std::function<MaterialShaderPtr()>& allocator);
+        const std::function<MaterialShaderPtr()>& allocator,
+        uint32_t permutationKeyMask = UINT32_MAX);
 
     MaterialShaderPtr createShaderFor(const MaterialPtr& material);
 
+    // Creates the shaders for all materials of the scene. Each permutation that isn't cached yet is compiled once,
+    // the permutations are compiled concurrently. Materials keep their scene order within their shader.
+    std::unordered_map<MaterialShaderPtr, std::vector<MaterialPtr>> createShadersFor(const ScenePtr& scene);
+
     void clearCache();
 
 private:
-    std::function<MaterialShaderPtr()> getAllocatorFor(const MaterialPtr& material);
-    MaterialShaderPtr getCachedShaderFor(const MaterialPtr& material);
-
-    size_t hash(const MaterialPtr& material);
-    static size_t hash(const MaterialShaderPtr& shader, const MaterialPtr& material);
+    // shader index in the upper, material permutation key in the lower 32 bits
+    [[nodiscard]] uint64_t getKey(const MaterialPtr& material) const;
+    [[nodiscard]] MaterialShaderPtr allocateShader(uint64_t key) const;
 
-    MaterialShaderPtr createShader(const MaterialPtr& material);
+    MaterialShaderPtr createShader(const MaterialPtr& material, uint64_t key);
+    void initShader(
+        const MaterialShaderPtr& shader,
+        const MaterialPtr& material,
+        ShaderProgramPtr shaderProgram);
     VkDescriptorSetLayout createMaterialDescriptorSetLayoutFor(const MaterialPtr& material);
     ShaderProgramPtr createShaderProgramFor(
         const MaterialShaderPtr& shader,
         const MaterialPtr& material);
 
-    void addToCache(const MaterialShaderPtr& shader, const MaterialPtr& material);
-
     BufferPtr createShaderDataBuffer(const MaterialShaderPtr& shader);
     VkDescriptorSetLayout createShaderDescriptorSetLayout();
     VkDescriptorSet createShaderDescriptorSet(
@@ -48,7 +56,9 @@ private:
     VkDescriptorPool descriptorPool = VK_NULL_HANDLE;
     std::filesystem::path shadersDirectory;
     std::string defaultShaderId;
-    std::map<std::string, std::function<MaterialShaderPtr()>> allocatorMap;
+    std::vector<std::function<MaterialShaderPtr()>> allocators;
+    std::vector<uint32_t> permutationKeyMasks;
+    std::map<std::string, uint32_t, std::less<>> allocatorIndices;
     MaterialShaderCache shaderCache;
 };
 
@@ -21,30 +21,31 @@ void Mesh::addSubMesh(const SubMesh& subMesh)
 
 // ---------------------------------------------------------------------------------------------------------------------
 
-void Mesh::setDescriptorSet(VkDescriptorSet descriptorSet)
+BoundingBox Mesh::getBounds() const
 {
-    this->descriptorSet = descriptorSet;
+    BoundingBox bounds;
+    for (const auto& subMesh : subMeshes) {
+        if (!subMesh.getBounds().isValid()) {
+            return {};
+        }
+        bounds.extend(subMesh.getBounds());
+    }
+
+    return bounds;
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
 
-VkDescriptorSet Mesh::getDescriptorSet() const
-{
-    return descriptorSet;
-}
-
-// ---------------------------------------------------------------------------------------------------------------------
-
-void Mesh::setDataBuffer(const BufferPtr& dataBuffer)
+void Mesh::setDescriptorSet(VkDescriptorSet descriptorSet)
 {
-    this->dataBuffer = dataBuffer;
+    this->descriptorSet = descriptorSet;
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
 
-const BufferPtr& Mesh::getDataBuffer() const
+VkDescriptorSet Mesh::getDescriptorSet() const
 {
-    return dataBuffer;
+    return descriptorSet;
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
@@ -11,16 +11,15 @@ public:
     void addSubMesh(const SubMesh& subMesh);
     [[nodiscard]] std::vector<SubMesh>& getSubMeshes();
 
+    // union of the sub mesh bounds in object space - invalid if any sub mesh has unknown bounds
+    [[nodiscard]] BoundingBox getBounds() const;
+
     void setDescriptorSet(VkDescriptorSet descriptorSet);
     [[nodiscard]] VkDescriptorSet getDescriptorSet() const;
 
-    void setDataBuffer(const BufferPtr& dataBuffer);
-    [[nodiscard]] const BufferPtr& getDataBuffer() const;
-
 private:
     std::vector<SubMesh> subMeshes;
     VkDescriptorSet descriptorSet;
-    BufferPtr dataBuffer;
 };
 
 using MeshPtr = std::shared_ptr<Mesh>;
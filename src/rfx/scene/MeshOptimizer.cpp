@@ -0,0 +1,352 @@
+#include "rfx/pch.h"
+#include "rfx/scene/MeshOptimizer.h"
+
+using namespace rfx;
+using namespace glm;
+using namespace std;
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+namespace {
+
+// the triangle reorderings work on the vertex range referenced by an index range
+struct VertexRange
+{
+    uint32_t first = 0;
+    uint32_t count = 0;
+};
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+VertexRange getVertexRange(span<const uint32_t> indices)
+{
+    if (indices.empty()) {
+        return {};
+    }
+
+    const auto [minIndex, maxIndex] = ranges::minmax_element(indices);
+
+    return { *minIndex, *maxIndex - *minIndex + 1 };
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+class VertexCache
+{
+public:
+    VertexCache(VertexRange vertexRange, uint32_t cacheSize)
+        : vertexRange(vertexRange),
+          cacheSize(cacheSize),
+          cacheTimes(vertexRange.count, 0) {}
+
+    // returns true for a cache miss
+    bool use(uint32_t index)
+    {
+        uint32_t& cacheTime = cacheTimes[index - vertexRange.first];
+        if (cacheTime > 0 && time - cacheTime < cacheSize) {
+            return false;
+        }
+
+        cacheTime = ++time;
+        return true;
+    }
+
+private:
+    VertexRange vertexRange;
+    uint32_t cacheSize = 0;
+    uint32_t time = 0;
+    vector<uint32_t> cacheTimes;
+};
+
+} // namespace
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+uint32_t MeshOptimizer::deduplicateVertices(
+    const std::byte* vertices,
+    uint32_t vertexCount,
+    uint32_t vertexSize,
+    span<uint32_t> indices)
+{
+    unordered_map<string_view, uint32_t> uniqueVertices;
+    uniqueVertices.reserve(vertexCount);
+
+    vector<uint32_t> remap(vertexCount);
+    for (uint32_t i = 0; i < vertexCount; ++i) {
+        const string_view vertex(reinterpret_cast<const char*>(vertices + size_t { i } * vertexSize), vertexSize);
+        remap[i] = uniqueVertices.try_emplace(vertex, i).first->second;
+    }
+
+    for (uint32_t& index : indices) {
+        RFX_CHECK_ARGUMENT(index < vertexCount);
+        index = remap[index];
+    }
+
+    return static_cast<uint32_t>(uniqueVertices.size());
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void MeshOptimizer::optimizeVertexCache(span<uint32_t> indices)
+{
+    // Tipsify, see Sander et al., "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw"
+    RFX_CHECK_ARGUMENT(indices.size() % 3 == 0);
+
+    const auto triangleCount = static_cast<uint32_t>(indices.size() / 3);
+    const VertexRange vertexRange = getVertexRange(indices);
+    if (triangleCount < 2) {
+        return;
+    }
+
+    // vertex -> adjacent triangles
+    vector<uint32_t> adjacencyOffsets(vertexRange.count + 1, 0);
+    for (uint32_t index : indices) {
+        adjacencyOffsets[index - vertexRange.first + 1]++;
+    }
+    partial_sum(adjacencyOffsets.begin(), adjacencyOffsets.end(), adjacencyOffsets.begin());
+
+    vector<uint32_t> adjacentTriangles(indices.size());
+    vector<uint32_t> liveTriangleCounts(vertexRange.count);
+    for (uint32_t triangle = 0; triangle < triangleCount; ++triangle) {
+        for (uint32_t corner = 0; corner < 3; ++corner) {
+            const uint32_t vertex = indices[triangle * 3 + corner] - vertexRange.first;
+            adjacentTriangles[adjacencyOffsets[vertex] + liveTriangleCounts[vertex]++] = triangle;
+        }
+    }
+
+    vector<uint32_t> cacheTimes(vertexRange.count, 0);
+    vector<bool> emittedTriangles(triangleCount, false);
+    vector<uint32_t> deadEnds;
+    vector<uint32_t> candidates;
+    vector<uint32_t> optimizedIndices;
+    optimizedIndices.reserve(indices.size());
+
+    uint32_t time = CACHE_SIZE + 1;
+    uint32_t cursor = 0;
+    int64_t fanningVertex = 0;
+
+    while (fanningVertex >= 0)
+    {
+        candidates.clear();
+
+        const auto vertex = static_cast<uint32_t>(fanningVertex);
+        for (uint32_t i = adjacencyOffsets[vertex]; i < adjacencyOffsets[vertex + 1]; ++i)
+        {
+            const uint32_t triangle = adjacentTriangles[i];
+            if (emittedTriangles[triangle]) {
+                continue;
+            }
+
+            for (uint32_t corner = 0; corner < 3; ++corner)
+            {
+                const uint32_t index = indices[triangle * 3 + corner];
+                const uint32_t triangleVertex = index - vertexRange.first;
+
+                optimizedIndices.push_back(index);
+                deadEnds.push_back(triangleVertex);
+                candidates.push_back(triangleVertex);
+                liveTriangleCounts[triangleVertex]--;
+
+                if (time - cacheTimes[triangleVertex] > CACHE_SIZE) {
+                    cacheTimes[triangleVertex] = time++;
+                }
+            }
+
+            emittedTriangles[triangle] = true;
+        }
+
+        // the candidate that stays in the cache longest after its remaining triangles are emitted
+        fanningVertex = -1;
+        uint32_t bestPriority = 0;
+        for (uint32_t candidate : candidates)
+        {
+            if (liveTriangleCounts[candidate] == 0) {
+                continue;
+            }
+
+            uint32_t priority = 0;
+            if (time - cacheTimes[candidate] + 2 * liveTriangleCounts[candidate] <= CACHE_SIZE) {
+                priority = time - cacheTimes[candidate];
+            }
+            if (priority > bestPriority) {
+                bestPriority = priority;
+                fanningVertex = candidate;
+            }
+        }
+
+        // dead end: continue with a recently used vertex, or the next one with triangles left
+        while (fanningVertex < 0 && !deadEnds.empty())
+        {
+            const uint32_t deadEnd = deadEnds.back();
+            deadEnds.pop_back();
+            if (liveTriangleCounts[deadEnd] > 0) {
+                fanningVertex = deadEnd;
+            }
+        }
+
+        while (fanningVertex < 0 && cursor < vertexRange.count)
+        {
+            if (liveTriangleCounts[cursor] > 0) {
+                fanningVertex = cursor;
+            }
+            cursor++;
+        }
+    }
+
+    ranges::copy(optimizedIndices, indices.begin());
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void MeshOptimizer::optimizeOverdraw(
+    span<uint32_t> indices,
+    span<const vec3> positions)
+{
+    RFX_CHECK_ARGUMENT(indices.size() % 3 == 0);
+
+    struct Cluster
+    {
+        uint32_t firstTriangle = 0;
+        uint32_t triangleCount = 0;
+        vec3 centroid { 0.0f };
+        vec3 normal { 0.0f };
+        float area = 0.0f;
+        float sortKey = 0.0f;
+    };
+
+    const auto triangleCount = static_cast<uint32_t>(indices.size() / 3);
+    if (triangleCount < 2) {
+        return;
+    }
+
+    // a triangle whose vertices all miss the cache starts a new cluster, so reordering the clusters keeps the
+    // cache locality of the triangles within them
+    vector<Cluster> clusters;
+    VertexCache vertexCache(getVertexRange(indices), CACHE_SIZE);
+    vec3 meshCentroid { 0.0f };
+    float meshArea = 0.0f;
+
+    for (uint32_t triangle = 0; triangle < triangleCount; ++triangle)
+    {
+        const uint32_t* triangleIndices = &indices[triangle * 3];
+        uint32_t missCount = 0;
+        for (uint32_t corner = 0; corner < 3; ++corner) {
+            RFX_CHECK_ARGUMENT(triangleIndices[corner] < positions.size());
+            missCount += vertexCache.use(triangleIndices[corner]) ? 1 : 0;
+        }
+
+        if (clusters.empty() || missCount == 3) {
+            clusters.push_back({ .firstTriangle = triangle });
+        }
+
+        const vec3& p0 = positions[triangleIndices[0]];
+        const vec3& p1 = positions[triangleIndices[1]];
+        const vec3& p2 = positions[triangleIndices[2]];
+        const vec3 areaNormal = cross(p1 - p0, p2 - p0);
+        const float area = length(areaNormal) * 0.5f;
+        const vec3 centroid = (p0 + p1 + p2) / 3.0f;
+
+        Cluster& cluster = clusters.back();
+        cluster.triangleCount++;
+        cluster.centroid += centroid * area;
+        cluster.normal += areaNormal;
+        cluster.area += area;
+
+        meshCentroid += centroid * area;
+        meshArea += area;
+    }
+
+    if (clusters.size() < 2 || meshArea <= 0.0f) {
+        return;
+    }
+
+    // clusters facing away from the mesh center are likely in front of the rest of the mesh
+    meshCentroid /= meshArea;
+    for (Cluster& cluster : clusters)
+    {
+        if (cluster.area <= 0.0f || length(cluster.normal) <= 0.0f) {
+            continue;
+        }
+
+        cluster.sortKey = dot(cluster.centroid / cluster.area - meshCentroid, normalize(cluster.normal));
+    }
+
+    ranges::stable_sort(clusters, greater<>(), &Cluster::sortKey);
+
+    vector<uint32_t> sortedIndices;
+    sortedIndices.reserve(indices.size());
+    for (const Cluster& cluster : clusters) {
+        const auto first = indices.begin() + cluster.firstTriangle * 3;
+        sortedIndices.insert(sortedIndices.end(), first, first + cluster.triangleCount * 3);
+    }
+
+    ranges::copy(sortedIndices, indices.begin());
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+uint32_t MeshOptimizer::optimizeVertexFetch(
+    std::byte* vertices,
+    uint32_t vertexCount,
+    uint32_t vertexSize,
+    span<uint32_t> indices)
+{
+    vector<uint32_t> remap(vertexCount, UINT32_MAX);
+    vector<std::byte> optimizedVertices;
+    optimizedVertices.reserve(size_t { vertexCount } * vertexSize);
+
+    uint32_t optimizedVertexCount = 0;
+    for (uint32_t& index : indices)
+    {
+        RFX_CHECK_ARGUMENT(index < vertexCount);
+
+        if (remap[index] == UINT32_MAX) {
+            remap[index] = optimizedVertexCount++;
+            const std::byte* vertex = vertices + size_t { index } * vertexSize;
+            optimizedVertices.insert(optimizedVertices.end(), vertex, vertex + vertexSize);
+        }
+
+        index = remap[index];
+    }
+
+    ranges::copy(optimizedVertices, vertices);
+
+    return optimizedVertexCount;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+MeshOptimizer::CacheStats MeshOptimizer::analyzeVertexCache(
+    span<const uint32_t> indices,
+    uint32_t cacheSize)
+{
+    RFX_CHECK_ARGUMENT(indices.size() % 3 == 0);
+    RFX_CHECK_ARGUMENT(cacheSize > 0);
+
+    if (indices.empty()) {
+        return {};
+    }
+
+    const VertexRange vertexRange = getVertexRange(indices);
+    VertexCache vertexCache(vertexRange, cacheSize);
+    vector<bool> referencedVertices(vertexRange.count, false);
+
+    uint32_t missCount = 0;
+    uint32_t referencedVertexCount = 0;
+    for (uint32_t index : indices)
+    {
+        missCount += vertexCache.use(index) ? 1 : 0;
+
+        if (!referencedVertices[index - vertexRange.first]) {
+            referencedVertices[index - vertexRange.first] = true;
+            referencedVertexCount++;
+        }
+    }
+
+    return {
+        .acmr = static_cast<float>(missCount) / static_cast<float>(indices.size() / 3),
+        .atvr = static_cast<float>(missCount) / static_cast<float>(referencedVertexCount)
+    };
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <span>
+
+
+namespace rfx {
+
+/**
+ *  CPU optimizations of indexed triangle lists, in the order they are meant to be applied:
+ *
+ *  1. deduplicateVertices() remaps the indices of bitwise equal vertices
+ *  2. optimizeVertexCache() reorders the triangles for post-transform vertex cache locality (Tipsify)
+ *  3. optimizeOverdraw() reorders clusters of those triangles so that outward facing surfaces are drawn first
+ *  4. optimizeVertexFetch() reorders the vertices by first use and drops the unreferenced ones
+ *
+ *  The triangle reorderings keep the winding of each triangle and can be applied to index ranges (e.g. submeshes)
+ *  separately. Vertices are opaque blocks of vertexSize bytes.
+ */
+class MeshOptimizer
+{
+public:
+    // size of the FIFO vertex cache assumed by the triangle reordering and simulated by analyzeVertexCache()
+    static constexpr uint32_t CACHE_SIZE = 16;
+
+    struct CacheStats
+    {
+        float acmr = 0.0f;      // average cache miss ratio: transformed vertices per triangle, 0.5 is optimal
+        float atvr = 0.0f;      // average transformed vertex ratio: transforms per referenced vertex, 1 is optimal
+    };
+
+    // returns the number of unique vertices, the vertex data isn't modified
+    static uint32_t deduplicateVertices(
+        const std::byte* vertices,
+        uint32_t vertexCount,
+        uint32_t vertexSize,
+        std::span<uint32_t> indices);
+
+    static void optimizeVertexCache(std::span<uint32_t> indices);
+
+    // positions are indexed like the vertices, indices should be cache optimized already
+    static void optimizeOverdraw(
+        std::span<uint32_t> indices,
+        std::span<const glm::vec3> positions);
+
+    // returns the new vertex count
+    static uint32_t optimizeVertexFetch(
+        std::byte* vertices,
+        uint32_t vertexCount,
+        uint32_t vertexSize,
+        std::span<uint32_t> indices);
+
+    static CacheStats analyzeVertexCache(std::span<const uint32_t> indices, uint32_t cacheSize = CACHE_SIZE);
+};
+
+} // namespace rfx
@@ -40,3 +40,37 @@ uint32_t ModelNode::getMeshCount() const
 
 // ---------------------------------------------------------------------------------------------------------------------
 
+
+const vector<BoundingBox>& ModelNode::getMeshWorldBounds() const
+{
+    return meshWorldBounds_;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void ModelNode::setDataOffset(uint32_t dataOffset)
+{
+    dataOffset_ = dataOffset;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+uint32_t ModelNode::getDataOffset() const
+{
+    return dataOffset_;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void ModelNode::update()
+{
+    meshWorldBounds_.clear();
+    meshWorldBounds_.reserve(meshes_.size());
+
+    for (const auto& mesh : meshes_) {
+        meshWorldBounds_.push_back(mesh->getBounds().transform(worldTransform_));
+        worldBounds_.extend(meshWorldBounds_.back());
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
@@ -16,8 +16,20 @@ public:
     [[nodiscard]] const std::vector<MeshPtr>& getMeshes() const;
     [[nodiscard]] uint32_t getMeshCount() const;
 
+    // world space bounds per mesh, in mesh order - valid after compile()
+    [[nodiscard]] const std::vector<BoundingBox>& getMeshWorldBounds() const;
+
+    // dynamic offset of the node data within the uniform buffer bound at the mesh descriptor set, shared by the
+    // meshes of the node
+    void setDataOffset(uint32_t dataOffset);
+    [[nodiscard]] uint32_t getDataOffset() const;
+
 private:
+    void update() override;
+
     std::vector<MeshPtr> meshes_;
+    std::vector<BoundingBox> meshWorldBounds_;
+    uint32_t dataOffset_ = 0;
 };
 
 } // namespace rfx
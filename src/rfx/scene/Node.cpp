@@ -69,16 +69,26 @@ const mat4& Node::getWorldTransform() const
 
 // ---------------------------------------------------------------------------------------------------------------------
 
+const BoundingBox& Node::getWorldBounds() const
+{
+    return worldBounds_;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
 void Node::compile()
 {
     if (parent_) {
         worldTransform_ = parent_->getWorldTransform() * localTransform_;
     }
 
+    worldBounds_ = {};
+
     update();
 
     for (const auto& child : children_) {
         child->compile();
+        worldBounds_.extend(child->getWorldBounds());
     }
 }
 
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "rfx/scene/BoundingBox.h"
+
 namespace rfx {
 
 class Node;
@@ -23,6 +25,9 @@ public:
     void setWorldTransform(const glm::mat4& worldTransform);
     [[nodiscard]] const glm::mat4& getWorldTransform() const;
 
+    // world space bounds of this node and its descendants, valid after compile()
+    [[nodiscard]] const BoundingBox& getWorldBounds() const;
+
     void compile();
 
 protected:
@@ -31,6 +36,7 @@ protected:
 
     glm::mat4 localTransform_ { 1.0f };
     glm::mat4 worldTransform_ { 1.0f };
+    BoundingBox worldBounds_;
 
 private:
     virtual void update() {}
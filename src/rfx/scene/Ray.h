@@ -0,0 +1,12 @@
+#pragma once
+
+
+namespace rfx {
+
+struct Ray
+{
+    glm::vec3 origin {};
+    glm::vec3 direction { 0.0f, 0.0f, -1.0f };  // normalized
+};
+
+} // namespace rfx
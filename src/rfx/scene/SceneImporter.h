@@ -5,6 +5,14 @@
 namespace rfx
 {
 
+struct SceneImportOptions
+{
+    uint32_t vertexPackingMask = 0;     // attributes stored in packed form, see VertexFormat::PACKED_ATTRIBUTES
+    bool optimizeMeshes = false;        // deduplicate and reorder vertices and triangles, see MeshOptimizer
+};
+
+// ---------------------------------------------------------------------------------------------------------------------
+
 class SceneImporter
 {
 public:
@@ -8,8 +8,9 @@ using namespace std::filesystem;
 
 // ---------------------------------------------------------------------------------------------------------------------
 
-SceneLoader::SceneLoader(GraphicsDevicePtr graphicsDevice)
-    : graphicsDevice(move(graphicsDevice)) {}
+SceneLoader::SceneLoader(GraphicsDevicePtr graphicsDevice, const SceneImportOptions& options)
+    : graphicsDevice(move(graphicsDevice)),
+      options(options) {}
 
 // ---------------------------------------------------------------------------------------------------------------------
 
@@ -22,7 +23,7 @@ ScenePtr SceneLoader::load(const path& path)
         RFX_THROW_NOT_IMPLEMENTED();
     }
     else if (extension == ".gltf" || extension == ".glb") {
-        GltfSceneImporter gltfSceneImporter(graphicsDevice);
+        GltfSceneImporter gltfSceneImporter(graphicsDevice, options);
         return gltfSceneImporter.import(path);
     }
     else {
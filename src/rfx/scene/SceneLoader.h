@@ -1,6 +1,7 @@
 #pragma once
 
 #include "rfx/scene/Scene.h"
+#include "rfx/scene/SceneImporter.h"
 
 
 namespace rfx {
@@ -8,12 +9,13 @@ namespace rfx {
 class SceneLoader
 {
 public:
-    explicit SceneLoader(GraphicsDevicePtr graphicsDevice);
+    explicit SceneLoader(GraphicsDevicePtr graphicsDevice, const SceneImportOptions& options = {});
 
     ScenePtr load(const std::filesystem::path& path);
 
 private:
     GraphicsDevicePtr graphicsDevice;
+    SceneImportOptions options;
 };
 
 
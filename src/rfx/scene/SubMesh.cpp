@@ -44,3 +44,17 @@ const MaterialPtr& SubMesh::getMaterial() const
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
+
+void SubMesh::setBounds(const BoundingBox& bounds)
+{
+    SubMesh::bounds = bounds;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+const BoundingBox& SubMesh::getBounds() const
+{
+    return bounds;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "rfx/scene/Material.h"
+#include "rfx/scene/BoundingBox.h"
 
 namespace rfx {
 
@@ -18,10 +19,15 @@ public:
     void setMaterial(const MaterialPtr& material);
     [[nodiscard]] const MaterialPtr& getMaterial() const;
 
+    // object space bounds of the referenced vertices
+    void setBounds(const BoundingBox& bounds);
+    [[nodiscard]] const BoundingBox& getBounds() const;
+
 private:
     uint32_t firstIndex = 0;
     uint32_t indexCount = 0;
     MaterialPtr material;
+    BoundingBox bounds;
 };
 
 } // namespace rfx
\ No newline at end of file
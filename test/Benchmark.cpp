@@ -0,0 +1,65 @@
+#include "rfx/pch.h"
+#include "Benchmark.h"
+#include "rfx/common/StopWatch.h"
+#include "rfx/common/Logger.h"
+
+
+using namespace rfx;
+using namespace rfx::test;
+using namespace std;
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+int Benchmark::runMain(
+    int argc,
+    char** argv,
+    uint32_t defaultSize,
+    const function<void(uint32_t)>& run)
+{
+    try {
+        initLogging();
+
+        const uint32_t size = argc >= 2 ? stoul(argv[1]) : defaultSize;
+        run(size);
+    }
+    catch (const exception& ex) {
+        RFX_LOG_ERROR << ex.what() << endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void Benchmark::initLogging()
+{
+#ifdef _DEBUG
+    Logger::setLogLevel(LogLevel::DEBUG);
+#endif // _DEBUG
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+chrono::microseconds Benchmark::measure(const string& stage, const function<void()>& function)
+{
+    StopWatch stopWatch;
+    stopWatch.start();
+    function();
+    stopWatch.stop();
+
+    const chrono::microseconds elapsedTime = stopWatch.getElapsedTime();
+    RFX_LOG_INFO << fmt::format("{}: {:.1f} ms", stage, chrono::duration<float, milli>(elapsedTime).count());
+
+    return elapsedTime;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+float Benchmark::getSpeedup(chrono::microseconds referenceTime, chrono::microseconds time)
+{
+    return static_cast<float>(referenceTime.count())
+        / static_cast<float>(std::max<chrono::microseconds::rep>(time.count(), 1));
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
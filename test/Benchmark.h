@@ -0,0 +1,26 @@
+#pragma once
+
+namespace rfx::test {
+
+// the scaffolding shared by the CPU benchmarks, which time a workload against a reference and check its results
+class Benchmark
+{
+public:
+    // sets up logging and runs the benchmark with the size given as first argument or defaultSize,
+    // returns the exit code of main()
+    static int runMain(
+        int argc,
+        char** argv,
+        uint32_t defaultSize,
+        const std::function<void(uint32_t)>& run);
+
+    // runs the function once and logs its elapsed time
+    static std::chrono::microseconds measure(const std::string& stage, const std::function<void()>& function);
+
+    [[nodiscard]] static float getSpeedup(std::chrono::microseconds referenceTime, std::chrono::microseconds time);
+
+private:
+    static void initLogging();
+};
+
+} // namespace rfx::test
@@ -0,0 +1,247 @@
+#include "rfx/pch.h"
+#include "BvhBenchmark.h"
+#include "rfx/common/Logger.h"
+
+#include <glm/gtc/constants.hpp>
+#include <random>
+
+
+using namespace rfx;
+using namespace rfx::test;
+using namespace glm;
+using namespace std;
+
+static constexpr uint32_t DEFAULT_ITEM_COUNT = 100000;
+static constexpr float SCENE_EXTENT = 500.0f;
+static constexpr uint32_t QUERY_COUNT = 1000;
+static constexpr uint32_t FRUSTUM_QUERY_COUNT = 100;
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+int main(int argc, char **argv)
+{
+    return Benchmark::runMain(argc, argv, DEFAULT_ITEM_COUNT, [](uint32_t itemCount) {
+        RFX_CHECK_ARGUMENT(itemCount > 0);
+
+        auto theApp = make_shared<BvhBenchmark>();
+        theApp->run(itemCount);
+    });
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void BvhBenchmark::run(uint32_t itemCount)
+{
+    vector<BoundingBox> itemBounds = createItemBounds(itemCount);
+
+    RFX_LOG_INFO << "Building hierarchy over " << itemCount << " items";
+
+    measure("build", [&] { hierarchy.build(itemBounds); });
+    RFX_LOG_INFO << hierarchy.getNodeCount() << " nodes";
+
+    benchmarkRefit(itemBounds);
+    benchmarkFrustumQueries(itemBounds);
+    benchmarkRangeQueries(itemBounds);
+    benchmarkRaycasts(itemBounds);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+vector<BoundingBox> BvhBenchmark::createItemBounds(uint32_t itemCount)
+{
+    mt19937 randomEngine;
+    uniform_real_distribution<float> position(-SCENE_EXTENT, SCENE_EXTENT);
+    uniform_real_distribution<float> extent(0.5f, 5.0f);
+
+    vector<BoundingBox> itemBounds(itemCount);
+    for (BoundingBox& bounds : itemBounds)
+    {
+        const vec3 center(position(randomEngine), position(randomEngine), position(randomEngine));
+        const vec3 extents(extent(randomEngine), extent(randomEngine), extent(randomEngine));
+        bounds = { .min = center - extents, .max = center + extents };
+    }
+
+    return itemBounds;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void BvhBenchmark::benchmarkRefit(vector<BoundingBox>& itemBounds)
+{
+    // every tenth item moves a little, like animated nodes between two frames
+    const vec3 offset(1.0f, 0.5f, -1.0f);
+    for (uint32_t item = 0; item < itemBounds.size(); item += 10) {
+        itemBounds[item].min += offset;
+        itemBounds[item].max += offset;
+    }
+
+    measure("refit", [&] {
+        for (uint32_t item = 0; item < itemBounds.size(); item += 10) {
+            hierarchy.setItemBounds(item, itemBounds[item]);
+        }
+        hierarchy.refit();
+    });
+
+    for (uint32_t item = 0; item < itemBounds.size(); ++item) {
+        const BoundingBox& bounds = hierarchy.getItemBounds(item);
+        RFX_CHECK_STATE(bounds.min == itemBounds[item].min && bounds.max == itemBounds[item].max,
+            "item bounds differ after refit");
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void BvhBenchmark::benchmarkFrustumQueries(const vector<BoundingBox>& itemBounds)
+{
+    mat4 projection = perspective(radians(45.0f), 16.0f / 9.0f, 0.1f, 4.0f * SCENE_EXTENT);
+    projection[1][1] *= -1;
+
+    // a camera circling the scene, looking at its center
+    vector<Frustum> frustums;
+    for (uint32_t i = 0; i < FRUSTUM_QUERY_COUNT; ++i)
+    {
+        const float angle = static_cast<float>(i) / FRUSTUM_QUERY_COUNT * two_pi<float>();
+        const vec3 eye(cos(angle) * 2.0f * SCENE_EXTENT, 0.0f, sin(angle) * 2.0f * SCENE_EXTENT);
+        frustums.emplace_back(projection * lookAt(eye, vec3(0.0f), vec3(0.0f, 1.0f, 0.0f)));
+    }
+
+    vector<uint32_t> expectedCounts(frustums.size());
+    vector<uint32_t> counts(frustums.size());
+
+    const chrono::microseconds referenceTime = measure("frustum reference", [&] {
+        for (size_t i = 0; i < frustums.size(); ++i) {
+            expectedCounts[i] = static_cast<uint32_t>(ranges::count_if(itemBounds,
+                [&](const BoundingBox& bounds) { return frustums[i].isVisible(bounds); }));
+        }
+    });
+
+    const chrono::microseconds queryTime = measure("frustum query", [&] {
+        for (size_t i = 0; i < frustums.size(); ++i) {
+            hierarchy.query(frustums[i], [&](uint32_t) { counts[i]++; });
+        }
+    });
+
+    logSpeedup("frustum query", referenceTime, queryTime);
+    RFX_CHECK_STATE(counts == expectedCounts, "frustum query results differ from the reference");
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void BvhBenchmark::benchmarkRangeQueries(const vector<BoundingBox>& itemBounds)
+{
+    mt19937 randomEngine;
+    uniform_real_distribution<float> position(-SCENE_EXTENT, SCENE_EXTENT);
+    uniform_real_distribution<float> extent(5.0f, 50.0f);
+
+    vector<BoundingBox> queryRanges(QUERY_COUNT);
+    for (BoundingBox& range : queryRanges)
+    {
+        const vec3 center(position(randomEngine), position(randomEngine), position(randomEngine));
+        const vec3 extents(extent(randomEngine));
+        range = { .min = center - extents, .max = center + extents };
+    }
+
+    vector<uint32_t> expectedCounts(queryRanges.size());
+    vector<uint32_t> counts(queryRanges.size());
+
+    const chrono::microseconds referenceTime = measure("range reference", [&] {
+        for (size_t i = 0; i < queryRanges.size(); ++i) {
+            expectedCounts[i] = static_cast<uint32_t>(ranges::count_if(itemBounds,
+                [&](const BoundingBox& bounds) { return queryRanges[i].overlaps(bounds); }));
+        }
+    });
+
+    const chrono::microseconds queryTime = measure("range query", [&] {
+        for (size_t i = 0; i < queryRanges.size(); ++i) {
+            hierarchy.query(queryRanges[i], [&](uint32_t) { counts[i]++; });
+        }
+    });
+
+    logSpeedup("range query", referenceTime, queryTime);
+    RFX_CHECK_STATE(counts == expectedCounts, "range query results differ from the reference");
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void BvhBenchmark::benchmarkRaycasts(const vector<BoundingBox>& itemBounds)
+{
+    mt19937 randomEngine;
+    uniform_real_distribution<float> position(-2.0f * SCENE_EXTENT, 2.0f * SCENE_EXTENT);
+
+    // rays from outside the scene through random points inside it
+    vector<Ray> rays(QUERY_COUNT);
+    for (Ray& ray : rays)
+    {
+        const vec3 origin(position(randomEngine), position(randomEngine), 2.0f * SCENE_EXTENT);
+        const vec3 target(position(randomEngine) * 0.5f, position(randomEngine) * 0.5f, 0.0f);
+        ray = { .origin = origin, .direction = normalize(target - origin) };
+    }
+
+    vector<optional<float>> expectedDistances(rays.size());
+    vector<optional<float>> distances(rays.size());
+
+    const chrono::microseconds referenceTime = measure("raycast reference", [&] {
+        for (size_t i = 0; i < rays.size(); ++i) {
+            expectedDistances[i] = raycastReference(itemBounds, rays[i]);
+        }
+    });
+
+    const chrono::microseconds queryTime = measure("raycast", [&] {
+        for (size_t i = 0; i < rays.size(); ++i) {
+            const optional<BoundingVolumeHierarchy::RayHit> hit = hierarchy.raycast(rays[i]);
+            if (hit) {
+                distances[i] = hit->distance;
+            }
+        }
+    });
+
+    logSpeedup("raycast", referenceTime, queryTime);
+
+    // items can be hit at the same distance, so only the distance is compared
+    for (size_t i = 0; i < rays.size(); ++i) {
+        RFX_CHECK_STATE(distances[i].has_value() == expectedDistances[i].has_value()
+            && (!distances[i] || abs(*distances[i] - *expectedDistances[i]) <= 1e-3f * std::max(*expectedDistances[i], 1.0f)),
+            "raycast results differ from the reference");
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+optional<float> BvhBenchmark::raycastReference(
+    const vector<BoundingBox>& itemBounds,
+    const Ray& ray)
+{
+    const vec3 inverseDirection = 1.0f / ray.direction;
+    optional<float> nearestDistance;
+
+    for (const BoundingBox& bounds : itemBounds)
+    {
+        const vec3 t0 = (bounds.min - ray.origin) * inverseDirection;
+        const vec3 t1 = (bounds.max - ray.origin) * inverseDirection;
+        const vec3 tMin = glm::min(t0, t1);
+        const vec3 tMax = glm::max(t0, t1);
+
+        const float entry = std::max({ tMin.x, tMin.y, tMin.z, 0.0f });
+        const float exit = std::min({ tMax.x, tMax.y, tMax.z });
+
+        if (entry <= exit && (!nearestDistance || entry < *nearestDistance)) {
+            nearestDistance = entry;
+        }
+    }
+
+    return nearestDistance;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void BvhBenchmark::logSpeedup(
+    const string& stage,
+    chrono::microseconds referenceTime,
+    chrono::microseconds time)
+{
+    RFX_LOG_INFO << fmt::format("{}: {:.1f}x faster than testing every item",
+        stage,
+        getSpeedup(referenceTime, time));
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
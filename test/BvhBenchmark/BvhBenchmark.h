@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Benchmark.h"
+#include "rfx/scene/BoundingVolumeHierarchy.h"
+
+namespace rfx::test {
+
+class BvhBenchmark : public Benchmark
+{
+public:
+    void run(uint32_t itemCount);
+
+private:
+    // boxes of different sizes scattered in a cube, like the meshes of a large scene
+    static std::vector<BoundingBox> createItemBounds(uint32_t itemCount);
+
+    void benchmarkRefit(std::vector<BoundingBox>& itemBounds);
+    void benchmarkFrustumQueries(const std::vector<BoundingBox>& itemBounds);
+    void benchmarkRangeQueries(const std::vector<BoundingBox>& itemBounds);
+    void benchmarkRaycasts(const std::vector<BoundingBox>& itemBounds);
+
+    // nearest hit distance by testing every item, as the hierarchy would without nodes
+    static std::optional<float> raycastReference(
+        const std::vector<BoundingBox>& itemBounds,
+        const Ray& ray);
+
+    static void logSpeedup(
+        const std::string& stage,
+        std::chrono::microseconds referenceTime,
+        std::chrono::microseconds time);
+
+    BoundingVolumeHierarchy hierarchy;
+};
+
+} // namespace rfx::test
@@ -493,7 +493,7 @@ void ColoredQuadTest::createGraphicsPipeline()
 
     ThrowIfFailed(vkCreateGraphicsPipelines(
         graphicsDevice->getLogicalDevice(),
-        VK_NULL_HANDLE,
+        graphicsDevice->getPipelineCache()->getHandle(),
         1,
         &pipelineInfo,
         nullptr,
@@ -80,7 +80,7 @@ void CubeMapTest::createSceneResources()
 
 void CubeMapTest::buildRenderGraph()
 {
-    renderGraph = make_shared<RenderGraph>(graphicsDevice, sceneDescriptorSet_);
+    renderGraph = make_shared<RenderGraph>(graphicsDevice, sceneDescriptorSets_);
     renderGraph->add(make_shared<SkyBoxNode>(skyBox));
 }
 
@@ -0,0 +1,145 @@
+#include "rfx/pch.h"
+#include "DeviceMemoryBenchmark.h"
+#include "Benchmark.h"
+#include "rfx/common/Logger.h"
+
+
+using namespace rfx;
+using namespace rfx::test;
+using namespace std;
+
+static constexpr uint32_t DEFAULT_RESOURCE_COUNT = 1000;   // of each kind
+static constexpr VkDeviceSize MATERIAL_DATA_SIZE = 256;
+static constexpr uint32_t VERTEX_COUNT = 1024;
+static constexpr uint32_t INDEX_COUNT = 3 * 2048;
+static constexpr uint32_t TEXTURE_SIZE = 64;
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+int main(int argc, char **argv)
+{
+    return Benchmark::runMain(argc, argv, DEFAULT_RESOURCE_COUNT, [](uint32_t resourceCount) {
+        RFX_CHECK_ARGUMENT(resourceCount > 0);
+
+        auto theApp = make_shared<DeviceMemoryBenchmark>(resourceCount);
+        theApp->run();
+    });
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+DeviceMemoryBenchmark::DeviceMemoryBenchmark(uint32_t resourceCount)
+    : resourceCount(resourceCount) {}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void DeviceMemoryBenchmark::initGraphics()
+{
+    // nothing is rendered
+    devToolsEnabled = false;
+
+    Application::initGraphics();
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void DeviceMemoryBenchmark::beginMainLoop()
+{
+    Application::beginMainLoop();
+
+    runBenchmark();
+
+    glfwSetWindowShouldClose(window_->getGlfwWindow(), GLFW_TRUE);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void DeviceMemoryBenchmark::runBenchmark()
+{
+    RFX_LOG_INFO << "Loading " << resourceCount << " material uniform buffers, meshes and textures";
+
+    graphicsDevice->setMemorySubAllocationEnabled(false);
+    const chrono::microseconds dedicatedTime = measureLoad("dedicated allocations");
+
+    graphicsDevice->setMemorySubAllocationEnabled(true);
+    const chrono::microseconds subAllocatedTime = measureLoad("sub-allocations");
+
+    RFX_LOG_INFO << fmt::format("sub-allocation: {:.2f}x faster",
+        Benchmark::getSpeedup(dedicatedTime, subAllocatedTime));
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+chrono::microseconds DeviceMemoryBenchmark::measureLoad(const string& stage)
+{
+    const uint64_t previousDeviceMemoryAllocations = graphicsDevice->getMemoryStats().totalDeviceMemoryAllocations;
+
+    Resources resources;
+    const chrono::microseconds loadTime = Benchmark::measure(stage, [&] { load(resources); });
+
+    const DeviceMemoryStats stats = graphicsDevice->getMemoryStats();
+    RFX_LOG_INFO << fmt::format("{}: {} vkAllocateMemory() calls, {} live device memory allocations",
+        stage,
+        stats.totalDeviceMemoryAllocations - previousDeviceMemoryAllocations,
+        stats.deviceMemoryCount);
+    graphicsDevice->logMemoryStats();
+
+    return loadTime;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void DeviceMemoryBenchmark::load(Resources& resources)
+{
+    // the content doesn't matter, only the allocations and uploads
+    const vector<std::byte> materialData(MATERIAL_DATA_SIZE);
+
+    const VertexFormat vertexFormat(VertexFormat::COORDINATES | VertexFormat::NORMALS | VertexFormat::TEXCOORDS);
+    const vector<std::byte> vertexData(VERTEX_COUNT * vertexFormat.getVertexSize());
+    const vector<uint32_t> indices(INDEX_COUNT);
+
+    const ImageDesc textureDesc {
+        .format = VK_FORMAT_R8G8B8A8_UNORM,
+        .width = TEXTURE_SIZE,
+        .height = TEXTURE_SIZE,
+        .bytesPerPixel = 4,
+        .channels = 4,
+        .mipLevels = 1,
+        .mipOffsets = { 0 }
+    };
+    const vector<std::byte> textureData(TEXTURE_SIZE * TEXTURE_SIZE * textureDesc.bytesPerPixel);
+
+    const UploadQueuePtr& uploadQueue = graphicsDevice->getUploadQueue();
+    uploadQueue->beginBatch();
+
+    for (uint32_t i = 0; i < resourceCount; ++i)
+    {
+        BufferPtr materialBuffer = graphicsDevice->createBuffer(
+            MATERIAL_DATA_SIZE,
+            VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+        graphicsDevice->bind(materialBuffer);
+        materialBuffer->load(materialData.size(), materialData.data());
+        resources.materialBuffers.push_back(move(materialBuffer));
+
+        VertexBufferPtr vertexBuffer = graphicsDevice->createVertexBuffer(VERTEX_COUNT, vertexFormat);
+        graphicsDevice->bind(vertexBuffer);
+        uploadQueue->uploadBuffer(vertexBuffer, vertexData.data(), vertexData.size());
+        resources.vertexBuffers.push_back(move(vertexBuffer));
+
+        IndexBufferPtr indexBuffer = graphicsDevice->createIndexBuffer(INDEX_COUNT, VK_INDEX_TYPE_UINT32);
+        graphicsDevice->bind(indexBuffer);
+        uploadQueue->uploadBuffer(indexBuffer, indices.data(), indices.size() * sizeof(uint32_t));
+        resources.indexBuffers.push_back(move(indexBuffer));
+
+        resources.textures.push_back(graphicsDevice->createTexture2D(
+            fmt::format("texture#{}", i),
+            textureDesc,
+            textureData,
+            false));
+    }
+
+    uploadQueue->wait(uploadQueue->endBatch());
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
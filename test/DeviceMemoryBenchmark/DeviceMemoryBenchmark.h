@@ -0,0 +1,37 @@
+#pragma once
+
+#include "rfx/application/Application.h"
+
+
+namespace rfx::test {
+
+// loads material uniform buffers, meshes and textures with and without sub-allocation, logs the vkAllocateMemory()
+// calls and the load time of both, then quits without presenting a frame
+class DeviceMemoryBenchmark : public Application
+{
+public:
+    explicit DeviceMemoryBenchmark(uint32_t resourceCount);
+
+protected:
+    void initGraphics() override;
+    void beginMainLoop() override;
+
+private:
+    struct Resources
+    {
+        std::vector<BufferPtr> materialBuffers;
+        std::vector<VertexBufferPtr> vertexBuffers;
+        std::vector<IndexBufferPtr> indexBuffers;
+        std::vector<Texture2DPtr> textures;
+    };
+
+    void runBenchmark();
+
+    // loads the resources, logs the allocations and releases them again
+    std::chrono::microseconds measureLoad(const std::string& stage);
+    void load(Resources& resources);
+
+    uint32_t resourceCount = 0;
+};
+
+} // namespace rfx::test
@@ -0,0 +1,182 @@
+#include "rfx/pch.h"
+#include "IblBakerBenchmark.h"
+#include "rfx/common/Logger.h"
+
+#include <glm/gtc/packing.hpp>
+
+
+using namespace rfx;
+using namespace rfx::test;
+using namespace glm;
+using namespace std;
+
+static constexpr uint32_t DEFAULT_ENVIRONMENT_SIZE = 512;
+
+// the baked maps are stored as half floats
+static constexpr float TOLERANCE = 2e-3f;
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+int main(int argc, char **argv)
+{
+    return Benchmark::runMain(argc, argv, DEFAULT_ENVIRONMENT_SIZE, [](uint32_t environmentSize) {
+        RFX_CHECK_ARGUMENT(environmentSize > 0);
+
+        auto theApp = make_shared<IblBakerBenchmark>();
+        theApp->run(environmentSize);
+    });
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void IblBakerBenchmark::run(uint32_t environmentSize)
+{
+    RFX_LOG_INFO << "Baking IBL maps of a " << environmentSize << "x" << environmentSize << " environment";
+
+    ImageDesc brdfLutDesc {};
+    vector<std::byte> brdfLutData;
+    measure("BRDF LUT", [&] { IblBaker::bakeBrdfLut(&brdfLutDesc, &brdfLutData); });
+    checkBrdfLut(brdfLutDesc, brdfLutData);
+
+    // sky gradient with a sun, the sun is much brighter than the sky like in HDR environments
+    const vec3 skyColor(0.3f, 0.5f, 0.9f);
+    const vec3 groundColor(0.2f, 0.15f, 0.1f);
+    const vec3 sunDirection = normalize(vec3(0.3f, 0.8f, 0.4f));
+    const vec3 sunColor(50.0f);
+
+    ImageDesc environmentDesc {};
+    vector<std::byte> environmentData;
+    createEnvironment(environmentSize, [&](const vec3& direction) {
+        const vec3 sky = mix(groundColor, skyColor, direction.y * 0.5f + 0.5f);
+        return sky + pow(std::max(dot(direction, sunDirection), 0.0f), 256.0f) * sunColor;
+    }, &environmentDesc, &environmentData);
+
+    ImageDesc irradianceMapDesc {};
+    vector<std::byte> irradianceMapData;
+    measure("irradiance map", [&] {
+        IblBaker::bakeIrradianceMap(environmentDesc, environmentData, &irradianceMapDesc, &irradianceMapData);
+    });
+    checkCubeMap("irradiance map", irradianceMapDesc, irradianceMapData, groundColor, skyColor + sunColor);
+
+    ImageDesc specularMapDesc {};
+    vector<std::byte> specularMapData;
+    measure("specular map", [&] {
+        IblBaker::bakeSpecularMap(environmentDesc, environmentData, &specularMapDesc, &specularMapData);
+    });
+    checkCubeMap("specular map", specularMapDesc, specularMapData, groundColor, skyColor + sunColor);
+
+    // the maps of a constant environment are that constant, at every roughness
+    const vec3 constantColor(0.5f, 1.0f, 2.0f);
+    createEnvironment(environmentSize, [&constantColor](const vec3&) {
+        return constantColor;
+    }, &environmentDesc, &environmentData);
+
+    IblBaker::bakeIrradianceMap(environmentDesc, environmentData, &irradianceMapDesc, &irradianceMapData);
+    checkCubeMap("constant irradiance map", irradianceMapDesc, irradianceMapData, constantColor, constantColor);
+
+    IblBaker::bakeSpecularMap(environmentDesc, environmentData, &specularMapDesc, &specularMapData);
+    checkCubeMap("constant specular map", specularMapDesc, specularMapData, constantColor, constantColor);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void IblBakerBenchmark::createEnvironment(
+    uint32_t size,
+    const function<vec3(const vec3&)>& getRadiance,
+    ImageDesc* outImageDesc,
+    vector<std::byte>* outImageData)
+{
+    *outImageDesc = {
+        .format = VK_FORMAT_R32G32B32A32_SFLOAT,
+        .width = size,
+        .height = size,
+        .bytesPerPixel = 4 * sizeof(float),
+        .channels = 4,
+        .layers = 6,
+        .mipLevels = 1,
+        .mipOffsets = { 0 },
+        .isCubemap = true
+    };
+
+    outImageData->resize(static_cast<size_t>(size) * size * 6 * outImageDesc->bytesPerPixel);
+    auto texels = reinterpret_cast<float*>(outImageData->data());
+
+    for (uint32_t face = 0; face < 6; ++face) {
+        for (uint32_t y = 0; y < size; ++y) {
+            for (uint32_t x = 0; x < size; ++x)
+            {
+                const float s = 2.0f * (static_cast<float>(x) + 0.5f) / static_cast<float>(size) - 1.0f;
+                const float t = 2.0f * (static_cast<float>(y) + 0.5f) / static_cast<float>(size) - 1.0f;
+
+                // faces in Vulkan layer order: +x, -x, +y, -y, +z, -z
+                vec3 direction;
+                switch (face) {
+                    case 0: direction = vec3(1.0f, -t, -s); break;
+                    case 1: direction = vec3(-1.0f, -t, s); break;
+                    case 2: direction = vec3(s, 1.0f, t); break;
+                    case 3: direction = vec3(s, -1.0f, -t); break;
+                    case 4: direction = vec3(s, -t, 1.0f); break;
+                    default: direction = vec3(-s, -t, -1.0f); break;
+                }
+
+                const vec3 radiance = getRadiance(normalize(direction));
+                float* texel = texels + ((static_cast<size_t>(face) * size + y) * size + x) * 4;
+                texel[0] = radiance.r;
+                texel[1] = radiance.g;
+                texel[2] = radiance.b;
+                texel[3] = 1.0f;
+            }
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void IblBakerBenchmark::checkBrdfLut(
+    const ImageDesc& imageDesc,
+    const vector<std::byte>& imageData)
+{
+    RFX_CHECK_STATE(imageDesc.format == VK_FORMAT_R16G16_SFLOAT, "unexpected BRDF LUT format");
+
+    // scale + bias is the directional albedo for F0 = 1, the importance sampled estimate may slightly exceed 1
+    const auto texels = reinterpret_cast<const uint16_t*>(imageData.data());
+    const size_t texelCount = static_cast<size_t>(imageDesc.width) * imageDesc.height;
+    for (size_t i = 0; i < texelCount; ++i)
+    {
+        const float scale = unpackHalf1x16(texels[i * 2]);
+        const float bias = unpackHalf1x16(texels[i * 2 + 1]);
+        RFX_CHECK_STATE(scale >= 0.0f && bias >= 0.0f && scale + bias <= 1.05f, "BRDF LUT value out of range");
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void IblBakerBenchmark::checkCubeMap(
+    const string& name,
+    const ImageDesc& imageDesc,
+    const vector<std::byte>& imageData,
+    const vec3& minRadiance,
+    const vec3& maxRadiance)
+{
+    RFX_CHECK_STATE(imageDesc.format == VK_FORMAT_R16G16B16A16_SFLOAT, "unexpected " + name + " format");
+
+    for (uint32_t level = 0; level < imageDesc.mipLevels; ++level)
+    {
+        const uint32_t size = std::max(imageDesc.width >> level, 1u);
+        const auto texels = reinterpret_cast<const uint16_t*>(imageData.data() + imageDesc.mipOffsets[level]);
+        const size_t texelCount = static_cast<size_t>(size) * size * imageDesc.layers;
+
+        for (size_t i = 0; i < texelCount; ++i) {
+            for (uint32_t channel = 0; channel < 3; ++channel)
+            {
+                const float value = unpackHalf1x16(texels[i * 4 + channel]);
+                RFX_CHECK_STATE(
+                    value >= minRadiance[channel] * (1.0f - TOLERANCE)
+                        && value <= maxRadiance[channel] * (1.0f + TOLERANCE),
+                    fmt::format("{} level {} is outside of the environment's range", name, level));
+            }
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "Benchmark.h"
+#include "rfx/graphics/IblBaker.h"
+
+namespace rfx::test {
+
+class IblBakerBenchmark : public Benchmark
+{
+public:
+    void run(uint32_t environmentSize);
+
+private:
+    // RGBA32F cube map faces, like TextureLoader::loadCubeMapImage() returns them for HDR files
+    static void createEnvironment(
+        uint32_t size,
+        const std::function<glm::vec3(const glm::vec3&)>& getRadiance,
+        ImageDesc* outImageDesc,
+        std::vector<std::byte>* outImageData);
+
+    static void checkBrdfLut(
+        const ImageDesc& imageDesc,
+        const std::vector<std::byte>& imageData);
+
+    // the baked maps are weighted averages of the environment, so each texel must be within its range
+    static void checkCubeMap(
+        const std::string& name,
+        const ImageDesc& imageDesc,
+        const std::vector<std::byte>& imageData,
+        const glm::vec3& minRadiance,
+        const glm::vec3& maxRadiance);
+};
+
+} // namespace rfx::test
@@ -0,0 +1,104 @@
+#include "rfx/pch.h"
+#include "IndexUtilBenchmark.h"
+#include "rfx/graphics/IndexUtil.h"
+#include "rfx/common/Logger.h"
+
+#include <random>
+
+
+using namespace rfx;
+using namespace rfx::test;
+using namespace std;
+
+static constexpr uint32_t DEFAULT_INDEX_COUNT = 10000000;
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+int main(int argc, char **argv)
+{
+    return Benchmark::runMain(argc, argv, DEFAULT_INDEX_COUNT, [](uint32_t indexCount) {
+        RFX_CHECK_ARGUMENT(indexCount > 0);
+
+        auto theApp = make_shared<IndexUtilBenchmark>();
+        theApp->run(indexCount);
+    });
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void IndexUtilBenchmark::run(uint32_t indexCount)
+{
+    RFX_LOG_INFO << "Converting " << indexCount << " indices";
+
+    // the base vertex of a mesh appended to a model's vertex buffer
+    const uint32_t baseVertex = 1000;
+
+    measureWidening(createIndices<uint8_t>(indexCount, 256), baseVertex);
+    measureWidening(createIndices<uint16_t>(indexCount, IndexUtil::MAX_UINT16_VERTEX_COUNT), baseVertex);
+    measureWidening(createIndices<uint32_t>(indexCount, 1 << 20), baseVertex);
+    measureNarrowing(createIndices<uint32_t>(indexCount, IndexUtil::MAX_UINT16_VERTEX_COUNT));
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+template<typename T>
+vector<T> IndexUtilBenchmark::createIndices(uint32_t indexCount, uint32_t vertexCount)
+{
+    mt19937 randomEngine;
+    uniform_int_distribution<uint32_t> index(0, vertexCount - 1);
+
+    vector<T> indices(indexCount);
+    for (T& i : indices) {
+        i = static_cast<T>(index(randomEngine));
+    }
+
+    return indices;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+template<typename T>
+void IndexUtilBenchmark::measureWidening(const vector<T>& indices, uint32_t baseVertex)
+{
+    const string type = fmt::format("uint{}", sizeof(T) * 8);
+
+    // the reference is the transform the importer used before IndexUtil
+    vector<uint32_t> expectedIndices(indices.size());
+    const chrono::microseconds referenceTime = measure(type + " -> uint32 transform", [&] {
+        ranges::transform(indices, expectedIndices.begin(),
+            [baseVertex](T index) { return index + baseVertex; });
+    });
+
+    vector<uint32_t> convertedIndices(indices.size());
+    const chrono::microseconds convertTime = measure(type + " -> uint32 IndexUtil", [&] {
+        IndexUtil::convert(indices.data(), indices.size(), baseVertex, convertedIndices.data());
+    });
+
+    RFX_LOG_INFO << fmt::format("{} -> uint32: {:.1f}x faster", type,
+        getSpeedup(referenceTime, convertTime));
+
+    RFX_CHECK_STATE(convertedIndices == expectedIndices, "converted indices differ from the reference");
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void IndexUtilBenchmark::measureNarrowing(const vector<uint32_t>& indices)
+{
+    vector<uint16_t> expectedIndices(indices.size());
+    const chrono::microseconds referenceTime = measure("uint32 -> uint16 transform", [&] {
+        ranges::transform(indices, expectedIndices.begin(),
+            [](uint32_t index) { return static_cast<uint16_t>(index); });
+    });
+
+    vector<uint16_t> convertedIndices(indices.size());
+    const chrono::microseconds convertTime = measure("uint32 -> uint16 IndexUtil", [&] {
+        IndexUtil::convert(indices.data(), indices.size(), convertedIndices.data());
+    });
+
+    RFX_LOG_INFO << fmt::format("uint32 -> uint16: {:.1f}x faster",
+        getSpeedup(referenceTime, convertTime));
+
+    RFX_CHECK_STATE(convertedIndices == expectedIndices, "converted indices differ from the reference");
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "Benchmark.h"
+
+namespace rfx::test {
+
+class IndexUtilBenchmark : public Benchmark
+{
+public:
+    void run(uint32_t indexCount);
+
+private:
+    // random indices below vertexCount
+    template<typename T>
+    static std::vector<T> createIndices(uint32_t indexCount, uint32_t vertexCount);
+
+    template<typename T>
+    static void measureWidening(const std::vector<T>& indices, uint32_t baseVertex);
+    static void measureNarrowing(const std::vector<uint32_t>& indices);
+};
+
+} // namespace rfx::test
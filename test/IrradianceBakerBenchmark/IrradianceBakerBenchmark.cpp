@@ -0,0 +1,149 @@
+#include "rfx/pch.h"
+#include "IrradianceBakerBenchmark.h"
+#include "rfx/common/Logger.h"
+#include "rfx/common/Math.h"
+
+#include <random>
+
+
+using namespace rfx;
+using namespace rfx::test;
+using namespace glm;
+using namespace std;
+
+static constexpr uint32_t DEFAULT_WIDTH = 256;
+static constexpr uint32_t SAMPLE_COUNT = 1024;
+
+// only the summation order differs from the reference
+static constexpr float TOLERANCE = 1e-4f;
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+int main(int argc, char **argv)
+{
+    return Benchmark::runMain(argc, argv, DEFAULT_WIDTH, [](uint32_t width) {
+        RFX_CHECK_ARGUMENT(width >= 2 && width % 2 == 0);
+
+        auto theApp = make_shared<IrradianceBakerBenchmark>();
+        theApp->run(width);
+    });
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void IrradianceBakerBenchmark::run(uint32_t width)
+{
+    const uint32_t height = width / 2;
+    const vector<vec3> radiance = createRadianceMap(width, height);
+    vector<vec3> expectedIrradiance(radiance.size());
+    vector<vec3> irradiance(radiance.size());
+
+    RFX_LOG_INFO << "Baking " << width << "x" << height << " irradiance map with " << SAMPLE_COUNT << " samples";
+
+    const chrono::microseconds referenceTime = measure("reference", [&] {
+        bakeReference(radiance.data(), width, height, SAMPLE_COUNT, expectedIrradiance.data());
+    });
+
+    const IrradianceBaker irradianceBaker(width, height, SAMPLE_COUNT);
+
+    for (uint32_t threadCount : { 1u, ThreadPool::getDefaultThreadCount() })
+    {
+        const chrono::microseconds bakeTime = measure(fmt::format("{} thread(s)", threadCount), [&] {
+            irradianceBaker.bake(radiance.data(), irradiance.data(), threadCount);
+        });
+
+        const float maxRelativeDifference = getMaxRelativeDifference(expectedIrradiance, irradiance);
+        RFX_LOG_INFO << fmt::format("{} thread(s): {:.1f}x faster, max relative difference {:.2e}",
+            threadCount,
+            getSpeedup(referenceTime, bakeTime),
+            maxRelativeDifference);
+
+        RFX_CHECK_STATE(maxRelativeDifference <= TOLERANCE, "irradiance differs from the reference");
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+vector<vec3> IrradianceBakerBenchmark::createRadianceMap(uint32_t width, uint32_t height)
+{
+    // sky gradient with a sun and some noise, so that neighboring texels differ
+    const vec3 sunDirection = normalize(vec3(0.3f, 0.4f, 0.8f));
+    mt19937 randomEngine;
+    uniform_real_distribution<float> noise(0.9f, 1.1f);
+
+    vector<vec3> radiance(width * height);
+    for (uint32_t y = 0; y < height; ++y) {
+        const float theta = float(y) / float(height) * Math::PI;
+        for (uint32_t x = 0; x < width; ++x)
+        {
+            const float phi = float(x) / float(width) * Math::TWO_PI;
+            const vec3 direction(sin(theta) * cos(phi), sin(theta) * sin(phi), cos(theta));
+
+            const vec3 sky = mix(vec3(0.2f, 0.15f, 0.1f), vec3(0.3f, 0.5f, 0.9f), direction.z * 0.5f + 0.5f);
+            const float sun = pow(std::max(dot(direction, sunDirection), 0.0f), 256.0f) * 50.0f;
+
+            radiance[y * width + x] = (sky + sun) * noise(randomEngine);
+        }
+    }
+
+    return radiance;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void IrradianceBakerBenchmark::bakeReference(
+    const vec3* radiance,
+    uint32_t width,
+    uint32_t height,
+    uint32_t sampleCount,
+    vec3* outIrradiance)
+{
+    for (uint32_t y = 0; y != height; y++)
+    {
+        const float theta1 = float(y) / float(height) * Math::PI;
+        for (uint32_t x = 0; x != width; x++)
+        {
+            const float phi1 = float(x) / float(width) * Math::TWO_PI;
+            const vec3 V1 = vec3(sin(theta1) * cos(phi1), sin(theta1) * sin(phi1), cos(theta1));
+            vec3 color = vec3(0.0f);
+            float weight = 0.0f;
+            for (uint32_t i = 0; i != sampleCount; i++)
+            {
+                const vec2 h = IrradianceBaker::hammersley2d(i, sampleCount);
+                const int x1 = int(floor(h.x * float(width)));
+                const int y1 = int(floor(h.y * float(height)));
+                const float theta2 = float(y1) / float(height) * Math::PI;
+                const float phi2 = float(x1) / float(width) * Math::TWO_PI;
+                const vec3 V2 = vec3(sin(theta2) * cos(phi2), sin(theta2) * sin(phi2), cos(theta2));
+                const float D = std::max(0.0f, dot(V1, V2));
+                if (D > 0.01f)
+                {
+                    color += radiance[y1 * width + x1] * D;
+                    weight += D;
+                }
+            }
+
+            outIrradiance[y * width + x] = color / weight;
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+float IrradianceBakerBenchmark::getMaxRelativeDifference(
+    const vector<vec3>& expected,
+    const vector<vec3>& actual)
+{
+    float maxRelativeDifference = 0.0f;
+    for (size_t i = 0; i < expected.size(); ++i) {
+        for (int channel = 0; channel < 3; ++channel)
+        {
+            const float difference = abs(actual[i][channel] - expected[i][channel]);
+            maxRelativeDifference = std::max(maxRelativeDifference, difference / std::max(expected[i][channel], 1e-6f));
+        }
+    }
+
+    return maxRelativeDifference;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
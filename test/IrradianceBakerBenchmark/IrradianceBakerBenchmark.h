@@ -0,0 +1,29 @@
+#pragma once
+
+#include "Benchmark.h"
+#include "rfx/graphics/IrradianceBaker.h"
+
+namespace rfx::test {
+
+class IrradianceBakerBenchmark : public Benchmark
+{
+public:
+    void run(uint32_t width);
+
+private:
+    static std::vector<glm::vec3> createRadianceMap(uint32_t width, uint32_t height);
+
+    // the scalar loop IrradianceBaker replaces, as it was in IrradianceMapGenTest
+    static void bakeReference(
+        const glm::vec3* radiance,
+        uint32_t width,
+        uint32_t height,
+        uint32_t sampleCount,
+        glm::vec3* outIrradiance);
+
+    static float getMaxRelativeDifference(
+        const std::vector<glm::vec3>& expected,
+        const std::vector<glm::vec3>& actual);
+};
+
+} // namespace rfx::test
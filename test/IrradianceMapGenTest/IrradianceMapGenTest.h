@@ -32,8 +32,6 @@ private:
         size_t destImageHeight,
         size_t monteCarloSampleCount,
         glm::vec3* destImageData);
-    static glm::vec2 hammersley2d(uint32_t i, uint32_t N);
-    static float radicalInverse_VdC(uint32_t bits);
 
     void writeDestImage(
         const std::filesystem::path& destImagePath,
@@ -0,0 +1,263 @@
+#include "rfx/pch.h"
+#include "LightClustersBenchmark.h"
+#include "rfx/scene/DirectionalLight.h"
+#include "rfx/scene/SpotLight.h"
+#include "rfx/common/Logger.h"
+
+#include <random>
+
+
+using namespace rfx;
+using namespace rfx::test;
+using namespace glm;
+using namespace std;
+
+static constexpr uint32_t DEFAULT_LIGHT_COUNT = 1000;
+static constexpr uint32_t UPDATE_COUNT = 100;
+static constexpr uint32_t SAMPLE_COUNT = 64;     // lit points per light
+static constexpr VkExtent2D EXTENT { 1920, 1080 };
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+int main(int argc, char **argv)
+{
+    return Benchmark::runMain(argc, argv, DEFAULT_LIGHT_COUNT, [](uint32_t lightCount) {
+        RFX_CHECK_ARGUMENT(lightCount > 0 && lightCount < LightClusters::MAX_LIGHTS);
+
+        auto theApp = make_shared<LightClustersBenchmark>();
+        theApp->run(lightCount);
+    });
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void LightClustersBenchmark::run(uint32_t lightCount)
+{
+    // the default projection of the test applications, the camera at the origin looking down -z
+    mat4 projMatrix = perspective(
+        radians(45.0f),
+        static_cast<float>(EXTENT.width) / static_cast<float>(EXTENT.height),
+        0.1f,
+        1000.0f);
+    projMatrix[1][1] *= -1;
+    const mat4 viewMatrix { 1.0f };
+
+    const vector<LightPtr> lights = createLights(lightCount);
+
+    LightClusters lightClusters;
+    lightClusters.setProjection(projMatrix, EXTENT);
+
+    RFX_LOG_INFO << "Binning " << lights.size() << " lights into " << LightClusters::CLUSTER_COUNT << " froxels";
+
+    const chrono::microseconds updateTime = measure(fmt::format("{} updates", UPDATE_COUNT), [&] {
+        for (uint32_t i = 0; i < UPDATE_COUNT; ++i) {
+            lightClusters.update(lights, viewMatrix);
+        }
+    });
+
+    vector<vector<uint32_t>> expectedClusterLights;
+    const chrono::microseconds referenceTime = measure("reference", [&] {
+        expectedClusterLights = binReference(lightClusters, lights, viewMatrix);
+    });
+
+    const LightClusters::Stats& stats = lightClusters.getStats();
+    RFX_LOG_INFO << fmt::format("{:.3f} ms per update, {:.1f}x faster than the reference",
+        chrono::duration<float, milli>(updateTime).count() / UPDATE_COUNT,
+        static_cast<float>(referenceTime.count() * UPDATE_COUNT)
+            / static_cast<float>(std::max<chrono::microseconds::rep>(updateTime.count(), 1)));
+    RFX_LOG_INFO << fmt::format("{} light indices, at most {} lights per froxel",
+        stats.lightIndexCount, stats.maxClusterLightCount);
+
+    RFX_CHECK_STATE(stats.droppedLightCount == 0 && stats.droppedLightIndexCount == 0,
+        "lights were dropped, use fewer lights");
+
+    checkBinnedLights(lightClusters, expectedClusterLights);
+    checkLitPoints(lightClusters, lights, viewMatrix, projMatrix, EXTENT);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+vector<LightPtr> LightClustersBenchmark::createLights(uint32_t lightCount)
+{
+    mt19937 randomEngine;
+    uniform_real_distribution<float> x(-40.0f, 40.0f);
+    uniform_real_distribution<float> y(-20.0f, 20.0f);
+    uniform_real_distribution<float> z(-100.0f, 0.0f);
+    uniform_real_distribution<float> range(0.5f, 5.0f);
+    uniform_real_distribution<float> direction(-1.0f, 1.0f);
+    uniform_real_distribution<float> coneAngle(radians(10.0f), radians(80.0f));
+
+    vector<LightPtr> lights;
+
+    auto directionalLight = make_shared<DirectionalLight>("directional-light#0");
+    directionalLight->setDirection({ -1.0f, -1.0f, -1.0f });
+    lights.push_back(directionalLight);
+
+    // every fourth light is a spot light
+    for (uint32_t i = 0; i < lightCount; ++i)
+    {
+        PointLightPtr pointLight;
+        if (i % 4 == 3) {
+            auto spotLight = make_shared<SpotLight>(fmt::format("spot-light#{}", i));
+            spotLight->setDirection({ direction(randomEngine), direction(randomEngine), direction(randomEngine) });
+            spotLight->setOuterConeAngle(coneAngle(randomEngine));
+            pointLight = spotLight;
+        }
+        else {
+            pointLight = make_shared<PointLight>(fmt::format("point-light#{}", i));
+        }
+
+        pointLight->setColor({ 1.0f, 1.0f, 1.0f });
+        pointLight->setPosition({ x(randomEngine), y(randomEngine), z(randomEngine) });
+        pointLight->setRange(range(randomEngine));
+        lights.push_back(pointLight);
+    }
+
+    return lights;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+vector<vector<uint32_t>> LightClustersBenchmark::binReference(
+    const LightClusters& lightClusters,
+    const vector<LightPtr>& lights,
+    const mat4& viewMatrix)
+{
+    const vector<BoundingBox>& clusterBounds = lightClusters.getClusterBounds();
+    const uint32_t directionalLightCount = lightClusters.getParams().directionalLightCount;
+
+    vector<vector<uint32_t>> clusterLights(LightClusters::CLUSTER_COUNT);
+
+    // the light data holds the directional lights first, the other lights follow in their order
+    uint32_t lightIndex = directionalLightCount;
+    for (const LightPtr& light : lights)
+    {
+        if (light->getType() == Light::DIRECTIONAL) {
+            continue;
+        }
+
+        const LightClusters::BoundingSphere sphere = LightClusters::getBoundingSphere(light);
+        const vec3 center = vec3(viewMatrix * vec4(sphere.center, 1.0f));
+
+        for (uint32_t i = 0; i < LightClusters::CLUSTER_COUNT; ++i)
+        {
+            const vec3 offset = glm::clamp(center, clusterBounds[i].min, clusterBounds[i].max) - center;
+            if (dot(offset, offset) <= sphere.radius * sphere.radius) {
+                clusterLights[i].push_back(lightIndex);
+            }
+        }
+
+        lightIndex++;
+    }
+
+    return clusterLights;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void LightClustersBenchmark::checkBinnedLights(
+    const LightClusters& lightClusters,
+    const vector<vector<uint32_t>>& expectedClusterLights)
+{
+    const vector<LightClusters::Cluster>& clusters = lightClusters.getClusters();
+    const vector<uint32_t>& lightIndices = lightClusters.getLightIndices();
+
+    // the tile range of a light skips froxels whose bounds overlap the light outside of its projected bounds, so the
+    // lists are subsets of the reference lists
+    size_t expectedLightIndexCount = 0;
+    for (uint32_t i = 0; i < LightClusters::CLUSTER_COUNT; ++i)
+    {
+        const vector<uint32_t>& expectedLights = expectedClusterLights[i];
+        const span clusterLights(lightIndices.data() + clusters[i].offset, clusters[i].count);
+
+        RFX_CHECK_STATE(ranges::is_sorted(clusterLights), "light list isn't in light order");
+        RFX_CHECK_STATE(ranges::includes(expectedLights, clusterLights), "light binned into a froxel it doesn't overlap");
+
+        expectedLightIndexCount += expectedLights.size();
+    }
+
+    RFX_LOG_INFO << fmt::format("{} of {} reference light indices", lightIndices.size(), expectedLightIndexCount);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void LightClustersBenchmark::checkLitPoints(
+    const LightClusters& lightClusters,
+    const vector<LightPtr>& lights,
+    const mat4& viewMatrix,
+    const mat4& projMatrix,
+    const VkExtent2D& extent)
+{
+    const LightClusters::ClusterParams& params = lightClusters.getParams();
+    const vector<LightClusters::Cluster>& clusters = lightClusters.getClusters();
+    const vector<uint32_t>& lightIndices = lightClusters.getLightIndices();
+
+    // the view depth range of the froxels
+    const float nearPlane = projMatrix[3][2] / projMatrix[2][2];
+    const float farPlane = projMatrix[3][2] / (projMatrix[2][2] + 1.0f);
+
+    mt19937 randomEngine;
+    normal_distribution<float> direction;
+    uniform_real_distribution<float> distance;
+
+    uint32_t visibleSampleCount = 0;
+    uint32_t lightIndex = params.directionalLightCount;
+    for (const LightPtr& light : lights)
+    {
+        if (light->getType() == Light::DIRECTIONAL) {
+            continue;
+        }
+
+        const LightClusters::BoundingSphere sphere = LightClusters::getBoundingSphere(light);
+        const vec3 center = vec3(viewMatrix * vec4(sphere.center, 1.0f));
+
+        for (uint32_t i = 0; i < SAMPLE_COUNT; ++i)
+        {
+            const vec3 sampleDirection = normalize(vec3(
+                direction(randomEngine),
+                direction(randomEngine),
+                direction(randomEngine)));
+            const vec3 point = center + sampleDirection * sphere.radius * cbrt(distance(randomEngine));
+
+            const vec4 clipCoords = projMatrix * vec4(point, 1.0f);
+            const vec2 normalizedDeviceCoords = vec2(clipCoords) / clipCoords.w;
+            if (-point.z <= nearPlane || -point.z >= farPlane
+                    || abs(normalizedDeviceCoords.x) >= 1.0f || abs(normalizedDeviceCoords.y) >= 1.0f) {
+                continue;
+            }
+
+            const LightClusters::Cluster& cluster = clusters[getCluster(params, projMatrix, extent, point)];
+            const span clusterLights(lightIndices.data() + cluster.offset, cluster.count);
+            RFX_CHECK_STATE(ranges::binary_search(clusterLights, lightIndex), "lit point's froxel misses the light");
+
+            visibleSampleCount++;
+        }
+
+        lightIndex++;
+    }
+
+    RFX_LOG_INFO << fmt::format("{} lit points found their light", visibleSampleCount);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+uint32_t LightClustersBenchmark::getCluster(
+    const LightClusters::ClusterParams& params,
+    const mat4& projMatrix,
+    const VkExtent2D& extent,
+    const vec3& viewSpacePoint)
+{
+    const vec4 clipCoords = projMatrix * vec4(viewSpacePoint, 1.0f);
+    const vec2 fragCoord = (vec2(clipCoords) / clipCoords.w * 0.5f + 0.5f) * vec2(extent.width, extent.height);
+
+    const uvec2 tile = glm::min(
+        uvec2(fragCoord * params.tileScale),
+        uvec2(params.tileCountX, params.tileCountY) - 1u);
+
+    const float slice = log(-viewSpacePoint.z) * params.sliceScale + params.sliceBias;
+    const auto sliceIndex = static_cast<uint32_t>(std::clamp(slice, 0.0f, static_cast<float>(params.sliceCount - 1)));
+
+    return (sliceIndex * params.tileCountY + tile.y) * params.tileCountX + tile.x;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
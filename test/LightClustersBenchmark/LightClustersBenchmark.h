@@ -0,0 +1,44 @@
+#pragma once
+
+#include "Benchmark.h"
+#include "rfx/rendering/LightClusters.h"
+
+namespace rfx::test {
+
+class LightClustersBenchmark : public Benchmark
+{
+public:
+    void run(uint32_t lightCount);
+
+private:
+    // a directional light and point and spot lights of random range in front of the camera
+    static std::vector<LightPtr> createLights(uint32_t lightCount);
+
+    // tests every light against the bounds of every froxel, returns the light indices per froxel
+    static std::vector<std::vector<uint32_t>> binReference(
+        const LightClusters& lightClusters,
+        const std::vector<LightPtr>& lights,
+        const glm::mat4& viewMatrix);
+
+    // the binned lights of each froxel must overlap it
+    static void checkBinnedLights(
+        const LightClusters& lightClusters,
+        const std::vector<std::vector<uint32_t>>& expectedClusterLights);
+
+    // the froxel of each point lit by a light must list the light, points are sampled inside the light's bounds
+    static void checkLitPoints(
+        const LightClusters& lightClusters,
+        const std::vector<LightPtr>& lights,
+        const glm::mat4& viewMatrix,
+        const glm::mat4& projMatrix,
+        const VkExtent2D& extent);
+
+    // the froxel of a view space point, like getCluster() in clustered.glsl
+    static uint32_t getCluster(
+        const LightClusters::ClusterParams& params,
+        const glm::mat4& projMatrix,
+        const VkExtent2D& extent,
+        const glm::vec3& viewSpacePoint);
+};
+
+} // namespace rfx::test
@@ -0,0 +1,125 @@
+#include "rfx/pch.h"
+#include "MeshOptimizerBenchmark.h"
+#include "rfx/common/Logger.h"
+
+#include <glm/gtc/constants.hpp>
+#include <array>
+#include <random>
+
+
+using namespace rfx;
+using namespace rfx::test;
+using namespace glm;
+using namespace std;
+
+static constexpr uint32_t DEFAULT_RESOLUTION = 512;
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+int main(int argc, char **argv)
+{
+    return Benchmark::runMain(argc, argv, DEFAULT_RESOLUTION, [](uint32_t resolution) {
+        RFX_CHECK_ARGUMENT(resolution >= 3);
+
+        auto theApp = make_shared<MeshOptimizerBenchmark>();
+        theApp->run(resolution);
+    });
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void MeshOptimizerBenchmark::run(uint32_t resolution)
+{
+    vector<Vertex> vertices;
+    vector<uint32_t> indices;
+    createTorus(resolution, vertices, indices);
+
+    const auto vertexCount = static_cast<uint32_t>(vertices.size());
+    auto* vertexData = reinterpret_cast<std::byte*>(vertices.data());
+    vector<vec3> positions;
+    uint32_t uniqueVertexCount = 0;
+    uint32_t optimizedVertexCount = 0;
+
+    RFX_LOG_INFO << "Optimizing torus with " << indices.size() / 3 << " triangles and " << vertexCount << " vertices";
+    logStats("input", indices);
+
+    measure("deduplicate", [&] {
+        uniqueVertexCount = MeshOptimizer::deduplicateVertices(vertexData, vertexCount, sizeof(Vertex), indices);
+    });
+    logStats("deduplicated", indices);
+
+    measure("vertex cache", [&] { MeshOptimizer::optimizeVertexCache(indices); });
+    logStats("vertex cache optimized", indices);
+
+    positions.reserve(vertexCount);
+    ranges::transform(vertices, back_inserter(positions), &Vertex::position);
+
+    measure("overdraw", [&] { MeshOptimizer::optimizeOverdraw(indices, positions); });
+    logStats("overdraw optimized", indices);
+
+    measure("vertex fetch", [&] {
+        optimizedVertexCount = MeshOptimizer::optimizeVertexFetch(vertexData, vertexCount, sizeof(Vertex), indices);
+    });
+    logStats("vertex fetch optimized", indices);
+
+    RFX_LOG_INFO << vertexCount << " -> " << uniqueVertexCount << " unique -> " << optimizedVertexCount << " vertices";
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void MeshOptimizerBenchmark::createTorus(
+    uint32_t resolution,
+    vector<Vertex>& outVertices,
+    vector<uint32_t>& outIndices)
+{
+    static constexpr float MAJOR_RADIUS = 1.0f;
+    static constexpr float MINOR_RADIUS = 0.25f;
+
+    const auto createVertex = [resolution](uint32_t i, uint32_t j) {
+        const float u = static_cast<float>(i) / static_cast<float>(resolution);
+        const float v = static_cast<float>(j) / static_cast<float>(resolution);
+        const float phi = u * two_pi<float>();
+        const float theta = v * two_pi<float>();
+
+        const vec3 center(cos(phi) * MAJOR_RADIUS, 0.0f, sin(phi) * MAJOR_RADIUS);
+        const vec3 normal(cos(phi) * cos(theta), sin(theta), sin(phi) * cos(theta));
+
+        return Vertex {
+            .position = center + normal * MINOR_RADIUS,
+            .normal = normal,
+            .texCoord = { u, v }
+        };
+    };
+
+    // a shuffled triangle soup, like exporters write it when they don't weld vertices
+    vector<array<Vertex, 3>> triangles;
+    triangles.reserve(2 * resolution * resolution);
+    for (uint32_t i = 0; i < resolution; ++i) {
+        for (uint32_t j = 0; j < resolution; ++j) {
+            triangles.push_back({ createVertex(i, j), createVertex(i, j + 1), createVertex(i + 1, j + 1) });
+            triangles.push_back({ createVertex(i, j), createVertex(i + 1, j + 1), createVertex(i + 1, j) });
+        }
+    }
+
+    ranges::shuffle(triangles, mt19937 {});
+
+    outVertices.clear();
+    outIndices.clear();
+    for (const auto& triangle : triangles) {
+        for (const Vertex& vertex : triangle) {
+            outIndices.push_back(static_cast<uint32_t>(outVertices.size()));
+            outVertices.push_back(vertex);
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void MeshOptimizerBenchmark::logStats(const string& stage, span<const uint32_t> indices)
+{
+    const MeshOptimizer::CacheStats cacheStats = MeshOptimizer::analyzeVertexCache(indices);
+
+    RFX_LOG_INFO << fmt::format("{}: ACMR {:.3f}, ATVR {:.3f}", stage, cacheStats.acmr, cacheStats.atvr);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
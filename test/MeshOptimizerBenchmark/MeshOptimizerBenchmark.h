@@ -0,0 +1,29 @@
+#pragma once
+
+#include "Benchmark.h"
+#include "rfx/scene/MeshOptimizer.h"
+
+namespace rfx::test {
+
+class MeshOptimizerBenchmark : public Benchmark
+{
+public:
+    void run(uint32_t resolution);
+
+private:
+    struct Vertex
+    {
+        glm::vec3 position;
+        glm::vec3 normal;
+        glm::vec2 texCoord;
+    };
+
+    static void createTorus(
+        uint32_t resolution,
+        std::vector<Vertex>& outVertices,
+        std::vector<uint32_t>& outIndices);
+
+    static void logStats(const std::string& stage, std::span<const uint32_t> indices);
+};
+
+} // namespace rfx::test
@@ -108,7 +108,7 @@ void MultiLightTest::createMeshResources()
 
 void MultiLightTest::buildRenderGraph()
 {
-    renderGraph = make_shared<RenderGraph>(graphicsDevice, sceneDescriptorSet_);
+    renderGraph = make_shared<RenderGraph>(graphicsDevice, sceneDescriptorSets_);
     renderGraph->add(scene, materialShaderMap);
 }
 
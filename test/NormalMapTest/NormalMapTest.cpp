@@ -96,7 +96,7 @@ void NormalMapTest::createMeshResources()
 
 void NormalMapTest::buildRenderGraph()
 {
-    renderGraph = make_shared<RenderGraph>(graphicsDevice, sceneDescriptorSet_);
+    renderGraph = make_shared<RenderGraph>(graphicsDevice, sceneDescriptorSets_);
     renderGraph->add(scene, materialShaderMap);
 }
 
@@ -91,7 +91,7 @@ void PBRTest::createMeshResources()
 
 void PBRTest::buildRenderGraph()
 {
-    renderGraph = make_shared<RenderGraph>(graphicsDevice, sceneDescriptorSet_);
+    renderGraph = make_shared<RenderGraph>(graphicsDevice, sceneDescriptorSets_);
     renderGraph->add(scene, materialShaderMap);
 }
 
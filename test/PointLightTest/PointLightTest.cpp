@@ -103,7 +103,7 @@ void PointLightTest::createMeshResources()
 
 void PointLightTest::buildRenderGraph()
 {
-    renderGraph = make_shared<RenderGraph>(graphicsDevice, sceneDescriptorSet_);
+    renderGraph = make_shared<RenderGraph>(graphicsDevice, sceneDescriptorSets_);
     renderGraph->add(scene, materialShaderMap);
 }
 
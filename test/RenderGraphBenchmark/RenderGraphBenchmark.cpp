@@ -0,0 +1,185 @@
+#include "rfx/pch.h"
+#include "RenderGraphBenchmark.h"
+#include "Benchmark.h"
+#include "rfx/scene/SceneLoader.h"
+#include "rfx/common/Logger.h"
+
+
+using namespace rfx;
+using namespace rfx::test;
+using namespace glm;
+using namespace std;
+using namespace std::filesystem;
+
+static constexpr uint32_t WARM_UP_FRAME_COUNT = 10;
+static constexpr uint32_t FRAME_COUNT = 200;
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+int main()
+{
+    try {
+        auto theApp = make_shared<RenderGraphBenchmark>();
+        theApp->run();
+    }
+    catch (const exception& ex) {
+        RFX_LOG_ERROR << ex.what() << endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void RenderGraphBenchmark::initGraphics()
+{
+    TestApplication::initGraphics();
+
+    loadScene();
+    createShadersFor(scene, TexturedPBRShader::ID);
+
+    initGraphicsResources();
+    buildRenderGraph();
+    createCommandBuffers();
+
+    // every draw item is recorded, independent of the camera
+    renderGraph->setCamera(nullptr);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void RenderGraphBenchmark::loadScene()
+{
+    const path scenePath = getAssetsDirectory() / "models/sci-fi-corridors/scene.gltf";
+
+    SceneLoader sceneLoader(graphicsDevice);
+    scene = sceneLoader.load(scenePath);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void RenderGraphBenchmark::initShaderFactory(MaterialShaderFactory& shaderFactory)
+{
+    shaderFactory.addAllocator(TexturedPBRShader::ID,
+        [this] { return make_shared<TexturedPBRShader>(graphicsDevice); });
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void RenderGraphBenchmark::updateShaderData()
+{
+    for (const auto& [shader, materials] : materialShaderMap) {
+        shader->updateDataBuffer();
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void RenderGraphBenchmark::createMeshResources()
+{
+    TestApplication::createMeshResources();
+
+    createMeshDataBuffers(scene);
+    createMeshDescriptorSets(scene);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void RenderGraphBenchmark::buildRenderGraph()
+{
+    renderGraph = make_shared<RenderGraph>(graphicsDevice, sceneDescriptorSets_);
+    renderGraph->add(scene, materialShaderMap);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void RenderGraphBenchmark::beginMainLoop()
+{
+    TestApplication::beginMainLoop();
+
+    runBenchmark();
+
+    glfwSetWindowShouldClose(window_->getGlfwWindow(), GLFW_TRUE);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void RenderGraphBenchmark::runBenchmark()
+{
+    const VkCommandPoolCreateInfo poolInfo = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+        .queueFamilyIndex = graphicsDevice->getGraphicsQueue()->getFamilyIndex()
+    };
+
+    VkCommandPool commandPool = VK_NULL_HANDLE;
+    ThrowIfFailed(vkCreateCommandPool(
+        graphicsDevice->getLogicalDevice(),
+        &poolInfo,
+        nullptr,
+        &commandPool));
+
+    // nothing is submitted, so the command buffers can be re-recorded right away
+    const CommandBufferPtr commandBuffer = graphicsDevice->createCommandBuffers(
+        commandPool, 1, VK_COMMAND_BUFFER_LEVEL_PRIMARY).at(0);
+
+    chrono::microseconds singleThreadTime {};
+
+    for (uint32_t threadCount = 1; threadCount <= ThreadPool::getDefaultThreadCount(); threadCount *= 2)
+    {
+        const chrono::microseconds elapsedTime = measure(threadCount, commandBuffer, commandPool);
+        if (threadCount == 1) {
+            singleThreadTime = elapsedTime;
+        }
+
+        const RenderGraph::Stats& stats = renderGraph->getStats();
+        RFX_LOG_INFO << fmt::format("{} thread(s): {:.3f} ms per frame, {:.2f}x, {} draw calls",
+            threadCount,
+            chrono::duration<float, milli>(elapsedTime).count() / FRAME_COUNT,
+            Benchmark::getSpeedup(singleThreadTime, elapsedTime),
+            stats.drawCallCount);
+    }
+
+    vkDestroyCommandPool(graphicsDevice->getLogicalDevice(), commandPool, nullptr);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+chrono::microseconds RenderGraphBenchmark::measure(
+    uint32_t threadCount,
+    const CommandBufferPtr& commandBuffer,
+    VkCommandPool commandPool)
+{
+    const VkFramebuffer renderTarget = graphicsDevice->getSwapChain()->getFramebuffers().at(0);
+
+    renderGraph->setRecordThreadCount(threadCount);
+
+    const auto recordFrame = [&](uint32_t frame) {
+        ThrowIfFailed(vkResetCommandPool(graphicsDevice->getLogicalDevice(), commandPool, 0));
+        renderGraph->record(commandBuffer, renderPass, renderTarget, frame % MAX_FRAMES_IN_FLIGHT);
+    };
+
+    for (uint32_t frame = 0; frame < WARM_UP_FRAME_COUNT; ++frame) {
+        recordFrame(frame);
+    }
+
+    StopWatch stopWatch;
+    stopWatch.start();
+    for (uint32_t frame = 0; frame < FRAME_COUNT; ++frame) {
+        recordFrame(frame);
+    }
+    stopWatch.stop();
+
+    return stopWatch.getElapsedTime();
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void RenderGraphBenchmark::cleanup()
+{
+    scene.reset();
+
+    TestApplication::cleanup();
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
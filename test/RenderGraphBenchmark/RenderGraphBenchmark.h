@@ -0,0 +1,34 @@
+#pragma once
+
+#include "TestApplication.h"
+#include "TexturedPBRTest/TexturedPBRShader.h"
+#include "rfx/scene/Scene.h"
+
+
+namespace rfx::test {
+
+// records the render graph of the TexturedPBRTest scene with increasing thread counts and logs the recording time,
+// then quits without presenting a frame
+class RenderGraphBenchmark : public TestApplication
+{
+protected:
+    void initGraphics() override;
+    void initShaderFactory(MaterialShaderFactory& shaderFactory) override;
+    void createMeshResources() override;
+    void updateShaderData() override;
+    void beginMainLoop() override;
+    void cleanup() override;
+
+private:
+    void loadScene();
+    void buildRenderGraph() override;
+    void runBenchmark();
+    [[nodiscard]] std::chrono::microseconds measure(
+        uint32_t threadCount,
+        const CommandBufferPtr& commandBuffer,
+        VkCommandPool commandPool);
+
+    ScenePtr scene;
+};
+
+} // namespace rfx::test
@@ -0,0 +1,82 @@
+#include "rfx/pch.h"
+#include "RenderQueueBenchmark.h"
+#include "rfx/common/Logger.h"
+
+#include <random>
+
+
+using namespace rfx;
+using namespace rfx::test;
+using namespace std;
+
+static constexpr uint32_t DEFAULT_DRAW_COUNT = 100000;
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+int main(int argc, char **argv)
+{
+    return Benchmark::runMain(argc, argv, DEFAULT_DRAW_COUNT, [](uint32_t drawCount) {
+        RFX_CHECK_ARGUMENT(drawCount > 0);
+
+        auto theApp = make_shared<RenderQueueBenchmark>();
+        theApp->run(drawCount);
+    });
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void RenderQueueBenchmark::run(uint32_t drawCount)
+{
+    const vector<uint64_t> keys = createKeys(drawCount);
+
+    RFX_LOG_INFO << "Sorting " << drawCount << " draws";
+
+    // the reference sorts the same entries by key, stable, so that equal keys keep their item order
+    vector<RenderQueue::Entry> expectedEntries;
+    expectedEntries.reserve(keys.size());
+    for (uint32_t i = 0; i < keys.size(); ++i) {
+        expectedEntries.push_back({ keys[i], i });
+    }
+
+    const chrono::microseconds referenceTime = measure("stable_sort", [&] {
+        ranges::stable_sort(expectedEntries, {}, &RenderQueue::Entry::key);
+    });
+
+    RenderQueue renderQueue;
+    for (uint32_t i = 0; i < keys.size(); ++i) {
+        renderQueue.add(keys[i], i);
+    }
+
+    const chrono::microseconds sortTime = measure("radix sort", [&] { renderQueue.sort(); });
+
+    RFX_LOG_INFO << fmt::format("radix sort: {:.1f}x faster",
+        getSpeedup(referenceTime, sortTime));
+
+    const vector<RenderQueue::Entry>& entries = renderQueue.getEntries();
+    RFX_CHECK_STATE(entries.size() == expectedEntries.size(), "entries were lost");
+    for (size_t i = 0; i < entries.size(); ++i) {
+        RFX_CHECK_STATE(entries[i].key == expectedEntries[i].key && entries[i].item == expectedEntries[i].item,
+            "radix sort order differs from the reference");
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+vector<uint64_t> RenderQueueBenchmark::createKeys(uint32_t drawCount)
+{
+    mt19937 randomEngine;
+    uniform_int_distribution<uint32_t> pipeline(0, 7);
+    uniform_int_distribution<uint32_t> material(0, 255);
+    uniform_int_distribution<uint32_t> geometry(0, 63);
+    uniform_real_distribution<float> depth(0.0f, 1000.0f);
+
+    vector<uint64_t> keys(drawCount);
+    for (uint64_t& key : keys) {
+        key = RenderQueue::createKey(0, pipeline(randomEngine), material(randomEngine), geometry(randomEngine))
+            | RenderQueue::createDepthKey(depth(randomEngine));
+    }
+
+    return keys;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
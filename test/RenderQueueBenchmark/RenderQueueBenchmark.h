@@ -0,0 +1,18 @@
+#pragma once
+
+#include "Benchmark.h"
+#include "rfx/rendering/RenderQueue.h"
+
+namespace rfx::test {
+
+class RenderQueueBenchmark : public Benchmark
+{
+public:
+    void run(uint32_t drawCount);
+
+private:
+    // keys like the render graph creates them: few pipelines, more materials and geometry buffers, random depth
+    static std::vector<uint64_t> createKeys(uint32_t drawCount);
+};
+
+} // namespace rfx::test
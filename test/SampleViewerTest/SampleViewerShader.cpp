@@ -15,12 +15,17 @@ static const string FRAGMENT_SHADER_ID = "pbr_gltf/pbr_gltf";
 
 // ---------------------------------------------------------------------------------------------------------------------
 
-SampleViewerShader::SampleViewerShader(const GraphicsDevicePtr& graphicsDevice)
-    : TestMaterialShader(
-        graphicsDevice,
-        ID,
-        VERTEX_SHADER_ID,
-        FRAGMENT_SHADER_ID) {}
+SampleViewerShader::SampleViewerShader(
+    const GraphicsDevicePtr& graphicsDevice,
+    bool bindless,
+    bool clusteredLighting)
+        : TestMaterialShader(
+            graphicsDevice,
+            ID,
+            VERTEX_SHADER_ID,
+            FRAGMENT_SHADER_ID),
+          bindless(bindless),
+          clusteredLighting(clusteredLighting) {}
 
 // ---------------------------------------------------------------------------------------------------------------------
 
@@ -60,7 +65,15 @@ vector<string> SampleViewerShader::getShaderDefinesFor(const MaterialPtr& materi
     defines.emplace_back("USE_PUNCTUAL");
     defines.emplace_back("LINEAR_OUTPUT");
 
-    if (material->getBaseColorTexture() != nullptr) {
+    if (clusteredLighting) {
+        defines.emplace_back("CLUSTERED_LIGHTING");
+    }
+
+    // bindless shaders are shared by materials with and without textures
+    if (bindless) {
+        defines.emplace_back("BINDLESS");
+    }
+    else if (material->getBaseColorTexture() != nullptr) {
         defines.emplace_back("HAS_BASE_COLOR_MAP 1");
     }
 
@@ -77,6 +90,10 @@ vector<string> SampleViewerShader::getShaderDefinesFor(const MaterialPtr& materi
         defines.emplace_back("HAS_NORMAL_VEC3");
     }
 
+    if (vertexFormat.containsPackedNormals()) {
+        defines.emplace_back("HAS_PACKED_NORMALS");
+    }
+
     if (vertexFormat.containsTexCoords()) {
         defines.emplace_back("HAS_TEXCOORD_VEC2");
     }
@@ -108,11 +125,16 @@ vector<string> SampleViewerShader::getVertexShaderInputsFor(const MaterialPtr& m
         location++;
     }
 
-    if (vertexFormat.containsNormals()) {
+    if (vertexFormat.containsPackedNormals()) {
+        inputs.push_back(fmt::format("layout(location = {}) in uint inPackedNormal;", location));
+        location++;
+    }
+    else if (vertexFormat.containsNormals()) {
         inputs.push_back(fmt::format("layout(location = {}) in vec3 inNormal;", location));
         location++;
     }
 
+    // packed tex coords are unorm, so they are read as floats as well
     uint32_t texCoordSetCount = vertexFormat.getTexCoordSetCount();
     if (texCoordSetCount > 0) {
         inputs.push_back(fmt::format("layout(location = {}) in vec2 inTexCoord[{}];", location, texCoordSetCount));
@@ -153,6 +175,11 @@ vector<string> SampleViewerShader::getVertexShaderOutputsFor(const MaterialPtr&
         location += texCoordSetCount;
     }
 
+    if (bindless) {
+        outputs.push_back(fmt::format("layout(location = {}) flat out uint outMaterialIndex;", location));
+        location++;
+    }
+
     return outputs;
 }
 
@@ -187,6 +214,11 @@ vector<string> SampleViewerShader::getFragmentShaderInputsFor(const MaterialPtr&
         location += texCoordSetCount;
     }
 
+    if (bindless) {
+        inputs.push_back(fmt::format("layout(location = {}) flat in uint inMaterialIndex;", location));
+        location++;
+    }
+
     return inputs;
 }
 
@@ -19,7 +19,12 @@ public:
     static const std::string ID;
     static const int MAX_LIGHTS = 8;
 
-    explicit SampleViewerShader(const GraphicsDevicePtr& graphicsDevice);
+    // bindless shaders read the material from a BindlessMaterialTable at set 2, clustered lighting shaders read the
+    // lights from the ClusteredLighting buffers at set 0 instead of the lights set with setLight()
+    explicit SampleViewerShader(
+        const GraphicsDevicePtr& graphicsDevice,
+        bool bindless = false,
+        bool clusteredLighting = false);
 
     [[nodiscard]] std::vector<std::byte> createDataFor(const MaterialPtr& material) const override;
     [[nodiscard]] const void* getData() const override;
@@ -59,6 +64,8 @@ private:
 
 
     ShaderData data {};
+    bool bindless = false;
+    bool clusteredLighting = false;
 };
 
 using SampleViewerShaderPtr = std::shared_ptr<SampleViewerShader>;
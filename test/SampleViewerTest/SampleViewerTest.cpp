@@ -3,6 +3,8 @@
 #include "rfx/scene/SceneLoader.h"
 #include "rfx/common/Logger.h"
 
+#include <glm/gtc/constants.hpp>
+
 using namespace rfx;
 using namespace rfx::test;
 using namespace glm;
@@ -17,6 +19,12 @@ static const char* models[] = {
     "VertexColorTest"
 };
 
+// point lights on a fibonacci sphere around the model, lit with clustered lighting
+static constexpr uint32_t POINT_LIGHT_COUNT = 256;
+static constexpr float POINT_LIGHT_ORBIT_RADIUS = 1.2f;
+static constexpr float POINT_LIGHT_RANGE = 0.4f;
+static constexpr float POINT_LIGHT_SPEED = 0.0002f;    // radians per millisecond
+
 // ---------------------------------------------------------------------------------------------------------------------
 
 int main()
@@ -37,8 +45,14 @@ int main()
 
 void SampleViewerTest::initGraphics()
 {
+    indirectDrawing_ = true;
+
     TestApplication::initGraphics();
 
+    clusteredLighting_ = make_shared<ClusteredLighting>(graphicsDevice, MAX_FRAMES_IN_FLIGHT);
+
+    bindlessMaterials_ = graphicsDevice->isBindlessSupported();
+
     loadScene();
     createShadersFor(scene, SampleViewerShader::ID);
 
@@ -61,7 +75,11 @@ void SampleViewerTest::loadScene()
 
     scenePath.replace_extension("gltf");
 
-    SceneLoader sceneLoader(graphicsDevice);
+    // half float coordinates aren't precise enough for the larger sample models, the shader doesn't read tangents
+    SceneLoader sceneLoader(graphicsDevice, {
+        .vertexPackingMask = VertexFormat::PACKED_NORMALS | VertexFormat::PACKED_TEXCOORDS,
+        .optimizeMeshes = true
+    });
     scene = sceneLoader.load(scenePath);
 
     if (scene->getLightCount() > 0) {
@@ -82,6 +100,52 @@ void SampleViewerTest::createLights()
     directionalLight->setDirection({ -1.0F, -1.0F, -1.0F });
 
     scene->addLight(directionalLight);
+
+    pointLights.clear();
+    for (uint32_t i = 0; i < POINT_LIGHT_COUNT; ++i)
+    {
+        const float hue = static_cast<float>(i) / POINT_LIGHT_COUNT;
+        const vec3 color = 0.5f + 0.5f * cos(two_pi<float>() * (hue + vec3(0.0f, 1.0f / 3.0f, 2.0f / 3.0f)));
+
+        auto pointLight = make_shared<PointLight>(fmt::format("point-light#{}", i));
+        pointLight->setColor(color);
+        pointLight->setRange(POINT_LIGHT_RANGE);
+        pointLight->setEnabled(pointLightsEnabled);
+        pointLights.push_back(pointLight);
+
+        scene->addLight(pointLight);
+    }
+
+    updatePointLights(0.0f);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void SampleViewerTest::updatePointLights(float deltaTime)
+{
+    const float goldenAngle = pi<float>() * (3.0f - sqrt(5.0f));
+    pointLightTime += deltaTime;
+
+    for (uint32_t i = 0; i < pointLights.size(); ++i)
+    {
+        const float y = 1.0f - 2.0f * (static_cast<float>(i) + 0.5f) / static_cast<float>(pointLights.size());
+        const float ringRadius = sqrt(1.0f - y * y);
+        const float angle = static_cast<float>(i) * goldenAngle + pointLightTime * POINT_LIGHT_SPEED;
+
+        pointLights[i]->setPosition(
+            vec3(cos(angle) * ringRadius, y, sin(angle) * ringRadius) * POINT_LIGHT_ORBIT_RADIUS);
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void SampleViewerTest::updateLightClusters()
+{
+    clusteredLighting_->setProjection(
+        sceneData_.projMatrix,
+        graphicsDevice->getSwapChain()->getDesc().extent);
+
+    clusteredLighting_->update(getCurrentFrame(), scene->getLights(), sceneData_.viewMatrix);
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
@@ -90,17 +154,61 @@ void SampleViewerTest::buildRenderGraph()
 {
     skyBoxNode = make_shared<SkyBoxNode>(skyBox);
 
-    renderGraph = make_shared<RenderGraph>(graphicsDevice, sceneDescriptorSet_);
+    renderGraph = make_shared<RenderGraph>(graphicsDevice, sceneDescriptorSets_);
     renderGraph->add(skyBoxNode);
     renderGraph->add(scene, materialShaderMap);
+    renderGraph->enableIndirectDrawing(createDrawDataDescriptorSets(), materialTable_);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+vector<VkDescriptorSet> SampleViewerTest::createDrawDataDescriptorSets()
+{
+    // one per frame in flight, the render graph rewrites the draw data of a frame while the others are in flight
+    const vector<VkDescriptorSetLayout> layouts(MAX_FRAMES_IN_FLIGHT, meshDescriptorSetLayout_);
+
+    const VkDescriptorSetAllocateInfo allocInfo {
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+        .descriptorPool = descriptorPool,
+        .descriptorSetCount = static_cast<uint32_t>(layouts.size()),
+        .pSetLayouts = layouts.data()
+    };
+
+    drawDataDescriptorSets.resize(layouts.size());
+    ThrowIfFailed(vkAllocateDescriptorSets(
+        graphicsDevice->getLogicalDevice(),
+        &allocInfo,
+        drawDataDescriptorSets.data()));
+
+    return drawDataDescriptorSets;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void SampleViewerTest::destroyDrawDataDescriptorSets()
+{
+    if (drawDataDescriptorSets.empty()) {
+        return;
+    }
+
+    ThrowIfFailed(vkFreeDescriptorSets(
+        graphicsDevice->getLogicalDevice(),
+        descriptorPool,
+        static_cast<uint32_t>(drawDataDescriptorSets.size()),
+        drawDataDescriptorSets.data()));
+    drawDataDescriptorSets.clear();
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
 
 void SampleViewerTest::initShaderFactory(MaterialShaderFactory& shaderFactory)
 {
+    // bindless shaders look up the textures at runtime, so texture presence doesn't select a permutation
     shaderFactory.addAllocator(SampleViewerShader::ID,
-        [this] { return make_shared<SampleViewerShader>(graphicsDevice); });
+        [this] {
+            return make_shared<SampleViewerShader>(graphicsDevice, bindlessMaterials_, clusteredLighting_ != nullptr);
+        },
+        bindlessMaterials_ ? ~Material::TEXTURE_PERMUTATION_KEY_MASK : UINT32_MAX);
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
@@ -135,16 +243,6 @@ void SampleViewerTest::createSkyBox()
 
 // ---------------------------------------------------------------------------------------------------------------------
 
-void SampleViewerTest::createMeshResources()
-{
-    TestApplication::createMeshResources();
-
-    createMeshDataBuffers(scene);
-    createMeshDescriptorSets(scene);
-}
-
-// ---------------------------------------------------------------------------------------------------------------------
-
 void SampleViewerTest::updateShaderData()
 {
     for (const auto& [shader, material] : materialShaderMap)
@@ -198,6 +296,12 @@ void SampleViewerTest::updateDevTools()
         if (lightNeedsUpdate) {
             updateShaderData();
         }
+
+        if (devTools->checkBox("point lights enabled", &pointLightsEnabled)) {
+            for (const auto& pointLight : pointLights) {
+                pointLight->setEnabled(pointLightsEnabled);
+            }
+        }
     }
 
     // Background
@@ -207,22 +311,42 @@ void SampleViewerTest::updateDevTools()
     {
         if (devTools->checkBox("Environment Map", &useEnvironmentMap)) {
             skyBoxNode->setEnabled(useEnvironmentMap);
-            freeCommandBuffers();
-            createCommandBuffers();
         }
 
         if (devTools->sliderFloat("Blur", &environmentBlurFactor, 0.0f, 1.0f)) {
             skyBox->setBlur(environmentBlurFactor);
         }
     }
+
+    // Statistics
+    static bool statisticsExpanded = false;
+    statisticsExpanded = devTools->collapsingHeader("Statistics", statisticsExpanded);
+    if (statisticsExpanded && renderGraph != nullptr)
+    {
+        const RenderGraph::Stats& stats = renderGraph->getStats();
+        devTools->text(fmt::format("{} draws ({} instances) in {} draw calls",
+            stats.drawCount, stats.instanceCount, stats.drawCallCount));
+        devTools->text(fmt::format("{} pipeline binds", stats.pipelineBindCount));
+        devTools->text(fmt::format("{} descriptor set binds", stats.descriptorSetBindCount));
+        devTools->text(fmt::format("{} vertex / {} index buffer binds",
+            stats.vertexBufferBindCount, stats.indexBufferBindCount));
+
+        const ClusteredLighting::Stats& lightStats = clusteredLighting_->getStats();
+        devTools->text(fmt::format("{} lights, {} light indices (max {} per cluster)",
+            lightStats.lightCount, lightStats.lightIndexCount, lightStats.maxClusterLightCount));
+    }
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
 
 void SampleViewerTest::update(float deltaTime)
 {
+    updatePointLights(deltaTime);
+
     TestApplication::update(deltaTime);
 
+    updateLightClusters();
+
     if (needsReload) {
         reload();
     }
@@ -234,9 +358,13 @@ void SampleViewerTest::reload()
 {
     needsReload = false;
 
+    // the descriptor sets and buffers below may still be used by the frames in flight
+    graphicsDevice->waitIdle();
+
     destroyScene();
     destroyShaderMap();
     destroyRenderGraph();
+    destroyDrawDataDescriptorSets();
     destroyRenderPass();
     destroyMeshResources();
     destroySceneResources();
@@ -281,6 +409,7 @@ void SampleViewerTest::cleanupSwapChain()
     }
 
     skyBoxNode.reset();
+    destroyDrawDataDescriptorSets();
 
     TestApplication::cleanupSwapChain();
 }
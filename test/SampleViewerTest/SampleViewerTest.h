@@ -4,6 +4,7 @@
 #include "SampleViewerShader.h"
 #include "rfx/scene/Scene.h"
 #include "rfx/scene/DirectionalLight.h"
+#include "rfx/scene/PointLight.h"
 #include "rfx/scene/SkyBox.h"
 #include "rfx/rendering/SkyBoxNode.h"
 
@@ -19,7 +20,6 @@ protected:
     void initGraphics() override;
     void initShaderFactory(MaterialShaderFactory& shaderFactory) override;
     void createSceneResources() override;
-    void createMeshResources() override;
     void updateShaderData() override;
     void updateDevTools() override;
     void update(float deltaTime) override;
@@ -29,8 +29,12 @@ protected:
 private:
     void loadScene();
     void createLights();
+    void updatePointLights(float deltaTime);
+    void updateLightClusters();
     void createSkyBox();
     void buildRenderGraph() override;
+    std::vector<VkDescriptorSet> createDrawDataDescriptorSets();
+    void destroyDrawDataDescriptorSets();
     void reload();
     void destroyScene();
 
@@ -38,11 +42,15 @@ private:
 
     SkyBoxPtr skyBox;
     SkyBoxNodePtr skyBoxNode;
+    std::vector<VkDescriptorSet> drawDataDescriptorSets;
 
     int selectedModelIndex = 2;
     bool needsReload = false;
     bool imageBasedLighting = false;
     DirectionalLightPtr directionalLight;
+    std::vector<PointLightPtr> pointLights;
+    bool pointLightsEnabled = true;
+    float pointLightTime = 0.0f;
 
     bool useEnvironmentMap = true;
     float environmentBlurFactor = 0.0f;
@@ -103,7 +103,7 @@ void SpotLightTest::createMeshResources()
 
 void SpotLightTest::buildRenderGraph()
 {
-    renderGraph = make_shared<RenderGraph>(graphicsDevice, sceneDescriptorSet_);
+    renderGraph = make_shared<RenderGraph>(graphicsDevice, sceneDescriptorSets_);
     renderGraph->add(scene, materialShaderMap);
 }
 
@@ -1,6 +1,7 @@
 #include "rfx/pch.h"
 #include "TestApplication.h"
 #include "rfx/graphics/PipelineUtil.h"
+#include "rfx/common/Math.h"
 
 using namespace rfx;
 using namespace glm;
@@ -35,16 +36,22 @@ void TestApplication::initGraphicsResources()
 void TestApplication::createDescriptorPool()
 {
     const uint32_t uniformBufferDescCount = 8000;
+    const uint32_t dynamicUniformBufferDescCount = 16;
+    const uint32_t storageBufferDescCount = 256;
     const uint32_t combinedImageSamplerDescCount = 8000;
     const uint32_t maxSets = 8000;
 
     vector<VkDescriptorPoolSize> poolSizes = {
         { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, uniformBufferDescCount },
+        { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, dynamicUniformBufferDescCount },
+        { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, storageBufferDescCount },
         { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, combinedImageSamplerDescCount }
     };
 
+    // the scene, mesh and draw data descriptor sets are freed and reallocated when the swapchain is recreated
     VkDescriptorPoolCreateInfo poolCreateInfo {
         .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+        .flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT,
         .maxSets = maxSets,
         .poolSizeCount = static_cast<uint32_t>(poolSizes.size()),
         .pPoolSizes = poolSizes.data()
@@ -63,15 +70,18 @@ void TestApplication::createSceneResources()
 {
     createSceneDataBuffer();
     createSceneDescriptorSetLayout();
-    createSceneDescriptorSet();
+    createSceneDescriptorSets();
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
 
 void TestApplication::createSceneDataBuffer()
 {
+    const VkDeviceSize alignment = graphicsDevice->getDesc().properties.limits.minUniformBufferOffsetAlignment;
+    sceneDataSliceSize_ = Math::alignUp(sizeof(SceneData), alignment);
+
     sceneDataBuffer_ = graphicsDevice->createBuffer(
-        sizeof(SceneData),
+        sceneDataSliceSize_ * MAX_FRAMES_IN_FLIGHT,
         VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
         VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
 
@@ -82,17 +92,21 @@ void TestApplication::createSceneDataBuffer()
 
 void TestApplication::createSceneDescriptorSetLayout()
 {
-    const VkDescriptorSetLayoutBinding sceneDescSetLayoutBinding {
+    vector<VkDescriptorSetLayoutBinding> sceneDescSetLayoutBindings {{
         .binding = 0,
         .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
         .descriptorCount = 1,
         .stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT
-    };
+    }};
+
+    if (clusteredLighting_) {
+        ranges::copy(ClusteredLighting::getDescriptorSetLayoutBindings(1), back_inserter(sceneDescSetLayoutBindings));
+    }
 
     const VkDescriptorSetLayoutCreateInfo sceneDescSetLayoutCreateInfo {
         .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
-        .bindingCount = 1,
-        .pBindings = &sceneDescSetLayoutBinding
+        .bindingCount = static_cast<uint32_t>(sceneDescSetLayoutBindings.size()),
+        .pBindings = sceneDescSetLayoutBindings.data()
     };
 
     ThrowIfFailed(vkCreateDescriptorSetLayout(
@@ -104,27 +118,51 @@ void TestApplication::createSceneDescriptorSetLayout()
 
 // ---------------------------------------------------------------------------------------------------------------------
 
-void TestApplication::createSceneDescriptorSet()
+void TestApplication::createSceneDescriptorSets()
 {
+    const vector<VkDescriptorSetLayout> descriptorSetLayouts(MAX_FRAMES_IN_FLIGHT, sceneDescriptorSetLayout_);
+
     const VkDescriptorSetAllocateInfo allocInfo {
         .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
         .descriptorPool = descriptorPool,
-        .descriptorSetCount = 1,
-        .pSetLayouts = &sceneDescriptorSetLayout_
+        .descriptorSetCount = MAX_FRAMES_IN_FLIGHT,
+        .pSetLayouts = descriptorSetLayouts.data()
     };
 
+    sceneDescriptorSets_.resize(MAX_FRAMES_IN_FLIGHT);
     ThrowIfFailed(vkAllocateDescriptorSets(
         graphicsDevice->getLogicalDevice(),
         &allocInfo,
-        &sceneDescriptorSet_));
+        sceneDescriptorSets_.data()));
+
+    vector<VkDescriptorBufferInfo> bufferInfos(MAX_FRAMES_IN_FLIGHT);
+    vector<array<VkDescriptorBufferInfo, ClusteredLighting::BINDING_COUNT>> lightBufferInfos(MAX_FRAMES_IN_FLIGHT);
+    vector<VkWriteDescriptorSet> writeDescriptorSets;
 
-    const VkWriteDescriptorSet writeDescriptorSet =
-        buildWriteDescriptorSet(sceneDescriptorSet_, 0, &sceneDataBuffer_->getDescriptorBufferInfo());
+    for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
+    {
+        bufferInfos[i] = {
+            .buffer = sceneDataBuffer_->getHandle(),
+            .offset = i * sceneDataSliceSize_,
+            .range = sizeof(SceneData)
+        };
+        writeDescriptorSets.push_back(buildWriteDescriptorSet(sceneDescriptorSets_[i], 0, &bufferInfos[i]));
+
+        if (clusteredLighting_) {
+            lightBufferInfos[i] = clusteredLighting_->getDescriptorBufferInfos(i);
+            for (uint32_t binding = 0; binding < ClusteredLighting::BINDING_COUNT; ++binding) {
+                VkWriteDescriptorSet writeDescriptorSet =
+                    buildWriteDescriptorSet(sceneDescriptorSets_[i], binding + 1, &lightBufferInfos[i][binding]);
+                writeDescriptorSet.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+                writeDescriptorSets.push_back(writeDescriptorSet);
+            }
+        }
+    }
 
     vkUpdateDescriptorSets(
         graphicsDevice->getLogicalDevice(),
-        1,
-        &writeDescriptorSet,
+        static_cast<uint32_t>(writeDescriptorSets.size()),
+        writeDescriptorSets.data(),
         0,
         nullptr);
 }
@@ -133,36 +171,44 @@ void TestApplication::createSceneDescriptorSet()
 
 void TestApplication::createMeshDataBuffers(const ScenePtr& scene)
 {
+    meshDataNodes_.clear();
+
     ranges::for_each(scene->getModels(),
         [this](const ModelPtr& model) {
             createMeshDataBuffers(model);
         });
+
+    // mesh data of all geometry nodes is rewritten every frame into the frame's region of the ring
+    meshDataRing_ = make_shared<UniformBufferRing>(
+        graphicsDevice,
+        meshDataNodes_.size() * UniformBufferRing::getAlignedSize(*graphicsDevice, sizeof(MeshData)),
+        MAX_FRAMES_IN_FLIGHT);
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
 
 void TestApplication::createMeshDataBuffers(const ModelPtr& model)
 {
-    for (const auto& node : model->getGeometryNodes()) {
-        if (node->getMeshCount() == 0) {
-            continue;
-        }
+    ranges::copy(model->getGeometryNodes(), back_inserter(meshDataNodes_));
+}
 
-        RFX_CHECK_STATE(node->getMeshCount() == 1, "");
+// ---------------------------------------------------------------------------------------------------------------------
 
-        MeshData meshData = {
-            .modelMatrix = node->getWorldTransform()
-        };
+void TestApplication::updateMeshData()
+{
+    if (!meshDataRing_) {
+        return;
+    }
 
-        BufferPtr meshDataBuffer = graphicsDevice->createBuffer(
-            sizeof(MeshData),
-            VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    meshDataRing_->beginFrame(getCurrentFrame());
 
-        graphicsDevice->bind(meshDataBuffer);
-        meshDataBuffer->load(sizeof(MeshData), &meshData);
+    for (const auto& node : meshDataNodes_)
+    {
+        const MeshData meshData = {
+            .modelMatrix = node->getWorldTransform()
+        };
 
-        node->getMeshes().at(0)->setDataBuffer(meshDataBuffer);
+        node->setDataOffset(meshDataRing_->push(meshData));
     }
 }
 
@@ -179,7 +225,9 @@ void TestApplication::createMeshDescriptorSetLayout()
 {
     const VkDescriptorSetLayoutBinding meshDescSetLayoutBinding {
         .binding = 0,
-        .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+        .descriptorType = indirectDrawing_
+            ? VK_DESCRIPTOR_TYPE_STORAGE_BUFFER
+            : VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
         .descriptorCount = 1,
         .stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT
     };
@@ -201,16 +249,9 @@ void TestApplication::createMeshDescriptorSetLayout()
 
 void TestApplication::createMeshDescriptorSets(const ScenePtr& scene)
 {
-    ranges::for_each(scene->getModels(),
-        [this](const ModelPtr& model) {
-            createMeshDescriptorSets(model);
-        });
-}
+    RFX_CHECK_STATE(meshDataRing_ != nullptr, "Mesh data buffers must be created first");
+    RFX_CHECK_STATE(!indirectDrawing_, "Indirect drawing binds the render graph's draw data instead of mesh data");
 
-// ---------------------------------------------------------------------------------------------------------------------
-
-void TestApplication::createMeshDescriptorSets(const ModelPtr& model)
-{
     const VkDescriptorSetAllocateInfo allocInfo {
         .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
         .descriptorPool = descriptorPool,
@@ -218,28 +259,46 @@ void TestApplication::createMeshDescriptorSets(const ModelPtr& model)
         .pSetLayouts = &meshDescriptorSetLayout_
     };
 
-    for (const auto& mesh : model->getMeshes()) {
+    ThrowIfFailed(vkAllocateDescriptorSets(
+        graphicsDevice->getLogicalDevice(),
+        &allocInfo,
+        &meshDescriptorSet_));
 
-        VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
-        ThrowIfFailed(vkAllocateDescriptorSets(
-            graphicsDevice->getLogicalDevice(),
-            &allocInfo,
-            &descriptorSet));
+    const VkDescriptorBufferInfo bufferInfo {
+        .buffer = meshDataRing_->getBuffer()->getHandle(),
+        .offset = 0,
+        .range = sizeof(MeshData)
+    };
 
-        const VkWriteDescriptorSet writeDescriptorSet =
-            buildWriteDescriptorSet(
-                descriptorSet,
-                0,
-                &mesh->getDataBuffer()->getDescriptorBufferInfo());
+    const VkWriteDescriptorSet writeDescriptorSet {
+        .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+        .dstSet = meshDescriptorSet_,
+        .dstBinding = 0,
+        .dstArrayElement = 0,
+        .descriptorCount = 1,
+        .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
+        .pBufferInfo = &bufferInfo
+    };
+
+    vkUpdateDescriptorSets(
+        graphicsDevice->getLogicalDevice(),
+        1,
+        &writeDescriptorSet,
+        0,
+        nullptr);
+
+    ranges::for_each(scene->getModels(),
+        [this](const ModelPtr& model) {
+            createMeshDescriptorSets(model);
+        });
+}
 
-        vkUpdateDescriptorSets(
-            graphicsDevice->getLogicalDevice(),
-            1,
-            &writeDescriptorSet,
-            0,
-            nullptr);
+// ---------------------------------------------------------------------------------------------------------------------
 
-        mesh->setDescriptorSet(descriptorSet);
+void TestApplication::createMeshDescriptorSets(const ModelPtr& model)
+{
+    for (const auto& mesh : model->getMeshes()) {
+        mesh->setDescriptorSet(meshDescriptorSet_);
     }
 }
 
@@ -370,7 +429,9 @@ void TestApplication::createPipelines()
         vector<VkDescriptorSetLayout> descriptorSetLayouts {
             sceneDescriptorSetLayout_,
             shader->getShaderDescriptorSetLayout(),
-            shader->getMaterialDescriptorSetLayout(),
+            materialTable_
+                ? materialTable_->getDescriptorSetLayout()
+                : shader->getMaterialDescriptorSetLayout(),
             meshDescriptorSetLayout_
         };
 
@@ -444,6 +505,7 @@ void TestApplication::update(float deltaTime)
 
     updateCamera(deltaTime);
     updateSceneData(deltaTime);
+    updateMeshData();
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
@@ -515,6 +577,8 @@ void TestApplication::cleanup()
 
     destroyShaderMap();
     destroyRenderGraph();
+    meshDataRing_.reset();
+    clusteredLighting_.reset();
 
     if (wireframePipeline) {
         vkDestroyPipeline(device, wireframePipeline, nullptr);
@@ -532,6 +596,7 @@ void TestApplication::destroyShaderMap()
         shader->destroy();
     }
     materialShaderMap.clear();
+    materialTable_.reset();
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
@@ -559,6 +624,14 @@ void TestApplication::destroySceneResources()
 {
     if (sceneDescriptorSetLayout_ != nullptr) {
         const VkDevice device = graphicsDevice->getLogicalDevice();
+        if (!sceneDescriptorSets_.empty()) {
+            ThrowIfFailed(vkFreeDescriptorSets(
+                device,
+                descriptorPool,
+                static_cast<uint32_t>(sceneDescriptorSets_.size()),
+                sceneDescriptorSets_.data()));
+            sceneDescriptorSets_.clear();
+        }
         vkDestroyDescriptorSetLayout(device, sceneDescriptorSetLayout_, nullptr);
         sceneDescriptorSetLayout_ = nullptr;
     }
@@ -574,6 +647,12 @@ void TestApplication::destroyMeshResources()
     }
 
     const VkDevice device = graphicsDevice->getLogicalDevice();
+
+    if (meshDescriptorSet_ != VK_NULL_HANDLE) {
+        ThrowIfFailed(vkFreeDescriptorSets(device, descriptorPool, 1, &meshDescriptorSet_));
+        meshDescriptorSet_ = VK_NULL_HANDLE;
+    }
+
     vkDestroyDescriptorSetLayout(device, meshDescriptorSetLayout_, nullptr);
     meshDescriptorSetLayout_ = nullptr;
 }
@@ -654,7 +733,9 @@ void TestApplication::updateSceneData(float deltaTime)
 
 void TestApplication::updateSceneDataBuffer()
 {
-    sceneDataBuffer_->load(sizeof(SceneData), &sceneData_);
+    // only the slice of the current frame is written - the other slices may still be read by frames in flight
+    auto* sliceData = static_cast<std::byte*>(sceneDataBuffer_->getMappedData()) + getCurrentFrame() * sceneDataSliceSize_;
+    memcpy(sliceData, &sceneData_, sizeof(SceneData));
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
@@ -671,28 +752,24 @@ void TestApplication::createShadersFor(
 
     initShaderFactory(shaderFactory);
 
-    ranges::for_each(scene->getModels(),
-        [this, &shaderFactory](const ModelPtr& model) {
-            createShadersFor(model, shaderFactory);
-        });
-
-    updateShaderData();
-}
-
-// ---------------------------------------------------------------------------------------------------------------------
+    for (const auto& [shader, materials] : shaderFactory.createShadersFor(scene)) {
+        for (const auto& material : materials)
+        {
+            if (!bindlessMaterials_) {
+                initMaterialUniformBuffer(material, shader);
+                initMaterialDescriptorSet(material, shader);
+            }
 
-void TestApplication::createShadersFor(
-    const ModelPtr& model,
-    MaterialShaderFactory& shaderFactory)
-{
-    for (const auto& material : model->getMaterials())
-    {
-        const MaterialShaderPtr shader = shaderFactory.createShaderFor(material);
-        initMaterialUniformBuffer(material, shader);
-        initMaterialDescriptorSet(material, shader);
+            materialShaderMap[shader].push_back(material);
+        }
+    }
 
-        materialShaderMap[shader].push_back(material);
+    if (bindlessMaterials_) {
+        materialTable_ = make_shared<BindlessMaterialTable>(graphicsDevice);
+        materialTable_->build(scene);
     }
+
+    updateShaderData();
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
@@ -866,22 +943,23 @@ void TestApplication::createCommandBuffers()
 {
     RFX_CHECK_STATE(renderGraph != nullptr, "");
 
-    const unique_ptr<SwapChain>& swapChain = graphicsDevice->getSwapChain();
-    const vector<VkFramebuffer>& swapChainFrameBuffers = swapChain->getFramebuffers();
+    renderGraph->setCamera(camera);
 
-    commandBuffers = graphicsDevice->createCommandBuffers(
-        graphicsDevice->getGraphicsCommandPool(),
-        swapChainFrameBuffers.size());
+    // the render graph is re-recorded every frame, see recordFrame()
+    perFrameRecording = true;
+}
 
-    for (size_t i = 0; i < commandBuffers.size(); ++i)
-    {
-        const auto& commandBuffer = commandBuffers[i];
+// ---------------------------------------------------------------------------------------------------------------------
 
-        renderGraph->record(
-            commandBuffer,
-            renderPass,
-            swapChainFrameBuffers[i]);
-    }
+void TestApplication::recordFrame(const CommandBufferPtr& commandBuffer)
+{
+    const vector<VkFramebuffer>& swapChainFrameBuffers = graphicsDevice->getSwapChain()->getFramebuffers();
+
+    renderGraph->record(
+        commandBuffer,
+        renderPass,
+        swapChainFrameBuffers[currentImageIndex],
+        getCurrentFrame());
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
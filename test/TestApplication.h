@@ -2,9 +2,12 @@
 
 #include "rfx/application/Application.h"
 #include "rfx/rendering/RenderGraph.h"
+#include "rfx/rendering/ClusteredLighting.h"
+#include "rfx/graphics/UniformBufferRing.h"
 #include "rfx/scene/Model.h"
 #include "rfx/scene/FlyCamera.h"
 #include "rfx/scene/MaterialShaderFactory.h"
+#include "rfx/scene/BindlessMaterialTable.h"
 
 
 namespace rfx {
@@ -31,7 +34,7 @@ protected:
     virtual void createSceneResources();
     void destroySceneResources();
     void createSceneDescriptorSetLayout();
-    void createSceneDescriptorSet();
+    void createSceneDescriptorSets();
     void createSceneDataBuffer();
     void updateSceneData(float deltaTime);
     void updateSceneDataBuffer();
@@ -39,9 +42,6 @@ protected:
     void createShadersFor(
         const ScenePtr& scene,
         const std::string& defaultShaderId);
-    void createShadersFor(
-        const ModelPtr& model,
-        MaterialShaderFactory& shaderFactory);
     virtual void initShaderFactory(MaterialShaderFactory& shaderFactory) = 0;
 
     virtual void createMeshResources();
@@ -51,11 +51,13 @@ protected:
     void createMeshDescriptorSets(const ModelPtr& model);
     void createMeshDataBuffers(const ScenePtr& scene);
     void createMeshDataBuffers(const ModelPtr& model);
+    void updateMeshData();
 
     virtual void createPipelines();
     virtual void buildRenderGraph() {}
     void destroyRenderGraph();
     virtual void createCommandBuffers();
+    void recordFrame(const CommandBufferPtr& commandBuffer) override;
 
     void initGraphicsResources();
     BufferPtr createAndBindUniformBuffer(VkDeviceSize bufferSize);
@@ -104,14 +106,27 @@ protected:
     bool mouseCursorLocked = false;
 
     VkDescriptorSetLayout sceneDescriptorSetLayout_ = VK_NULL_HANDLE;
-    VkDescriptorSet sceneDescriptorSet_ = VK_NULL_HANDLE;
-    std::shared_ptr<Buffer> sceneDataBuffer_;
+    std::vector<VkDescriptorSet> sceneDescriptorSets_;     // one per frame in flight
+    std::shared_ptr<Buffer> sceneDataBuffer_;               // one slice per frame in flight
+    VkDeviceSize sceneDataSliceSize_ = 0;
     SceneData sceneData_ {};
 
+    // with clustered lighting, set 0 also holds the light buffers at bindings 1-3
+    ClusteredLightingPtr clusteredLighting_;
+
+    // with indirect drawing, set 3 holds the render graph's per-draw storage buffer instead of the mesh data
+    bool indirectDrawing_ = false;
     VkDescriptorSetLayout meshDescriptorSetLayout_ = VK_NULL_HANDLE;
+    VkDescriptorSet meshDescriptorSet_ = VK_NULL_HANDLE;    // shared by all meshes, indexed with dynamic offsets
+    UniformBufferRingPtr meshDataRing_;
+    std::vector<std::shared_ptr<ModelNode>> meshDataNodes_;
 
     std::unordered_map<MaterialShaderPtr, std::vector<MaterialPtr>> materialShaderMap;
 
+    // with bindless materials, set 2 holds the table instead of a descriptor set per material
+    bool bindlessMaterials_ = false;
+    BindlessMaterialTablePtr materialTable_;
+
     RenderGraphPtr renderGraph;
 };
 
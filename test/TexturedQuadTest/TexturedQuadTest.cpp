@@ -536,7 +536,7 @@ void TexturedQuadTest::createGraphicsPipeline()
 
     ThrowIfFailed(vkCreateGraphicsPipelines(
         graphicsDevice->getLogicalDevice(),
-        VK_NULL_HANDLE,
+        graphicsDevice->getPipelineCache()->getHandle(),
         1,
         &pipelineInfo,
         nullptr,